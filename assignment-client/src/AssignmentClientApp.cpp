@@ -18,6 +18,8 @@
 
 #include <LogHandler.h>
 #include <HifiConfigVariantMap.h>
+#include <NodeList.h>
+#include <PacketReplayer.h>
 #include <SharedUtil.h>
 #include <ShutdownEventListener.h>
 
@@ -90,6 +92,19 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
     const QCommandLineOption parentPIDOption(PARENT_PID_OPTION, "PID of the parent process", "parent-pid");
     parser.addOption(parentPIDOption);
 
+    const QCommandLineOption captureOption(ASSIGNMENT_CAPTURE_OPTION, "capture received packets to a file", "capture-file");
+    parser.addOption(captureOption);
+
+    const QCommandLineOption replayOption(ASSIGNMENT_REPLAY_OPTION,
+                                          "replay a packet capture instead of connecting to a domain", "capture-file");
+    parser.addOption(replayOption);
+
+    const QCommandLineOption replaySpeedOption(ASSIGNMENT_REPLAY_SPEED_OPTION, "speed up the replay", "multiplier");
+    parser.addOption(replaySpeedOption);
+
+    const QCommandLineOption replayReportOption(ASSIGNMENT_REPLAY_REPORT_OPTION, "write per frame replay stats", "csv-file");
+    parser.addOption(replayReportOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -220,6 +235,12 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
 
     DependencyManager::registerInheritance<LimitedNodeList, NodeList>();
 
+    if ((numForks || minForks || maxForks) && (parser.isSet(captureOption) || parser.isSet(replayOption))) {
+        qCritical() << "--capture and --replay are for a single assignment-client, they can't be used with -n, --min or --max";
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
     if (numForks || minForks || maxForks) {
         AssignmentClientMonitor* monitor =  new AssignmentClientMonitor(numForks, minForks, maxForks,
                                                                         requestAssignmentType, assignmentPool,
@@ -233,5 +254,22 @@ AssignmentClientApp::AssignmentClientApp(int argc, char* argv[]) :
                                                         assignmentServerPort, monitorPort);
         client->setParent(this);
         connect(this, &QCoreApplication::aboutToQuit, client, &AssignmentClient::aboutToQuit);
+
+        auto nodeList = DependencyManager::get<NodeList>();
+
+        if (parser.isSet(captureOption)) {
+            nodeList->startPacketCapture(parser.value(captureOption));
+        }
+
+        if (parser.isSet(replayOption)) {
+            // feed the assignment-client a captured session, starting from the assignment the domain-server handed out
+            float speed = parser.isSet(replaySpeedOption) ? parser.value(replaySpeedOption).toFloat() : 1.0f;
+            auto replayer = new PacketReplayer(parser.value(replayOption), speed, PacketReplayer::DEFAULT_FRAME_MSECS,
+                                               parser.value(replayReportOption));
+            replayer->moveToThread(nodeList->thread());
+            connect(replayer, &PacketReplayer::finished, this, &QCoreApplication::quit);
+            connect(replayer, &PacketReplayer::finished, replayer, &PacketReplayer::deleteLater);
+            QMetaObject::invokeMethod(replayer, "start", Qt::QueuedConnection);
+        }
     }
 }
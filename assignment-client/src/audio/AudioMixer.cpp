@@ -87,7 +87,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
             PacketType::RadiusIgnoreRequest,
             PacketType::RequestsDomainListData,
             PacketType::PerAvatarGainSet },
-            this, "queueAudioPacket");
+            this, &AudioMixer::queueAudioPacket);
 
     // packets whose consequences are global should be processed on the main thread
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
@@ -100,7 +100,7 @@ AudioMixer::AudioMixer(ReceivedMessage& message) :
         PacketType::ReplicatedInjectAudio,
         PacketType::ReplicatedSilentAudioFrame
     },
-        this, "queueReplicatedAudioPacket"
+        this, &AudioMixer::queueReplicatedAudioPacket
     );
 
     connect(nodeList.data(), &NodeList::nodeKilled, this, &AudioMixer::handleNodeKilled);
@@ -195,7 +195,7 @@ void AudioMixer::handleNodeKilled(SharedNodePointer killedNode) {
     nodeList->eachNode([&killedNode](const SharedNodePointer& node) {
         auto clientData = dynamic_cast<AudioMixerClientData*>(node->getLinkedData());
         if (clientData) {
-            clientData->removeNode(killedNode->getUUID());
+            clientData->removeNode(*killedNode);
         }
     });
 }
@@ -313,6 +313,14 @@ void AudioMixer::sendStatsPacket() {
     mixStats["total_mixes"] = _stats.totalMixes;
     mixStats["avg_mixes_per_block"] = _stats.totalMixes / _numStatFrames;
 
+    int sharedMixLookups = _stats.sharedMixHits + _stats.sharedMixMisses;
+    mixStats["%_shared_mix_hits"] = (sharedMixLookups > 0) ?
+        QString::number((float(_stats.sharedMixHits) / sharedMixLookups) * 100.0f, 'f', 2) : QString("0.0");
+    mixStats["shared_mix_hits"] = _stats.sharedMixHits;
+    mixStats["%_shared_mix_skipped_renders"] = percentageForMixStats(_stats.sharedMixSkippedRenders);
+    mixStats["shared_mix_skipped_renders"] = _stats.sharedMixSkippedRenders;
+    mixStats["shared_encode_hits"] = _stats.sharedEncodeHits;
+
     statsObject["mix_stats"] = mixStats;
 
     _numStatFrames = _numSilentPackets = 0;
@@ -400,21 +408,23 @@ void AudioMixer::start() {
 
         auto frameTimer = _frameTiming.timer();
 
-        nodeList->nestedEach([&](NodeList::const_iterator cbegin, NodeList::const_iterator cend) {
+        {
+            auto nodeTable = nodeList->getNodeTable();
+
             // prepare frames; pop off any new audio from their streams
             {
                 auto prepareTimer = _prepareTiming.timer();
-                std::for_each(cbegin, cend, [&](const SharedNodePointer& node) {
-                    _stats.sumStreams += prepareFrame(node, frame);
+                std::for_each(nodeTable->cbegin(), nodeTable->cend(), [&](const SharedNodePointer& node) {
+                    _stats.sumStreams += prepareFrame(node, frame, nodeTable->getIndexCount());
                 });
             }
 
             // mix across slave threads
             {
                 auto mixTimer = _mixTiming.timer();
-                _slavePool.mix(cbegin, cend, frame, _throttlingRatio);
+                _slavePool.mix(nodeTable->cbegin(), nodeTable->cend(), frame, _throttlingRatio);
             }
-        });
+        }
 
         // gather stats
         _slavePool.each([&](AudioMixerSlave& slave) {
@@ -515,12 +525,15 @@ void AudioMixer::throttle(std::chrono::microseconds duration, int frame) {
     }
 }
 
-int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame) {
+int AudioMixer::prepareFrame(const SharedNodePointer& node, unsigned int frame, NodeIndex nodeIndexCount) {
     AudioMixerClientData* data = (AudioMixerClientData*)node->getLinkedData();
     if (data == nullptr) {
         return 0;
     }
 
+    // the slaves index the per-source state of every listener by node index, it can't grow during the mix
+    data->prepareNodeSources(nodeIndexCount);
+
     return data->checkBuffersBeforeFrameSend();
 }
 
@@ -625,6 +638,19 @@ void AudioMixer::parseSettingsObject(const QJsonObject& settingsObject) {
             qCDebug(audio) << "Codec preference order changed to" << _codecPreferenceOrder;
         }
 
+        const QString CODEC_BITRATE = "codec_bitrate";
+        if (audioEnvGroupObject[CODEC_BITRATE].isString()) {
+            bool ok = false;
+            int bitrateKbps = audioEnvGroupObject[CODEC_BITRATE].toString().toInt(&ok);
+            if (ok && bitrateKbps > 0) {
+                // applies to encoders created from here on, existing listeners keep theirs until they reconnect
+                for (auto& codec : _availableCodecs) {
+                    codec.second->setBitrate(bitrateKbps * 1000);
+                }
+                qCDebug(audio) << "Codec bitrate changed to" << bitrateKbps << "kbps";
+            }
+        }
+
         const QString ATTENATION_PER_DOULING_IN_DISTANCE = "attenuation_per_doubling_in_distance";
         if (audioEnvGroupObject[ATTENATION_PER_DOULING_IN_DISTANCE].isString()) {
             bool ok = false;
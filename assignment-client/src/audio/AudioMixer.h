@@ -78,7 +78,7 @@ private:
     void throttle(std::chrono::microseconds frameDuration, int frame);
     // pop a frame from any streams on the node
     // returns the number of available streams
-    int prepareFrame(const SharedNodePointer& node, unsigned int frame);
+    int prepareFrame(const SharedNodePointer& node, unsigned int frame, NodeIndex nodeIndexCount);
 
     AudioMixerClientData* getOrCreateClientData(Node* node);
 
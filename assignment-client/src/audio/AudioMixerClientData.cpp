@@ -197,7 +197,12 @@ void AudioMixerClientData::parsePerAvatarGainSet(ReceivedMessage& message, const
         qCDebug(audio) << "Setting MASTER avatar gain for " << uuid << " to " << gain;
     } else {
         // set the per-source avatar gain
-        hrtfForStream(avatarUuid, QUuid()).setGainAdjustment(gain);
+        auto avatarNode = DependencyManager::get<NodeList>()->nodeWithUUID(avatarUuid);
+        if (!avatarNode) {
+            qCDebug(audio) << "Ignoring avatar gain adjustment for unknown node" << avatarUuid;
+            return;
+        }
+        hrtfForStream(*avatarNode, QUuid()).setGainAdjustment(gain);
         qCDebug(audio) << "Setting avatar gain adjustment for hrtf[" << uuid << "][" << avatarUuid << "] to " << gain;
     }
 }
@@ -222,20 +227,73 @@ AvatarAudioStream* AudioMixerClientData::getAvatarAudioStream() {
     return NULL;
 }
 
+void AudioMixerClientData::prepareNodeSources(NodeIndex nodeIndexCount) {
+    if (_nodeSourcesIgnoreCache.size() < nodeIndexCount) {
+        _nodeSourcesIgnoreCache.resize(nodeIndexCount);
+    }
+    if (_nodeSources.size() < nodeIndexCount) {
+        _nodeSources.resize(nodeIndexCount);
+    }
+}
+
+AudioMixerClientData::NodeSource* AudioMixerClientData::findNodeSource(const QUuid& nodeID) {
+    auto it = std::find_if(_nodeSources.begin(), _nodeSources.end(), [&](const NodeSource& source) {
+        return source.nodeID == nodeID;
+    });
+    return it != _nodeSources.end() ? &(*it) : nullptr;
+}
+
+AudioHRTF& AudioMixerClientData::hrtfForStream(NodeSource& source, const QUuid& streamID) {
+    if (streamID.isNull()) {
+        if (!source.avatarHRTF) {
+            source.avatarHRTF.reset(new AudioHRTF());
+        }
+        return *source.avatarHRTF;
+    }
+
+    return source.injectorHRTFs[streamID];
+}
+
+AudioHRTF& AudioMixerClientData::hrtfForStream(const Node& node, const QUuid& streamID) {
+    auto nodeIndex = node.getNodeIndex();
+    if (nodeIndex >= _nodeSources.size()) {
+        _nodeSources.resize(nodeIndex + 1);
+    }
+
+    auto& source = _nodeSources[nodeIndex];
+    if (source.nodeID != node.getUUID()) {
+        // this index belonged to a node that's gone, start over
+        source = NodeSource();
+        source.nodeID = node.getUUID();
+    }
+
+    return hrtfForStream(source, streamID);
+}
+
 void AudioMixerClientData::removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID) {
-    auto it = _nodeSourcesHRTFMap.find(nodeID);
-    if (it != _nodeSourcesHRTFMap.end()) {
+    auto source = findNodeSource(nodeID);
+    if (source) {
         // erase the stream with the given ID from the given node
-        it->second.erase(streamID);
-
-        // is the map for this node now empty?
-        // if so we can remove it
-        if (it->second.size() == 0) {
-            _nodeSourcesHRTFMap.erase(it);
+        if (streamID.isNull()) {
+            source->avatarHRTF.reset();
+        } else {
+            source->injectorHRTFs.erase(streamID);
         }
     }
 }
 
+void AudioMixerClientData::removeNode(const Node& node) {
+    auto nodeIndex = node.getNodeIndex();
+
+    if (nodeIndex < _nodeSourcesIgnoreCache.size()) {
+        _nodeSourcesIgnoreCache[nodeIndex].reset();
+    }
+
+    if (nodeIndex < _nodeSources.size() && _nodeSources[nodeIndex].nodeID == node.getUUID()) {
+        _nodeSources[nodeIndex] = NodeSource();
+    }
+}
+
 void AudioMixerClientData::removeAgentAvatarAudioStream() {
     QWriteLocker writeLocker { &_streamsLock };
     auto it = _audioStreams.find(QUuid());
@@ -544,16 +602,30 @@ void AudioMixerClientData::sendSelectAudioFormat(SharedNodePointer node, const Q
     nodeList->sendPacket(std::move(replyPacket), *node);
 }
 
-void AudioMixerClientData::encodeFrameOfZeros(QByteArray& encodedZeros) {
-    static QByteArray zeros(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 0);
+int AudioMixerClientData::encode(const int16_t* samples, uint8_t* encoded, int encodedCapacity) {
+    int encodedSize;
+    if (_encoder) {
+        encodedSize = _encoder->encode(samples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, encoded, encodedCapacity);
+    } else if (encodedCapacity >= AudioConstants::NETWORK_FRAME_BYTES_STEREO) {
+        memcpy(encoded, samples, AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+        encodedSize = AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+    } else {
+        encodedSize = -1;
+    }
+
+    // once you have encoded, you need to flush eventually.
+    _shouldFlushEncoder = true;
+    return encodedSize;
+}
+
+int AudioMixerClientData::encodeFrameOfZeros(uint8_t* encoded, int encodedCapacity) {
+    static const int16_t zeros[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO] = { 0 };
+    int encodedSize = 0;
     if (_shouldFlushEncoder) {
-        if (_encoder) {
-            _encoder->encode(zeros, encodedZeros);
-        } else {
-            encodedZeros = zeros;
-        }
+        encodedSize = encode(zeros, encoded, encodedCapacity);
     }
     _shouldFlushEncoder = false;
+    return encodedSize;
 }
 
 void AudioMixerClientData::setupCodec(CodecPluginPointer codec, const QString& codecName) {
@@ -646,6 +718,10 @@ bool AudioMixerClientData::IgnoreNodeCache::isCached() {
     return _isCached;
 }
 
+void AudioMixerClientData::IgnoreNodeCache::reset() {
+    _isCached = false;
+}
+
 bool AudioMixerClientData::IgnoreNodeCache::shouldIgnore() {
     bool ignore = _shouldIgnore;
     _isCached = false;
@@ -656,9 +732,12 @@ bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const Shar
     // this is symmetric over self / node; if computed, it is cached in the other
 
     // check the cache to avoid computation
-    auto& cache = _nodeSourcesIgnoreMap[node->getUUID()];
-    if (cache.isCached()) {
-        return cache.shouldIgnore();
+    auto nodeIndex = node->getNodeIndex();
+    if (nodeIndex < _nodeSourcesIgnoreCache.size()) {
+        auto& cache = _nodeSourcesIgnoreCache[nodeIndex];
+        if (cache.isCached()) {
+            return cache.shouldIgnore();
+        }
     }
 
     AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
@@ -669,9 +748,9 @@ bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const Shar
     // compute shouldIgnore
     bool shouldIgnore = true;
     if ( // the nodes are not ignoring each other explicitly (or are but get data regardless)
-            (!self->isIgnoringNodeWithID(node->getUUID()) ||
+            (!self->isIgnoringNode(*node) ||
              (nodeData->getRequestsDomainListData() && node->getCanKick())) &&
-            (!node->isIgnoringNodeWithID(self->getUUID()) ||
+            (!node->isIgnoringNode(*self) ||
              (getRequestsDomainListData() && self->getCanKick())))  {
 
         // if either node is enabling an ignore radius, check their proximity
@@ -685,7 +764,10 @@ bool AudioMixerClientData::shouldIgnore(const SharedNodePointer self, const Shar
     }
 
     // cache in node
-    nodeData->_nodeSourcesIgnoreMap[self->getUUID()].cache(shouldIgnore);
+    auto selfIndex = self->getNodeIndex();
+    if (selfIndex < nodeData->_nodeSourcesIgnoreCache.size()) {
+        nodeData->_nodeSourcesIgnoreCache[selfIndex].cache(shouldIgnore);
+    }
 
     return shouldIgnore;
 }
@@ -12,13 +12,16 @@
 #ifndef hifi_AudioMixerClientData_h
 #define hifi_AudioMixerClientData_h
 
+#include <memory>
 #include <queue>
+#include <vector>
 
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
 #include <AudioHRTF.h>
 #include <AudioLimiter.h>
+#include <Node.h>
 #include <UUIDHasher.h>
 
 #include <plugins/CodecPlugin.h>
@@ -49,14 +52,17 @@ public:
     // the following methods should be called from the AudioMixer assignment thread ONLY
     // they are not thread-safe
 
+    // sizes the per-source state for every node index of the frame, so the mix can use it from any slave
+    void prepareNodeSources(NodeIndex nodeIndexCount);
+
     // returns a new or existing HRTF object for the given stream from the given node
-    AudioHRTF& hrtfForStream(const QUuid& nodeID, const QUuid& streamID = QUuid()) { return _nodeSourcesHRTFMap[nodeID][streamID]; }
+    AudioHRTF& hrtfForStream(const Node& node, const QUuid& streamID = QUuid());
 
     // removes an AudioHRTF object for a given stream
     void removeHRTFForStream(const QUuid& nodeID, const QUuid& streamID = QUuid());
 
     // remove all sources and data from this node
-    void removeNode(const QUuid& nodeID) { _nodeSourcesIgnoreMap.unsafe_erase(nodeID); _nodeSourcesHRTFMap.erase(nodeID); }
+    void removeNode(const Node& node);
 
     void removeAgentAvatarAudioStream();
 
@@ -90,17 +96,19 @@ public:
 
     void setupCodec(CodecPluginPointer codec, const QString& codecName);
     void cleanupCodec();
-    void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
-        if (_encoder) {
-            _encoder->encode(decodedBuffer, encodedBuffer);
-        } else {
-            encodedBuffer = decodedBuffer;
-        }
-        // once you have encoded, you need to flush eventually.
-        _shouldFlushEncoder = true;
+    // upper bound on the encoded size of a stereo network frame, for sizing the mixed audio packet
+    int getMaxEncodedFrameSize() const {
+        return _encoder ? _encoder->getMaxEncodedSize(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO)
+            : AudioConstants::NETWORK_FRAME_BYTES_STEREO;
     }
-    void encodeFrameOfZeros(QByteArray& encodedZeros);
+    // encodes a stereo network frame into the caller's buffer, returns the encoded size or -1 if it didn't fit
+    int encode(const int16_t* samples, uint8_t* encoded, int encodedCapacity);
+    int encodeFrameOfZeros(uint8_t* encoded, int encodedCapacity);
     bool shouldFlushEncoder() { return _shouldFlushEncoder; }
+    // a stateless encoder produces the same frame as any other for the same samples, so its frames can be shared
+    bool hasStatelessEncoder() const { return !_encoder || _encoder->isStateless(); }
+    // stands in for encode() when the frame was copied from another listener with the same mix
+    void didShareEncodedFrame() { _shouldFlushEncoder = true; }
 
     QString getCodecName() { return _selectedCodecName; }
 
@@ -158,19 +166,27 @@ private:
         void cache(bool shouldIgnore);
         bool isCached();
         bool shouldIgnore();
+        void reset();
 
     private:
         std::atomic<bool> _isCached { false };
         bool _shouldIgnore { false };
     };
-    struct IgnoreNodeCacheHasher { std::size_t operator()(const QUuid& key) const { return qHash(key); } };
 
-    using NodeSourcesIgnoreMap = tbb::concurrent_unordered_map<QUuid, IgnoreNodeCache, IgnoreNodeCacheHasher>;
-    NodeSourcesIgnoreMap _nodeSourcesIgnoreMap;
+    // indexed by the NodeIndex of the other node, sized before each mix so slaves can cache in each other's data
+    std::vector<IgnoreNodeCache> _nodeSourcesIgnoreCache;
 
     using HRTFMap = std::unordered_map<QUuid, AudioHRTF>;
-    using NodeSourcesHRTFMap = std::unordered_map<QUuid, HRTFMap>;
-    NodeSourcesHRTFMap _nodeSourcesHRTFMap;
+    struct NodeSource {
+        QUuid nodeID; // the node owning the index when this was created, indices are reused
+        std::unique_ptr<AudioHRTF> avatarHRTF;
+        HRTFMap injectorHRTFs;
+    };
+    NodeSource* findNodeSource(const QUuid& nodeID);
+    AudioHRTF& hrtfForStream(NodeSource& source, const QUuid& streamID);
+
+    // indexed by the NodeIndex of the source node
+    std::vector<NodeSource> _nodeSources;
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
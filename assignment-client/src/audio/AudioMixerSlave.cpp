@@ -15,6 +15,7 @@
 #include <glm/gtx/norm.hpp>
 #include <glm/gtx/vector_angle.hpp>
 
+#include <AudioLogging.h>
 #include <LogHandler.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
@@ -38,9 +39,12 @@
 
 using AudioStreamMap = AudioMixerClientData::AudioStreamMap;
 
+static const int HRTF_DATASET_INDEX = 1;
+
 // packet helpers
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec);
-void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer);
+void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, const int16_t* mixSamples,
+        AudioMixerSharedMixes* sharedMixes, AudioMixerSharedMixes::Fingerprint fingerprint, AudioMixerStats& stats);
 void sendSilentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
 void sendMutePacket(const SharedNodePointer& node, AudioMixerClientData&);
 void sendEnvironmentPacket(const SharedNodePointer& node, AudioMixerClientData& data);
@@ -60,11 +64,13 @@ void AudioMixerSlave::processPackets(const SharedNodePointer& node) {
     }
 }
 
-void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
+void AudioMixerSlave::configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+        AudioMixerSharedMixes* sharedMixes) {
     _begin = begin;
     _end = end;
     _frame = frame;
     _throttlingRatio = throttlingRatio;
+    _sharedMixes = sharedMixes;
 }
 
 void AudioMixerSlave::mix(const SharedNodePointer& node) {
@@ -98,17 +104,12 @@ void AudioMixerSlave::mix(const SharedNodePointer& node) {
 
         // send audio packet
         if (mixHasAudio || data->shouldFlushEncoder()) {
-            QByteArray encodedBuffer;
+            // without audio, it is time to flush (resets shouldFlush until the next encode)
             if (mixHasAudio) {
-                // encode the audio
-                QByteArray decodedBuffer(reinterpret_cast<char*>(_bufferSamples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                data->encode(decodedBuffer, encodedBuffer);
+                sendMixPacket(node, *data, _bufferSamples, _sharedMixes, _fingerprint, stats);
             } else {
-                // time to flush (resets shouldFlush until the next encode)
-                data->encodeFrameOfZeros(encodedBuffer);
+                sendMixPacket(node, *data, nullptr, nullptr, 0, stats);
             }
-
-            sendMixPacket(node, *data, encodedBuffer);
         } else {
             ++stats.sumListenersSilent;
             sendSilentPacket(node, *data);
@@ -129,19 +130,18 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
     AvatarAudioStream* listenerAudioStream = static_cast<AudioMixerClientData*>(listener->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerData = static_cast<AudioMixerClientData*>(listener->getLinkedData());
 
-    // zero out the mix for this listener
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    // gather the streams for this listener before mixing, so that the mix can be fingerprinted
+    _contributions.clear();
 
     bool isThrottling = _throttlingRatio > 0.0f;
     std::vector<std::pair<float, SharedNodePointer>> throttledNodes;
 
     typedef void (AudioMixerSlave::*MixFunctor)(
-            AudioMixerClientData&, const QUuid&, const AvatarAudioStream&, const PositionalAudioStream&);
+            AudioMixerClientData&, const Node&, const AvatarAudioStream&, const PositionalAudioStream&);
     auto forAllStreams = [&](const SharedNodePointer& node, AudioMixerClientData* nodeData, MixFunctor mixFunctor) {
-        auto nodeID = node->getUUID();
         for (auto& streamPair : nodeData->getAudioStreams()) {
             auto nodeStream = streamPair.second;
-            (this->*mixFunctor)(*listenerData, nodeID, *listenerAudioStream, *nodeStream);
+            (this->*mixFunctor)(*listenerData, *node, *listenerAudioStream, *nodeStream);
         }
     };
 
@@ -160,15 +160,13 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
             for (auto& streamPair : nodeData->getAudioStreams()) {
                 auto nodeStream = streamPair.second;
                 if (nodeStream->shouldLoopbackForNode()) {
-                    mixStream(*listenerData, node->getUUID(), *listenerAudioStream, *nodeStream);
+                    mixStream(*listenerData, *node, *listenerAudioStream, *nodeStream);
                 }
             }
         } else if (!listenerData->shouldIgnore(listener, node, _frame)) {
             if (!isThrottling) {
                 forAllStreams(node, nodeData, &AudioMixerSlave::mixStream);
             } else {
-                auto nodeID = node->getUUID();
-
                 // compute the node's max relative volume
                 float nodeVolume;
                 for (auto& streamPair : nodeData->getAudioStreams()) {
@@ -179,7 +177,7 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
                     float gain = approximateGain(*listenerAudioStream, *nodeStream, relativePosition);
 
                     // modify by hrtf gain adjustment
-                    auto& hrtf = listenerData->hrtfForStream(nodeID, nodeStream->getStreamIdentifier());
+                    auto& hrtf = listenerData->hrtfForStream(*node, nodeStream->getStreamIdentifier());
                     gain *= hrtf.getGainAdjustment();
 
                     auto streamVolume = nodeStream->getLastPopOutputTrailingLoudness() * gain;
@@ -220,6 +218,39 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
+    // reuse the mix of another listener who hears the same streams the same way this frame
+    bool isSharedMix = false;
+    if (_sharedMixes) {
+        AudioMixerSharedMixes::FingerprintBuilder fingerprint;
+        for (const MixContribution& contribution : _contributions) {
+            fingerprint.addStream(contribution.streamer, contribution.gain, contribution.azimuth,
+                contribution.distance, contribution.isEcho, contribution.throttle);
+        }
+        _fingerprint = fingerprint.getFingerprint();
+
+        isSharedMix = _sharedMixes->findMix(_fingerprint, _mixSamples);
+        if (isSharedMix) {
+            ++stats.sharedMixHits;
+        } else {
+            ++stats.sharedMixMisses;
+        }
+    }
+
+    if (isSharedMix) {
+        // this listener's HRTFs still follow their streams, so they carry on from where they are once its mix diverges
+        memset(_sharedMixScratch, 0, sizeof(_sharedMixScratch));
+        for (const MixContribution& contribution : _contributions) {
+            advanceStream(*listenerData, contribution);
+        }
+    } else {
+        // zero out the mix for this listener
+        memset(_mixSamples, 0, sizeof(_mixSamples));
+
+        for (const MixContribution& contribution : _contributions) {
+            addStream(*listenerData, contribution);
+        }
+    }
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     auto mixEnd = p_high_resolution_clock::now();
     auto mixTime = std::chrono::duration_cast<std::chrono::nanoseconds>(mixEnd - mixStart);
@@ -236,30 +267,29 @@ bool AudioMixerSlave::prepareMix(const SharedNodePointer& listener) {
         }
     }
 
-    // use the per listener AudioLimiter to render the mixed data
+    // use the per listener AudioLimiter to render the mixed data, shared or not
     listenerData->audioLimiter.render(_mixSamples, _bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
+    if (_sharedMixes && !isSharedMix) {
+        _sharedMixes->insertMix(_fingerprint, _mixSamples, _bufferSamples);
+    }
+
     return hasAudio;
 }
 
-void AudioMixerSlave::throttleStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
+void AudioMixerSlave::throttleStream(AudioMixerClientData& listenerNodeData, const Node& sourceNode,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
-    addStream(listenerNodeData, sourceNodeID, listeningNodeStream, streamToAdd, true);
+    collectStream(listenerNodeData, sourceNode, listeningNodeStream, streamToAdd, true);
 }
 
-void AudioMixerSlave::mixStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
+void AudioMixerSlave::mixStream(AudioMixerClientData& listenerNodeData, const Node& sourceNode,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd) {
-    addStream(listenerNodeData, sourceNodeID, listeningNodeStream, streamToAdd, false);
+    collectStream(listenerNodeData, sourceNode, listeningNodeStream, streamToAdd, false);
 }
 
-void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QUuid& sourceNodeID,
+void AudioMixerSlave::collectStream(AudioMixerClientData& listenerNodeData, const Node& sourceNode,
         const AvatarAudioStream& listeningNodeStream, const PositionalAudioStream& streamToAdd,
         bool throttle) {
-    ++stats.totalMixes;
-
-    // to reduce artifacts we call the HRTF functor for every source, even if throttled or silent
-    // this ensures the correct tail from last mixed block and the correct spatialization of next first block
-
     // check if this is a server echo of a source back to itself
     bool isEcho = (&streamToAdd == &listeningNodeStream);
 
@@ -268,7 +298,23 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     float distance = glm::max(glm::length(relativePosition), EPSILON);
     float gain = computeGain(listenerNodeData, listeningNodeStream, streamToAdd, relativePosition, isEcho);
     float azimuth = isEcho ? 0.0f : computeAzimuth(listeningNodeStream, listeningNodeStream, relativePosition);
-    const int HRTF_DATASET_INDEX = 1;
+
+    _contributions.push_back({ &sourceNode, &streamToAdd, gain, azimuth, distance, isEcho, throttle });
+}
+
+void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const MixContribution& contribution) {
+    ++stats.totalMixes;
+
+    // to reduce artifacts we call the HRTF functor for every source, even if throttled or silent
+    // this ensures the correct tail from last mixed block and the correct spatialization of next first block
+
+    const Node& sourceNode = *contribution.streamerNode;
+    const PositionalAudioStream& streamToAdd = *contribution.streamer;
+    bool isEcho = contribution.isEcho;
+    bool throttle = contribution.throttle;
+    float distance = contribution.distance;
+    float gain = contribution.gain;
+    float azimuth = contribution.azimuth;
 
     if (!streamToAdd.lastPopSucceeded()) {
         bool forceSilentBlock = true;
@@ -294,7 +340,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
             // (this is not done for stereo streams since they do not go through the HRTF)
             if (!streamToAdd.isStereo() && !isEcho) {
                 // get the existing listener-source HRTF object, or create a new one
-                auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+                auto& hrtf = listenerNodeData.hrtfForStream(sourceNode, streamToAdd.getStreamIdentifier());
 
                 static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
                 hrtf.renderSilent(silentMonoBlock, _mixSamples, HRTF_DATASET_INDEX, azimuth, distance, gain,
@@ -333,7 +379,7 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     }
 
     // get the existing listener-source HRTF object, or create a new one
-    auto& hrtf = listenerNodeData.hrtfForStream(sourceNodeID, streamToAdd.getStreamIdentifier());
+    auto& hrtf = listenerNodeData.hrtfForStream(sourceNode, streamToAdd.getStreamIdentifier());
 
     streamPopOutput.readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
@@ -361,6 +407,33 @@ void AudioMixerSlave::addStream(AudioMixerClientData& listenerNodeData, const QU
     ++stats.hrtfRenders;
 }
 
+void AudioMixerSlave::advanceStream(AudioMixerClientData& listenerNodeData, const MixContribution& contribution) {
+    // still a mix of the stream for this listener, only its rendering was saved
+    ++stats.totalMixes;
+    ++stats.sharedMixSkippedRenders;
+
+    const PositionalAudioStream& streamToAdd = *contribution.streamer;
+
+    // stereo and echo sources are not passed through HRTF, so have no state to keep
+    if (streamToAdd.isStereo() || contribution.isEcho) {
+        return;
+    }
+
+    auto& hrtf = listenerNodeData.hrtfForStream(*contribution.streamerNode, streamToAdd.getStreamIdentifier());
+
+    // renderSilent flushes the HRTF once and then only tracks the spatialization, the mix itself came from elsewhere
+    static int16_t silentMonoBlock[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL] = {};
+    int16_t* input = silentMonoBlock;
+    if (streamToAdd.lastPopSucceeded()) {
+        streamToAdd.getLastPopOutput().readSamples(_bufferSamples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        input = _bufferSamples;
+    }
+
+    float gain = contribution.throttle ? 0.0f : contribution.gain;
+    hrtf.renderSilent(input, _sharedMixScratch, HRTF_DATASET_INDEX, contribution.azimuth, contribution.distance, gain,
+                      AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+}
+
 std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 sequence, QString codec) {
     auto audioPacket = NLPacket::create(type, size);
     audioPacket->writePrimitive(sequence);
@@ -368,15 +441,40 @@ std::unique_ptr<NLPacket> createAudioPacket(PacketType type, int size, quint16 s
     return audioPacket;
 }
 
-void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, QByteArray& buffer) {
+void sendMixPacket(const SharedNodePointer& node, AudioMixerClientData& data, const int16_t* mixSamples,
+        AudioMixerSharedMixes* sharedMixes, AudioMixerSharedMixes::Fingerprint fingerprint, AudioMixerStats& stats) {
     const int MIX_PACKET_SIZE =
-        sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+        sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE + data.getMaxEncodedFrameSize();
     quint16 sequence = data.getOutgoingSequenceNumber();
     QString codec = data.getCodecName();
     auto mixPacket = createAudioPacket(PacketType::MixedAudio, MIX_PACKET_SIZE, sequence, codec);
 
-    // pack samples
-    mixPacket->write(buffer.constData(), buffer.size());
+    // encode samples straight into the packet payload, a null mix encodes a frame of zeros
+    auto encoded = reinterpret_cast<uint8_t*>(mixPacket->getPayload() + mixPacket->pos());
+    int encodedCapacity = (int)mixPacket->bytesAvailableForWrite();
+    int encodedSize = -1;
+
+    // a shared mix only has to be encoded once per stateless codec, stateful encoders each need every frame
+    bool shareEncodedFrame = sharedMixes && mixSamples && data.hasStatelessEncoder();
+    if (shareEncodedFrame) {
+        encodedSize = sharedMixes->findEncodedFrame(fingerprint, codec, mixSamples, encoded, encodedCapacity);
+    }
+
+    if (encodedSize >= 0) {
+        data.didShareEncodedFrame();
+        ++stats.sharedEncodeHits;
+    } else {
+        encodedSize = mixSamples ? data.encode(mixSamples, encoded, encodedCapacity)
+            : data.encodeFrameOfZeros(encoded, encodedCapacity);
+        if (shareEncodedFrame && encodedSize >= 0) {
+            sharedMixes->insertEncodedFrame(fingerprint, codec, mixSamples, encoded, encodedSize);
+        }
+    }
+    if (encodedSize < 0) {
+        qCWarning(audio) << "Mixed audio for" << node->getUUID() << "does not fit in its packet, dropping the frame";
+        return;
+    }
+    mixPacket->setPayloadSize(mixPacket->pos() + encodedSize);
 
     // send packet
     DependencyManager::get<NodeList>()->sendPacket(std::move(mixPacket), *node);
@@ -14,6 +14,7 @@
 
 #include <AABox.h>
 #include <AudioHRTF.h>
+#include <AudioMixerSharedMixes.h>
 #include <AudioRingBuffer.h>
 #include <ThreadedAssignment.h>
 #include <UUIDHasher.h>
@@ -34,7 +35,9 @@ public:
     void processPackets(const SharedNodePointer& node);
 
     // configure a round of mixing
-    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio);
+    // listeners whose mixes fingerprint the same share a single rendered mix through sharedMixes, if given
+    void configureMix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio,
+            AudioMixerSharedMixes* sharedMixes = nullptr);
 
     // mix and broadcast non-ignored streams to the node (requires configuration using configureMix, above)
     // returns true if a mixed packet was sent to the node
@@ -43,25 +46,46 @@ public:
     AudioMixerStats stats;
 
 private:
+    // a stream to be mixed for the current listener, with its spatialization
+    struct MixContribution {
+        const Node* streamerNode;
+        const PositionalAudioStream* streamer;
+        float gain;
+        float azimuth;
+        float distance;
+        bool isEcho;
+        bool throttle;
+    };
+
     // create mix, returns true if mix has audio
     bool prepareMix(const SharedNodePointer& listener);
-    void throttleStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
+    void throttleStream(AudioMixerClientData& listenerData, const Node& streamerNode,
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer);
-    void mixStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
+    void mixStream(AudioMixerClientData& listenerData, const Node& streamerNode,
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer);
-    void addStream(AudioMixerClientData& listenerData, const QUuid& streamerID,
+    void collectStream(AudioMixerClientData& listenerData, const Node& streamerNode,
             const AvatarAudioStream& listenerStream, const PositionalAudioStream& streamer,
             bool throttle);
+    void addStream(AudioMixerClientData& listenerData, const MixContribution& contribution);
+    // keeps the listener's HRTF for a stream in step when its mix is shared rather than rendered
+    void advanceStream(AudioMixerClientData& listenerData, const MixContribution& contribution);
 
     // mixing buffers
     float _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
     int16_t _bufferSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    // receives what advancing the HRTFs of a shared mix renders, which is not heard
+    float _sharedMixScratch[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    // the current listener's contributions and the fingerprint they hash to
+    std::vector<MixContribution> _contributions;
+    AudioMixerSharedMixes::Fingerprint _fingerprint { 0 };
 
     // frame state
     ConstIter _begin;
     ConstIter _end;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    AudioMixerSharedMixes* _sharedMixes { nullptr };
 };
 
 #endif // hifi_AudioMixerSlave_h
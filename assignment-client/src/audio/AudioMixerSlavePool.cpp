@@ -77,11 +77,14 @@ void AudioMixerSlavePool::processPackets(ConstIter begin, ConstIter end) {
 void AudioMixerSlavePool::mix(ConstIter begin, ConstIter end, unsigned int frame, float throttlingRatio) {
     _function = &AudioMixerSlave::mix;
     _configure = [=](AudioMixerSlave& slave) {
-        slave.configureMix(_begin, _end, _frame, _throttlingRatio);
+        slave.configureMix(_begin, _end, _frame, _throttlingRatio, &_sharedMixes);
     };
     _frame = frame;
     _throttlingRatio = throttlingRatio;
 
+    // mixes are only shared within a frame
+    _sharedMixes.reset();
+
     run(begin, end);
 }
 
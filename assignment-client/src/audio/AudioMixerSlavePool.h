@@ -98,6 +98,7 @@ private:
     Queue _queue;
     unsigned int _frame { 0 };
     float _throttlingRatio { 0.0f };
+    AudioMixerSharedMixes _sharedMixes;
     ConstIter _begin;
     ConstIter _end;
 };
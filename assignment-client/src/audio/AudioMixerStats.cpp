@@ -21,6 +21,10 @@ void AudioMixerStats::reset() {
     hrtfThrottleRenders = 0;
     manualStereoMixes = 0;
     manualEchoMixes = 0;
+    sharedMixHits = 0;
+    sharedMixSkippedRenders = 0;
+    sharedMixMisses = 0;
+    sharedEncodeHits = 0;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime = 0;
 #endif
@@ -36,6 +40,10 @@ void AudioMixerStats::accumulate(const AudioMixerStats& otherStats) {
     hrtfThrottleRenders += otherStats.hrtfThrottleRenders;
     manualStereoMixes += otherStats.manualStereoMixes;
     manualEchoMixes += otherStats.manualEchoMixes;
+    sharedMixHits += otherStats.sharedMixHits;
+    sharedMixSkippedRenders += otherStats.sharedMixSkippedRenders;
+    sharedMixMisses += otherStats.sharedMixMisses;
+    sharedEncodeHits += otherStats.sharedEncodeHits;
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     mixTime += otherStats.mixTime;
 #endif
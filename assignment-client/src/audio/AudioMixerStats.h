@@ -30,6 +30,11 @@ struct AudioMixerStats {
     int manualStereoMixes { 0 };
     int manualEchoMixes { 0 };
 
+    int sharedMixHits { 0 };
+    int sharedMixSkippedRenders { 0 };  // mixes of a stream that a shared mix saved rendering
+    int sharedMixMisses { 0 };
+    int sharedEncodeHits { 0 };
+
 #ifdef HIFI_AUDIO_MIXER_DEBUG
     uint64_t mixTime { 0 };
 #endif
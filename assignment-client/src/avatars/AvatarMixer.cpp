@@ -45,7 +45,7 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::AvatarData, this, "queueIncomingPacket");
+    packetReceiver.registerListener(PacketType::AvatarData, this, &AvatarMixer::queueIncomingPacket);
     packetReceiver.registerListener(PacketType::AdjustAvatarSorting, this, "handleAdjustAvatarSorting");
     packetReceiver.registerListener(PacketType::ViewFrustum, this, "handleViewFrustumPacket");
     packetReceiver.registerListener(PacketType::AvatarIdentity, this, "handleAvatarIdentityPacket");
@@ -59,7 +59,7 @@ AvatarMixer::AvatarMixer(ReceivedMessage& message) :
         PacketType::ReplicatedKillAvatar
     }, this, "handleReplicatedPacket");
 
-    packetReceiver.registerListener(PacketType::ReplicatedBulkAvatarData, this, "handleReplicatedBulkAvatarPacket");
+    packetReceiver.registerListener(PacketType::ReplicatedBulkAvatarData, this, &AvatarMixer::handleReplicatedBulkAvatarPacket);
 
     auto nodeList = DependencyManager::get<NodeList>();
     connect(nodeList.data(), &NodeList::packetVersionMismatch, this, &AvatarMixer::handlePacketVersionMismatch);
@@ -561,7 +561,7 @@ void AvatarMixer::handleRequestsDomainListDataPacket(QSharedPointer<ReceivedMess
                     // ...For those nodes, reset the lastBroadcastTime to 0
                     // so that the AvatarMixer will send Identity data to us
                     [&](const SharedNodePointer& node) {
-                    nodeData->setLastBroadcastTime(node->getUUID(), 0);
+                    nodeData->setLastBroadcastTime(*node, 0);
                 }
                 );
             }
@@ -626,14 +626,14 @@ void AvatarMixer::handleNodeIgnoreRequestPacket(QSharedPointer<ReceivedMessage>
             // Reset the lastBroadcastTime for the ignored avatar to 0
             // so the AvatarMixer knows it'll have to send identity data about the ignored avatar
             // to the ignorer if the ignorer unignores.
-            nodeData->setLastBroadcastTime(ignoredUUID, 0);
+            nodeData->resetLastBroadcastTime(ignoredUUID);
 
             // Reset the lastBroadcastTime for the ignorer (FROM THE PERSPECTIVE OF THE IGNORED) to 0
             // so the AvatarMixer knows it'll have to send identity data about the ignorer
             // to the ignored if the ignorer unignores.
             auto ignoredNode = nodeList->nodeWithUUID(ignoredUUID);
             AvatarMixerClientData* ignoredNodeData = reinterpret_cast<AvatarMixerClientData*>(ignoredNode->getLinkedData());
-            ignoredNodeData->setLastBroadcastTime(senderNode->getUUID(), 0);
+            ignoredNodeData->setLastBroadcastTime(*senderNode, 0);
         }
 
         if (addToIgnore) {
@@ -72,22 +72,57 @@ int AvatarMixerClientData::parseData(ReceivedMessage& message) {
     // compute the offset to the data payload
     return _avatar->parseDataFromBuffer(message.readWithoutCopy(message.getBytesLeftToRead()));
 }
-uint64_t AvatarMixerClientData::getLastBroadcastTime(const QUuid& nodeUUID) const {
-    // return the matching PacketSequenceNumber, or the default if we don't have it
-    auto nodeMatch = _lastBroadcastTimes.find(nodeUUID);
-    if (nodeMatch != _lastBroadcastTimes.end()) {
-        return nodeMatch->second;
+const AvatarMixerClientData::OtherAvatarState* AvatarMixerClientData::findOtherAvatarState(const Node& otherNode) const {
+    auto nodeIndex = otherNode.getNodeIndex();
+    if (nodeIndex < _otherAvatarStates.size() && _otherAvatarStates[nodeIndex].nodeUUID == otherNode.getUUID()) {
+        return &_otherAvatarStates[nodeIndex];
+    }
+    return nullptr;
+}
+
+AvatarMixerClientData::OtherAvatarState& AvatarMixerClientData::otherAvatarState(const Node& otherNode) {
+    auto nodeIndex = otherNode.getNodeIndex();
+    if (nodeIndex >= _otherAvatarStates.size()) {
+        _otherAvatarStates.resize(nodeIndex + 1);
     }
-    return 0;
+
+    auto& state = _otherAvatarStates[nodeIndex];
+    if (state.nodeUUID != otherNode.getUUID()) {
+        // this index belonged to a node that's gone, start over
+        state = OtherAvatarState();
+        state.nodeUUID = otherNode.getUUID();
+    }
+    return state;
+}
+
+uint64_t AvatarMixerClientData::getLastBroadcastTime(const Node& otherNode) const {
+    // return the matching broadcast time, or the default if we don't have it
+    auto state = findOtherAvatarState(otherNode);
+    return state ? state->lastBroadcastTime : 0;
 }
 
-uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const {
+uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const Node& otherNode) const {
     // return the matching PacketSequenceNumber, or the default if we don't have it
-    auto nodeMatch = _lastBroadcastSequenceNumbers.find(nodeUUID);
-    if (nodeMatch != _lastBroadcastSequenceNumbers.end()) {
-        return nodeMatch->second;
+    auto state = findOtherAvatarState(otherNode);
+    return state ? state->lastBroadcastSequenceNumber : 0;
+}
+
+void AvatarMixerClientData::resetLastBroadcastTime(const QUuid& nodeUUID) {
+    for (auto& state : _otherAvatarStates) {
+        if (state.nodeUUID == nodeUUID) {
+            state.lastBroadcastTime = 0;
+            return;
+        }
+    }
+}
+
+void AvatarMixerClientData::cleanupKilledNode(const QUuid& nodeUUID) {
+    for (auto& state : _otherAvatarStates) {
+        if (state.nodeUUID == nodeUUID) {
+            state = OtherAvatarState();
+            return;
+        }
     }
-    return 0;
 }
 
 void AvatarMixerClientData::ignoreOther(SharedNodePointer self, SharedNodePointer other) {
@@ -100,7 +135,7 @@ void AvatarMixerClientData::ignoreOther(SharedNodePointer self, SharedNodePointe
         } else {
             killPacket->writePrimitive(KillAvatarReason::YourAvatarEnteredTheirBubble);
         }
-        setLastBroadcastTime(other->getUUID(), 0);
+        resetLastBroadcastTime(other->getUUID());
         DependencyManager::get<NodeList>()->sendUnreliablePacket(*killPacket, *self);
     }
 }
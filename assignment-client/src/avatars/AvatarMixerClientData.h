@@ -17,11 +17,13 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
+#include <vector>
 
 #include <QtCore/QJsonObject>
 #include <QtCore/QUrl>
 
 #include <AvatarData.h>
+#include <Node.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
@@ -45,19 +47,18 @@ public:
     const AvatarData* getConstAvatarData() const { return _avatar.get(); }
     AvatarSharedPointer getAvatarSharedPointer() const { return _avatar; }
 
-    uint16_t getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
-    void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, uint16_t sequenceNumber)
-        { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+    // the state kept about other avatars is indexed by the other node's NodeIndex
+    uint16_t getLastBroadcastSequenceNumber(const Node& otherNode) const;
+    void setLastBroadcastSequenceNumber(const Node& otherNode, uint16_t sequenceNumber)
+        { otherAvatarState(otherNode).lastBroadcastSequenceNumber = sequenceNumber; }
 
-    uint64_t getLastBroadcastTime(const QUuid& nodeUUID) const;
-    void setLastBroadcastTime(const QUuid& nodeUUID, uint64_t broadcastTime) { _lastBroadcastTimes[nodeUUID] = broadcastTime; }
-    Q_INVOKABLE void removeLastBroadcastTime(const QUuid& nodeUUID) { _lastBroadcastTimes.erase(nodeUUID); }
+    uint64_t getLastBroadcastTime(const Node& otherNode) const;
+    void setLastBroadcastTime(const Node& otherNode, uint64_t broadcastTime)
+        { otherAvatarState(otherNode).lastBroadcastTime = broadcastTime; }
+    // for callers that only have the UUID, a no-op if we never sent the other avatar
+    void resetLastBroadcastTime(const QUuid& nodeUUID);
 
-    Q_INVOKABLE void cleanupKilledNode(const QUuid& nodeUUID) {
-        removeLastBroadcastSequenceNumber(nodeUUID);
-        removeLastBroadcastTime(nodeUUID);
-    }
+    Q_INVOKABLE void cleanupKilledNode(const QUuid& nodeUUID);
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
@@ -112,18 +113,17 @@ public:
 
     ViewFrustum getViewFrustom() const { return _currentViewFrustum; }
 
-    quint64 getLastOtherAvatarEncodeTime(QUuid otherAvatar) {
-        quint64 result = 0;
-        if (_lastOtherAvatarEncodeTime.find(otherAvatar) != _lastOtherAvatarEncodeTime.end()) {
-            result = _lastOtherAvatarEncodeTime[otherAvatar];
-        }
-        _lastOtherAvatarEncodeTime[otherAvatar] = usecTimestampNow();
+    quint64 getLastOtherAvatarEncodeTime(const Node& otherNode) {
+        auto& state = otherAvatarState(otherNode);
+        quint64 result = state.lastEncodeTime;
+        state.lastEncodeTime = usecTimestampNow();
         return result;
     }
 
-    QVector<JointData>& getLastOtherAvatarSentJoints(QUuid otherAvatar) {
-        _lastOtherAvatarSentJoints[otherAvatar].resize(_avatar->getJointCount());
-        return _lastOtherAvatarSentJoints[otherAvatar];
+    QVector<JointData>& getLastOtherAvatarSentJoints(const Node& otherNode) {
+        auto& lastSentJoints = otherAvatarState(otherNode).lastSentJoints;
+        lastSentJoints.resize(_avatar->getJointCount());
+        return lastSentJoints;
     }
 
     void queuePacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
@@ -138,13 +138,20 @@ private:
     AvatarSharedPointer _avatar { new AvatarData() };
 
     uint16_t _lastReceivedSequenceNumber { 0 };
-    std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
-    std::unordered_map<QUuid, uint64_t> _lastBroadcastTimes;
 
-    // this is a map of the last time we encoded an "other" avatar for
-    // sending to "this" node
-    std::unordered_map<QUuid, quint64> _lastOtherAvatarEncodeTime;
-    std::unordered_map<QUuid, QVector<JointData>> _lastOtherAvatarSentJoints;
+    // what we last sent "this" node about an "other" avatar
+    struct OtherAvatarState {
+        QUuid nodeUUID; // the node owning the index when this was created, indices are reused
+        uint16_t lastBroadcastSequenceNumber { 0 };
+        uint64_t lastBroadcastTime { 0 };
+        quint64 lastEncodeTime { 0 };
+        QVector<JointData> lastSentJoints;
+    };
+    const OtherAvatarState* findOtherAvatarState(const Node& otherNode) const;
+    OtherAvatarState& otherAvatarState(const Node& otherNode);
+
+    // indexed by the NodeIndex of the other node
+    std::vector<OtherAvatarState> _otherAvatarStates;
 
     uint64_t _identityChangeTimestamp;
     bool _avatarSessionDisplayNameMustChange{ true };
@@ -159,7 +159,10 @@ void EntityTreeSendThread::traverseTreeAndSendContents(SharedNodePointer node, O
         #else
         const uint64_t TIME_BUDGET = 200; // usec
         #endif
-        _traversal.traverse(TIME_BUDGET);
+        // adding or removing a child rebuilds its parent's child array, so the traversal holds the tree lock for its budget
+        _myServer->getOctree()->withReadLock([&]{
+            _traversal.traverse(TIME_BUDGET);
+        });
         OctreeServer::trackTreeTraverseTime((float)(usecTimestampNow() - startTime));
     }
 
@@ -22,6 +22,7 @@
 static QUuid DEFAULT_NODE_ID_REF;
 const quint64 TOO_LONG_SINCE_LAST_NACK = 1 * USECS_PER_SECOND;
 
+
 OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServer) :
     _myServer(myServer),
     _receivedPacketCount(0),
@@ -31,7 +32,13 @@ OctreeInboundPacketProcessor::OctreeInboundPacketProcessor(OctreeServer* myServe
     _totalElementsInPacket(0),
     _totalPackets(0),
     _lastNackTime(usecTimestampNow()),
-    _shuttingDown(false)
+    _shuttingDown(false),
+    _editBatch([this](const OctreeEditBatch::EditPacket& packet, quint64 lockWaitTime) {
+        // Make sure our Node and NodeList knows we've heard from this node.
+        QUuid nodeUUID = packet.sendingNode ? packet.sendingNode->getUUID() : DEFAULT_NODE_ID_REF;
+        trackInboundPacket(nodeUUID, packet.sequence, packet.transitTime, (int)packet.edits.size(),
+                           packet.decodeTime + packet.applyTime, lockWaitTime);
+    })
 {
 }
 
@@ -43,6 +50,8 @@ void OctreeInboundPacketProcessor::resetStats() {
     _totalPackets = 0;
     _lastNackTime = usecTimestampNow();
 
+    _editBatch.resetStats();
+
     QWriteLocker locker(&_senderStatsLock);
     _singleSenderStats.clear();
 }
@@ -70,11 +79,18 @@ void OctreeInboundPacketProcessor::midProcess() {
     // check if it's time to send a nack. If yes, do so
     quint64 now = usecTimestampNow();
     if (now - _lastNackTime >= TOO_LONG_SINCE_LAST_NACK) {
+        // the batched packets' sequence numbers must be tracked first, or we'd nack them
+        _editBatch.flush(_myServer->getOctree());
+
         _lastNackTime = now;
         sendNackPackets();
     }
 }
 
+void OctreeInboundPacketProcessor::postProcess() {
+    _editBatch.flush(_myServer->getOctree());
+}
+
 void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage> message, SharedNodePointer sendingNode) {
     if (_shuttingDown) {
         qDebug() << "OctreeInboundPacketProcessor::processPacket() while shutting down... ignoring incoming packet";
@@ -92,18 +108,9 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
     // Ask our tree subclass if it can handle the incoming packet...
     PacketType packetType = message->getType();
     
-    if (packetType == PacketType::ChallengeOwnership) {
-        _myServer->getOctree()->withWriteLock([&] {
-            _myServer->getOctree()->processChallengeOwnershipPacket(*message, sendingNode);
-        });
-    } else if (packetType == PacketType::ChallengeOwnershipRequest) {
-        _myServer->getOctree()->withWriteLock([&] {
-            _myServer->getOctree()->processChallengeOwnershipRequestPacket(*message, sendingNode);
-        });
-    } else if (packetType == PacketType::ChallengeOwnershipReply) {
-        _myServer->getOctree()->withWriteLock([&] {
-            _myServer->getOctree()->processChallengeOwnershipReplyPacket(*message, sendingNode);
-        });
+    if (packetType == PacketType::ChallengeOwnership || packetType == PacketType::ChallengeOwnershipRequest ||
+        packetType == PacketType::ChallengeOwnershipReply) {
+        _editBatch.processChallengeOwnershipPacket(_myServer->getOctree(), *message, sendingNode);
     } else if (_myServer->getOctree()->handlesEditPacketType(packetType)) {
         PerformanceWarning warn(debugProcessPacket, "processPacket KNOWN TYPE", debugProcessPacket);
         _receivedPacketCount++;
@@ -152,6 +159,12 @@ void OctreeInboundPacketProcessor::processPacket(QSharedPointer<ReceivedMessage>
             }
         }
         
+        if (_myServer->getOctree()->canDecodeEditPackets()) {
+            // this packet is decoded and applied with the rest of its batch
+            _editBatch.addEditPacket(_myServer->getOctree(), message, sendingNode, sequence, transitTime);
+            return;
+        }
+
         const unsigned char* editData = nullptr;
         
         while (message->getBytesLeftToRead() > 0) {
@@ -14,6 +14,7 @@
 #ifndef hifi_OctreeInboundPacketProcessor_h
 #define hifi_OctreeInboundPacketProcessor_h
 
+#include <OctreeEditBatch.h>
 #include <ReceivedPacketProcessor.h>
 
 #include "SequenceNumberStats.h"
@@ -70,6 +71,13 @@ public:
     quint64 getAverageLockWaitTimePerElement() const
                 { return _totalElementsInPacket == 0 ? 0 : _totalLockWaitTime / _totalElementsInPacket; }
 
+    // edits are decoded in parallel and applied in batches, under one write lock per batch
+    quint64 getTotalEditBatches() const { return _editBatch.getTotalBatches(); }
+    float getAverageEditsPerBatch() const { return _editBatch.getAverageEditsPerBatch(); }
+    quint64 getAverageDecodeTimePerBatch() const { return _editBatch.getAverageDecodeTimePerBatch(); }
+    quint64 getAverageLockWaitTimePerBatch() const { return _editBatch.getAverageLockWaitTimePerBatch(); }
+    quint64 getAverageApplyTimePerBatch() const { return _editBatch.getAverageApplyTimePerBatch(); }
+
     void resetStats();
 
     NodeToSenderStatsMap getSingleSenderStats() { QReadLocker locker(&_senderStatsLock); return _singleSenderStats; }
@@ -83,6 +91,7 @@ protected:
     virtual uint32_t getMaxWait() const override;
     virtual void preProcess() override;
     virtual void midProcess() override;
+    virtual void postProcess() override;
 
 private:
     int sendNackPackets();
@@ -105,5 +114,7 @@ private:
 
     std::atomic<uint64_t> _lastNackTime;
     bool _shuttingDown;
+
+    OctreeEditBatch _editBatch;
 };
 #endif // hifi_OctreeInboundPacketProcessor_h
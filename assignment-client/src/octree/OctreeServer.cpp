@@ -715,6 +715,17 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("            Average Filter Time: %1 usecs\r\n")
             .arg(locale.toString((uint)averageFilterTime).rightJustified(COLUMN_WIDTH, ' '));
 
+        statsString += QString("              Total Edit Batches: %1 batches\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getTotalEditBatches()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString().sprintf("             Average Edits/Batch: %f edits/batch\r\n",
+                                         (double)_octreeInboundPacketProcessor->getAverageEditsPerBatch());
+        statsString += QString("       Average Decode Time/Batch: %1 usecs\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getAverageDecodeTimePerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("    Average Wait Lock Time/Batch: %1 usecs\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getAverageLockWaitTimePerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+        statsString += QString("        Average Apply Time/Batch: %1 usecs\r\n")
+            .arg(locale.toString((uint)_octreeInboundPacketProcessor->getAverageApplyTimePerBatch()).rightJustified(COLUMN_WIDTH, ' '));
+
 
         int senderNumber = 0;
         NodeToSenderStatsMap allSenderStats = _octreeInboundPacketProcessor->getSingleSenderStats();
@@ -1615,12 +1626,17 @@ void OctreeServer::sendStatsPacket() {
         dataArray2["1. packetQueue"] = (double)_octreeInboundPacketProcessor->packetsToProcessCount();
         dataArray2["2. totalPackets"] = (double)_octreeInboundPacketProcessor->getTotalPacketsProcessed();
         dataArray2["3. totalElements"] = (double)_octreeInboundPacketProcessor->getTotalElementsProcessed();
+        dataArray2["4. totalEditBatches"] = (double)_octreeInboundPacketProcessor->getTotalEditBatches();
+        dataArray2["5. avgEditsPerBatch"] = (double)_octreeInboundPacketProcessor->getAverageEditsPerBatch();
 
         timingArray2["1. avgTransitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageTransitTimePerPacket();
         timingArray2["2. avgProcessTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerPacket();
         timingArray2["3. avgLockWaitTimePerPacket"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerPacket();
         timingArray2["4. avgProcessTimePerElement"] = (double)_octreeInboundPacketProcessor->getAverageProcessTimePerElement();
         timingArray2["5. avgLockWaitTimePerElement"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerElement();
+        timingArray2["6. avgDecodeTimePerBatch"] = (double)_octreeInboundPacketProcessor->getAverageDecodeTimePerBatch();
+        timingArray2["7. avgLockWaitTimePerBatch"] = (double)_octreeInboundPacketProcessor->getAverageLockWaitTimePerBatch();
+        timingArray2["8. avgApplyTimePerBatch"] = (double)_octreeInboundPacketProcessor->getAverageApplyTimePerBatch();
     }
 
     QJsonObject statsObject3;
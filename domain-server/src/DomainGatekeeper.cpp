@@ -11,22 +11,22 @@
 
 #include "DomainGatekeeper.h"
 
-#include <openssl/err.h>
-#include <openssl/rsa.h>
-#include <openssl/x509.h>
-
 #include <AccountManager.h>
 #include <Assignment.h>
+#include <SharedUtil.h>
 
 #include "DomainServer.h"
 #include "DomainServerNodeData.h"
 
 using SharedAssignmentPointer = QSharedPointer<Assignment>;
 
+// connect requests are re-sent by the clients, so past this many waiting verifications new ones are dropped
+const int MAX_PENDING_SIGNATURE_VERIFICATIONS = 1024;
+
 DomainGatekeeper::DomainGatekeeper(DomainServer* server) :
     _server(server)
 {
-
+    connect(&_signatureVerifier, &SignatureVerifier::verified, this, &DomainGatekeeper::userSignatureVerified);
 }
 
 void DomainGatekeeper::addPendingAssignedNode(const QUuid& nodeUUID, const QUuid& assignmentUUID,
@@ -103,12 +103,21 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
         }
 
         node = processAgentConnectRequest(nodeConnection, username, usernameSignature);
+
+        if (!node && _pendingSignatureVerifications.contains(username.toLower())) {
+            // the request is completed once the username signature has been verified
+            return;
+        }
     }
 
+    completeConnectRequest(nodeConnection, node);
+}
+
+void DomainGatekeeper::completeConnectRequest(const NodeConnectionData& nodeConnection, const SharedNodePointer& node) {
     if (node) {
         // set the sending sock addr and node interest set on this node
         DomainServerNodeData* nodeData = static_cast<DomainServerNodeData*>(node->getLinkedData());
-        nodeData->setSendingSockAddr(message->getSenderSockAddr());
+        nodeData->setSendingSockAddr(nodeConnection.senderSockAddr);
 
         // guard against patched agents asking to hear about other agents
         auto safeInterestSet = nodeConnection.interestList.toSet();
@@ -120,14 +129,14 @@ void DomainGatekeeper::processConnectRequestPacket(QSharedPointer<ReceivedMessag
         nodeData->setPlaceName(nodeConnection.placeName);
 
         qDebug() << "Allowed connection from node" << uuidStringWithoutCurlyBraces(node->getUUID())
-            << "on" << message->getSenderSockAddr() << "with MAC" << nodeConnection.hardwareAddress
+            << "on" << nodeConnection.senderSockAddr << "with MAC" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
 
         // signal that we just connected a node so the DomainServer can get it a list
         // and broadcast its presence right away
         emit connectedNode(node);
     } else {
-        qDebug() << "Refusing connection from node at" << message->getSenderSockAddr()
+        qDebug() << "Refusing connection from node at" << nodeConnection.senderSockAddr
             << "with hardware address" << nodeConnection.hardwareAddress
             << "and machine fingerprint" << nodeConnection.machineFingerprint;
     }
@@ -379,19 +388,6 @@ const QString MAXIMUM_USER_CAPACITY_REDIRECT_LOCATION = "security.maximum_user_c
 SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnectionData& nodeConnection,
                                                                const QString& username,
                                                                const QByteArray& usernameSignature) {
-
-    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
-
-    // start with empty permissions
-    NodePermissions userPerms(NodePermissionsKey(username, 0));
-    userPerms.setAll(false);
-
-    // check if this user is on our local machine - if this is true set permissions to those for a "localhost" connection
-    QHostAddress senderHostAddress = nodeConnection.senderSockAddr.getAddress();
-    bool isLocalUser =
-        (senderHostAddress == limitedNodeList->getLocalSockAddr().getAddress() || senderHostAddress == QHostAddress::LocalHost);
-
-    QString verifiedUsername; // if this remains empty, consider this an anonymous connection attempt
     if (!username.isEmpty()) {
         if (usernameSignature.isEmpty()) {
             // user is attempting to prove their identity to us, but we don't have enough information
@@ -402,23 +398,30 @@ SharedNodePointer DomainGatekeeper::processAgentConnectRequest(const NodeConnect
 #ifdef WANT_DEBUG
             qDebug() << "stalling login because we have no username-signature:" << username;
 #endif
-            return SharedNodePointer();
-        } else if (verifyUserSignature(username, usernameSignature, nodeConnection.senderSockAddr)) {
-            // they sent us a username and the signature verifies it
-            getGroupMemberships(username);
-            verifiedUsername = username;
-        } else {
+        } else if (!queueUserSignatureVerification(nodeConnection, username, usernameSignature)) {
             // they sent us a username, but it didn't check out
-            requestUserPublicKey(username);
 #ifdef WANT_DEBUG
             qDebug() << "stalling login because signature verification failed:" << username;
 #endif
-            return SharedNodePointer();
         }
+        return SharedNodePointer();
     }
 
-    userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
-                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
+    // anonymous connection attempt
+    return admitAgent(nodeConnection, username, QString());
+}
+
+SharedNodePointer DomainGatekeeper::admitAgent(const NodeConnectionData& nodeConnection, const QString& username,
+                                               const QString& verifiedUsername) {
+    auto limitedNodeList = DependencyManager::get<LimitedNodeList>();
+
+    // check if this user is on our local machine - if this is true set permissions to those for a "localhost" connection
+    QHostAddress senderHostAddress = nodeConnection.senderSockAddr.getAddress();
+    bool isLocalUser =
+        (senderHostAddress == limitedNodeList->getLocalSockAddr().getAddress() || senderHostAddress == QHostAddress::LocalHost);
+
+    NodePermissions userPerms = setPermissionsForUser(isLocalUser, verifiedUsername, nodeConnection.senderSockAddr.getAddress(),
+                                                      nodeConnection.hardwareAddress, nodeConnection.machineFingerprint);
 
     if (!userPerms.can(NodePermissions::Permission::canConnectToDomain)) {
         sendConnectionDeniedPacket("You lack the required permissions to connect to this domain.",
@@ -528,11 +531,17 @@ SharedNodePointer DomainGatekeeper::addVerifiedNodeFromConnectRequest(const Node
     return newNode;
 }
 
-bool DomainGatekeeper::verifyUserSignature(const QString& username,
-                                           const QByteArray& usernameSignature,
-                                           const HifiSockAddr& senderSockAddr) {
+bool DomainGatekeeper::queueUserSignatureVerification(const NodeConnectionData& nodeConnection,
+                                                      const QString& username,
+                                                      const QByteArray& usernameSignature) {
     // it's possible this user can be allowed to connect, but we need to check their username signature
     auto lowerUsername = username.toLower();
+
+    if (_pendingSignatureVerifications.contains(lowerUsername)) {
+        // this is a re-sent connect request, the first one is still being verified
+        return true;
+    }
+
     KeyFlagPair publicKeyPair = _userPublicKeys.value(lowerUsername);
 
     QByteArray publicKeyArray = publicKeyPair.first;
@@ -540,69 +549,99 @@ bool DomainGatekeeper::verifyUserSignature(const QString& username,
 
     const QUuid& connectionToken = _connectionTokenHash.value(lowerUsername);
 
-    if (!publicKeyArray.isEmpty() && !connectionToken.isNull()) {
-        // if we do have a public key for the user, check for a signature match
-
-        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyArray.constData());
-
-        // first load up the public key into an RSA struct
-        RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKeyArray.size());
+    if (publicKeyArray.isEmpty() || connectionToken.isNull()) {
+        qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
+        requestUserPublicKey(username); // no joy.  maybe next time?
+        return false;
+    }
 
-        QByteArray lowercaseUsernameUTF8 = lowerUsername.toUtf8();
-        QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(connectionToken.toRfc4122()),
-                                                                QCryptographicHash::Sha256);
+    if (_pendingSignatureVerifications.size() >= MAX_PENDING_SIGNATURE_VERIFICATIONS) {
+        qDebug() << "Too many pending username signature verifications - delaying connection for" << username;
+        ++_signatureVerificationStats.dropped;
+        return true;
+    }
 
-        if (rsaPublicKey) {
-            int decryptResult = RSA_verify(NID_sha256,
-                                           reinterpret_cast<const unsigned char*>(usernameWithToken.constData()),
-                                           usernameWithToken.size(),
-                                           reinterpret_cast<const unsigned char*>(usernameSignature.constData()),
-                                           usernameSignature.size(),
-                                           rsaPublicKey);
+    QByteArray lowercaseUsernameUTF8 = lowerUsername.toUtf8();
+    QByteArray usernameWithToken = QCryptographicHash::hash(lowercaseUsernameUTF8.append(connectionToken.toRfc4122()),
+                                                            QCryptographicHash::Sha256);
+
+    // keys are only parsed again when they change
+    if (!_signatureVerifier.verify(lowerUsername, publicKeyArray, usernameWithToken, usernameSignature)) {
+        // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+        qDebug() << "Couldn't convert data to RSA key for" << username << "- denying connection.";
+        sendConnectionDeniedPacket("Couldn't convert data to RSA key.", nodeConnection.senderSockAddr,
+            DomainHandler::ConnectionRefusedReason::LoginError);
+        requestUserPublicKey(username);
+        return false;
+    }
 
-            if (decryptResult == 1) {
-                qDebug() << "Username signature matches for" << username;
+    PendingSignatureVerification pending;
+    pending.nodeConnection = nodeConnection;
+    pending.username = username;
+    pending.isOptimisticKey = isOptimisticKey;
+    pending.queuedTimestamp = usecTimestampNow();
+    _pendingSignatureVerifications.insert(lowerUsername, pending);
+    _signatureVerificationStats.maxPending = std::max(_signatureVerificationStats.maxPending,
+                                                      _pendingSignatureVerifications.size());
 
-                // free up the public key and remove connection token before we return
-                RSA_free(rsaPublicKey);
-                _connectionTokenHash.remove(username);
+    return true;
+}
 
-                return true;
+void DomainGatekeeper::userSignatureVerified(QString lowerUsername, bool verified, quint64 verifyTime) {
+    auto it = _pendingSignatureVerifications.find(lowerUsername);
+    if (it == _pendingSignatureVerifications.end()) {
+        return;
+    }
+    PendingSignatureVerification pending = it.value();
+    _pendingSignatureVerifications.erase(it);
 
-            } else {
-                // we only send back a LoginError if this wasn't an "optimistic" key
-                // (a key that we hoped would work but is probably stale)
+    _signatureVerificationStats.verifyTime.updateAverage(verifyTime);
+    _signatureVerificationStats.totalTime.updateAverage(usecTimestampNow() - pending.queuedTimestamp);
 
-                if (!senderSockAddr.isNull() && !isOptimisticKey) {
-                    qDebug() << "Error decrypting username signature for" << username << "- denying connection.";
-                    sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
-                        DomainHandler::ConnectionRefusedReason::LoginError);
-                } else if (!senderSockAddr.isNull()) {
-                    qDebug() << "Error decrypting username signature for" << username << "with optimisitic key -"
-                        << "re-requesting public key and delaying connection";
-                }
+    const QString& username = pending.username;
+    const HifiSockAddr& senderSockAddr = pending.nodeConnection.senderSockAddr;
+    SharedNodePointer node;
 
-                // free up the public key, we don't need it anymore
-                RSA_free(rsaPublicKey);
-            }
+    if (verified) {
+        qDebug() << "Username signature matches for" << username;
+        ++_signatureVerificationStats.verified;
 
-        } else {
+        // remove the connection token, it's been used
+        _connectionTokenHash.remove(lowerUsername);
 
-            // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-            if (!senderSockAddr.isNull()) {
-                qDebug() << "Couldn't convert data to RSA key for" << username << "- denying connection.";
-                sendConnectionDeniedPacket("Couldn't convert data to RSA key.", senderSockAddr,
-                    DomainHandler::ConnectionRefusedReason::LoginError);
-            }
-        }
+        getGroupMemberships(username);
+        node = admitAgent(pending.nodeConnection, username, username);
     } else {
-        if (!senderSockAddr.isNull()) {
-            qDebug() << "Insufficient data to decrypt username signature - delaying connection.";
+        ++_signatureVerificationStats.failed;
+
+        // we only send back a LoginError if this wasn't an "optimistic" key
+        // (a key that we hoped would work but is probably stale)
+        if (!pending.isOptimisticKey) {
+            qDebug() << "Error decrypting username signature for" << username << "- denying connection.";
+            sendConnectionDeniedPacket("Error decrypting username signature.", senderSockAddr,
+                DomainHandler::ConnectionRefusedReason::LoginError);
+        } else {
+            qDebug() << "Error decrypting username signature for" << username << "with optimisitic key -"
+                << "re-requesting public key and delaying connection";
         }
+
+        requestUserPublicKey(username); // no joy.  maybe next time?
     }
 
-    requestUserPublicKey(username); // no joy.  maybe next time?
-    return false;
+    completeConnectRequest(pending.nodeConnection, node);
+}
+
+QJsonObject DomainGatekeeper::getSignatureVerificationStats() const {
+    QJsonObject stats;
+    stats["pending"] = _pendingSignatureVerifications.size();
+    stats["max_pending"] = _signatureVerificationStats.maxPending;
+    stats["verified"] = (double)_signatureVerificationStats.verified;
+    stats["failed"] = (double)_signatureVerificationStats.failed;
+    stats["dropped"] = (double)_signatureVerificationStats.dropped;
+    stats["cached_keys"] = _signatureVerifier.getNumCachedKeys();
+    stats["avg_verify_usecs"] = _signatureVerificationStats.verifyTime.getAverage();
+    stats["avg_total_usecs"] = _signatureVerificationStats.totalTime.getAverage();
+    return stats;
 }
 
 bool DomainGatekeeper::isWithinMaxCapacity() {
@@ -679,6 +718,9 @@ void DomainGatekeeper::publicKeyJSONCallback(QNetworkReply& requestReply) {
 
         qDebug().nospace() << "Extracted " << (isOptimisticKey ? "optimistic " : " ") << "public key for " << username.toLower();
 
+        // the parsed key is now stale
+        _signatureVerifier.forgetKey(username.toLower());
+
         _userPublicKeys[username.toLower()] =
             {
                 QByteArray::fromBase64(jsonObject[JSON_DATA_KEY].toObject()[JSON_PUBLIC_KEY_KEY].toString().toUtf8()),
@@ -16,6 +16,7 @@
 
 #include <unordered_map>
 
+#include <QtCore/QJsonObject>
 #include <QtCore/QObject>
 #include <QtNetwork/QNetworkReply>
 
@@ -23,6 +24,8 @@
 
 #include <NLPacket.h>
 #include <Node.h>
+#include <SignatureVerifier.h>
+#include <SimpleMovingAverage.h>
 #include <UUIDHasher.h>
 
 #include "NodeConnectionData.h"
@@ -42,6 +45,9 @@ public:
     void removeICEPeer(const QUuid& peerUUID) { _icePeers.remove(peerUUID); }
 
     static void sendProtocolMismatchConnectionDenial(const HifiSockAddr& senderSockAddr);
+
+    // queue depth and latency of the username signature verifications
+    QJsonObject getSignatureVerificationStats() const;
 public slots:
     void processConnectRequestPacket(QSharedPointer<ReceivedMessage> message);
     void processICEPingPacket(QSharedPointer<ReceivedMessage> message);
@@ -68,17 +74,23 @@ public slots:
 
 private slots:
     void handlePeerPingTimeout();
+    void userSignatureVerified(QString lowerUsername, bool verified, quint64 verifyTime);
 private:
     SharedNodePointer processAssignmentConnectRequest(const NodeConnectionData& nodeConnection,
                                                       const PendingAssignedNodeData& pendingAssignment);
     SharedNodePointer processAgentConnectRequest(const NodeConnectionData& nodeConnection,
                                                  const QString& username,
                                                  const QByteArray& usernameSignature);
+    SharedNodePointer admitAgent(const NodeConnectionData& nodeConnection, const QString& username,
+                                 const QString& verifiedUsername);
     SharedNodePointer addVerifiedNodeFromConnectRequest(const NodeConnectionData& nodeConnection,
                                                         QUuid nodeID = QUuid());
+    void completeConnectRequest(const NodeConnectionData& nodeConnection, const SharedNodePointer& node);
     
-    bool verifyUserSignature(const QString& username, const QByteArray& usernameSignature,
-                             const HifiSockAddr& senderSockAddr);
+    // RSA verification is done on a worker thread, the connect request is completed by userSignatureVerified().
+    // Returns false if the signature can't be verified with the data we have.
+    bool queueUserSignatureVerification(const NodeConnectionData& nodeConnection, const QString& username,
+                                        const QByteArray& usernameSignature);
     bool isWithinMaxCapacity();
     
     bool shouldAllowConnectionFromNode(const QString& username, const QByteArray& usernameSignature,
@@ -120,6 +132,26 @@ private:
     void getGroupMemberships(const QString& username);
     // void getIsGroupMember(const QString& username, const QUuid groupID);
     void getDomainOwnerFriendsList();
+
+    struct PendingSignatureVerification {
+        NodeConnectionData nodeConnection;
+        QString username;
+        bool isOptimisticKey { false };
+        quint64 queuedTimestamp { 0 };
+    };
+    QHash<QString, PendingSignatureVerification> _pendingSignatureVerifications; // by lowercase username
+
+    struct SignatureVerificationStats {
+        int maxPending { 0 };
+        quint64 verified { 0 };
+        quint64 failed { 0 };
+        quint64 dropped { 0 };
+        SimpleMovingAverage verifyTime;
+        SimpleMovingAverage totalTime; // including the time spent in the queue
+    };
+    SignatureVerificationStats _signatureVerificationStats;
+
+    SignatureVerifier _signatureVerifier;
 };
 
 
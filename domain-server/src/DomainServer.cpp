@@ -1791,8 +1791,6 @@ QString DomainServer::pathForRedirect(QString path) const {
 
 const QString URI_OAUTH = "/oauth";
 bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
-    const QString JSON_MIME_TYPE = "application/json";
-
     const QString URI_ASSIGNMENT = "/assignment";
     const QString URI_NODES = "/nodes";
     const QString URI_SETTINGS = "/settings";
@@ -1944,7 +1942,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
             // print out the created JSON
             QJsonDocument assignmentDocument(assignmentJSON);
-            connection->respond(HTTPConnection::StatusCode200, assignmentDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+            connection->respondWithJSON(HTTPConnection::StatusCode200, assignmentDocument);
 
             // we've processed this request
             return true;
@@ -1963,7 +1961,14 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 
             // print out the created JSON
             QJsonDocument transactionsDocument(rootObject);
-            connection->respond(HTTPConnection::StatusCode200, transactionsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+            connection->respondWithJSON(HTTPConnection::StatusCode200, transactionsDocument);
+
+            return true;
+        } else if (url.path() == "/gatekeeper.json") {
+            QJsonObject rootJSON;
+            rootJSON["signature_verification"] = _gatekeeper.getSignatureVerificationStats();
+
+            connection->respondWithJSON(HTTPConnection::StatusCode200, QJsonDocument(rootJSON));
 
             return true;
         } else if (url.path() == QString("%1.json").arg(URI_NODES)) {
@@ -1983,7 +1988,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
             QJsonDocument nodesDocument(rootJSON);
 
             // send the response
-            connection->respond(HTTPConnection::StatusCode200, nodesDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+            connection->respondWithJSON(HTTPConnection::StatusCode200, nodesDocument);
 
             return true;
         } else if (url.path() == URI_RESTART) {
@@ -2018,7 +2023,7 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                     QJsonDocument statsDocument(statsObject);
 
                     // send the response
-                    connection->respond(HTTPConnection::StatusCode200, statsDocument.toJson(), qPrintable(JSON_MIME_TYPE));
+                    connection->respondWithJSON(HTTPConnection::StatusCode200, statsDocument);
 
                     // tell the caller we processed the request
                     return true;
@@ -2223,6 +2228,11 @@ bool DomainServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
 static const QString HIFI_SESSION_COOKIE_KEY = "DS_WEB_SESSION_UUID";
 static const QString STATE_QUERY_KEY = "state";
 
+bool DomainServer::isThreadSafeHTTPRequest(HTTPConnection* connection, const QUrl& url) {
+    // the domain ID doesn't need authentication or anything from the main thread
+    return connection->requestOperation() == QNetworkAccessManager::GetOperation && url.path() == "/id";
+}
+
 bool DomainServer::handleHTTPSRequest(HTTPSConnection* connection, const QUrl &url, bool skipSubHandler) {
     if (url.path() == URI_OAUTH) {
 
@@ -62,6 +62,7 @@ public:
 
     bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
     bool handleHTTPSRequest(HTTPSConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
+    bool isThreadSafeHTTPRequest(HTTPConnection* connection, const QUrl& url) override;
 
 public slots:
     /// Called by NodeList to inform us a node has been added
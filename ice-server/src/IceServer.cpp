@@ -13,6 +13,11 @@
 
 #include <openssl/x509.h>
 
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QTimer>
 #include <QtNetwork/QNetworkReply>
@@ -21,18 +26,78 @@
 #include <LimitedNodeList.h>
 #include <NetworkAccessManager.h>
 #include <NetworkingConstants.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 #include <SharedUtil.h>
 
-const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
-const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
+const int STATS_INTERVAL_MSECS = 60 * 1000;
+
+const QString LOCAL_PUBLIC_KEY_EXTENSION = ".key";
+
+// accepts the SubjectPublicKeyInfo DER the metaverse API serves, and the PKCS#1 DER RSAKeypairGenerator produces
+static RSAUniquePtr rsaPublicKeyFromDER(const QByteArray& publicKeyDER) {
+    const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyDER.constData());
+    RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKeyDER.size());
+    if (!rsaPublicKey) {
+        publicKeyData = reinterpret_cast<const unsigned char*>(publicKeyDER.constData());
+        rsaPublicKey = d2i_RSAPublicKey(NULL, &publicKeyData, publicKeyDER.size());
+    }
+
+    if (rsaPublicKey) {
+        return { rsaPublicKey, RSA_free };
+    }
+    return RSAUniquePtr();
+}
 
 IceServer::IceServer(int argc, char* argv[]) :
     QCoreApplication(argc, argv),
     _id(QUuid::createUuid()),
-    _serverSocket(0, false),
-    _activePeers()
+    _serverSocket(0, false)
 {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity ICE server");
+    parser.addHelpOption();
+
+    const QCommandLineOption threadsOption("t", "number of worker threads (defaults to one less than the core count)",
+                                           "threads");
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption publicKeysOption("k", "public keys to verify heartbeats with before asking the metaverse API: "
+                                              "a directory of <domain ID>.key files, or one key file for every domain",
+                                              "path");
+    parser.addOption(publicKeysOption);
+
+    parser.process(*this);
+
+    if (parser.isSet(publicKeysOption)) {
+        QFileInfo publicKeysInfo(parser.value(publicKeysOption));
+        if (publicKeysInfo.isDir()) {
+            _localPublicKeyDirectory = publicKeysInfo.absoluteFilePath();
+            qDebug() << "Reading domain public keys from" << _localPublicKeyDirectory;
+        } else {
+            QFile publicKeyFile(publicKeysInfo.absoluteFilePath());
+            QByteArray publicKey = publicKeyFile.open(QIODevice::ReadOnly) ? publicKeyFile.readAll() : QByteArray();
+            if (rsaPublicKeyFromDER(publicKey)) {
+                _localPublicKey = publicKey;
+                qWarning() << "Verifying every domain's heartbeats with the public key in" << publicKeyFile.fileName();
+            } else {
+                qWarning() << "Could not read a public key from" << publicKeyFile.fileName() << "- ignoring it";
+            }
+        }
+    }
+
+    // leave a core for the socket thread, which receives and sends every packet
+    int numThreads = std::max(QThread::idealThreadCount() - 1, 1);
+    if (parser.isSet(threadsOption)) {
+        numThreads = std::max(parser.value(threadsOption).toInt(), 1);
+    }
+
+    qDebug() << "ice-server is handling heartbeats on" << numThreads << "worker threads";
+    for (int i = 0; i < numThreads; ++i) {
+        _workers.emplace_back(new IceServerWorker(*this));
+        _workers.back()->start();
+    }
+
     // start the ice-server socket
     qDebug() << "ice-server socket is listening on" << ICE_SERVER_DEFAULT_PORT;
     _serverSocket.bind(QHostAddress::AnyIPv4, ICE_SERVER_DEFAULT_PORT);
@@ -44,16 +109,25 @@ IceServer::IceServer(int argc, char* argv[]) :
     using std::placeholders::_1;
     _serverSocket.setPacketFilterOperator(std::bind(&IceServer::packetVersionMatch, this, _1));
 
-    // setup our timer to clear inactive peers
-    QTimer* inactivePeerTimer = new QTimer(this);
-    connect(inactivePeerTimer, &QTimer::timeout, this, &IceServer::clearInactivePeers);
-    inactivePeerTimer->start(CLEAR_INACTIVE_PEERS_INTERVAL_MSECS);
+    // setup our timer to report throughput
+    QTimer* statsTimer = new QTimer(this);
+    connect(statsTimer, &QTimer::timeout, this, &IceServer::logStats);
+    statsTimer->start(STATS_INTERVAL_MSECS);
 
     // handle public keys when they arrive from the QNetworkAccessManager
     auto& networkAccessManager = NetworkAccessManager::getInstance();
     connect(&networkAccessManager, &QNetworkAccessManager::finished, this, &IceServer::publicKeyReplyFinished);
 }
 
+IceServer::~IceServer() {
+    for (auto& worker : _workers) {
+        worker->stop();
+    }
+    for (auto& worker : _workers) {
+        worker->wait();
+    }
+}
+
 bool IceServer::packetVersionMatch(const udt::Packet& packet) {
     PacketType headerType = NLPacket::typeInHeader(packet);
     PacketVersion headerVersion = NLPacket::versionInHeader(packet);
@@ -65,146 +139,106 @@ bool IceServer::packetVersionMatch(const udt::Packet& packet) {
     }
 }
 
+IceServerWorker& IceServer::workerForDomain(const QUuid& domainID) {
+    return *_workers[qHash(domainID) % _workers.size()];
+}
+
 void IceServer::processPacket(std::unique_ptr<udt::Packet> packet) {
 
     auto nlPacket = NLPacket::fromBase(std::move(packet));
     
     // make sure that this packet at least looks like something we can read
     if (nlPacket->getPayloadSize() >= NLPacket::localHeaderSize(PacketType::ICEServerHeartbeat)) {
-        
+        ++_numReceivedPackets;
+
+        // find the domain this packet is about, everything else is left to the worker that owns that domain
+        QUuid domainID;
         if (nlPacket->getType() == PacketType::ICEServerHeartbeat) {
-            SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(*nlPacket);
-            if (peer) {
-                // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
-                peer->activateMatchingOrNewSymmetricSocket(nlPacket->getSenderSockAddr());
-
-                // we have an active and verified heartbeating peer
-                // send them an ACK packet so they know that they are being heard and ready for ICE
-                static auto ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
-                _serverSocket.writePacket(*ackPacket, nlPacket->getSenderSockAddr());
-            } else {
-                // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
-                static auto deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
-                _serverSocket.writePacket(*deniedPacket, nlPacket->getSenderSockAddr());
+            // heartbeats lead with the domain ID
+            if (nlPacket->getPayloadSize() < NUM_BYTES_RFC4122_UUID) {
+                return;
             }
+            domainID = QUuid::fromRfc4122(QByteArray::fromRawData(nlPacket->getPayload(), NUM_BYTES_RFC4122_UUID));
         } else if (nlPacket->getType() == PacketType::ICEServerQuery) {
-            QDataStream heartbeatStream(nlPacket.get());
-            
-            // this is a node hoping to connect to a heartbeating peer - do we have the heartbeating peer?
+            // queries name the domain they want to connect to after the sender's own details
+            QDataStream queryStream(nlPacket.get());
             QUuid senderUUID;
-            heartbeatStream >> senderUUID;
-            
-            // pull the public and private sock addrs for this peer
             HifiSockAddr publicSocket, localSocket;
-            heartbeatStream >> publicSocket >> localSocket;
-            
-            // check if this node also included a UUID that they would like to connect to
-            QUuid connectRequestID;
-            heartbeatStream >> connectRequestID;
-            
-            SharedNetworkPeer matchingPeer = _activePeers.value(connectRequestID);
-            
-            if (matchingPeer) {
-                
-                qDebug() << "Sending information for peer" << connectRequestID << "to peer" << senderUUID;
-                
-                // we have the peer they want to connect to - send them pack the information for that peer
-                sendPeerInformationPacket(*matchingPeer, &nlPacket->getSenderSockAddr());
-                
-                // we also need to send them to the active peer they are hoping to connect to
-                // create a dummy peer object we can pass to sendPeerInformationPacket
-                
-                NetworkPeer dummyPeer(senderUUID, publicSocket, localSocket);
-                sendPeerInformationPacket(dummyPeer, matchingPeer->getActiveSocket());
-            } else {
-                qDebug() << "Peer" << senderUUID << "asked for" << connectRequestID << "but no matching peer found";
-            }
+            queryStream >> senderUUID >> publicSocket >> localSocket >> domainID;
+            nlPacket->seek(0);
+        } else {
+            return;
         }
+
+        workerForDomain(domainID).queuePacket(std::move(nlPacket));
     }
 }
 
-SharedNetworkPeer IceServer::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
-
-    // pull the UUID, public and private sock addrs for this peer
-    QUuid senderUUID;
-    HifiSockAddr publicSocket, localSocket;
-    QByteArray signature;
-
-    QDataStream heartbeatStream(&packet);
-    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
-
-    auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
-    heartbeatStream >> signature;
+void IceServer::queueOutgoingPacket(std::shared_ptr<NLPacket> packet, const HifiSockAddr& destination) {
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(_outgoingMutex);
+        wasEmpty = _outgoingPackets.empty();
+        _outgoingPackets.emplace_back(std::move(packet), destination);
+    }
 
-    // make sure this is a verified heartbeat before performing any more processing
-    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
-        // make sure we have this sender in our peer hash
-        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+    // the udt::Socket is only written from its own thread, wake it once for however many packets pile up
+    if (wasEmpty) {
+        QMetaObject::invokeMethod(this, "sendOutgoingPackets", Qt::QueuedConnection);
+    }
+}
 
-        if (!matchingPeer) {
-            // if we don't have this sender we need to create them now
-            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
-            _activePeers.insert(senderUUID, matchingPeer);
+void IceServer::sendOutgoingPackets() {
+    {
+        std::lock_guard<std::mutex> lock(_outgoingMutex);
+        _sendingPackets.swap(_outgoingPackets);
+    }
 
-            qDebug() << "Added a new network peer" << *matchingPeer;
-        } else {
-            // we already had the peer so just potentially update their sockets
-            matchingPeer->setPublicSocket(publicSocket);
-            matchingPeer->setLocalSocket(localSocket);
-        }
+    for (auto& outgoingPacket : _sendingPackets) {
+        _serverSocket.writePacket(*outgoingPacket.first, outgoingPacket.second);
+    }
+    _sendingPackets.clear();
+}
 
-        // update our last heard microstamp for this network peer to now
-        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
-        
-        return matchingPeer;
-    } else {
-        // not verified, return the empty peer object
-        return SharedNetworkPeer();
+void IceServer::logStats() {
+    int numDroppedPackets = 0;
+    for (auto& worker : _workers) {
+        numDroppedPackets += worker->getNumDroppedPackets();
     }
+
+    qDebug() << "ice-server received" << (float)_numReceivedPackets * MSECS_PER_SECOND / STATS_INTERVAL_MSECS
+        << "packets/s -" << numDroppedPackets << "dropped since start";
+    _numReceivedPackets = 0;
 }
 
-bool IceServer::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature) {
-    // make sure we're not already waiting for a public key for this domain-server
-    if (!_pendingPublicKeyRequests.contains(domainID)) {
-        // check if we have a public key for this domain ID - if we do not then fire off the request for it
-        auto it = _domainPublicKeys.find(domainID);
-        if (it != _domainPublicKeys.end()) {
-
-            // attempt to verify the signature for this heartbeat
-            const auto rsaPublicKey = it->second.get();
-
-            if (rsaPublicKey) {
-                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
-                int verificationResult = RSA_verify(NID_sha256,
-                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
-                                                    hashedPlaintext.size(),
-                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
-                                                    signature.size(),
-                                                    rsaPublicKey);
-
-                if (verificationResult == 1) {
-                    // this is the only success case - we return true here to indicate that the heartbeat is verified
-                    return true;
-                } else {
-                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
-                }
+RSAUniquePtr IceServer::readLocalPublicKey(const QUuid& domainID) const {
+    if (!_localPublicKey.isEmpty()) {
+        return rsaPublicKeyFromDER(_localPublicKey);
+    }
 
-            } else {
-                // we can't let this user in since we couldn't convert their public key to an RSA key we could use
-                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
-                qWarning() << "Re-requesting public key from API";
+    if (!_localPublicKeyDirectory.isEmpty()) {
+        QFile publicKeyFile(QDir(_localPublicKeyDirectory).filePath(uuidStringWithoutCurlyBraces(domainID)
+            + LOCAL_PUBLIC_KEY_EXTENSION));
+        if (publicKeyFile.open(QIODevice::ReadOnly)) {
+            auto publicKey = rsaPublicKeyFromDER(publicKeyFile.readAll());
+            if (!publicKey) {
+                qWarning() << "Could not read a public key from" << publicKeyFile.fileName();
             }
+            return publicKey;
         }
-
-        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
-        // ask the metaverse API for the right public key and return false to indicate that this is not verified
-        requestDomainPublicKey(domainID);
     }
 
-    return false;
+    return RSAUniquePtr();
 }
 
 void IceServer::requestDomainPublicKey(const QUuid& domainID) {
+    // a local key stands in for the metaverse API, for domains that are not registered with it
+    RSAUniquePtr localPublicKey = readLocalPublicKey(domainID);
+    if (localPublicKey) {
+        workerForDomain(domainID).queuePublicKey(domainID, std::move(localPublicKey));
+        return;
+    }
+
     // send a request to the metaverse API for the public key for this domain
     auto& networkAccessManager = NetworkAccessManager::getInstance();
 
@@ -218,15 +252,13 @@ void IceServer::requestDomainPublicKey(const QUuid& domainID) {
 
     qDebug() << "Requesting public key for domain with ID" << domainID;
 
-    // add this to the set of pending public key requests
-    _pendingPublicKeyRequests.insert(domainID);
-
     networkAccessManager.get(publicKeyRequest);
 }
 
 void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
     // get the domain ID from the QNetworkReply attribute
     QUuid domainID = reply->request().attribute(QNetworkRequest::User).toUuid();
+    RSAUniquePtr publicKey;
 
     if (reply->error() == QNetworkReply::NoError) {
         // pull out the public key and store it for this domain
@@ -248,13 +280,9 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
                 auto apiPublicKey = QByteArray::fromBase64(dataObject[PUBLIC_KEY_KEY].toString().toUtf8());
 
                 // convert the downloaded public key to an RSA struct, if possible
-                const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(apiPublicKey.constData());
-
-                RSA* rsaPublicKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, apiPublicKey.size());
+                publicKey = rsaPublicKeyFromDER(apiPublicKey);
 
-                if (rsaPublicKey) {
-                    _domainPublicKeys[domainID] = { rsaPublicKey, RSA_free };
-                } else {
+                if (!publicKey) {
                     qWarning() << "Could not convert in-memory public key for" << domainID << "to usable RSA public key.";
                     qWarning() << "Public key will be re-requested on next heartbeat.";
                 }
@@ -273,39 +301,8 @@ void IceServer::publicKeyReplyFinished(QNetworkReply* reply) {
         qWarning() << "Error retreiving public key for domain with ID" << domainID << "-" <<  reply->errorString();
     }
 
-    // remove this domain ID from the list of pending public key requests
-    _pendingPublicKeyRequests.remove(domainID);
+    // hand the key to the worker for this domain, which also clears the pending request on its side
+    workerForDomain(domainID).queuePublicKey(domainID, std::move(publicKey));
 
     reply->deleteLater();
 }
-
-void IceServer::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr) {
-    auto peerPacket = NLPacket::create(PacketType::ICEServerPeerInformation);
-
-    // get the byte array for this peer
-    peerPacket->write(peer.toByteArray());
-    
-    // write the current packet
-    _serverSocket.writePacket(*peerPacket, *destinationSockAddr);
-}
-
-void IceServer::clearInactivePeers() {
-    NetworkPeerHash::iterator peerItem = _activePeers.begin();
-
-    while (peerItem != _activePeers.end()) {
-        SharedNetworkPeer peer = peerItem.value();
-
-        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
-            qDebug() << "Removing peer from memory for inactivity -" << *peer;
-
-            // if we had a public key for this domain, remove it now
-            _domainPublicKeys.erase(peer->getUUID());
-
-            // remove the peer object
-            peerItem = _activePeers.erase(peerItem);
-        } else {
-            // we didn't kill this peer, push the iterator forwards
-            ++peerItem;
-        }
-    }
-}
@@ -12,50 +12,67 @@
 #ifndef hifi_IceServer_h
 #define hifi_IceServer_h
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
 #include <QUdpSocket>
 
-#include <openssl/rsa.h>
-
-#include <UUIDHasher.h>
-
 #include <NetworkPeer.h>
 #include <HTTPConnection.h>
 #include <HTTPManager.h>
 #include <NLPacket.h>
 #include <udt/Socket.h>
 
+#include "IceServerWorker.h"
+
 class QNetworkReply;
 
 class IceServer : public QCoreApplication {
     Q_OBJECT
 public:
     IceServer(int argc, char* argv[]);
+    ~IceServer();
+
+    // queues a packet to be written by the socket thread, callable from any thread
+    void queueOutgoingPacket(std::shared_ptr<NLPacket> packet, const HifiSockAddr& destination);
+
+public slots:
+    void requestDomainPublicKey(const QUuid& domainID);
+
 private slots:
-    void clearInactivePeers();
     void publicKeyReplyFinished(QNetworkReply* reply);
+    void sendOutgoingPackets();
+    void logStats();
+
 private:
     bool packetVersionMatch(const udt::Packet& packet);
     void processPacket(std::unique_ptr<udt::Packet> packet);
-    
-    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
-    void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
 
-    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
-    void requestDomainPublicKey(const QUuid& domainID);
+    IceServerWorker& workerForDomain(const QUuid& domainID);
+
+    // the key for a domain from the local public key path, null if there is none
+    RSAUniquePtr readLocalPublicKey(const QUuid& domainID) const;
 
     QUuid _id;
     udt::Socket _serverSocket;
 
-    using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
-    NetworkPeerHash _activePeers;
+    // heartbeats and queries are sharded across the workers by domain ID
+    std::vector<std::unique_ptr<IceServerWorker>> _workers;
+
+    using OutgoingPacket = std::pair<std::shared_ptr<NLPacket>, HifiSockAddr>;
+    std::mutex _outgoingMutex;
+    std::vector<OutgoingPacket> _outgoingPackets; // guarded by _outgoingMutex
+    std::vector<OutgoingPacket> _sendingPackets; // only touched by the socket thread
 
-    using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
-    using DomainPublicKeyHash = std::unordered_map<QUuid, RSAUniquePtr>;
-    DomainPublicKeyHash _domainPublicKeys;
+    int _numReceivedPackets { 0 }; // only touched by the socket thread
 
-    QSet<QUuid> _pendingPublicKeyRequests;
+    // public keys read from disk instead of the metaverse API, either one <domain ID>.key file per domain in a
+    // directory, or a single key that every domain is verified with
+    QString _localPublicKeyDirectory;
+    QByteArray _localPublicKey;
 };
 
 #endif // hifi_IceServer_h
@@ -0,0 +1,289 @@
+//
+//  IceServerWorker.cpp
+//  ice-server/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "IceServerWorker.h"
+
+#include <chrono>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+
+#include <udt/PacketHeaders.h>
+#include <SharedUtil.h>
+
+#include "IceServer.h"
+
+const int CLEAR_INACTIVE_PEERS_INTERVAL_MSECS = 1 * 1000;
+const int PEER_SILENCE_THRESHOLD_MSECS = 5 * 1000;
+
+// past this, packets are dropped on arrival rather than answered after their senders have given up on them
+const size_t MAX_PENDING_PACKETS = 8192;
+
+IceServerWorker::IceServerWorker(IceServer& server) :
+    _server(server)
+{
+}
+
+void IceServerWorker::queuePacket(std::unique_ptr<NLPacket> packet) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_pendingPackets.size() >= MAX_PENDING_PACKETS) {
+            ++_numDroppedPackets;
+            return;
+        }
+        _pendingPackets.push_back(std::move(packet));
+    }
+    _condition.notify_one();
+}
+
+void IceServerWorker::queuePublicKey(const QUuid& domainID, RSAUniquePtr publicKey) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingPublicKeys.emplace_back(domainID, std::move(publicKey));
+    }
+    _condition.notify_one();
+}
+
+void IceServerWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _condition.notify_one();
+}
+
+void IceServerWorker::run() {
+    std::vector<std::unique_ptr<NLPacket>> packets;
+    std::vector<std::pair<QUuid, RSAUniquePtr>> publicKeys;
+
+    auto nextClear = std::chrono::steady_clock::now() + std::chrono::milliseconds(CLEAR_INACTIVE_PEERS_INTERVAL_MSECS);
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait_until(lock, nextClear, [&] {
+                return _stop || !_pendingPackets.empty() || !_pendingPublicKeys.empty();
+            });
+
+            if (_stop) {
+                return;
+            }
+
+            // take everything queued so far, so that the socket thread is never held up behind processing
+            packets.swap(_pendingPackets);
+            publicKeys.swap(_pendingPublicKeys);
+        }
+
+        for (auto& publicKey : publicKeys) {
+            const QUuid& domainID = publicKey.first;
+            if (publicKey.second) {
+                // a new key invalidates whatever was verified with the old one
+                _domainPublicKeys[domainID] = { std::move(publicKey.second), QByteArray(), QByteArray() };
+            }
+
+            // remove this domain ID from the list of pending public key requests
+            _pendingPublicKeyRequests.remove(domainID);
+        }
+        publicKeys.clear();
+
+        for (auto& packet : packets) {
+            processPacket(*packet);
+        }
+        packets.clear();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextClear) {
+            clearInactivePeers();
+            nextClear = now + std::chrono::milliseconds(CLEAR_INACTIVE_PEERS_INTERVAL_MSECS);
+        }
+    }
+}
+
+void IceServerWorker::processPacket(NLPacket& packet) {
+    if (packet.getType() == PacketType::ICEServerHeartbeat) {
+        SharedNetworkPeer peer = addOrUpdateHeartbeatingPeer(packet);
+        if (peer) {
+            // so that we can send packets to the heartbeating peer when we need, we need to activate a socket now
+            peer->activateMatchingOrNewSymmetricSocket(packet.getSenderSockAddr());
+
+            // we have an active and verified heartbeating peer
+            // send them an ACK packet so they know that they are being heard and ready for ICE
+            static std::shared_ptr<NLPacket> ackPacket = NLPacket::create(PacketType::ICEServerHeartbeatACK);
+            _server.queueOutgoingPacket(ackPacket, packet.getSenderSockAddr());
+        } else {
+            // we couldn't verify this peer - respond back to them so they know they may need to perform keypair re-generation
+            static std::shared_ptr<NLPacket> deniedPacket = NLPacket::create(PacketType::ICEServerHeartbeatDenied);
+            _server.queueOutgoingPacket(deniedPacket, packet.getSenderSockAddr());
+        }
+    } else if (packet.getType() == PacketType::ICEServerQuery) {
+        QDataStream heartbeatStream(&packet);
+
+        // this is a node hoping to connect to a heartbeating peer - do we have the heartbeating peer?
+        QUuid senderUUID;
+        heartbeatStream >> senderUUID;
+
+        // pull the public and private sock addrs for this peer
+        HifiSockAddr publicSocket, localSocket;
+        heartbeatStream >> publicSocket >> localSocket;
+
+        // check if this node also included a UUID that they would like to connect to
+        QUuid connectRequestID;
+        heartbeatStream >> connectRequestID;
+
+        SharedNetworkPeer matchingPeer = _activePeers.value(connectRequestID);
+
+        if (matchingPeer) {
+
+            qDebug() << "Sending information for peer" << connectRequestID << "to peer" << senderUUID;
+
+            // we have the peer they want to connect to - send them pack the information for that peer
+            sendPeerInformationPacket(*matchingPeer, &packet.getSenderSockAddr());
+
+            // we also need to send them to the active peer they are hoping to connect to
+            // create a dummy peer object we can pass to sendPeerInformationPacket
+
+            NetworkPeer dummyPeer(senderUUID, publicSocket, localSocket);
+            sendPeerInformationPacket(dummyPeer, matchingPeer->getActiveSocket());
+        } else {
+            qDebug() << "Peer" << senderUUID << "asked for" << connectRequestID << "but no matching peer found";
+        }
+    }
+}
+
+SharedNetworkPeer IceServerWorker::addOrUpdateHeartbeatingPeer(NLPacket& packet) {
+
+    // pull the UUID, public and private sock addrs for this peer
+    QUuid senderUUID;
+    HifiSockAddr publicSocket, localSocket;
+    QByteArray signature;
+
+    QDataStream heartbeatStream(&packet);
+    heartbeatStream >> senderUUID >> publicSocket >> localSocket;
+
+    auto signedPlaintext = QByteArray::fromRawData(packet.getPayload(), heartbeatStream.device()->pos());
+    heartbeatStream >> signature;
+
+    // make sure this is a verified heartbeat before performing any more processing
+    if (isVerifiedHeartbeat(senderUUID, signedPlaintext, signature)) {
+        // make sure we have this sender in our peer hash
+        SharedNetworkPeer matchingPeer = _activePeers.value(senderUUID);
+
+        if (!matchingPeer) {
+            // if we don't have this sender we need to create them now
+            matchingPeer = QSharedPointer<NetworkPeer>::create(senderUUID, publicSocket, localSocket);
+            _activePeers.insert(senderUUID, matchingPeer);
+
+            qDebug() << "Added a new network peer" << *matchingPeer;
+        } else {
+            // we already had the peer so just potentially update their sockets
+            matchingPeer->setPublicSocket(publicSocket);
+            matchingPeer->setLocalSocket(localSocket);
+        }
+
+        // update our last heard microstamp for this network peer to now
+        matchingPeer->setLastHeardMicrostamp(usecTimestampNow());
+
+        return matchingPeer;
+    } else {
+        // not verified, return the empty peer object
+        return SharedNetworkPeer();
+    }
+}
+
+bool IceServerWorker::isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext,
+                                          const QByteArray& signature) {
+    // make sure we're not already waiting for a public key for this domain-server
+    if (!_pendingPublicKeyRequests.contains(domainID)) {
+        // check if we have a public key for this domain ID - if we do not then fire off the request for it
+        auto it = _domainPublicKeys.find(domainID);
+        if (it != _domainPublicKeys.end()) {
+            auto& domainPublicKey = it->second;
+
+            // a repeat of the last verified heartbeat needs no RSA work
+            if (!domainPublicKey.verifiedSignature.isEmpty() && signature == domainPublicKey.verifiedSignature
+                && plaintext == domainPublicKey.verifiedPlaintext) {
+                return true;
+            }
+
+            // attempt to verify the signature for this heartbeat
+            const auto rsaPublicKey = domainPublicKey.publicKey.get();
+
+            if (rsaPublicKey) {
+                auto hashedPlaintext = QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+                int verificationResult = RSA_verify(NID_sha256,
+                                                    reinterpret_cast<const unsigned char*>(hashedPlaintext.constData()),
+                                                    hashedPlaintext.size(),
+                                                    reinterpret_cast<const unsigned char*>(signature.constData()),
+                                                    signature.size(),
+                                                    rsaPublicKey);
+
+                if (verificationResult == 1) {
+                    // this is the only success case - we return true here to indicate that the heartbeat is verified
+                    // plaintext points into the packet, so take a deep copy for the cache
+                    domainPublicKey.verifiedPlaintext = QByteArray(plaintext.constData(), plaintext.size());
+                    domainPublicKey.verifiedSignature = signature;
+                    return true;
+                } else {
+                    qDebug() << "Failed to verify heartbeat for" << domainID << "- re-requesting public key from API.";
+                }
+
+            } else {
+                // we can't let this user in since we couldn't convert their public key to an RSA key we could use
+                qWarning() << "Public key for" << domainID << "is not a usable RSA* public key.";
+                qWarning() << "Re-requesting public key from API";
+            }
+        }
+
+        // we could not verify this heartbeat (missing public key, could not load public key, bad actor)
+        // ask the metaverse API for the right public key and return false to indicate that this is not verified
+        requestDomainPublicKey(domainID);
+    }
+
+    return false;
+}
+
+void IceServerWorker::requestDomainPublicKey(const QUuid& domainID) {
+    // add this to the set of pending public key requests, the reply comes back through queuePublicKey
+    _pendingPublicKeyRequests.insert(domainID);
+
+    // the network access manager lives on the main thread
+    QMetaObject::invokeMethod(&_server, "requestDomainPublicKey", Qt::QueuedConnection, Q_ARG(QUuid, domainID));
+}
+
+void IceServerWorker::sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr) {
+    auto peerPacket = NLPacket::create(PacketType::ICEServerPeerInformation);
+
+    // get the byte array for this peer
+    peerPacket->write(peer.toByteArray());
+
+    // write the current packet
+    _server.queueOutgoingPacket(std::move(peerPacket), *destinationSockAddr);
+}
+
+void IceServerWorker::clearInactivePeers() {
+    NetworkPeerHash::iterator peerItem = _activePeers.begin();
+
+    while (peerItem != _activePeers.end()) {
+        SharedNetworkPeer peer = peerItem.value();
+
+        if ((usecTimestampNow() - peer->getLastHeardMicrostamp()) > (PEER_SILENCE_THRESHOLD_MSECS * 1000)) {
+            qDebug() << "Removing peer from memory for inactivity -" << *peer;
+
+            // if we had a public key for this domain, remove it now
+            _domainPublicKeys.erase(peer->getUUID());
+
+            // remove the peer object
+            peerItem = _activePeers.erase(peerItem);
+        } else {
+            // we didn't kill this peer, push the iterator forwards
+            ++peerItem;
+        }
+    }
+}
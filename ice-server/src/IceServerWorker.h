@@ -0,0 +1,97 @@
+//
+//  IceServerWorker.h
+//  ice-server/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_IceServerWorker_h
+#define hifi_IceServerWorker_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+
+#include <openssl/rsa.h>
+
+#include <UUIDHasher.h>
+
+#include <NetworkPeer.h>
+#include <NLPacket.h>
+
+class IceServer;
+
+using RSAUniquePtr = std::unique_ptr<RSA, std::function<void(RSA*)>>;
+
+// Handles the heartbeats and queries for one shard of the domain ID space. Every packet about a given domain lands
+// on the same worker, so the worker owns its share of the peer table, public keys and verification cache outright
+// and never takes a lock to read or update them. The only shared state is the inbound queue.
+class IceServerWorker : public QThread {
+    Q_OBJECT
+public:
+    IceServerWorker(IceServer& server);
+
+    // called from the socket thread
+    void queuePacket(std::unique_ptr<NLPacket> packet);
+
+    // called from the main thread when a public key request finishes, publicKey is null if the request failed
+    void queuePublicKey(const QUuid& domainID, RSAUniquePtr publicKey);
+
+    void stop();
+
+    int getNumDroppedPackets() const { return _numDroppedPackets; }
+
+protected:
+    void run() override;
+
+private:
+    struct DomainPublicKey {
+        RSAUniquePtr publicKey;
+
+        // heartbeats only change when the domain's sockets do, and RSA signatures are deterministic, so the last
+        // verified heartbeat can be matched byte for byte instead of being verified again
+        QByteArray verifiedPlaintext;
+        QByteArray verifiedSignature;
+    };
+
+    void processPacket(NLPacket& packet);
+
+    SharedNetworkPeer addOrUpdateHeartbeatingPeer(NLPacket& incomingPacket);
+    void sendPeerInformationPacket(const NetworkPeer& peer, const HifiSockAddr* destinationSockAddr);
+
+    bool isVerifiedHeartbeat(const QUuid& domainID, const QByteArray& plaintext, const QByteArray& signature);
+    void requestDomainPublicKey(const QUuid& domainID);
+
+    void clearInactivePeers();
+
+    IceServer& _server;
+
+    // inbound state, shared with the socket and main threads
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<std::unique_ptr<NLPacket>> _pendingPackets;
+    std::vector<std::pair<QUuid, RSAUniquePtr>> _pendingPublicKeys;
+    bool _stop { false };
+    std::atomic<int> _numDroppedPackets { 0 };
+
+    // owned by the worker thread
+    using NetworkPeerHash = QHash<QUuid, SharedNetworkPeer>;
+    NetworkPeerHash _activePeers;
+
+    using DomainPublicKeyHash = std::unordered_map<QUuid, DomainPublicKey>;
+    DomainPublicKeyHash _domainPublicKeys;
+
+    QSet<QUuid> _pendingPublicKeyRequests;
+};
+
+#endif // hifi_IceServerWorker_h
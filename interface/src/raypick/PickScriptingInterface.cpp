@@ -133,6 +133,10 @@ QVariantMap PickScriptingInterface::getPrevPickResult(unsigned int uid) {
     return result;
 }
 
+QVariantMap PickScriptingInterface::getUpdateStats(unsigned int uid) {
+    return DependencyManager::get<PickManager>()->getUpdateStats(uid);
+}
+
 void PickScriptingInterface::setPrecisionPicking(unsigned int uid, bool precisionPicking) {
     DependencyManager::get<PickManager>()->setPrecisionPicking(uid, precisionPicking);
 }
@@ -138,6 +138,22 @@ public:
      */
     Q_INVOKABLE QVariantMap getPrevPickResult(unsigned int uid);
 
+    /**jsdoc
+     * Get the time spent computing the intersections of this Pick.  Intersections shared with other Picks with the same
+     * filter are counted for the first of them only.
+     * @function Picks.getUpdateStats
+     * @param {number} uid The ID of the Pick, as returned by {@link Picks.createPick}.
+     * @returns {Picks.PickUpdateStats} The statistics, empty if there is no such Pick.
+     */
+    /**jsdoc
+     * @typedef {Object} Picks.PickUpdateStats
+     * @property {number} updates The number of updates in which the Pick was computed.
+     * @property {number} lastUsecs The time spent in the last update, in microseconds.
+     * @property {number} averageUsecs The average time spent in recent updates, in microseconds.
+     * @property {number} maxUsecs The longest time spent in an update, in microseconds.
+     */
+    Q_INVOKABLE QVariantMap getUpdateStats(unsigned int uid);
+
     /**jsdoc
      * Sets whether or not to use precision picking.
      * @function Picks.setPrecisionPicking
@@ -25,6 +25,24 @@ PickResultPointer RayPick::getEntityIntersection(const PickRay& pick) {
     }
 }
 
+std::vector<PickResultPointer> RayPick::getEntityIntersections(const std::vector<PickRay>& picks) {
+    std::vector<RayToEntityIntersectionResult> entityResults =
+        DependencyManager::get<EntityScriptingInterface>()->findRayIntersectionsVector(picks, !getFilter().doesPickCoarse(),
+            getIncludeItemsAs<EntityItemID>(), getIgnoreItemsAs<EntityItemID>(), !getFilter().doesPickInvisible(), !getFilter().doesPickNonCollidable());
+
+    std::vector<PickResultPointer> results;
+    results.reserve(picks.size());
+    for (size_t i = 0; i < picks.size(); i++) {
+        const RayToEntityIntersectionResult& entityRes = entityResults[i];
+        if (entityRes.intersects) {
+            results.push_back(std::make_shared<RayPickResult>(IntersectionType::ENTITY, entityRes.entityID, entityRes.distance, entityRes.intersection, picks[i], entityRes.surfaceNormal));
+        } else {
+            results.push_back(std::make_shared<RayPickResult>(picks[i].toVariantMap()));
+        }
+    }
+    return results;
+}
+
 PickResultPointer RayPick::getOverlayIntersection(const PickRay& pick) {
     RayToOverlayIntersectionResult overlayRes =
         qApp->getOverlays().findRayIntersectionVector(pick, !getFilter().doesPickCoarse(),
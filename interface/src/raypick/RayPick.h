@@ -71,10 +71,14 @@ public:
 
     PickResultPointer getDefaultResult(const QVariantMap& pickVariant) const override { return std::make_shared<RayPickResult>(pickVariant); }
     PickResultPointer getEntityIntersection(const PickRay& pick) override;
+    std::vector<PickResultPointer> getEntityIntersections(const std::vector<PickRay>& picks) override;
     PickResultPointer getOverlayIntersection(const PickRay& pick) override;
     PickResultPointer getAvatarIntersection(const PickRay& pick) override;
     PickResultPointer getHUDIntersection(const PickRay& pick) override;
 
+    // The entity tree and the overlays are locked by each query.  Avatars and the HUD have to be read on the main thread.
+    bool canIntersectConcurrently(IntersectionType type) const override { return type == ENTITY || type == OVERLAY; }
+
     // These are helper functions for projecting and intersecting rays
     static glm::vec3 intersectRayWithEntityXYPlane(const QUuid& entityID, const glm::vec3& origin, const glm::vec3& direction);
     static glm::vec3 intersectRayWithOverlayXYPlane(const QUuid& overlayID, const glm::vec3& origin, const glm::vec3& direction);
@@ -45,7 +45,7 @@ protected:
 
     float _alpha;
 
-    QString _alphaVar;
+    AnimVariantKey _alphaVar;
 
     // no copies
     AnimBlendLinear(const AnimBlendLinear&) = delete;
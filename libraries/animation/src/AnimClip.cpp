@@ -96,26 +96,35 @@ void AnimClip::setCurrentFrameInternal(float frame) {
 
 void AnimClip::copyFromNetworkAnim() {
     assert(_networkAnim && _networkAnim->isLoaded() && _skeleton);
-    _anim.clear();
+    convertFrames(_networkAnim->getGeometry(), *_skeleton, _anim, _url);
+
+    // mirrorAnim will be re-built on demand, if needed.
+    _mirrorAnim.clear();
+
+    _poses.resize(_skeleton->getNumJoints());
+}
+
+void AnimClip::convertFrames(const FBXGeometry& geom, const AnimSkeleton& skeleton, std::vector<AnimPoseVec>& frames,
+                             const QString& url) {
+    frames.clear();
 
     // build a mapping from animation joint indices to skeleton joint indices.
     // by matching joints with the same name.
-    const FBXGeometry& geom = _networkAnim->getGeometry();
     AnimSkeleton animSkeleton(geom);
     const auto animJointCount = animSkeleton.getNumJoints();
-    const auto skeletonJointCount = _skeleton->getNumJoints();
+    const auto skeletonJointCount = skeleton.getNumJoints();
     std::vector<int> jointMap;
     jointMap.reserve(animJointCount);
     for (int i = 0; i < animJointCount; i++) {
-        int skeletonJoint = _skeleton->nameToJointIndex(animSkeleton.getJointName(i));
+        int skeletonJoint = skeleton.nameToJointIndex(animSkeleton.getJointName(i));
         if (skeletonJoint == -1) {
-            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << _url;
+            qCWarning(animation) << "animation contains joint =" << animSkeleton.getJointName(i) << " which is not in the skeleton, url =" << url;
         }
         jointMap.push_back(skeletonJoint);
     }
 
     const int frameCount = geom.animationFrames.size();
-    _anim.resize(frameCount);
+    frames.resize(frameCount);
 
     for (int frame = 0; frame < frameCount; frame++) {
 
@@ -123,9 +132,9 @@ void AnimClip::copyFromNetworkAnim() {
 
         // init all joints in animation to default pose
         // this will give us a resonable result for bones in the model skeleton but not in the animation.
-        _anim[frame].reserve(skeletonJointCount);
+        frames[frame].reserve(skeletonJointCount);
         for (int skeletonJoint = 0; skeletonJoint < skeletonJointCount; skeletonJoint++) {
-            _anim[frame].push_back(_skeleton->getRelativeDefaultPose(skeletonJoint));
+            frames[frame].push_back(skeleton.getRelativeDefaultPose(skeletonJoint));
         }
 
         for (int animJoint = 0; animJoint < animJointCount; animJoint++) {
@@ -143,7 +152,7 @@ void AnimClip::copyFromNetworkAnim() {
                     postRot = animSkeleton.getPostRotationPose(animJoint);
                 } else {
                     // In order to support Blender, which does not have preRotation FBX support, we use the models defaultPose as the reference frame for the animations.
-                    preRot = AnimPose(glm::vec3(1.0f), _skeleton->getRelativeBindPose(skeletonJoint).rot(), glm::vec3());
+                    preRot = AnimPose(glm::vec3(1.0f), skeleton.getRelativeBindPose(skeletonJoint).rot(), glm::vec3());
                     postRot = AnimPose::identity;
                 }
 
@@ -156,7 +165,7 @@ void AnimClip::copyFromNetworkAnim() {
                 // adjust translation offsets, so large translation animatons on the reference skeleton
                 // will be adjusted when played on a skeleton with short limbs.
                 const glm::vec3& fbxZeroTrans = geom.animationFrames[0].translations[animJoint];
-                const AnimPose& relDefaultPose = _skeleton->getRelativeDefaultPose(skeletonJoint);
+                const AnimPose& relDefaultPose = skeleton.getRelativeDefaultPose(skeletonJoint);
                 float boneLengthScale = 1.0f;
                 const float EPSILON = 0.0001f;
                 if (fabsf(glm::length(fbxZeroTrans)) > EPSILON) {
@@ -165,15 +174,10 @@ void AnimClip::copyFromNetworkAnim() {
 
                 AnimPose trans = AnimPose(glm::vec3(1.0f), glm::quat(), relDefaultPose.trans() + boneLengthScale * (fbxAnimTrans - fbxZeroTrans));
 
-                _anim[frame][skeletonJoint] = trans * preRot * rot * postRot;
+                frames[frame][skeletonJoint] = trans * preRot * rot * postRot;
             }
         }
     }
-
-    // mirrorAnim will be re-built on demand, if needed.
-    _mirrorAnim.clear();
-
-    _poses.resize(skeletonJointCount);
 }
 
 void AnimClip::buildMirrorAnim() {
@@ -54,6 +54,12 @@ public:
     void setMirrorFlag(bool mirrorFlag) { _mirrorFlag = mirrorFlag; }
 
     void loadURL(const QString& url);
+
+    // Converts the frames of an animation into poses of skeleton, relative to their parents, indexed [frame][joint].
+    // Joints of skeleton that the animation doesn't have keep their default pose.
+    static void convertFrames(const FBXGeometry& animGeometry, const AnimSkeleton& skeleton,
+                              std::vector<AnimPoseVec>& frames, const QString& url = QString());
+
 protected:
 
     virtual void setCurrentFrameInternal(float frame) override;
@@ -79,12 +85,12 @@ protected:
     bool _mirrorFlag;
     float _frame;
 
-    QString _startFrameVar;
-    QString _endFrameVar;
-    QString _timeScaleVar;
-    QString _loopFlagVar;
-    QString _mirrorFlagVar;
-    QString _frameVar;
+    AnimVariantKey _startFrameVar;
+    AnimVariantKey _endFrameVar;
+    AnimVariantKey _timeScaleVar;
+    AnimVariantKey _loopFlagVar;
+    AnimVariantKey _mirrorFlagVar;
+    AnimVariantKey _frameVar;
 
     // no copies
     AnimClip(const AnimClip&) = delete;
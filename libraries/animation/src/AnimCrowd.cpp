@@ -0,0 +1,71 @@
+//
+//  AnimCrowd.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimCrowd.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "AnimClip.h"
+
+const float AnimCrowdClip::DEFAULT_FPS = 30.0f;
+
+AnimCrowdClipPointer AnimCrowdClip::fromGeometry(const FBXGeometry& animGeometry, float fps) {
+    auto clip = std::make_shared<AnimCrowdClip>();
+    auto skeleton = std::make_shared<AnimSkeleton>(animGeometry);
+    AnimClip::convertFrames(animGeometry, *skeleton, clip->frames);
+    clip->skeleton = skeleton;
+    clip->fps = fps;
+    return clip;
+}
+
+AnimCrowd::AnimCrowd(AnimCrowdClipPointer clip, int numAvatars) :
+    _clip(clip),
+    _endFrame((float)std::max((int)clip->frames.size() - 1, 0)),
+    _frames(numAvatars, 0.0f),
+    _prevIndices(numAvatars, 0),
+    _nextIndices(numAvatars, 0),
+    _alphas(numAvatars, 0.0f),
+    _relativePoses(clip->skeleton->getNumJoints(), numAvatars),
+    _absolutePoses(clip->skeleton->getNumJoints(), numAvatars)
+{
+}
+
+float AnimCrowd::wrapFrame(float frame) const {
+    // loops from the last frame straight back to the first, like a looping AnimClip
+    if (_endFrame <= 0.0f) {
+        return 0.0f;
+    }
+    frame = std::fmod(frame, _endFrame);
+    return frame < 0.0f ? frame + _endFrame : frame;
+}
+
+void AnimCrowd::setFrame(int avatarIndex, float frame) {
+    _frames[avatarIndex] = wrapFrame(frame);
+}
+
+void AnimCrowd::update(float dt) {
+    if (_clip->frames.empty()) {
+        return;
+    }
+
+    const int lastIndex = (int)_clip->frames.size() - 1;
+    const float frameStep = dt * _clip->fps;
+    for (size_t i = 0; i < _frames.size(); i++) {
+        float frame = wrapFrame(_frames[i] + frameStep);
+        _frames[i] = frame;
+        _prevIndices[i] = std::min((int)frame, lastIndex);
+        _nextIndices[i] = std::min(_prevIndices[i] + 1, lastIndex);
+        _alphas[i] = frame - std::floor(frame);
+    }
+
+    ::sampleFrames(_clip->frames, _prevIndices.data(), _nextIndices.data(), _alphas.data(), _relativePoses);
+    _absolutePoses = _relativePoses;
+    _clip->skeleton->convertRelativePosesToAbsolute(_absolutePoses);
+}
@@ -0,0 +1,66 @@
+//
+//  AnimCrowd.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimCrowd_h
+#define hifi_AnimCrowd_h
+
+#include <memory>
+#include <vector>
+
+#include "AnimPoseBatch.h"
+#include "AnimSkeleton.h"
+
+// An animation converted once for the skeleton it is played on, shared read-only by every crowd playing it.
+struct AnimCrowdClip {
+    static const float DEFAULT_FPS;
+
+    // plays the animation on its own skeleton
+    static std::shared_ptr<const AnimCrowdClip> fromGeometry(const FBXGeometry& animGeometry, float fps = DEFAULT_FPS);
+
+    AnimSkeleton::ConstPointer skeleton;
+    std::vector<AnimPoseVec> frames; // frames[frame][joint], relative to the parent joint
+    float fps { DEFAULT_FPS };
+};
+
+using AnimCrowdClipPointer = std::shared_ptr<const AnimCrowdClip>;
+
+// A crowd of avatars looping the same clip, each at its own frame. Every update samples the clip and converts the
+// poses to absolute for the whole crowd at once, in AnimPoseBatch layout, instead of avatar by avatar.
+//   AnimCrowd is not thread-safe, crowds on different threads can share the clip.
+class AnimCrowd {
+public:
+    AnimCrowd(AnimCrowdClipPointer clip, int numAvatars);
+
+    int getNumAvatars() const { return (int)_frames.size(); }
+
+    float getFrame(int avatarIndex) const { return _frames[avatarIndex]; }
+    void setFrame(int avatarIndex, float frame);
+
+    // advances every avatar by dt seconds, then evaluates their poses
+    void update(float dt);
+
+    const AnimPoseBatch& getRelativePoses() const { return _relativePoses; }
+    const AnimPoseBatch& getAbsolutePoses() const { return _absolutePoses; }
+
+protected:
+    float wrapFrame(float frame) const;
+
+    AnimCrowdClipPointer _clip;
+    float _endFrame { 0.0f };
+
+    std::vector<float> _frames;
+    std::vector<int> _prevIndices;
+    std::vector<int> _nextIndices;
+    std::vector<float> _alphas;
+
+    AnimPoseBatch _relativePoses;
+    AnimPoseBatch _absolutePoses;
+};
+
+#endif // hifi_AnimCrowd_h
@@ -83,8 +83,8 @@ protected:
             UnaryMinus
         };
         explicit OpCode(Type type) : type {type} {}
-        explicit OpCode(const QStringRef& strRef) : type {Type::Identifier}, strVal {strRef.toString()} {}
-        explicit OpCode(const QString& str) : type {Type::Identifier}, strVal {str} {}
+        explicit OpCode(const QStringRef& strRef) : type {Type::Identifier}, strVal {strRef.toString()}, key {strVal} {}
+        explicit OpCode(const QString& str) : type {Type::Identifier}, strVal {str}, key {str} {}
         explicit OpCode(int val) : type {Type::Int}, intVal {val} {}
         explicit OpCode(bool val) : type {Type::Bool}, intVal {(int)val} {}
         explicit OpCode(float val) : type {Type::Float}, floatVal {val} {}
@@ -93,7 +93,7 @@ protected:
             if (type == Int || type == Bool) {
                 return intVal != 0;
             } else if (type == Identifier) {
-                return map.lookup(strVal, false);
+                return map.lookup(key, false);
             } else {
                 return true;
             }
@@ -101,6 +101,7 @@ protected:
 
         Type type {Int};
         QString strVal;
+        AnimVariantKey key; // interned strVal, so identifiers are resolved without hashing at evaluation time
         int intVal {0};
         float floatVal {0.0f};
     };
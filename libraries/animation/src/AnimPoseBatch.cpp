@@ -0,0 +1,323 @@
+//
+//  AnimPoseBatch.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimPoseBatch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+static const float IDENTITY_COMPONENTS[AnimPoseBatch::NumComponents] = {
+    1.0f, 1.0f, 1.0f,       // scale
+    0.0f, 0.0f, 0.0f, 1.0f, // rot
+    0.0f, 0.0f, 0.0f        // trans
+};
+
+void AnimPoseBatch::resize(int numJoints, int numAvatars) {
+    _numJoints = numJoints;
+    _numAvatars = numAvatars;
+    _stride = ((numAvatars + LANE_WIDTH - 1) / LANE_WIDTH) * LANE_WIDTH;
+    _data.resize(_numJoints * NumComponents * _stride);
+    for (int i = 0; i < _numJoints; i++) {
+        for (int c = 0; c < NumComponents; c++) {
+            float* dst = get(i, (Component)c);
+            std::fill(dst, dst + _stride, IDENTITY_COMPONENTS[c]);
+        }
+    }
+}
+
+AnimPose AnimPoseBatch::getPose(int jointIndex, int avatarIndex) const {
+    assert(jointIndex >= 0 && jointIndex < _numJoints && avatarIndex >= 0 && avatarIndex < _numAvatars);
+    return AnimPose(glm::vec3(get(jointIndex, ScaleX)[avatarIndex], get(jointIndex, ScaleY)[avatarIndex], get(jointIndex, ScaleZ)[avatarIndex]),
+                    glm::quat(get(jointIndex, RotW)[avatarIndex], get(jointIndex, RotX)[avatarIndex],
+                              get(jointIndex, RotY)[avatarIndex], get(jointIndex, RotZ)[avatarIndex]),
+                    glm::vec3(get(jointIndex, TransX)[avatarIndex], get(jointIndex, TransY)[avatarIndex], get(jointIndex, TransZ)[avatarIndex]));
+}
+
+void AnimPoseBatch::setPose(int jointIndex, int avatarIndex, const AnimPose& pose) {
+    assert(jointIndex >= 0 && jointIndex < _numJoints && avatarIndex >= 0 && avatarIndex < _numAvatars);
+    get(jointIndex, ScaleX)[avatarIndex] = pose.scale().x;
+    get(jointIndex, ScaleY)[avatarIndex] = pose.scale().y;
+    get(jointIndex, ScaleZ)[avatarIndex] = pose.scale().z;
+    get(jointIndex, RotX)[avatarIndex] = pose.rot().x;
+    get(jointIndex, RotY)[avatarIndex] = pose.rot().y;
+    get(jointIndex, RotZ)[avatarIndex] = pose.rot().z;
+    get(jointIndex, RotW)[avatarIndex] = pose.rot().w;
+    get(jointIndex, TransX)[avatarIndex] = pose.trans().x;
+    get(jointIndex, TransY)[avatarIndex] = pose.trans().y;
+    get(jointIndex, TransZ)[avatarIndex] = pose.trans().z;
+}
+
+void AnimPoseBatch::getPoses(int avatarIndex, AnimPoseVec& poses) const {
+    poses.resize(_numJoints);
+    for (int i = 0; i < _numJoints; i++) {
+        poses[i] = getPose(i, avatarIndex);
+    }
+}
+
+void AnimPoseBatch::setPoses(int avatarIndex, const AnimPoseVec& poses) {
+    int numJoints = std::min((int)poses.size(), _numJoints);
+    for (int i = 0; i < numJoints; i++) {
+        setPose(i, avatarIndex, poses[i]);
+    }
+}
+
+//
+// LANE_WIDTH wide float vector used by the kernels below.
+//
+
+// on x86 architecture, assume that SSE2 is present
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+struct Lanes {
+    __m128 v;
+};
+
+static inline Lanes load(const float* src) { return { _mm_loadu_ps(src) }; }
+static inline void store(float* dst, Lanes a) { _mm_storeu_ps(dst, a.v); }
+static inline Lanes splat(float a) { return { _mm_set1_ps(a) }; }
+static inline Lanes operator+(Lanes a, Lanes b) { return { _mm_add_ps(a.v, b.v) }; }
+static inline Lanes operator-(Lanes a, Lanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+static inline Lanes operator*(Lanes a, Lanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+static inline Lanes operator/(Lanes a, Lanes b) { return { _mm_div_ps(a.v, b.v) }; }
+static inline Lanes sqrt(Lanes a) { return { _mm_sqrt_ps(a.v) }; }
+
+// a with the sign of b applied, i.e. -a where b is negative
+static inline Lanes mulSign(Lanes a, Lanes b) {
+    return { _mm_xor_ps(a.v, _mm_and_ps(b.v, _mm_set1_ps(-0.0f))) };
+}
+
+#else   // portable reference code
+
+struct Lanes {
+    float v[AnimPoseBatch::LANE_WIDTH];
+};
+
+#define LANES_FOR_EACH(expr) Lanes r; for (int i = 0; i < AnimPoseBatch::LANE_WIDTH; i++) { r.v[i] = expr; } return r
+
+static inline Lanes load(const float* src) { LANES_FOR_EACH(src[i]); }
+static inline void store(float* dst, Lanes a) { for (int i = 0; i < AnimPoseBatch::LANE_WIDTH; i++) { dst[i] = a.v[i]; } }
+static inline Lanes splat(float a) { LANES_FOR_EACH(a); }
+static inline Lanes operator+(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] + b.v[i]); }
+static inline Lanes operator-(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] - b.v[i]); }
+static inline Lanes operator*(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] * b.v[i]); }
+static inline Lanes operator/(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] / b.v[i]); }
+static inline Lanes sqrt(Lanes a) { LANES_FOR_EACH(sqrtf(a.v[i])); }
+static inline Lanes mulSign(Lanes a, Lanes b) { LANES_FOR_EACH(std::signbit(b.v[i]) ? -a.v[i] : a.v[i]); }
+
+#undef LANES_FOR_EACH
+
+#endif
+
+static inline Lanes lerp(Lanes a, Lanes b, Lanes alpha) {
+    return a + alpha * (b - a);
+}
+
+// same math as ::blend(), LANE_WIDTH poses at a time.
+// a, b and result point at the NumComponents component runs of one joint, offset to the first lane.
+static inline void blendLanes(const float* const* a, const float* const* b, Lanes alpha, float* const* result) {
+    for (int c = AnimPoseBatch::ScaleX; c <= AnimPoseBatch::ScaleZ; c++) {
+        store(result[c], lerp(load(a[c]), load(b[c]), alpha));
+    }
+    for (int c = AnimPoseBatch::TransX; c <= AnimPoseBatch::TransZ; c++) {
+        store(result[c], lerp(load(a[c]), load(b[c]), alpha));
+    }
+
+    // safeLerp(), flip b into the same hemisphere as a then normalize.
+    Lanes ax = load(a[AnimPoseBatch::RotX]);
+    Lanes ay = load(a[AnimPoseBatch::RotY]);
+    Lanes az = load(a[AnimPoseBatch::RotZ]);
+    Lanes aw = load(a[AnimPoseBatch::RotW]);
+    Lanes bx = load(b[AnimPoseBatch::RotX]);
+    Lanes by = load(b[AnimPoseBatch::RotY]);
+    Lanes bz = load(b[AnimPoseBatch::RotZ]);
+    Lanes bw = load(b[AnimPoseBatch::RotW]);
+    Lanes dot = ax * bx + ay * by + az * bz + aw * bw;
+    Lanes x = lerp(ax, mulSign(bx, dot), alpha);
+    Lanes y = lerp(ay, mulSign(by, dot), alpha);
+    Lanes z = lerp(az, mulSign(bz, dot), alpha);
+    Lanes w = lerp(aw, mulSign(bw, dot), alpha);
+    Lanes length = sqrt(x * x + y * y + z * z + w * w);
+    store(result[AnimPoseBatch::RotX], x / length);
+    store(result[AnimPoseBatch::RotY], y / length);
+    store(result[AnimPoseBatch::RotZ], z / length);
+    store(result[AnimPoseBatch::RotW], w / length);
+}
+
+// per lane alphas for the lane group starting at avatar laneStart, padding lanes get zero.
+static inline Lanes loadAlphas(const float* alphas, int laneStart, int numAvatars) {
+    if (laneStart + AnimPoseBatch::LANE_WIDTH <= numAvatars) {
+        return load(alphas + laneStart);
+    }
+    float padded[AnimPoseBatch::LANE_WIDTH] = { 0.0f };
+    for (int i = laneStart; i < numAvatars; i++) {
+        padded[i - laneStart] = alphas[i];
+    }
+    return load(padded);
+}
+
+static void blendBatch(const AnimPoseBatch& a, const AnimPoseBatch& b, const float* alphas, const float* jointWeights,
+                       AnimPoseBatch& result) {
+    assert(a.getNumJoints() == b.getNumJoints() && a.getNumJoints() == result.getNumJoints());
+    assert(a.getStride() == b.getStride() && a.getStride() == result.getStride());
+
+    const int numJoints = result.getNumJoints();
+    const int numAvatars = result.getNumAvatars();
+    const float* aComponents[AnimPoseBatch::NumComponents];
+    const float* bComponents[AnimPoseBatch::NumComponents];
+    float* resultComponents[AnimPoseBatch::NumComponents];
+
+    for (int laneStart = 0; laneStart < result.getStride(); laneStart += AnimPoseBatch::LANE_WIDTH) {
+        Lanes alpha = loadAlphas(alphas, laneStart, numAvatars);
+        for (int i = 0; i < numJoints; i++) {
+            for (int c = 0; c < AnimPoseBatch::NumComponents; c++) {
+                aComponents[c] = a.get(i, (AnimPoseBatch::Component)c) + laneStart;
+                bComponents[c] = b.get(i, (AnimPoseBatch::Component)c) + laneStart;
+                resultComponents[c] = result.get(i, (AnimPoseBatch::Component)c) + laneStart;
+            }
+            blendLanes(aComponents, bComponents, jointWeights ? alpha * splat(jointWeights[i]) : alpha, resultComponents);
+        }
+    }
+}
+
+void blend(const AnimPoseBatch& a, const AnimPoseBatch& b, const float* alphas, AnimPoseBatch& result) {
+    blendBatch(a, b, alphas, nullptr, result);
+}
+
+void blend(const AnimPoseBatch& a, const AnimPoseBatch& b, const float* alphas, const std::vector<float>& jointWeights,
+           AnimPoseBatch& result) {
+    assert((int)jointWeights.size() >= result.getNumJoints());
+    blendBatch(a, b, alphas, jointWeights.data(), result);
+}
+
+void multiply(const AnimPoseBatch& lhs, int lhsJoint, const AnimPoseBatch& rhs, int rhsJoint,
+              AnimPoseBatch& result, int resultJoint) {
+    assert(lhs.getStride() == rhs.getStride() && lhs.getStride() == result.getStride());
+
+    const float* ls[AnimPoseBatch::NumComponents];
+    const float* rs[AnimPoseBatch::NumComponents];
+    float* out[AnimPoseBatch::NumComponents];
+    for (int c = 0; c < AnimPoseBatch::NumComponents; c++) {
+        ls[c] = lhs.get(lhsJoint, (AnimPoseBatch::Component)c);
+        rs[c] = rhs.get(rhsJoint, (AnimPoseBatch::Component)c);
+        out[c] = result.get(resultJoint, (AnimPoseBatch::Component)c);
+    }
+
+    const Lanes TWO = splat(2.0f);
+    for (int i = 0; i < result.getStride(); i += AnimPoseBatch::LANE_WIDTH) {
+        Lanes lsx = load(ls[AnimPoseBatch::ScaleX] + i);
+        Lanes lsy = load(ls[AnimPoseBatch::ScaleY] + i);
+        Lanes lsz = load(ls[AnimPoseBatch::ScaleZ] + i);
+        Lanes lrx = load(ls[AnimPoseBatch::RotX] + i);
+        Lanes lry = load(ls[AnimPoseBatch::RotY] + i);
+        Lanes lrz = load(ls[AnimPoseBatch::RotZ] + i);
+        Lanes lrw = load(ls[AnimPoseBatch::RotW] + i);
+        Lanes rrx = load(rs[AnimPoseBatch::RotX] + i);
+        Lanes rry = load(rs[AnimPoseBatch::RotY] + i);
+        Lanes rrz = load(rs[AnimPoseBatch::RotZ] + i);
+        Lanes rrw = load(rs[AnimPoseBatch::RotW] + i);
+
+        // lhs.rot * (lhs.scale * rhs.trans), using v' = v + w * t + cross(q, t) where t = 2 * cross(q, v)
+        Lanes vx = lsx * load(rs[AnimPoseBatch::TransX] + i);
+        Lanes vy = lsy * load(rs[AnimPoseBatch::TransY] + i);
+        Lanes vz = lsz * load(rs[AnimPoseBatch::TransZ] + i);
+        Lanes tx = TWO * (lry * vz - lrz * vy);
+        Lanes ty = TWO * (lrz * vx - lrx * vz);
+        Lanes tz = TWO * (lrx * vy - lry * vx);
+        Lanes transX = load(ls[AnimPoseBatch::TransX] + i) + vx + lrw * tx + (lry * tz - lrz * ty);
+        Lanes transY = load(ls[AnimPoseBatch::TransY] + i) + vy + lrw * ty + (lrz * tx - lrx * tz);
+        Lanes transZ = load(ls[AnimPoseBatch::TransZ] + i) + vz + lrw * tz + (lrx * ty - lry * tx);
+
+        // lhs.rot * rhs.rot
+        Lanes rotX = lrw * rrx + lrx * rrw + lry * rrz - lrz * rry;
+        Lanes rotY = lrw * rry - lrx * rrz + lry * rrw + lrz * rrx;
+        Lanes rotZ = lrw * rrz + lrx * rry - lry * rrx + lrz * rrw;
+        Lanes rotW = lrw * rrw - lrx * rrx - lry * rry - lrz * rrz;
+
+        // all inputs are read before any output is written, so result may alias lhs or rhs.
+        Lanes scaleX = lsx * load(rs[AnimPoseBatch::ScaleX] + i);
+        Lanes scaleY = lsy * load(rs[AnimPoseBatch::ScaleY] + i);
+        Lanes scaleZ = lsz * load(rs[AnimPoseBatch::ScaleZ] + i);
+        store(out[AnimPoseBatch::ScaleX] + i, scaleX);
+        store(out[AnimPoseBatch::ScaleY] + i, scaleY);
+        store(out[AnimPoseBatch::ScaleZ] + i, scaleZ);
+        store(out[AnimPoseBatch::RotX] + i, rotX);
+        store(out[AnimPoseBatch::RotY] + i, rotY);
+        store(out[AnimPoseBatch::RotZ] + i, rotZ);
+        store(out[AnimPoseBatch::RotW] + i, rotW);
+        store(out[AnimPoseBatch::TransX] + i, transX);
+        store(out[AnimPoseBatch::TransY] + i, transY);
+        store(out[AnimPoseBatch::TransZ] + i, transZ);
+    }
+}
+
+// transpose one joint of LANE_WIDTH AoS poses into component runs.
+static inline void gatherPoses(const AnimPose* const* poses, float components[AnimPoseBatch::NumComponents][AnimPoseBatch::LANE_WIDTH]) {
+    for (int l = 0; l < AnimPoseBatch::LANE_WIDTH; l++) {
+        const AnimPose& pose = *poses[l];
+        components[AnimPoseBatch::ScaleX][l] = pose.scale().x;
+        components[AnimPoseBatch::ScaleY][l] = pose.scale().y;
+        components[AnimPoseBatch::ScaleZ][l] = pose.scale().z;
+        components[AnimPoseBatch::RotX][l] = pose.rot().x;
+        components[AnimPoseBatch::RotY][l] = pose.rot().y;
+        components[AnimPoseBatch::RotZ][l] = pose.rot().z;
+        components[AnimPoseBatch::RotW][l] = pose.rot().w;
+        components[AnimPoseBatch::TransX][l] = pose.trans().x;
+        components[AnimPoseBatch::TransY][l] = pose.trans().y;
+        components[AnimPoseBatch::TransZ][l] = pose.trans().z;
+    }
+}
+
+void sampleFrames(const std::vector<AnimPoseVec>& frames, const int* prevIndices, const int* nextIndices, const float* alphas,
+                  AnimPoseBatch& result) {
+    const int numAvatars = result.getNumAvatars();
+    if (frames.empty() || numAvatars == 0) {
+        return;
+    }
+    const int numJoints = std::min((int)frames[0].size(), result.getNumJoints());
+
+    float prevComponents[AnimPoseBatch::NumComponents][AnimPoseBatch::LANE_WIDTH];
+    float nextComponents[AnimPoseBatch::NumComponents][AnimPoseBatch::LANE_WIDTH];
+    const float* prevPointers[AnimPoseBatch::NumComponents];
+    const float* nextPointers[AnimPoseBatch::NumComponents];
+    float* resultPointers[AnimPoseBatch::NumComponents];
+    for (int c = 0; c < AnimPoseBatch::NumComponents; c++) {
+        prevPointers[c] = prevComponents[c];
+        nextPointers[c] = nextComponents[c];
+    }
+
+    const AnimPoseVec* prevFrames[AnimPoseBatch::LANE_WIDTH];
+    const AnimPoseVec* nextFrames[AnimPoseBatch::LANE_WIDTH];
+    const AnimPose* prevPoses[AnimPoseBatch::LANE_WIDTH];
+    const AnimPose* nextPoses[AnimPoseBatch::LANE_WIDTH];
+
+    for (int laneStart = 0; laneStart < result.getStride(); laneStart += AnimPoseBatch::LANE_WIDTH) {
+        Lanes alpha = loadAlphas(alphas, laneStart, numAvatars);
+        for (int l = 0; l < AnimPoseBatch::LANE_WIDTH; l++) {
+            int avatarIndex = laneStart + l;
+            prevFrames[l] = avatarIndex < numAvatars ? &frames[prevIndices[avatarIndex]] : nullptr;
+            nextFrames[l] = avatarIndex < numAvatars ? &frames[nextIndices[avatarIndex]] : nullptr;
+        }
+
+        for (int i = 0; i < numJoints; i++) {
+            for (int l = 0; l < AnimPoseBatch::LANE_WIDTH; l++) {
+                prevPoses[l] = prevFrames[l] ? &(*prevFrames[l])[i] : &AnimPose::identity;
+                nextPoses[l] = nextFrames[l] ? &(*nextFrames[l])[i] : &AnimPose::identity;
+            }
+            gatherPoses(prevPoses, prevComponents);
+            gatherPoses(nextPoses, nextComponents);
+            for (int c = 0; c < AnimPoseBatch::NumComponents; c++) {
+                resultPointers[c] = result.get(i, (AnimPoseBatch::Component)c) + laneStart;
+            }
+            blendLanes(prevPointers, nextPointers, alpha, resultPointers);
+        }
+    }
+}
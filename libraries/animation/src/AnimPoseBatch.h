@@ -0,0 +1,86 @@
+//
+//  AnimPoseBatch.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimPoseBatch_h
+#define hifi_AnimPoseBatch_h
+
+#include <vector>
+
+#include "AnimPose.h"
+
+// The poses of many avatars that share the same skeleton, stored as structure-of-arrays.
+// For every joint each pose component (scale.x, rot.w, trans.z, ...) is a contiguous run of floats, one per avatar,
+// so the blend and hierarchy kernels below can process LANE_WIDTH avatars per instruction.
+// The number of avatars is padded up to a multiple of LANE_WIDTH, the padding lanes hold identity poses.
+class AnimPoseBatch {
+public:
+    static const int LANE_WIDTH = 4;
+
+    enum Component {
+        ScaleX = 0,
+        ScaleY,
+        ScaleZ,
+        RotX,
+        RotY,
+        RotZ,
+        RotW,
+        TransX,
+        TransY,
+        TransZ,
+        NumComponents
+    };
+
+    AnimPoseBatch() {}
+    AnimPoseBatch(int numJoints, int numAvatars) { resize(numJoints, numAvatars); }
+
+    // resets every pose to identity
+    void resize(int numJoints, int numAvatars);
+
+    int getNumJoints() const { return _numJoints; }
+    int getNumAvatars() const { return _numAvatars; }
+    int getStride() const { return _stride; }
+
+    // getStride() floats, one per avatar
+    float* get(int jointIndex, Component component) { return &_data[(jointIndex * NumComponents + component) * _stride]; }
+    const float* get(int jointIndex, Component component) const { return &_data[(jointIndex * NumComponents + component) * _stride]; }
+
+    AnimPose getPose(int jointIndex, int avatarIndex) const;
+    void setPose(int jointIndex, int avatarIndex, const AnimPose& pose);
+
+    // copy one avatar's poses in/out of the batch, jointIndex order
+    void getPoses(int avatarIndex, AnimPoseVec& poses) const;
+    void setPoses(int avatarIndex, const AnimPoseVec& poses);
+
+protected:
+    std::vector<float> _data;
+    int _numJoints { 0 };
+    int _numAvatars { 0 };
+    int _stride { 0 };
+};
+
+// batched version of ::blend(), each avatar blends with its own alpha from alphas[avatarIndex].
+// result may be the same batch as a or b.
+void blend(const AnimPoseBatch& a, const AnimPoseBatch& b, const float* alphas, AnimPoseBatch& result);
+
+// same as above, but each avatar's alpha is scaled per joint by jointWeights[jointIndex], the way AnimOverlay applies its bone set.
+void blend(const AnimPoseBatch& a, const AnimPoseBatch& b, const float* alphas, const std::vector<float>& jointWeights,
+           AnimPoseBatch& result);
+
+// batched AnimPose::operator*, result[resultJoint] = lhs[lhsJoint] * rhs[rhsJoint] for every avatar.
+// Composes scale, rotation and translation directly instead of going through a matrix, which gives the same answer
+// as AnimPose::operator* for the uniformly scaled poses found in skeletons.  result may be the same batch as lhs or rhs.
+void multiply(const AnimPoseBatch& lhs, int lhsJoint, const AnimPoseBatch& rhs, int rhsJoint,
+              AnimPoseBatch& result, int resultJoint);
+
+// batched clip sampling, avatar i gets the blend of frames[prevIndices[i]] and frames[nextIndices[i]] by alphas[i].
+// frames is indexed [frame][joint] like AnimClip's animation, the indices must already be clamped to frames.size().
+void sampleFrames(const std::vector<AnimPoseVec>& frames, const int* prevIndices, const int* nextIndices, const float* alphas,
+                  AnimPoseBatch& result);
+
+#endif // hifi_AnimPoseBatch_h
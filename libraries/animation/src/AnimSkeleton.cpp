@@ -15,6 +15,7 @@
 #include <GLMHelpers.h>
 
 #include "AnimationLogging.h"
+#include "AnimPoseBatch.h"
 
 AnimSkeleton::AnimSkeleton(const FBXGeometry& fbxGeometry) {
     // convert to std::vector of joints
@@ -109,6 +110,17 @@ void AnimSkeleton::convertRelativePosesToAbsolute(AnimPoseVec& poses) const {
     }
 }
 
+void AnimSkeleton::convertRelativePosesToAbsolute(AnimPoseBatch& poses) const {
+    // parents come before their children, so each joint composes with an already absolute parent.
+    int lastIndex = std::min(poses.getNumJoints(), _jointsSize);
+    for (int i = 0; i < lastIndex; ++i) {
+        int parentIndex = _joints[i].parentIndex;
+        if (parentIndex != -1) {
+            ::multiply(poses, parentIndex, poses, i, poses, i);
+        }
+    }
+}
+
 void AnimSkeleton::convertAbsolutePosesToRelative(AnimPoseVec& poses) const {
     // poses start off absolute and leave in relative frame
     int lastIndex = std::min((int)poses.size(), _jointsSize);
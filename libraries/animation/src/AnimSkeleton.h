@@ -18,6 +18,8 @@
 #include <FBXReader.h>
 #include "AnimPose.h"
 
+class AnimPoseBatch;
+
 class AnimSkeleton {
 public:
     using Pointer = std::shared_ptr<AnimSkeleton>;
@@ -54,6 +56,7 @@ public:
     AnimPose getAbsolutePose(int jointIndex, const AnimPoseVec& relativePoses) const;
 
     void convertRelativePosesToAbsolute(AnimPoseVec& poses) const;
+    void convertRelativePosesToAbsolute(AnimPoseBatch& poses) const;
     void convertAbsolutePosesToRelative(AnimPoseVec& poses) const;
 
     void convertAbsoluteRotationsToRelative(std::vector<glm::quat>& rotations) const;
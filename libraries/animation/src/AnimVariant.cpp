@@ -12,11 +12,84 @@
 #include <QScriptEngine>
 #include <QScriptValueIterator>
 #include <QThread>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QVector>
 #include <RegisteredMetaTypes.h>
 #include "AnimVariant.h" // which has AnimVariant/AnimVariantMap
 
 const AnimVariant AnimVariant::False = AnimVariant();
 
+namespace {
+    // process wide table of interned anim var names.  Function local so it is safe to use from static initializers.
+    struct AnimVariantKeyRegistry {
+        QReadWriteLock lock;
+        QHash<QString, int> slots;
+        QVector<QString> names;
+    };
+
+    AnimVariantKeyRegistry& getKeyRegistry() {
+        static AnimVariantKeyRegistry registry;
+        return registry;
+    }
+}
+
+int AnimVariantKey::intern(const QString& name) {
+    if (name.isEmpty()) {
+        return -1;
+    }
+    auto& registry = getKeyRegistry();
+    {
+        QReadLocker locker(&registry.lock);
+        auto iter = registry.slots.constFind(name);
+        if (iter != registry.slots.constEnd()) {
+            return iter.value();
+        }
+    }
+    QWriteLocker locker(&registry.lock);
+    auto iter = registry.slots.constFind(name);
+    if (iter != registry.slots.constEnd()) {
+        return iter.value();
+    }
+    int slot = registry.names.size();
+    registry.names.push_back(name);
+    registry.slots.insert(name, slot);
+    return slot;
+}
+
+int AnimVariantKey::findSlot(const QString& name) {
+    auto& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return registry.slots.value(name, -1);
+}
+
+QString AnimVariantKey::getSlotName(int slot) {
+    auto& registry = getKeyRegistry();
+    QReadLocker locker(&registry.lock);
+    return (slot >= 0 && slot < registry.names.size()) ? registry.names[slot] : QString();
+}
+
+QString AnimVariantKey::getName() const {
+    return getSlotName(_slot);
+}
+
+void AnimVariantMap::setTrigger(const AnimVariantKey& key) {
+    if (key.isValid()) {
+        Entry& entry = editEntry(key.getSlot());
+        if (!entry.isTrigger) {
+            entry.isTrigger = true;
+            _triggerSlots.push_back(key.getSlot());
+        }
+    }
+}
+
+void AnimVariantMap::clearTriggers() {
+    for (int slot : _triggerSlots) {
+        _entries[slot].isTrigger = false;
+    }
+    _triggerSlots.clear();
+}
+
 QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const {
     if (QThread::currentThread() != engine->thread()) {
         qCWarning(animation) << "Cannot create Javacript object from non-script thread" << QThread::currentThread();
@@ -51,24 +124,37 @@ QScriptValue AnimVariantMap::animVariantMapToScriptValue(QScriptEngine* engine,
     };
     if (useNames) { // copy only the requested names
         for (const QString& name : names) {
-            auto search = _map.find(name);
-            if (search != _map.end()) {
-                setOne(name, search->second);
-            } else if (_triggers.count(name) == 1) {
+            // don't intern names the graph has never seen
+            int slot = AnimVariantKey::findSlot(name);
+            if (slot < 0 || slot >= (int)_entries.size()) {
+                continue; // scripts are allowed to request names that do not exist
+            }
+            const Entry& entry = _entries[slot];
+            if (entry.isSet) {
+                setOne(name, entry.value);
+            } else if (entry.isTrigger) {
                 target.setProperty(name, true);
-            } // scripts are allowed to request names that do not exist
+            }
         }
 
     } else {  // copy all of them
-        for (auto& pair : _map) {
-            setOne(pair.first, pair.second);
+        for (int slot = 0; slot < (int)_entries.size(); slot++) {
+            if (_entries[slot].isSet) {
+                setOne(AnimVariantKey::getSlotName(slot), _entries[slot].value);
+            }
         }
     }
     return target;
 }
 void AnimVariantMap::copyVariantsFrom(const AnimVariantMap& other) {
-    for (auto& pair : other._map) {
-        _map[pair.first] = pair.second;
+    if (other._entries.size() > _entries.size()) {
+        _entries.resize(other._entries.size());
+    }
+    for (size_t slot = 0; slot < other._entries.size(); slot++) {
+        if (other._entries[slot].isSet) {
+            _entries[slot].value = other._entries[slot].value;
+            _entries[slot].isSet = true;
+        }
     }
 }
 
@@ -15,8 +15,7 @@
 #include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
-#include <map>
-#include <set>
+#include <vector>
 #include <QScriptValue>
 #include <StreamUtils.h>
 #include <GLMHelpers.h>
@@ -114,120 +113,118 @@ protected:
     } _val;
 };
 
+// Name of an anim var interned into a small integer slot.
+// Every AnimVariantMap stores its values in a flat array indexed by these slots, so once the graph is loaded
+// the nodes look up their vars by index without hashing or comparing strings.
+class AnimVariantKey {
+public:
+    AnimVariantKey() {}
+    AnimVariantKey(const QString& name) : _slot(intern(name)) {}
+    AnimVariantKey(const char* name) : _slot(intern(QString(name))) {}
+
+    bool isValid() const { return _slot >= 0; }
+    int getSlot() const { return _slot; }
+    QString getName() const;
+
+    bool operator==(const AnimVariantKey& other) const { return _slot == other._slot; }
+    bool operator!=(const AnimVariantKey& other) const { return _slot != other._slot; }
+
+    // slot of an already interned name, -1 if the name was never interned
+    static int findSlot(const QString& name);
+    static QString getSlotName(int slot);
+
+private:
+    static int intern(const QString& name);
+
+    int _slot { -1 };
+};
+
 class AnimVariantMap {
 public:
 
-    bool lookup(const QString& key, bool defaultValue) const {
+    bool lookup(const AnimVariantKey& key, bool defaultValue) const {
         // check triggers first, then map
-        if (key.isEmpty()) {
+        const Entry* entry = findEntry(key);
+        if (!entry) {
             return defaultValue;
-        } else if (_triggers.find(key) != _triggers.end()) {
+        } else if (entry->isTrigger) {
             return true;
         } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getBool() : defaultValue;
+            return entry->isSet ? entry->value.getBool() : defaultValue;
         }
     }
 
-    int lookup(const QString& key, int defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getInt() : defaultValue;
-        }
+    int lookup(const AnimVariantKey& key, int defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getInt() : defaultValue;
     }
 
-    float lookup(const QString& key, float defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getFloat() : defaultValue;
-        }
+    float lookup(const AnimVariantKey& key, float defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getFloat() : defaultValue;
     }
 
-    const glm::vec3& lookupRaw(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getVec3() : defaultValue;
-        }
+    const glm::vec3& lookupRaw(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getVec3() : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometry(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformPoint(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometry(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? transformPoint(_rigToGeometryMat, value->getVec3()) : defaultValue;
     }
 
-    glm::vec3 lookupRigToGeometryVector(const QString& key, const glm::vec3& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? transformVectorFast(_rigToGeometryMat, iter->second.getVec3()) : defaultValue;
-        }
+    glm::vec3 lookupRigToGeometryVector(const AnimVariantKey& key, const glm::vec3& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? transformVectorFast(_rigToGeometryMat, value->getVec3()) : defaultValue;
     }
 
-    const glm::quat& lookupRaw(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getQuat() : defaultValue;
-        }
+    const glm::quat& lookupRaw(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getQuat() : defaultValue;
     }
 
-    glm::quat lookupRigToGeometry(const QString& key, const glm::quat& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? _rigToGeometryRot * iter->second.getQuat() : defaultValue;
-        }
+    glm::quat lookupRigToGeometry(const AnimVariantKey& key, const glm::quat& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? _rigToGeometryRot * value->getQuat() : defaultValue;
     }
 
-    const QString& lookup(const QString& key, const QString& defaultValue) const {
-        if (key.isEmpty()) {
-            return defaultValue;
-        } else {
-            auto iter = _map.find(key);
-            return iter != _map.end() ? iter->second.getString() : defaultValue;
-        }
+    const QString& lookup(const AnimVariantKey& key, const QString& defaultValue) const {
+        const AnimVariant* value = find(key);
+        return value ? value->getString() : defaultValue;
     }
 
-    void set(const QString& key, bool value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, int value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, float value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::vec3& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const glm::quat& value) { _map[key] = AnimVariant(value); }
-    void set(const QString& key, const QString& value) { _map[key] = AnimVariant(value); }
-    void unset(const QString& key) { _map.erase(key); }
+    void set(const AnimVariantKey& key, bool value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, int value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, float value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::vec3& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const glm::quat& value) { setVariant(key, AnimVariant(value)); }
+    void set(const AnimVariantKey& key, const QString& value) { setVariant(key, AnimVariant(value)); }
+    void unset(const AnimVariantKey& key) {
+        if (key.isValid() && key.getSlot() < (int)_entries.size()) {
+            _entries[key.getSlot()].isSet = false;
+        }
+    }
 
-    void setTrigger(const QString& key) { _triggers.insert(key); }
-    void clearTriggers() { _triggers.clear(); }
+    void setTrigger(const AnimVariantKey& key);
+    void clearTriggers();
 
     void setRigToGeometryTransform(const glm::mat4& rigToGeometry) {
         _rigToGeometryMat = rigToGeometry;
         _rigToGeometryRot = glmExtractRotation(rigToGeometry);
     }
 
-    void clearMap() { _map.clear(); }
-    bool hasKey(const QString& key) const { return _map.find(key) != _map.end(); }
-
-    const AnimVariant& get(const QString& key) const {
-        auto iter = _map.find(key);
-        if (iter != _map.end()) {
-            return iter->second;
-        } else {
-            return AnimVariant::False;
+    void clearMap() {
+        for (auto& entry : _entries) {
+            entry.isSet = false;
         }
     }
+    bool hasKey(const AnimVariantKey& key) const { return find(key) != nullptr; }
+
+    const AnimVariant& get(const AnimVariantKey& key) const {
+        const AnimVariant* value = find(key);
+        return value ? *value : AnimVariant::False;
+    }
 
     // Answer a Plain Old Javascript Object (for the given engine) all of our values set as properties.
     QScriptValue animVariantMapToScriptValue(QScriptEngine* engine, const QStringList& names, bool useNames) const;
@@ -238,25 +235,30 @@ public:
 #ifdef NDEBUG
     void dump() const {
         qCDebug(animation) << "AnimVariantMap =";
-        for (auto& pair : _map) {
-            switch (pair.second.getType()) {
+        for (int slot = 0; slot < (int)_entries.size(); slot++) {
+            if (!_entries[slot].isSet) {
+                continue;
+            }
+            const AnimVariant& value = _entries[slot].value;
+            QString name = AnimVariantKey::getSlotName(slot);
+            switch (value.getType()) {
             case AnimVariant::Type::Bool:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getBool();
+                qCDebug(animation) << "    " << name << "=" << value.getBool();
                 break;
             case AnimVariant::Type::Int:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getInt();
+                qCDebug(animation) << "    " << name << "=" << value.getInt();
                 break;
             case AnimVariant::Type::Float:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getFloat();
+                qCDebug(animation) << "    " << name << "=" << value.getFloat();
                 break;
             case AnimVariant::Type::Vec3:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getVec3();
+                qCDebug(animation) << "    " << name << "=" << value.getVec3();
                 break;
             case AnimVariant::Type::Quat:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getQuat();
+                qCDebug(animation) << "    " << name << "=" << value.getQuat();
                 break;
             case AnimVariant::Type::String:
-                qCDebug(animation) << "    " << pair.first << "=" << pair.second.getString();
+                qCDebug(animation) << "    " << name << "=" << value.getString();
                 break;
             default:
                 assert(("invalid AnimVariant::Type", false));
@@ -266,8 +268,38 @@ public:
 #endif
 
 protected:
-    std::map<QString, AnimVariant> _map;
-    std::set<QString> _triggers;
+    struct Entry {
+        AnimVariant value;
+        bool isSet { false };
+        bool isTrigger { false };
+    };
+
+    const Entry* findEntry(const AnimVariantKey& key) const {
+        return (key.isValid() && key.getSlot() < (int)_entries.size()) ? &_entries[key.getSlot()] : nullptr;
+    }
+
+    const AnimVariant* find(const AnimVariantKey& key) const {
+        const Entry* entry = findEntry(key);
+        return (entry && entry->isSet) ? &entry->value : nullptr;
+    }
+
+    Entry& editEntry(int slot) {
+        if (slot >= (int)_entries.size()) {
+            _entries.resize(slot + 1);
+        }
+        return _entries[slot];
+    }
+
+    void setVariant(const AnimVariantKey& key, const AnimVariant& value) {
+        if (key.isValid()) {
+            Entry& entry = editEntry(key.getSlot());
+            entry.value = value;
+            entry.isSet = true;
+        }
+    }
+
+    std::vector<Entry> _entries; // indexed by AnimVariantKey slot
+    std::vector<int> _triggerSlots;
     glm::mat4 _rigToGeometryMat;
     glm::quat _rigToGeometryRot;
 };
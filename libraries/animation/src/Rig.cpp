@@ -59,6 +59,75 @@ const glm::vec3 DEFAULT_RIGHT_EYE_POS(-0.3f, 0.9f, 0.0f);
 const glm::vec3 DEFAULT_LEFT_EYE_POS(0.3f, 0.9f, 0.0f);
 const glm::vec3 DEFAULT_HEAD_POS(0.0f, 0.75f, 0.0f);
 
+// Anim vars set by the rig every frame, interned once instead of on every set
+static const AnimVariantKey USER_ANIM_NONE_VAR("userAnimNone");
+static const AnimVariantKey USER_ANIM_A_VAR("userAnimA");
+static const AnimVariantKey USER_ANIM_B_VAR("userAnimB");
+static const AnimVariantKey SINE_VAR("sine");
+static const AnimVariantKey MOVE_FORWARD_SPEED_VAR("moveForwardSpeed");
+static const AnimVariantKey MOVE_FORWARD_ALPHA_VAR("moveForwardAlpha");
+static const AnimVariantKey MOVE_BACKWARD_SPEED_VAR("moveBackwardSpeed");
+static const AnimVariantKey MOVE_BACKWARD_ALPHA_VAR("moveBackwardAlpha");
+static const AnimVariantKey MOVE_LATERAL_SPEED_VAR("moveLateralSpeed");
+static const AnimVariantKey MOVE_LATERAL_ALPHA_VAR("moveLateralAlpha");
+static const AnimVariantKey IS_MOVING_FORWARD_VAR("isMovingForward");
+static const AnimVariantKey IS_MOVING_BACKWARD_VAR("isMovingBackward");
+static const AnimVariantKey IS_MOVING_RIGHT_VAR("isMovingRight");
+static const AnimVariantKey IS_MOVING_LEFT_VAR("isMovingLeft");
+static const AnimVariantKey IS_NOT_MOVING_VAR("isNotMoving");
+static const AnimVariantKey IS_TURNING_LEFT_VAR("isTurningLeft");
+static const AnimVariantKey IS_TURNING_RIGHT_VAR("isTurningRight");
+static const AnimVariantKey IS_NOT_TURNING_VAR("isNotTurning");
+static const AnimVariantKey IS_FLYING_VAR("isFlying");
+static const AnimVariantKey IS_NOT_FLYING_VAR("isNotFlying");
+static const AnimVariantKey IS_TAKEOFF_STAND_VAR("isTakeoffStand");
+static const AnimVariantKey IS_TAKEOFF_RUN_VAR("isTakeoffRun");
+static const AnimVariantKey IS_NOT_TAKEOFF_VAR("isNotTakeoff");
+static const AnimVariantKey IS_IN_AIR_STAND_VAR("isInAirStand");
+static const AnimVariantKey IS_IN_AIR_RUN_VAR("isInAirRun");
+static const AnimVariantKey IS_NOT_IN_AIR_VAR("isNotInAir");
+static const AnimVariantKey IN_AIR_ALPHA_VAR("inAirAlpha");
+static const AnimVariantKey IK_OVERLAY_ALPHA_VAR("ikOverlayAlpha");
+static const AnimVariantKey HEAD_POSITION_VAR("headPosition");
+static const AnimVariantKey HEAD_ROTATION_VAR("headRotation");
+static const AnimVariantKey HEAD_TYPE_VAR("headType");
+static const AnimVariantKey HEAD_WEIGHT_VAR("headWeight");
+static const AnimVariantKey LEFT_HAND_POSITION_VAR("leftHandPosition");
+static const AnimVariantKey LEFT_HAND_ROTATION_VAR("leftHandRotation");
+static const AnimVariantKey LEFT_HAND_TYPE_VAR("leftHandType");
+static const AnimVariantKey LEFT_HAND_POLE_VECTOR_ENABLED_VAR("leftHandPoleVectorEnabled");
+static const AnimVariantKey LEFT_HAND_POLE_REFERENCE_VECTOR_VAR("leftHandPoleReferenceVector");
+static const AnimVariantKey LEFT_HAND_POLE_VECTOR_VAR("leftHandPoleVector");
+static const AnimVariantKey RIGHT_HAND_POSITION_VAR("rightHandPosition");
+static const AnimVariantKey RIGHT_HAND_ROTATION_VAR("rightHandRotation");
+static const AnimVariantKey RIGHT_HAND_TYPE_VAR("rightHandType");
+static const AnimVariantKey RIGHT_HAND_POLE_VECTOR_ENABLED_VAR("rightHandPoleVectorEnabled");
+static const AnimVariantKey RIGHT_HAND_POLE_REFERENCE_VECTOR_VAR("rightHandPoleReferenceVector");
+static const AnimVariantKey RIGHT_HAND_POLE_VECTOR_VAR("rightHandPoleVector");
+static const AnimVariantKey LEFT_FOOT_POSITION_VAR("leftFootPosition");
+static const AnimVariantKey LEFT_FOOT_ROTATION_VAR("leftFootRotation");
+static const AnimVariantKey LEFT_FOOT_TYPE_VAR("leftFootType");
+static const AnimVariantKey LEFT_FOOT_POLE_VECTOR_ENABLED_VAR("leftFootPoleVectorEnabled");
+static const AnimVariantKey LEFT_FOOT_POLE_REFERENCE_VECTOR_VAR("leftFootPoleReferenceVector");
+static const AnimVariantKey LEFT_FOOT_POLE_VECTOR_VAR("leftFootPoleVector");
+static const AnimVariantKey RIGHT_FOOT_POSITION_VAR("rightFootPosition");
+static const AnimVariantKey RIGHT_FOOT_ROTATION_VAR("rightFootRotation");
+static const AnimVariantKey RIGHT_FOOT_TYPE_VAR("rightFootType");
+static const AnimVariantKey RIGHT_FOOT_POLE_VECTOR_ENABLED_VAR("rightFootPoleVectorEnabled");
+static const AnimVariantKey RIGHT_FOOT_POLE_REFERENCE_VECTOR_VAR("rightFootPoleReferenceVector");
+static const AnimVariantKey RIGHT_FOOT_POLE_VECTOR_VAR("rightFootPoleVector");
+static const AnimVariantKey IS_TALKING_VAR("isTalking");
+static const AnimVariantKey NOT_IS_TALKING_VAR("notIsTalking");
+static const AnimVariantKey SOLUTION_SOURCE_VAR("solutionSource");
+static const AnimVariantKey DEFAULT_POSE_OVERLAY_ALPHA_VAR("defaultPoseOverlayAlpha");
+static const AnimVariantKey DEFAULT_POSE_OVERLAY_BONE_SET_VAR("defaultPoseOverlayBoneSet");
+static const AnimVariantKey HIPS_TYPE_VAR("hipsType");
+static const AnimVariantKey HIPS_POSITION_VAR("hipsPosition");
+static const AnimVariantKey HIPS_ROTATION_VAR("hipsRotation");
+static const AnimVariantKey SPINE2_TYPE_VAR("spine2Type");
+static const AnimVariantKey SPINE2_POSITION_VAR("spine2Position");
+static const AnimVariantKey SPINE2_ROTATION_VAR("spine2Rotation");
+
 Rig::Rig() {
     // Ensure thread-safe access to the rigRegistry.
     std::lock_guard<std::mutex> guard(rigRegistryMutex);
@@ -113,9 +182,9 @@ void Rig::overrideAnimation(const QString& url, float fps, bool loop, float firs
     _userAnimState = { clipNodeEnum, url, fps, loop, firstFrame, lastFrame };
 
     // notify the userAnimStateMachine the desired state.
-    _animVars.set("userAnimNone", false);
-    _animVars.set("userAnimA", clipNodeEnum == UserAnimState::A);
-    _animVars.set("userAnimB", clipNodeEnum == UserAnimState::B);
+    _animVars.set(USER_ANIM_NONE_VAR, false);
+    _animVars.set(USER_ANIM_A_VAR, clipNodeEnum == UserAnimState::A);
+    _animVars.set(USER_ANIM_B_VAR, clipNodeEnum == UserAnimState::B);
 }
 
 void Rig::restoreAnimation() {
@@ -123,9 +192,9 @@ void Rig::restoreAnimation() {
         _userAnimState.clipNodeEnum = UserAnimState::None;
 
         // notify the userAnimStateMachine the desired state.
-        _animVars.set("userAnimNone", true);
-        _animVars.set("userAnimA", false);
-        _animVars.set("userAnimB", false);
+        _animVars.set(USER_ANIM_NONE_VAR, true);
+        _animVars.set(USER_ANIM_A_VAR, false);
+        _animVars.set(USER_ANIM_B_VAR, false);
     }
 }
 
@@ -638,7 +707,7 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
 
         // sine wave LFO var for testing.
         static float t = 0.0f;
-        _animVars.set("sine", 2.0f * 0.5f * sinf(t) + 0.5f);
+        _animVars.set(SINE_VAR, 2.0f * 0.5f * sinf(t) + 0.5f);
 
         float moveForwardAlpha = 0.0f;
         float moveBackwardAlpha = 0.0f;
@@ -649,14 +718,14 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
         calcAnimAlpha(-_averageForwardSpeed.getAverage(), BACKWARD_SPEEDS, &moveBackwardAlpha);
         calcAnimAlpha(fabsf(_averageLateralSpeed.getAverage()), LATERAL_SPEEDS, &moveLateralAlpha);
 
-        _animVars.set("moveForwardSpeed", _averageForwardSpeed.getAverage());
-        _animVars.set("moveForwardAlpha", moveForwardAlpha);
+        _animVars.set(MOVE_FORWARD_SPEED_VAR, _averageForwardSpeed.getAverage());
+        _animVars.set(MOVE_FORWARD_ALPHA_VAR, moveForwardAlpha);
 
-        _animVars.set("moveBackwardSpeed", -_averageForwardSpeed.getAverage());
-        _animVars.set("moveBackwardAlpha", moveBackwardAlpha);
+        _animVars.set(MOVE_BACKWARD_SPEED_VAR, -_averageForwardSpeed.getAverage());
+        _animVars.set(MOVE_BACKWARD_ALPHA_VAR, moveBackwardAlpha);
 
-        _animVars.set("moveLateralSpeed", fabsf(_averageLateralSpeed.getAverage()));
-        _animVars.set("moveLateralAlpha", moveLateralAlpha);
+        _animVars.set(MOVE_LATERAL_SPEED_VAR, fabsf(_averageLateralSpeed.getAverage()));
+        _animVars.set(MOVE_LATERAL_ALPHA_VAR, moveLateralAlpha);
 
         const float MOVE_ENTER_SPEED_THRESHOLD = 0.2f; // m/sec
         const float MOVE_EXIT_SPEED_THRESHOLD = 0.07f;  // m/sec
@@ -737,180 +806,180 @@ void Rig::computeMotionAnimationState(float deltaTime, const glm::vec3& worldPos
                 if (fabsf(forwardSpeed) > 0.5f * fabsf(lateralSpeed)) {
                     if (forwardSpeed > 0.0f) {
                         // forward
-                        _animVars.set("isMovingForward", true);
-                        _animVars.set("isMovingBackward", false);
-                        _animVars.set("isMovingRight", false);
-                        _animVars.set("isMovingLeft", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, true);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, false);
+                        _animVars.set(IS_MOVING_LEFT_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
 
                     } else {
                         // backward
-                        _animVars.set("isMovingBackward", true);
-                        _animVars.set("isMovingForward", false);
-                        _animVars.set("isMovingRight", false);
-                        _animVars.set("isMovingLeft", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, true);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, false);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, false);
+                        _animVars.set(IS_MOVING_LEFT_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
                     }
                 } else {
                     if (lateralSpeed > 0.0f) {
                         // right
-                        _animVars.set("isMovingRight", true);
-                        _animVars.set("isMovingLeft", false);
-                        _animVars.set("isMovingForward", false);
-                        _animVars.set("isMovingBackward", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, true);
+                        _animVars.set(IS_MOVING_LEFT_VAR, false);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, false);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
                     } else {
                         // left
-                        _animVars.set("isMovingLeft", true);
-                        _animVars.set("isMovingRight", false);
-                        _animVars.set("isMovingForward", false);
-                        _animVars.set("isMovingBackward", false);
-                        _animVars.set("isNotMoving", false);
+                        _animVars.set(IS_MOVING_LEFT_VAR, true);
+                        _animVars.set(IS_MOVING_RIGHT_VAR, false);
+                        _animVars.set(IS_MOVING_FORWARD_VAR, false);
+                        _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+                        _animVars.set(IS_NOT_MOVING_VAR, false);
                     }
                 }
             }
-            _animVars.set("isTurningLeft", false);
-            _animVars.set("isTurningRight", false);
-            _animVars.set("isNotTurning", true);
-            _animVars.set("isFlying", false);
-            _animVars.set("isNotFlying", true);
-            _animVars.set("isTakeoffStand", false);
-            _animVars.set("isTakeoffRun", false);
-            _animVars.set("isNotTakeoff", true);
-            _animVars.set("isInAirStand", false);
-            _animVars.set("isInAirRun", false);
-            _animVars.set("isNotInAir", true);
+            _animVars.set(IS_TURNING_LEFT_VAR, false);
+            _animVars.set(IS_TURNING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_TURNING_VAR, true);
+            _animVars.set(IS_FLYING_VAR, false);
+            _animVars.set(IS_NOT_FLYING_VAR, true);
+            _animVars.set(IS_TAKEOFF_STAND_VAR, false);
+            _animVars.set(IS_TAKEOFF_RUN_VAR, false);
+            _animVars.set(IS_NOT_TAKEOFF_VAR, true);
+            _animVars.set(IS_IN_AIR_STAND_VAR, false);
+            _animVars.set(IS_IN_AIR_RUN_VAR, false);
+            _animVars.set(IS_NOT_IN_AIR_VAR, true);
 
         } else if (_state == RigRole::Turn) {
             if (turningSpeed > 0.0f) {
                 // turning right
-                _animVars.set("isTurningRight", true);
-                _animVars.set("isTurningLeft", false);
-                _animVars.set("isNotTurning", false);
+                _animVars.set(IS_TURNING_RIGHT_VAR, true);
+                _animVars.set(IS_TURNING_LEFT_VAR, false);
+                _animVars.set(IS_NOT_TURNING_VAR, false);
             } else {
                 // turning left
-                _animVars.set("isTurningLeft", true);
-                _animVars.set("isTurningRight", false);
-                _animVars.set("isNotTurning", false);
+                _animVars.set(IS_TURNING_LEFT_VAR, true);
+                _animVars.set(IS_TURNING_RIGHT_VAR, false);
+                _animVars.set(IS_NOT_TURNING_VAR, false);
             }
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isNotMoving", true);
-            _animVars.set("isFlying", false);
-            _animVars.set("isNotFlying", true);
-            _animVars.set("isTakeoffStand", false);
-            _animVars.set("isTakeoffRun", false);
-            _animVars.set("isNotTakeoff", true);
-            _animVars.set("isInAirStand", false);
-            _animVars.set("isInAirRun", false);
-            _animVars.set("isNotInAir", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
+            _animVars.set(IS_FLYING_VAR, false);
+            _animVars.set(IS_NOT_FLYING_VAR, true);
+            _animVars.set(IS_TAKEOFF_STAND_VAR, false);
+            _animVars.set(IS_TAKEOFF_RUN_VAR, false);
+            _animVars.set(IS_NOT_TAKEOFF_VAR, true);
+            _animVars.set(IS_IN_AIR_STAND_VAR, false);
+            _animVars.set(IS_IN_AIR_RUN_VAR, false);
+            _animVars.set(IS_NOT_IN_AIR_VAR, true);
 
         } else if (_state == RigRole::Idle ) {
             // default anim vars to notMoving and notTurning
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isNotMoving", true);
-            _animVars.set("isTurningLeft", false);
-            _animVars.set("isTurningRight", false);
-            _animVars.set("isNotTurning", true);
-            _animVars.set("isFlying", false);
-            _animVars.set("isNotFlying", true);
-            _animVars.set("isTakeoffStand", false);
-            _animVars.set("isTakeoffRun", false);
-            _animVars.set("isNotTakeoff", true);
-            _animVars.set("isInAirStand", false);
-            _animVars.set("isInAirRun", false);
-            _animVars.set("isNotInAir", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
+            _animVars.set(IS_TURNING_LEFT_VAR, false);
+            _animVars.set(IS_TURNING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_TURNING_VAR, true);
+            _animVars.set(IS_FLYING_VAR, false);
+            _animVars.set(IS_NOT_FLYING_VAR, true);
+            _animVars.set(IS_TAKEOFF_STAND_VAR, false);
+            _animVars.set(IS_TAKEOFF_RUN_VAR, false);
+            _animVars.set(IS_NOT_TAKEOFF_VAR, true);
+            _animVars.set(IS_IN_AIR_STAND_VAR, false);
+            _animVars.set(IS_IN_AIR_RUN_VAR, false);
+            _animVars.set(IS_NOT_IN_AIR_VAR, true);
 
         } else if (_state == RigRole::Hover) {
             // flying.
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isNotMoving", true);
-            _animVars.set("isTurningLeft", false);
-            _animVars.set("isTurningRight", false);
-            _animVars.set("isNotTurning", true);
-            _animVars.set("isFlying", true);
-            _animVars.set("isNotFlying", false);
-            _animVars.set("isTakeoffStand", false);
-            _animVars.set("isTakeoffRun", false);
-            _animVars.set("isNotTakeoff", true);
-            _animVars.set("isInAirStand", false);
-            _animVars.set("isInAirRun", false);
-            _animVars.set("isNotInAir", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
+            _animVars.set(IS_TURNING_LEFT_VAR, false);
+            _animVars.set(IS_TURNING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_TURNING_VAR, true);
+            _animVars.set(IS_FLYING_VAR, true);
+            _animVars.set(IS_NOT_FLYING_VAR, false);
+            _animVars.set(IS_TAKEOFF_STAND_VAR, false);
+            _animVars.set(IS_TAKEOFF_RUN_VAR, false);
+            _animVars.set(IS_NOT_TAKEOFF_VAR, true);
+            _animVars.set(IS_IN_AIR_STAND_VAR, false);
+            _animVars.set(IS_IN_AIR_RUN_VAR, false);
+            _animVars.set(IS_NOT_IN_AIR_VAR, true);
 
         } else if (_state == RigRole::Takeoff) {
             // jumping in-air
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isNotMoving", true);
-            _animVars.set("isTurningLeft", false);
-            _animVars.set("isTurningRight", false);
-            _animVars.set("isNotTurning", true);
-            _animVars.set("isFlying", false);
-            _animVars.set("isNotFlying", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
+            _animVars.set(IS_TURNING_LEFT_VAR, false);
+            _animVars.set(IS_TURNING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_TURNING_VAR, true);
+            _animVars.set(IS_FLYING_VAR, false);
+            _animVars.set(IS_NOT_FLYING_VAR, true);
 
             bool takeOffRun = forwardSpeed > 0.1f;
             if (takeOffRun) {
-                _animVars.set("isTakeoffStand", false);
-                _animVars.set("isTakeoffRun", true);
+                _animVars.set(IS_TAKEOFF_STAND_VAR, false);
+                _animVars.set(IS_TAKEOFF_RUN_VAR, true);
             } else {
-                _animVars.set("isTakeoffStand", true);
-                _animVars.set("isTakeoffRun", false);
+                _animVars.set(IS_TAKEOFF_STAND_VAR, true);
+                _animVars.set(IS_TAKEOFF_RUN_VAR, false);
             }
 
-            _animVars.set("isNotTakeoff", false);
-            _animVars.set("isInAirStand", false);
-            _animVars.set("isInAirRun", false);
-            _animVars.set("isNotInAir", false);
+            _animVars.set(IS_NOT_TAKEOFF_VAR, false);
+            _animVars.set(IS_IN_AIR_STAND_VAR, false);
+            _animVars.set(IS_IN_AIR_RUN_VAR, false);
+            _animVars.set(IS_NOT_IN_AIR_VAR, false);
 
         } else if (_state == RigRole::InAir) {
             // jumping in-air
-            _animVars.set("isMovingForward", false);
-            _animVars.set("isMovingBackward", false);
-            _animVars.set("isMovingLeft", false);
-            _animVars.set("isMovingRight", false);
-            _animVars.set("isNotMoving", true);
-            _animVars.set("isTurningLeft", false);
-            _animVars.set("isTurningRight", false);
-            _animVars.set("isNotTurning", true);
-            _animVars.set("isFlying", false);
-            _animVars.set("isNotFlying", true);
-            _animVars.set("isTakeoffStand", false);
-            _animVars.set("isTakeoffRun", false);
-            _animVars.set("isNotTakeoff", true);
+            _animVars.set(IS_MOVING_FORWARD_VAR, false);
+            _animVars.set(IS_MOVING_BACKWARD_VAR, false);
+            _animVars.set(IS_MOVING_LEFT_VAR, false);
+            _animVars.set(IS_MOVING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_MOVING_VAR, true);
+            _animVars.set(IS_TURNING_LEFT_VAR, false);
+            _animVars.set(IS_TURNING_RIGHT_VAR, false);
+            _animVars.set(IS_NOT_TURNING_VAR, true);
+            _animVars.set(IS_FLYING_VAR, false);
+            _animVars.set(IS_NOT_FLYING_VAR, true);
+            _animVars.set(IS_TAKEOFF_STAND_VAR, false);
+            _animVars.set(IS_TAKEOFF_RUN_VAR, false);
+            _animVars.set(IS_NOT_TAKEOFF_VAR, true);
 
             bool inAirRun = forwardSpeed > 0.1f;
             if (inAirRun) {
-                _animVars.set("isInAirStand", false);
-                _animVars.set("isInAirRun", true);
+                _animVars.set(IS_IN_AIR_STAND_VAR, false);
+                _animVars.set(IS_IN_AIR_RUN_VAR, true);
             } else {
-                _animVars.set("isInAirStand", true);
-                _animVars.set("isInAirRun", false);
+                _animVars.set(IS_IN_AIR_STAND_VAR, true);
+                _animVars.set(IS_IN_AIR_RUN_VAR, false);
             }
-            _animVars.set("isNotInAir", false);
+            _animVars.set(IS_NOT_IN_AIR_VAR, false);
 
             // compute blend based on velocity
             const float JUMP_SPEED = 3.5f;
             float alpha = glm::clamp(-_lastVelocity.y / JUMP_SPEED, -1.0f, 1.0f) + 1.0f;
-            _animVars.set("inAirAlpha", alpha);
+            _animVars.set(IN_AIR_ALPHA_VAR, alpha);
         }
 
         t += deltaTime;
 
         if (_enableInverseKinematics != _lastEnableInverseKinematics) {
             if (_enableInverseKinematics) {
-                _animVars.set("ikOverlayAlpha", 1.0f);
+                _animVars.set(IK_OVERLAY_ALPHA_VAR, 1.0f);
             } else {
-                _animVars.set("ikOverlayAlpha", 0.0f);
+                _animVars.set(IK_OVERLAY_ALPHA_VAR, 0.0f);
             }
         }
         _lastEnableInverseKinematics = _enableInverseKinematics;
@@ -1008,7 +1077,7 @@ void Rig::updateAnimationStateHandlers() { // called on avatar update thread (wh
 
         // Gather results in (likely from an earlier update).
         // Note: the behavior is undefined if a handler (re-)sets a trigger. Scripts should not be doing that.
-        _animVars.copyVariantsFrom(value.results); // If multiple handlers write the same anim var, the last registgered wins. (_map preserves order).
+        _animVars.copyVariantsFrom(value.results); // If multiple handlers write the same anim var, the last registgered wins.
     }
 }
 
@@ -1129,23 +1198,23 @@ void Rig::computeHeadFromHMD(const AnimPose& hmdPose, glm::vec3& headPositionOut
 void Rig::updateHead(bool headEnabled, bool hipsEnabled, const AnimPose& headPose) {
     if (_animSkeleton) {
         if (headEnabled) {
-            _animVars.set("headPosition", headPose.trans());
-            _animVars.set("headRotation", headPose.rot());
+            _animVars.set(HEAD_POSITION_VAR, headPose.trans());
+            _animVars.set(HEAD_ROTATION_VAR, headPose.rot());
             if (hipsEnabled) {
                 // Since there is an explicit hips ik target, switch the head to use the more flexible Spline IK chain type.
                 // this will allow the spine to compress/expand and bend more natrually, ensuring that it can reach the head target position.
-                _animVars.set("headType", (int)IKTarget::Type::Spline);
-                _animVars.unset("headWeight");  // use the default weight for this target.
+                _animVars.set(HEAD_TYPE_VAR, (int)IKTarget::Type::Spline);
+                _animVars.unset(HEAD_WEIGHT_VAR);  // use the default weight for this target.
             } else {
                 // When there is no hips IK target, use the HmdHead IK chain type.  This will make the spine very stiff,
                 // but because the IK _hipsOffset is enabled, the hips will naturally follow underneath the head.
-                _animVars.set("headType", (int)IKTarget::Type::HmdHead);
-                _animVars.set("headWeight", 8.0f);
+                _animVars.set(HEAD_TYPE_VAR, (int)IKTarget::Type::HmdHead);
+                _animVars.set(HEAD_WEIGHT_VAR, 8.0f);
             }
         } else {
-            _animVars.unset("headPosition");
-            _animVars.set("headRotation", headPose.rot());
-            _animVars.set("headType", (int)IKTarget::Type::RotationOnly);
+            _animVars.unset(HEAD_POSITION_VAR);
+            _animVars.set(HEAD_ROTATION_VAR, headPose.rot());
+            _animVars.set(HEAD_TYPE_VAR, (int)IKTarget::Type::RotationOnly);
         }
     }
 }
@@ -1284,9 +1353,9 @@ void Rig::updateHands(bool leftHandEnabled, bool rightHandEnabled, bool hipsEnab
             handPosition = deflectHandFromTorso(handPosition, hipsShapeInfo, spineShapeInfo, spine1ShapeInfo, spine2ShapeInfo);
         }
 
-        _animVars.set("leftHandPosition", handPosition);
-        _animVars.set("leftHandRotation", handRotation);
-        _animVars.set("leftHandType", (int)IKTarget::Type::RotationAndPosition);
+        _animVars.set(LEFT_HAND_POSITION_VAR, handPosition);
+        _animVars.set(LEFT_HAND_ROTATION_VAR, handRotation);
+        _animVars.set(LEFT_HAND_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
 
         // compute pole vector
         int handJointIndex = _animSkeleton->nameToJointIndex("LeftHand");
@@ -1304,20 +1373,20 @@ void Rig::updateHands(bool leftHandEnabled, bool rightHandEnabled, bool hipsEnab
             glm::quat smoothDeltaRot = safeMix(deltaRot, Quaternions::IDENTITY, ELBOW_POLE_VECTOR_BLEND_FACTOR);
             _prevLeftHandPoleVector = smoothDeltaRot * _prevLeftHandPoleVector;
 
-            _animVars.set("leftHandPoleVectorEnabled", true);
-            _animVars.set("leftHandPoleReferenceVector", Vectors::UNIT_X);
-            _animVars.set("leftHandPoleVector", _prevLeftHandPoleVector);
+            _animVars.set(LEFT_HAND_POLE_VECTOR_ENABLED_VAR, true);
+            _animVars.set(LEFT_HAND_POLE_REFERENCE_VECTOR_VAR, Vectors::UNIT_X);
+            _animVars.set(LEFT_HAND_POLE_VECTOR_VAR, _prevLeftHandPoleVector);
         } else {
             _prevLeftHandPoleVectorValid = false;
-            _animVars.set("leftHandPoleVectorEnabled", false);
+            _animVars.set(LEFT_HAND_POLE_VECTOR_ENABLED_VAR, false);
         }
     } else {
         _prevLeftHandPoleVectorValid = false;
-        _animVars.set("leftHandPoleVectorEnabled", false);
+        _animVars.set(LEFT_HAND_POLE_VECTOR_ENABLED_VAR, false);
 
-        _animVars.unset("leftHandPosition");
-        _animVars.unset("leftHandRotation");
-        _animVars.set("leftHandType", (int)IKTarget::Type::HipsRelativeRotationAndPosition);
+        _animVars.unset(LEFT_HAND_POSITION_VAR);
+        _animVars.unset(LEFT_HAND_ROTATION_VAR);
+        _animVars.set(LEFT_HAND_TYPE_VAR, (int)IKTarget::Type::HipsRelativeRotationAndPosition);
 
     }
 
@@ -1331,9 +1400,9 @@ void Rig::updateHands(bool leftHandEnabled, bool rightHandEnabled, bool hipsEnab
             handPosition = deflectHandFromTorso(handPosition, hipsShapeInfo, spineShapeInfo, spine1ShapeInfo, spine2ShapeInfo);
         }
 
-        _animVars.set("rightHandPosition", handPosition);
-        _animVars.set("rightHandRotation", handRotation);
-        _animVars.set("rightHandType", (int)IKTarget::Type::RotationAndPosition);
+        _animVars.set(RIGHT_HAND_POSITION_VAR, handPosition);
+        _animVars.set(RIGHT_HAND_ROTATION_VAR, handRotation);
+        _animVars.set(RIGHT_HAND_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
 
         // compute pole vector
         int handJointIndex = _animSkeleton->nameToJointIndex("RightHand");
@@ -1351,20 +1420,20 @@ void Rig::updateHands(bool leftHandEnabled, bool rightHandEnabled, bool hipsEnab
             glm::quat smoothDeltaRot = safeMix(deltaRot, Quaternions::IDENTITY, ELBOW_POLE_VECTOR_BLEND_FACTOR);
             _prevRightHandPoleVector = smoothDeltaRot * _prevRightHandPoleVector;
 
-            _animVars.set("rightHandPoleVectorEnabled", true);
-            _animVars.set("rightHandPoleReferenceVector", -Vectors::UNIT_X);
-            _animVars.set("rightHandPoleVector", _prevRightHandPoleVector);
+            _animVars.set(RIGHT_HAND_POLE_VECTOR_ENABLED_VAR, true);
+            _animVars.set(RIGHT_HAND_POLE_REFERENCE_VECTOR_VAR, -Vectors::UNIT_X);
+            _animVars.set(RIGHT_HAND_POLE_VECTOR_VAR, _prevRightHandPoleVector);
         } else {
             _prevRightHandPoleVectorValid = false;
-            _animVars.set("rightHandPoleVectorEnabled", false);
+            _animVars.set(RIGHT_HAND_POLE_VECTOR_ENABLED_VAR, false);
         }
     } else {
         _prevRightHandPoleVectorValid = false;
-        _animVars.set("rightHandPoleVectorEnabled", false);
+        _animVars.set(RIGHT_HAND_POLE_VECTOR_ENABLED_VAR, false);
 
-        _animVars.unset("rightHandPosition");
-        _animVars.unset("rightHandRotation");
-        _animVars.set("rightHandType", (int)IKTarget::Type::HipsRelativeRotationAndPosition);
+        _animVars.unset(RIGHT_HAND_POSITION_VAR);
+        _animVars.unset(RIGHT_HAND_ROTATION_VAR);
+        _animVars.set(RIGHT_HAND_TYPE_VAR, (int)IKTarget::Type::HipsRelativeRotationAndPosition);
     }
 }
 
@@ -1375,9 +1444,9 @@ void Rig::updateFeet(bool leftFootEnabled, bool rightFootEnabled, const AnimPose
     int hipsIndex = indexOfJoint("Hips");
 
     if (leftFootEnabled) {
-        _animVars.set("leftFootPosition", leftFootPose.trans());
-        _animVars.set("leftFootRotation", leftFootPose.rot());
-        _animVars.set("leftFootType", (int)IKTarget::Type::RotationAndPosition);
+        _animVars.set(LEFT_FOOT_POSITION_VAR, leftFootPose.trans());
+        _animVars.set(LEFT_FOOT_ROTATION_VAR, leftFootPose.rot());
+        _animVars.set(LEFT_FOOT_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
 
         int footJointIndex = _animSkeleton->nameToJointIndex("LeftFoot");
         int kneeJointIndex = _animSkeleton->nameToJointIndex("LeftLeg");
@@ -1393,21 +1462,21 @@ void Rig::updateFeet(bool leftFootEnabled, bool rightFootEnabled, const AnimPose
         glm::quat smoothDeltaRot = safeMix(deltaRot, Quaternions::IDENTITY, KNEE_POLE_VECTOR_BLEND_FACTOR);
         _prevLeftFootPoleVector = smoothDeltaRot * _prevLeftFootPoleVector;
 
-        _animVars.set("leftFootPoleVectorEnabled", true);
-        _animVars.set("leftFootPoleReferenceVector", Vectors::UNIT_Z);
-        _animVars.set("leftFootPoleVector", _prevLeftFootPoleVector);
+        _animVars.set(LEFT_FOOT_POLE_VECTOR_ENABLED_VAR, true);
+        _animVars.set(LEFT_FOOT_POLE_REFERENCE_VECTOR_VAR, Vectors::UNIT_Z);
+        _animVars.set(LEFT_FOOT_POLE_VECTOR_VAR, _prevLeftFootPoleVector);
     } else {
-        _animVars.unset("leftFootPosition");
-        _animVars.unset("leftFootRotation");
-        _animVars.set("leftFootType", (int)IKTarget::Type::RotationAndPosition);
-        _animVars.set("leftFootPoleVectorEnabled", false);
+        _animVars.unset(LEFT_FOOT_POSITION_VAR);
+        _animVars.unset(LEFT_FOOT_ROTATION_VAR);
+        _animVars.set(LEFT_FOOT_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
+        _animVars.set(LEFT_FOOT_POLE_VECTOR_ENABLED_VAR, false);
         _prevLeftFootPoleVectorValid = false;
     }
 
     if (rightFootEnabled) {
-        _animVars.set("rightFootPosition", rightFootPose.trans());
-        _animVars.set("rightFootRotation", rightFootPose.rot());
-        _animVars.set("rightFootType", (int)IKTarget::Type::RotationAndPosition);
+        _animVars.set(RIGHT_FOOT_POSITION_VAR, rightFootPose.trans());
+        _animVars.set(RIGHT_FOOT_ROTATION_VAR, rightFootPose.rot());
+        _animVars.set(RIGHT_FOOT_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
 
         int footJointIndex = _animSkeleton->nameToJointIndex("RightFoot");
         int kneeJointIndex = _animSkeleton->nameToJointIndex("RightLeg");
@@ -1423,14 +1492,14 @@ void Rig::updateFeet(bool leftFootEnabled, bool rightFootEnabled, const AnimPose
         glm::quat smoothDeltaRot = safeMix(deltaRot, Quaternions::IDENTITY, KNEE_POLE_VECTOR_BLEND_FACTOR);
         _prevRightFootPoleVector = smoothDeltaRot * _prevRightFootPoleVector;
 
-        _animVars.set("rightFootPoleVectorEnabled", true);
-        _animVars.set("rightFootPoleReferenceVector", Vectors::UNIT_Z);
-        _animVars.set("rightFootPoleVector", _prevRightFootPoleVector);
+        _animVars.set(RIGHT_FOOT_POLE_VECTOR_ENABLED_VAR, true);
+        _animVars.set(RIGHT_FOOT_POLE_REFERENCE_VECTOR_VAR, Vectors::UNIT_Z);
+        _animVars.set(RIGHT_FOOT_POLE_VECTOR_VAR, _prevRightFootPoleVector);
     } else {
-        _animVars.unset("rightFootPosition");
-        _animVars.unset("rightFootRotation");
-        _animVars.set("rightFootPoleVectorEnabled", false);
-        _animVars.set("rightFootType", (int)IKTarget::Type::RotationAndPosition);
+        _animVars.unset(RIGHT_FOOT_POSITION_VAR);
+        _animVars.unset(RIGHT_FOOT_ROTATION_VAR);
+        _animVars.set(RIGHT_FOOT_POLE_VECTOR_ENABLED_VAR, false);
+        _animVars.set(RIGHT_FOOT_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
     }
 }
 
@@ -1547,8 +1616,8 @@ void Rig::updateFromControllerParameters(const ControllerParameters& params, flo
         return;
     }
 
-    _animVars.set("isTalking", params.isTalking);
-    _animVars.set("notIsTalking", !params.isTalking);
+    _animVars.set(IS_TALKING_VAR, params.isTalking);
+    _animVars.set(NOT_IS_TALKING_VAR, !params.isTalking);
 
     bool headEnabled = params.primaryControllerActiveFlags[PrimaryControllerType_Head];
     bool leftHandEnabled = params.primaryControllerActiveFlags[PrimaryControllerType_LeftHand];
@@ -1573,34 +1642,34 @@ void Rig::updateFromControllerParameters(const ControllerParameters& params, flo
     // if the hips or the feet are being controlled.
     if (hipsEnabled || rightFootEnabled || leftFootEnabled) {
         // for more predictable IK solve from the center of the joint limits, not from the underpose
-        _animVars.set("solutionSource", (int)AnimInverseKinematics::SolutionSource::RelaxToLimitCenterPoses);
+        _animVars.set(SOLUTION_SOURCE_VAR, (int)AnimInverseKinematics::SolutionSource::RelaxToLimitCenterPoses);
 
         // replace the feet animation with the default pose, this is to prevent unexpected toe wiggling.
-        _animVars.set("defaultPoseOverlayAlpha", 1.0f);
-        _animVars.set("defaultPoseOverlayBoneSet", (int)AnimOverlay::BothFeetBoneSet);
+        _animVars.set(DEFAULT_POSE_OVERLAY_ALPHA_VAR, 1.0f);
+        _animVars.set(DEFAULT_POSE_OVERLAY_BONE_SET_VAR, (int)AnimOverlay::BothFeetBoneSet);
     } else {
         // augment the IK with the underPose.
-        _animVars.set("solutionSource", (int)AnimInverseKinematics::SolutionSource::RelaxToUnderPoses);
+        _animVars.set(SOLUTION_SOURCE_VAR, (int)AnimInverseKinematics::SolutionSource::RelaxToUnderPoses);
 
         // feet should follow source animation
-        _animVars.unset("defaultPoseOverlayAlpha");
-        _animVars.unset("defaultPoseOverlayBoneSet");
+        _animVars.unset(DEFAULT_POSE_OVERLAY_ALPHA_VAR);
+        _animVars.unset(DEFAULT_POSE_OVERLAY_BONE_SET_VAR);
     }
 
     if (hipsEnabled) {
-        _animVars.set("hipsType", (int)IKTarget::Type::RotationAndPosition);
-        _animVars.set("hipsPosition", params.primaryControllerPoses[PrimaryControllerType_Hips].trans());
-        _animVars.set("hipsRotation", params.primaryControllerPoses[PrimaryControllerType_Hips].rot());
+        _animVars.set(HIPS_TYPE_VAR, (int)IKTarget::Type::RotationAndPosition);
+        _animVars.set(HIPS_POSITION_VAR, params.primaryControllerPoses[PrimaryControllerType_Hips].trans());
+        _animVars.set(HIPS_ROTATION_VAR, params.primaryControllerPoses[PrimaryControllerType_Hips].rot());
     } else {
-        _animVars.set("hipsType", (int)IKTarget::Type::Unknown);
+        _animVars.set(HIPS_TYPE_VAR, (int)IKTarget::Type::Unknown);
     }
 
     if (hipsEnabled && spine2Enabled) {
-        _animVars.set("spine2Type", (int)IKTarget::Type::Spline);
-        _animVars.set("spine2Position", params.primaryControllerPoses[PrimaryControllerType_Spine2].trans());
-        _animVars.set("spine2Rotation", params.primaryControllerPoses[PrimaryControllerType_Spine2].rot());
+        _animVars.set(SPINE2_TYPE_VAR, (int)IKTarget::Type::Spline);
+        _animVars.set(SPINE2_POSITION_VAR, params.primaryControllerPoses[PrimaryControllerType_Spine2].trans());
+        _animVars.set(SPINE2_ROTATION_VAR, params.primaryControllerPoses[PrimaryControllerType_Spine2].rot());
     } else {
-        _animVars.set("spine2Type", (int)IKTarget::Type::Unknown);
+        _animVars.set(SPINE2_TYPE_VAR, (int)IKTarget::Type::Unknown);
     }
 
     // set secondary targets
@@ -0,0 +1,138 @@
+//
+//  AudioMixerSharedMixes.cpp
+//  libraries/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <tuple>
+
+#include <NumericalConstants.h>
+
+#include "AudioMixerSharedMixes.h"
+
+// bucket sizes: contributions that land in the same buckets are considered to sound the same
+static const float GAIN_BUCKETS_PER_OCTAVE = 8.0f;      // ~0.75dB
+static const int AZIMUTH_BUCKETS_PER_CIRCLE = 64;       // ~5.6 degrees
+static const float DISTANCE_BUCKETS_PER_OCTAVE = 4.0f;  // the HRTF near-field filter varies slowly with distance
+
+// the limiter dithers its output by up to a step either way, so listeners limiting the same mix with the same
+// attenuation differ by this much
+static const int MAX_DITHER_DIFFERENCE = 2;
+
+static uint64_t mixBits(uint64_t value) {
+    // splitmix64 finalizer, so that summing the hashes of the contributions does not cancel them out
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+void AudioMixerSharedMixes::FingerprintBuilder::addStream(const void* stream, float gain, float azimuth,
+        float distance, bool isEcho, bool throttle) {
+    int32_t gainBucket = (gain > 0.0f && !throttle) ? (int32_t)std::lround(std::log2(gain) * GAIN_BUCKETS_PER_OCTAVE)
+        : INT32_MIN;
+    // wrapped, so that directions either side of straight behind land in the same bucket
+    int32_t azimuthBucket = (int32_t)std::lround(azimuth * (AZIMUTH_BUCKETS_PER_CIRCLE / TWO_PI));
+    azimuthBucket = ((azimuthBucket % AZIMUTH_BUCKETS_PER_CIRCLE) + AZIMUTH_BUCKETS_PER_CIRCLE) % AZIMUTH_BUCKETS_PER_CIRCLE;
+    int32_t distanceBucket = (int32_t)std::lround(std::log2(distance) * DISTANCE_BUCKETS_PER_OCTAVE);
+
+    uint64_t hash = mixBits((uint64_t)reinterpret_cast<uintptr_t>(stream));
+    hash = mixBits(hash ^ (uint32_t)gainBucket);
+    hash = mixBits(hash ^ (((uint64_t)(uint32_t)azimuthBucket << 32) | (uint32_t)distanceBucket));
+    hash = mixBits(hash ^ ((isEcho ? 1 : 0) | (throttle ? 2 : 0)));
+
+    _sum += hash;
+    ++_count;
+}
+
+AudioMixerSharedMixes::Fingerprint AudioMixerSharedMixes::FingerprintBuilder::getFingerprint() const {
+    return mixBits(_sum ^ mixBits(_count));
+}
+
+void AudioMixerSharedMixes::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _mixes.clear();
+}
+
+bool AudioMixerSharedMixes::findMix(Fingerprint fingerprint, float* samples) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _mixes.find(fingerprint);
+    if (it == _mixes.end()) {
+        return false;
+    }
+
+    memcpy(samples, it->second.samples, sizeof(it->second.samples));
+    return true;
+}
+
+void AudioMixerSharedMixes::insertMix(Fingerprint fingerprint, const float* samples, const int16_t* limitedSamples) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // another slave may have rendered the same fingerprint concurrently, the first one wins
+    auto result = _mixes.emplace(std::piecewise_construct, std::forward_as_tuple(fingerprint), std::forward_as_tuple());
+    if (result.second) {
+        Mix& mix = result.first->second;
+        memcpy(mix.samples, samples, sizeof(mix.samples));
+        memcpy(mix.limitedSamples, limitedSamples, sizeof(mix.limitedSamples));
+    }
+}
+
+int AudioMixerSharedMixes::findEncodedFrame(Fingerprint fingerprint, const QString& codec,
+        const int16_t* limitedSamples, uint8_t* encoded, int encodedCapacity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _mixes.find(fingerprint);
+    if (it == _mixes.end()) {
+        return -1;
+    }
+    if (!it->second.matches(limitedSamples)) {
+        return -1;
+    }
+
+    for (auto& encodedFrame : it->second.encodedFrames) {
+        if (encodedFrame.codec == codec) {
+            int encodedSize = (int)encodedFrame.data.size();
+            if (encodedSize > encodedCapacity) {
+                return -1;
+            }
+            memcpy(encoded, encodedFrame.data.data(), encodedSize);
+            return encodedSize;
+        }
+    }
+    return -1;
+}
+
+void AudioMixerSharedMixes::insertEncodedFrame(Fingerprint fingerprint, const QString& codec,
+        const int16_t* limitedSamples, const uint8_t* encoded, int encodedSize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _mixes.find(fingerprint);
+    if (it == _mixes.end() || !it->second.matches(limitedSamples)) {
+        return;
+    }
+
+    auto& encodedFrames = it->second.encodedFrames;
+    for (auto& encodedFrame : encodedFrames) {
+        if (encodedFrame.codec == codec) {
+            return;
+        }
+    }
+    encodedFrames.push_back({ codec, std::vector<uint8_t>(encoded, encoded + encodedSize) });
+}
+
+bool AudioMixerSharedMixes::Mix::matches(const int16_t* otherLimitedSamples) const {
+    // a limiter that is attenuating differently would be heard in the other's frames
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; ++i) {
+        if (std::abs(otherLimitedSamples[i] - limitedSamples[i]) > MAX_DITHER_DIFFERENCE) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+//
+//  AudioMixerSharedMixes.h
+//  libraries/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSharedMixes_h
+#define hifi_AudioMixerSharedMixes_h
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include <AudioConstants.h>
+
+// Mixes rendered during the current frame, keyed by a fingerprint of the streams that went into them.
+// Listeners that hear the same streams at (nearly) the same gain, direction and distance get the same mix, so the
+// first slave to render a fingerprint publishes it and the others copy it instead of running the HRTFs again.
+// The mix is published before limiting, since every listener's limiter has its own envelope to keep up to date.
+// Frames encoded by stateless codecs are published alongside, and handed out only for limited samples that match
+// the publisher's to within the limiter's dither.
+//   AudioMixerSharedMixes is thread-safe; it is shared by all mixer slaves and reset by the pool before each frame.
+class AudioMixerSharedMixes {
+public:
+    using Fingerprint = uint64_t;
+
+    // accumulates a fingerprint from the contributions to a mix, independent of the order they are added in
+    class FingerprintBuilder {
+    public:
+        void addStream(const void* stream, float gain, float azimuth, float distance, bool isEcho, bool throttle);
+        Fingerprint getFingerprint() const;
+
+    private:
+        uint64_t _sum { 0 };
+        uint64_t _count { 0 };
+    };
+
+    void reset();
+
+    // copies a published mix into samples, returns false if the fingerprint has not been mixed yet this frame
+    bool findMix(Fingerprint fingerprint, float* samples);
+    // publishes a mix with its publisher's limited samples, unless another slave got there first
+    void insertMix(Fingerprint fingerprint, const float* samples, const int16_t* limitedSamples);
+
+    // copies a published encoded frame into encoded, returns its size or -1 if there is none that fits or the
+    // limited samples differ from the publisher's
+    int findEncodedFrame(Fingerprint fingerprint, const QString& codec, const int16_t* limitedSamples,
+        uint8_t* encoded, int encodedCapacity);
+    // publishes a frame encoded from limitedSamples, if they match the publisher's
+    void insertEncodedFrame(Fingerprint fingerprint, const QString& codec, const int16_t* limitedSamples,
+        const uint8_t* encoded, int encodedSize);
+
+private:
+    struct EncodedFrame {
+        QString codec;
+        std::vector<uint8_t> data;
+    };
+
+    struct Mix {
+        float samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        int16_t limitedSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        std::vector<EncodedFrame> encodedFrames;
+
+        bool matches(const int16_t* otherLimitedSamples) const;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<Fingerprint, Mix> _mixes;
+};
+
+#endif // hifi_AudioMixerSharedMixes_h
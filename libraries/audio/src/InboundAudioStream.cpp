@@ -258,14 +258,22 @@ int InboundAudioStream::lostAudioData(int numPackets) {
 }
 
 int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties) {
-    QByteArray decodedBuffer;
-    if (_decoder) {
-        _decoder->decode(packetAfterStreamProperties, decodedBuffer);
-    } else {
-        decodedBuffer = packetAfterStreamProperties;
+    if (!_decoder) {
+        return _ringBuffer.writeData(packetAfterStreamProperties.data(), packetAfterStreamProperties.size());
+    }
+
+    auto encoded = reinterpret_cast<const uint8_t*>(packetAfterStreamProperties.constData());
+    int encodedSize = packetAfterStreamProperties.size();
+    int maxSamples = _decoder->getMaxDecodedSamples(encoded, encodedSize);
+    if (maxSamples > AudioConstants::NETWORK_FRAME_SAMPLES_STEREO) {
+        // the decoders size their output from the packet, one that claims more than a frame can't be decoded
+        return 0;
+    }
+    if ((int)_decodedSamples.size() < maxSamples) {
+        _decodedSamples.resize(maxSamples);
     }
-    auto actualSize = decodedBuffer.size();
-    return _ringBuffer.writeData(decodedBuffer.data(), actualSize);
+    int numSamples = std::max(_decoder->decode(encoded, encodedSize, _decodedSamples.data(), maxSamples), 0);
+    return _ringBuffer.writeData(reinterpret_cast<const char*>(_decodedSamples.data()), numSamples * (int)sizeof(int16_t));
 }
 
 int InboundAudioStream::writeDroppableSilentFrames(int silentFrames) {
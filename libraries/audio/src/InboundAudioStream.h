@@ -12,6 +12,8 @@
 #ifndef hifi_InboundAudioStream_h
 #define hifi_InboundAudioStream_h
 
+#include <vector>
+
 #include <Node.h>
 #include <NodeData.h>
 #include <NumericalConstants.h>
@@ -186,6 +188,7 @@ protected:
     CodecPluginPointer _codec;
     QString _selectedCodecName;
     Decoder* _decoder { nullptr };
+    std::vector<int16_t> _decodedSamples; // reused across frames by parseAudioData
     int _mismatchedAudioCodecCount { 0 };
 };
 
@@ -12,7 +12,10 @@
 
 #include <QBuffer>
 #include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QPointer>
 #include <QTcpSocket>
+#include <QTimer>
 
 #include "HTTPConnection.h"
 #include "EmbeddedWebserverLogging.h"
@@ -29,8 +32,12 @@ const char* HTTPConnection::StatusCode404 = "404 Not Found";
 const char* HTTPConnection::StatusCode500 = "500 Internal server error";
 const char* HTTPConnection::DefaultContentType = "text/plain; charset=ISO-8859-1";
 
+const int KEEP_ALIVE_TIMEOUT_MS = 15 * 1000;
+const qint64 STREAMED_CHUNK_SIZE = 64 * 1024;
+const int MAX_STREAMED_CHUNKS_IN_FLIGHT = 4;
+
 HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager) :
-    QObject(parentManager),
+    QObject(parentManager->_ioContext),
     _parentManager(parentManager),
     _socket(socket),
     _stream(socket),
@@ -39,10 +46,16 @@ HTTPConnection::HTTPConnection (QTcpSocket* socket, HTTPManager* parentManager)
     // take over ownership of the socket
     _socket->setParent(this);
 
+    _idleTimer = new QTimer(this);
+    _idleTimer->setSingleShot(true);
+    _idleTimer->setInterval(KEEP_ALIVE_TIMEOUT_MS);
+    connect(_idleTimer, SIGNAL(timeout()), _socket, SLOT(disconnectFromHost()));
+
     // connect initial slots
     connect(socket, SIGNAL(readyRead()), SLOT(readRequest()));
-    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(deleteLater()));
-    connect(socket, SIGNAL(disconnected()), SLOT(deleteLater()));
+    connect(socket, SIGNAL(error(QAbstractSocket::SocketError)), SLOT(socketClosed()));
+    connect(socket, SIGNAL(disconnected()), SLOT(socketClosed()));
+    connect(socket, SIGNAL(bytesWritten(qint64)), SLOT(writeStreamedChunks()));
 }
 
 HTTPConnection::~HTTPConnection() {
@@ -132,45 +145,198 @@ QList<FormData> HTTPConnection::parseFormData() const {
     return data;
 }
 
-void HTTPConnection::respond(const char* code, const QByteArray& content, const char* contentType, const Headers& headers) {
-    _socket->write("HTTP/1.1 ");
-    _socket->write(code);
-    _socket->write("\r\n");
-
-    int csize = content.size();
+QByteArray HTTPConnection::responseHeader(const char* code, const Headers& headers) const {
+    QByteArray header = "HTTP/1.1 ";
+    header += code;
+    header += "\r\n";
 
     for (Headers::const_iterator it = headers.constBegin(), end = headers.constEnd();
             it != end; it++) {
-        _socket->write(it.key());
-        _socket->write(": ");
-        _socket->write(it.value());
-        _socket->write("\r\n");
+        header += it.key();
+        header += ": ";
+        header += it.value();
+        header += "\r\n";
     }
+    header += _keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    return header;
+}
+
+void HTTPConnection::respond(const char* code, const QByteArray& content, const char* contentType, const Headers& headers) {
+    QByteArray response = responseHeader(code, headers);
+
+    int csize = content.size();
     if (csize > 0) {
-        _socket->write("Content-Length: ");
-        _socket->write(QByteArray::number(csize));
-        _socket->write("\r\n");
+        response += "Content-Length: ";
+        response += QByteArray::number(csize);
+        response += "\r\n";
+
+        response += "Content-Type: ";
+        response += contentType;
+        response += "\r\n";
+    } else if (_keepAlive) {
+        // the client can't tell where an empty response ends otherwise
+        response += "Content-Length: 0\r\n";
+    }
+    response += "\r\n";
+    response += content;
+
+    QMetaObject::invokeMethod(this, "writeResponseData", Q_ARG(QByteArray, response), Q_ARG(bool, true));
+}
+
+void HTTPConnection::respondWithJSON(const char* code, const QJsonDocument& document, const Headers& headers) {
+    static const char* JSON_CONTENT_TYPE = "application/json";
+
+    // the connection is kept until it's responded to, the guard only matters if the manager shuts down meanwhile
+    QPointer<HTTPConnection> connection { this };
+    _parentManager->runOnWorkerThread([connection, code, document, headers] {
+        if (connection) {
+            connection->respond(code, document.toJson(), JSON_CONTENT_TYPE, headers);
+        }
+    });
+}
 
-        _socket->write("Content-Type: ");
-        _socket->write(contentType);
-        _socket->write("\r\n");
+void HTTPConnection::beginChunkedResponse(const char* code, const char* contentType, const Headers& headers) {
+    _chunkedEncoding = (_requestVersion == "HTTP/1.1");
+    if (!_chunkedEncoding) {
+        _keepAlive = false;
     }
-    _socket->write("Connection: close\r\n\r\n");
 
-    if (csize > 0) {
-        _socket->write(content);
+    QByteArray header = responseHeader(code, headers);
+    header += "Content-Type: ";
+    header += contentType;
+    header += "\r\n";
+    if (_chunkedEncoding) {
+        header += "Transfer-Encoding: chunked\r\n";
+    }
+    header += "\r\n";
+
+    QMetaObject::invokeMethod(this, "writeResponseData", Q_ARG(QByteArray, header), Q_ARG(bool, false));
+}
+
+QByteArray HTTPConnection::chunkData(const QByteArray& data) const {
+    return _chunkedEncoding ? QByteArray::number(data.size(), 16) + "\r\n" + data + "\r\n" : data;
+}
+
+void HTTPConnection::writeChunk(const QByteArray& data) {
+    if (data.isEmpty()) {
+        // an empty chunk would end the response
+        return;
+    }
+    QMetaObject::invokeMethod(this, "writeResponseData", Q_ARG(QByteArray, chunkData(data)), Q_ARG(bool, false));
+}
+
+void HTTPConnection::endChunkedResponse() {
+    QByteArray lastChunk = _chunkedEncoding ? QByteArray("0\r\n\r\n") : QByteArray();
+    QMetaObject::invokeMethod(this, "writeResponseData", Q_ARG(QByteArray, lastChunk), Q_ARG(bool, true));
+}
+
+void HTTPConnection::respondWithDevice(const char* code, QIODevice* device, const char* contentType,
+                                       const Headers& headers) {
+    beginChunkedResponse(code, contentType, headers);
+
+    // the device is read on the I/O thread, queued after the header
+    device->setParent(nullptr);
+    device->moveToThread(thread());
+    QMetaObject::invokeMethod(this, "beginStreamedContent", Q_ARG(QIODevice*, device));
+}
+
+void HTTPConnection::beginStreamedContent(QIODevice* device) {
+    device->setParent(this);
+    _streamedDevice = device;
+    writeStreamedChunks();
+}
+
+void HTTPConnection::writeStreamedChunks() {
+    if (!_streamedDevice) {
+        return;
+    }
+
+    // read no further ahead of the client than a few chunks, the rest is read as they are sent
+    bool failed = false;
+    while (!_socketClosed && !_streamedDevice->atEnd() &&
+            _socket->bytesToWrite() < MAX_STREAMED_CHUNKS_IN_FLIGHT * STREAMED_CHUNK_SIZE) {
+        QByteArray data = _streamedDevice->read(STREAMED_CHUNK_SIZE);
+        if (data.isEmpty()) {
+            failed = true;
+            break;
+        }
+        writeResponseData(chunkData(data), false);
+    }
+    if (!_socketClosed && !failed && !_streamedDevice->atEnd()) {
+        return;
+    }
+
+    if (failed) {
+        qCWarning(embeddedwebserver) << "Failed to read streamed response content:" << _streamedDevice->errorString();
+        // the client can't tell a truncated response from a complete one unless the connection is closed
+        _keepAlive = false;
+    }
+    _streamedDevice->deleteLater();
+    _streamedDevice = nullptr;
+    writeResponseData(_chunkedEncoding ? QByteArray("0\r\n\r\n") : QByteArray(), true);
+}
+
+void HTTPConnection::writeResponseData(QByteArray data, bool complete) {
+    if (_socketClosed) {
+        if (complete) {
+            deleteLater();
+        }
+        return;
+    }
+
+    _socket->write(data);
+    if (!complete) {
+        return;
+    }
+    _requestPending = false;
+
+    if (_keepAlive) {
+        // get ready for the next request, which may already be here
+        _requestHeaders.clear();
+        _lastRequestHeader.clear();
+        _requestContent.clear();
+        _chunkedEncoding = false;
+        connect(_socket, SIGNAL(readyRead()), SLOT(readRequest()));
+        _idleTimer->start();
+        readRequest();
+    } else {
+        // make sure we receive no further read notifications
+        _socket->disconnect(SIGNAL(readyRead()), this);
+
+        _socket->disconnectFromHost();
+    }
+}
+
+void HTTPConnection::socketClosed() {
+    _idleTimer->stop();
+    if (_requestPending) {
+        // the handler still has this connection, it's deleted once the response is complete
+        _socketClosed = true;
+        // a streamed response completes here, as nothing more will be sent
+        writeStreamedChunks();
+    } else {
+        deleteLater();
     }
+}
 
-    // make sure we receive no further read notifications
-    _socket->disconnect(SIGNAL(readyRead()), this);
+void HTTPConnection::dispatchRequest(const QUrl& url) {
+    QByteArray connectionHeader = _requestHeaders.value("Connection").toLower();
+    if (_requestVersion == "HTTP/1.1") {
+        _keepAlive = !connectionHeader.contains("close");
+    } else {
+        _keepAlive = connectionHeader.contains("keep-alive");
+    }
 
-    _socket->disconnectFromHost();
+    _requestPending = true;
+    _parentManager->dispatchRequest(this, url);
 }
 
 void HTTPConnection::readRequest() {
     if (!_socket->canReadLine()) {
         return;
     }
+    _idleTimer->stop();
+
     // parse out the method and resource
     QByteArray line = _socket->readLine().trimmed();
     if (line.startsWith("HEAD")) {
@@ -190,11 +356,13 @@ void HTTPConnection::readRequest() {
 
     } else {
         qWarning() << "Unrecognized HTTP operation." << _address << line;
+        _keepAlive = false;
         respond("400 Bad Request", "Unrecognized operation.");
         return;
     }
     int idx = line.indexOf(' ') + 1;
     _requestUrl.setUrl(line.mid(idx, line.lastIndexOf(' ') - idx));
+    _requestVersion = line.mid(line.lastIndexOf(' ') + 1);
 
     // switch to reading the header
     _socket->disconnect(this, SLOT(readRequest()));
@@ -213,7 +381,7 @@ void HTTPConnection::readHeaders() {
 
             QByteArray clength = _requestHeaders.value("Content-Length");
             if (clength.isEmpty()) {
-                _parentManager->handleHTTPRequest(this, _requestUrl);
+                dispatchRequest(_requestUrl);
 
             } else {
                 _requestContent.resize(clength.toInt());
@@ -232,6 +400,8 @@ void HTTPConnection::readHeaders() {
         int idx = trimmed.indexOf(':');
         if (idx == -1) {
             qWarning() << "Invalid header." << _address << trimmed;
+            _socket->disconnect(this, SLOT(readHeaders()));
+            _keepAlive = false;
             respond("400 Bad Request", "The header was malformed.");
             return;
         }
@@ -252,5 +422,5 @@ void HTTPConnection::readContent() {
     _socket->read(_requestContent.data(), size);
     _socket->disconnect(this, SLOT(readContent()));
 
-    _parentManager->handleHTTPRequest(this, _requestUrl.path());
+    dispatchRequest(_requestUrl.path());
 }
@@ -26,7 +26,9 @@
 #include <QPair>
 #include <QUrl>
 
+class QJsonDocument;
 class QTcpSocket;
+class QTimer;
 class HTTPManager;
 class MaskFilter;
 class ServerApp;
@@ -37,7 +39,8 @@ typedef QHash<QByteArray, QByteArray> Headers;
 /// A form data element
 typedef QPair<Headers, QByteArray> FormData;
 
-/// Handles a single HTTP connection.
+/// Handles a single HTTP connection, on the I/O thread of its HTTPManager.  Several requests are served one after the
+/// other on the same connection when the client asks for it to be kept alive.
 class HTTPConnection : public QObject {
    Q_OBJECT
 
@@ -83,11 +86,31 @@ public:
     /// Duplicate keys are not supported.
     QHash<QString, QString> parseUrlEncodedForm();
 
-    /// Sends a response and closes the connection.
+    /// Sends a response, then closes the connection unless it's kept alive.  The respond methods may be called from any
+    /// thread, the connection must not be used once the response is complete.
     void respond (const char* code, const QByteArray& content = QByteArray(),
         const char* contentType = DefaultContentType,
         const Headers& headers = Headers());
 
+    /// Serializes the document on a worker thread of the manager, and sends it as the response.
+    void respondWithJSON (const char* code, const QJsonDocument& document, const Headers& headers = Headers());
+
+    /// Sends the status and headers of a response whose content is sent in chunks, as it's produced.  HTTP/1.0 clients
+    /// don't know chunked encoding, their response is sent as is and the connection is closed to mark its end.
+    void beginChunkedResponse (const char* code, const char* contentType = DefaultContentType,
+        const Headers& headers = Headers());
+
+    /// Sends the next chunk of a chunked response.
+    void writeChunk (const QByteArray& data);
+
+    /// Completes a chunked response.
+    void endChunkedResponse ();
+
+    /// Sends the content of a device, such as a large file, as a chunked response.  The connection takes the device
+    /// and reads it on its I/O thread as the socket sends what was written, keeping only a few chunks queued.
+    void respondWithDevice (const char* code, QIODevice* device, const char* contentType = DefaultContentType,
+        const Headers& headers = Headers());
+
 protected slots:
 
     /// Reads the request line.
@@ -99,8 +122,30 @@ protected slots:
     /// Reads the content.
     void readContent ();
 
+    /// Writes part of a response to the socket, and gets ready for the next request once it's complete.
+    void writeResponseData (QByteArray data, bool complete);
+
+    /// Deletes the connection once the socket is closed, unless a request is being handled.
+    void socketClosed ();
+
+    /// Starts sending the content of a device given to respondWithDevice().
+    void beginStreamedContent (QIODevice* device);
+
+    /// Reads and writes the next chunks of the streamed device while few enough bytes are waiting to be sent, and
+    /// completes the response at its end.
+    void writeStreamedChunks ();
+
 protected:
 
+    /// Hands the complete request to the manager.
+    void dispatchRequest (const QUrl& url);
+
+    /// Returns the status line and headers of a response.
+    QByteArray responseHeader (const char* code, const Headers& headers) const;
+
+    /// Returns the data framed as a chunk of the response.
+    QByteArray chunkData (const QByteArray& data) const;
+
     /// The parent HTTP manager
     HTTPManager* _parentManager;
 
@@ -127,6 +172,27 @@ protected:
 
     /// The content of the request.
     QByteArray _requestContent;
+
+    /// The HTTP version of the request.
+    QByteArray _requestVersion;
+
+    /// Whether the connection is kept open after the response.
+    bool _keepAlive { false };
+
+    /// Whether the content of the response is sent with chunked transfer encoding.
+    bool _chunkedEncoding { false };
+
+    /// Whether a request is being handled.
+    bool _requestPending { false };
+
+    /// Whether the socket was closed while a request was being handled.
+    bool _socketClosed { false };
+
+    /// The device whose content is being sent, owned by the connection.
+    QIODevice* _streamedDevice { nullptr };
+
+    /// Closes kept alive connections that aren't used.
+    QTimer* _idleTimer;
 };
 
 #endif // hifi_HTTPConnection_h
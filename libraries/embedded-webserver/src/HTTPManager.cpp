@@ -9,11 +9,15 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDebug>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMimeDatabase>
+#include <QtCore/QPointer>
+#include <QtCore/QRunnable>
 #include <QtNetwork/QTcpSocket>
 
 #include "HTTPConnection.h"
@@ -22,6 +26,21 @@
 
 const int SOCKET_ERROR_EXIT_CODE = 2;
 const int SOCKET_CHECK_INTERVAL_IN_MS = 30000;
+const int MAX_HTTP_WORKER_THREADS = 4;
+const qint64 STREAMED_FILE_MIN_SIZE = 1024 * 1024;
+
+namespace {
+
+class HTTPWorkerTask : public QRunnable {
+public:
+    HTTPWorkerTask(std::function<void()> task) : _task(task) {}
+    void run() override { _task(); }
+
+private:
+    std::function<void()> _task;
+};
+
+}
 
 HTTPManager::HTTPManager(const QHostAddress& listenAddress, quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler, QObject* parent) :
     QTcpServer(parent),
@@ -30,6 +49,14 @@ HTTPManager::HTTPManager(const QHostAddress& listenAddress, quint16 port, const
     _requestHandler(requestHandler),
     _port(port)
 {
+    _ioContext = new QObject();
+    _ioContext->moveToThread(&_ioThread);
+    connect(&_ioThread, &QThread::finished, _ioContext, &QObject::deleteLater);
+    _ioThread.setObjectName("HTTP I/O");
+    _ioThread.start();
+
+    _workerPool.setMaxThreadCount(std::min(QThread::idealThreadCount(), MAX_HTTP_WORKER_THREADS));
+
     bindSocket();
     
     _isListeningTimer = new QTimer(this);
@@ -37,8 +64,22 @@ HTTPManager::HTTPManager(const QHostAddress& listenAddress, quint16 port, const
     _isListeningTimer->start(SOCKET_CHECK_INTERVAL_IN_MS);
 }
 
+HTTPManager::~HTTPManager() {
+    close();
+    _workerPool.waitForDone();
+    _ioThread.quit();
+    _ioThread.wait();
+}
+
 void HTTPManager::incomingConnection(qintptr socketDescriptor) {
-    QTcpSocket* socket = new QTcpSocket(this);
+    // the socket has to be created on the thread it's used on
+    QTimer::singleShot(0, _ioContext, [this, socketDescriptor] {
+        createConnection(socketDescriptor);
+    });
+}
+
+void HTTPManager::createConnection(qintptr socketDescriptor) {
+    QTcpSocket* socket = new QTcpSocket(_ioContext);
     
     if (socket->setSocketDescriptor(socketDescriptor)) {
         new HTTPConnection(socket, this);
@@ -47,6 +88,31 @@ void HTTPManager::incomingConnection(qintptr socketDescriptor) {
     }
 }
 
+void HTTPManager::runOnWorkerThread(std::function<void()> task) {
+    _workerPool.start(new HTTPWorkerTask(task));
+}
+
+bool HTTPManager::isThreadSafeRequest(HTTPConnection* connection, const QUrl& url) {
+    return _requestHandler && _requestHandler->isThreadSafeHTTPRequest(connection, url);
+}
+
+void HTTPManager::dispatchRequest(HTTPConnection* connection, const QUrl& url) {
+    // a connection isn't deleted while its request is pending, but the I/O thread deletes them all when it shuts down,
+    // which can happen before a queued request gets to run
+    QPointer<HTTPConnection> guardedConnection { connection };
+    auto handleRequest = [this, guardedConnection, url] {
+        if (guardedConnection) {
+            handleHTTPRequest(guardedConnection, url);
+        }
+    };
+
+    if (isThreadSafeRequest(connection, url)) {
+        runOnWorkerThread(handleRequest);
+    } else {
+        QTimer::singleShot(0, this, handleRequest);
+    }
+}
+
 bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler) {
     if (!skipSubHandler && requestHandledByRequestHandler(connection, url)) {
         // this request was handled by our request handler object
@@ -98,12 +164,24 @@ bool HTTPManager::handleHTTPRequest(HTTPConnection* connection, const QUrl& url,
             // file exists, serve it
             static QMimeDatabase mimeDatabase;
             
+            QFileInfo localFileInfo(filePath);
+
+            if (localFileInfo.completeSuffix() != "shtml" && localFileInfo.size() > STREAMED_FILE_MIN_SIZE) {
+                // large files are read by the connection as the client receives them, rather than all at once
+                QFile* streamedFile = new QFile(filePath);
+                if (streamedFile->open(QIODevice::ReadOnly)) {
+                    connection->respondWithDevice(HTTPConnection::StatusCode200, streamedFile,
+                                                  qPrintable(mimeDatabase.mimeTypeForFile(filePath).name()));
+                    return true;
+                }
+                delete streamedFile;
+            }
+
             QFile localFile(filePath);
             localFile.open(QIODevice::ReadOnly);
+
             QByteArray localFileData = localFile.readAll();
             
-            QFileInfo localFileInfo(filePath);
-            
             if (localFileInfo.completeSuffix() == "shtml") {
                 // this is a file that may have some SSI statements
                 // the only thing we support is the include directive, but check the contents for that
@@ -16,7 +16,11 @@
 #ifndef hifi_HTTPManager_h
 #define hifi_HTTPManager_h
 
+#include <functional>
+
 #include <QtNetwork/QTcpServer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtCore/QTimer>
 
 class HTTPConnection;
@@ -26,17 +30,26 @@ class HTTPRequestHandler {
 public:
     /// Handles an HTTP request.
     virtual bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) = 0;
+
+    /// Returns true if the request can be handled on a worker thread, concurrently with other requests.  Called on the
+    /// I/O thread of the manager, so it should only look at the request.  Other requests are handled on the manager's thread.
+    virtual bool isThreadSafeHTTPRequest(HTTPConnection* connection, const QUrl& url) { return false; }
 };
 
-/// Handles HTTP connections
+/// Handles HTTP connections.  Sockets are read and written on an I/O thread, so slow clients and large responses don't
+/// hold up the thread of the manager.
 class HTTPManager : public QTcpServer, public HTTPRequestHandler {
    Q_OBJECT
 public:
     /// Initializes the manager.
     HTTPManager(const QHostAddress& listenAddress, quint16 port, const QString& documentRoot, HTTPRequestHandler* requestHandler = NULL, QObject* parent = 0);
+    ~HTTPManager();
     
     bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
 
+    /// Runs a task on the worker pool of the manager.
+    void runOnWorkerThread(std::function<void()> task);
+
 private slots:
     void isTcpServerListening();
     void queuedExit(QString errorMessage);
@@ -45,15 +58,27 @@ private:
     bool bindSocket();
     
 protected:
+    friend class HTTPConnection;
+
     /// Accepts all pending connections
     virtual void incomingConnection(qintptr socketDescriptor) override;
+    /// Creates the connection for an accepted socket, on the I/O thread.
+    virtual void createConnection(qintptr socketDescriptor);
     virtual bool requestHandledByRequestHandler(HTTPConnection* connection, const QUrl& url);
+    virtual bool isThreadSafeRequest(HTTPConnection* connection, const QUrl& url);
+
+    /// Hands a complete request to a worker thread or to the thread of the manager.  Called on the I/O thread.
+    void dispatchRequest(HTTPConnection* connection, const QUrl& url);
     
     QHostAddress _listenAddress;
     QString _documentRoot;
     HTTPRequestHandler* _requestHandler;
     QTimer* _isListeningTimer;
     const quint16 _port;
+
+    QThread _ioThread;
+    QObject* _ioContext;    // parent of the connections, lives on the I/O thread
+    QThreadPool _workerPool;
 };
 
 #endif // hifi_HTTPManager_h
@@ -25,8 +25,8 @@ HTTPSManager::HTTPSManager(QHostAddress listenAddress, quint16 port, const QSslC
     
 }
 
-void HTTPSManager::incomingConnection(qintptr socketDescriptor) {
-    QSslSocket* sslSocket = new QSslSocket(this);
+void HTTPSManager::createConnection(qintptr socketDescriptor) {
+    QSslSocket* sslSocket = new QSslSocket(_ioContext);
     
     sslSocket->setLocalCertificate(_certificate);
     sslSocket->setPrivateKey(_privateKey);
@@ -40,7 +40,7 @@ public:
     bool handleHTTPSRequest(HTTPSConnection* connection, const QUrl& url, bool skipSubHandler = false) override;
     
 protected:
-    void incomingConnection(qintptr socketDescriptor) override;
+    void createConnection(qintptr socketDescriptor) override;
     bool requestHandledByRequestHandler(HTTPConnection* connection, const QUrl& url) override;
 private:
     QSslCertificate _certificate;
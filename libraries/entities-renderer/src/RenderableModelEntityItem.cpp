@@ -291,6 +291,21 @@ bool RenderableModelEntityItem::findDetailedRayIntersection(const glm::vec3& ori
                                                        face, surfaceNormal, extraInfo, precisionPicking, false);
 }
 
+void RenderableModelEntityItem::findDetailedRayIntersections(const std::vector<glm::vec3>& origins,
+                        const std::vector<glm::vec3>& directions, std::vector<TriangleSet::RayIntersection>& results,
+                        bool precisionPicking) const {
+    auto model = getModel();
+    if (!model) {
+        // like findDetailedRayIntersection(), the hits against the entity's box stand
+        for (auto& result : results) {
+            result.intersects = true;
+        }
+        return;
+    }
+
+    model->findRayIntersectionsAgainstSubMeshes(origins, directions, results, precisionPicking, false);
+}
+
 void RenderableModelEntityItem::getCollisionGeometryResource() {
     QUrl hullURL(getCompoundShapeURL());
     QUrlQuery queryArgs(hullURL);
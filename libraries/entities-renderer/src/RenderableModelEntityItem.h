@@ -71,6 +71,9 @@ public:
                         bool& keepSearching, OctreeElementPointer& element, float& distance,
                         BoxFace& face, glm::vec3& surfaceNormal,
                         void** intersectedObject, bool precisionPicking) const override;
+    virtual bool supportsBatchedRayIntersection() const override { return true; }
+    virtual void findDetailedRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+                        std::vector<TriangleSet::RayIntersection>& results, bool precisionPicking) const override;
 
     virtual void setShapeType(ShapeType type) override;
     virtual void setCompoundShapeURL(const QString& url) override;
@@ -897,6 +897,19 @@ void EntityItem::debugDump() const {
     qCDebug(entities) << " dimensions:" << getDimensions();
 }
 
+void EntityItem::findDetailedRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+                         std::vector<TriangleSet::RayIntersection>& results, bool precisionPicking) const {
+    assert(origins.size() == directions.size() && origins.size() == results.size());
+    for (size_t i = 0; i < origins.size(); i++) {
+        TriangleSet::RayIntersection& result = results[i];
+        bool keepSearching = true;
+        OctreeElementPointer element;
+        void* intersectedObject = nullptr;
+        result.intersects = findDetailedRayIntersection(origins[i], directions[i], keepSearching, element, result.distance,
+            result.face, result.surfaceNormal, &intersectedObject, precisionPicking);
+    }
+}
+
 // adjust any internal timestamps to fix clock skew for this server
 void EntityItem::adjustEditPacketForClockSkew(QByteArray& buffer, qint64 clockSkew) {
     unsigned char* dataAt = reinterpret_cast<unsigned char*>(buffer.data());
@@ -25,6 +25,7 @@
 #include <PhysicsCollisionGroups.h>
 #include <ShapeInfo.h>
 #include <Transform.h>
+#include <TriangleSet.h>
 #include <SpatiallyNestable.h>
 #include <Interpolate.h>
 
@@ -162,6 +163,15 @@ public:
                          BoxFace& face, glm::vec3& surfaceNormal,
                          void** intersectedObject, bool precisionPicking) const { return true; }
 
+    // Whether findDetailedRayIntersections() tests a batch of rays faster than one findDetailedRayIntersection() each,
+    // in which case the entity tree leaves the entity's detailed tests to the end of a batch of rays.
+    virtual bool supportsBatchedRayIntersection() const { return false; }
+    // Same as findDetailedRayIntersection() for a batch of rays.  results[i] is the result of origins[i] and
+    // directions[i], and like the distance of findDetailedRayIntersection() it comes in holding the hit against the
+    // entity's box.
+    virtual void findDetailedRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+                         std::vector<TriangleSet::RayIntersection>& results, bool precisionPicking) const;
+
     // attributes applicable to all entity types
     EntityTypes::EntityType getType() const { return _type; }
 
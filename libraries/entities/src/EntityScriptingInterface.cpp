@@ -759,6 +759,45 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionVecto
     return findRayIntersectionWorker(ray, Octree::Lock, precisionPicking, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly);
 }
 
+std::vector<RayToEntityIntersectionResult> EntityScriptingInterface::findRayIntersectionsVector(const std::vector<PickRay>& rays,
+                bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude,
+                const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly) {
+    PROFILE_RANGE(script_entities, __FUNCTION__);
+
+    std::vector<RayToEntityIntersectionResult> results(rays.size());
+    if (_entityTree) {
+        std::vector<glm::vec3> origins;
+        std::vector<glm::vec3> directions;
+        origins.reserve(rays.size());
+        directions.reserve(rays.size());
+        for (const auto& ray : rays) {
+            origins.push_back(ray.origin);
+            directions.push_back(ray.direction);
+        }
+
+        std::vector<TriangleSet::RayIntersection> intersections;
+        std::vector<EntityItemID> entityIDs;
+        bool accurate = false;
+        _entityTree->findRayIntersections(origins, directions, entityIdsToInclude, entityIdsToDiscard,
+            visibleOnly, collidableOnly, precisionPicking, intersections, entityIDs, Octree::Lock, &accurate);
+
+        for (size_t i = 0; i < rays.size(); i++) {
+            RayToEntityIntersectionResult& result = results[i];
+            const TriangleSet::RayIntersection& intersection = intersections[i];
+            result.accurate = accurate;
+            result.intersects = intersection.intersects;
+            result.distance = intersection.distance;
+            result.face = intersection.face;
+            result.surfaceNormal = intersection.surfaceNormal;
+            if (result.intersects && !entityIDs[i].isNull()) {
+                result.entityID = entityIDs[i];
+                result.intersection = rays[i].origin + (rays[i].direction * result.distance);
+            }
+        }
+    }
+    return results;
+}
+
 // FIXME - we should remove this API and encourage all users to use findRayIntersection() instead. We've changed
 //         findRayIntersection() to be blocking because it never makes sense for a script to get back a non-answer
 RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking, 
@@ -10,6 +10,7 @@
 //
 
 #include "EntityTree.h"
+#include <unordered_map>
 #include <QtCore/QDateTime>
 #include <QtCore/QQueue>
 #include <openssl/err.h>
@@ -24,6 +25,7 @@
 #include <QtScript/QScriptEngine>
 
 #include <Extents.h>
+#include <OctreeElementArena.h>
 #include <PerfStat.h>
 #include <Profile.h>
 
@@ -63,6 +65,9 @@ public:
     glm::vec3& surfaceNormal;
     void** intersectedObject;
     bool found;
+
+    // when given, the entities that support batched ray intersection are left here for the end of the batch
+    DeferredRayIntersections* deferred;
 };
 
 
@@ -88,7 +93,7 @@ void EntityTree::createRootElement() {
 }
 
 OctreeElementPointer EntityTree::createNewElement(unsigned char* octalCode) {
-    auto newElement = EntityTreeElementPointer(new EntityTreeElement(octalCode));
+    auto newElement = std::allocate_shared<EntityTreeElement>(OctreeElementAllocator<EntityTreeElement>(), octalCode);
     newElement->setTree(std::static_pointer_cast<EntityTree>(shared_from_this()));
     return std::static_pointer_cast<OctreeElement>(newElement);
 }
@@ -752,7 +757,8 @@ bool findRayIntersectionOp(const OctreeElementPointer& element, void* extraData)
     EntityTreeElementPointer entityTreeElementPointer = std::static_pointer_cast<EntityTreeElement>(element);
     if (entityTreeElementPointer->findRayIntersection(args->origin, args->direction, keepSearching,
         args->element, args->distance, args->face, args->surfaceNormal, args->entityIdsToInclude,
-        args->entityIdsToDiscard, args->visibleOnly, args->collidableOnly, args->intersectedObject, args->precisionPicking)) {
+        args->entityIdsToDiscard, args->visibleOnly, args->collidableOnly, args->intersectedObject, args->precisionPicking,
+        args->deferred)) {
         args->found = true;
     }
     return keepSearching;
@@ -766,7 +772,7 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
                                     Octree::lockType lockType, bool* accurateResult) {
     RayArgs args = { origin, direction, entityIdsToInclude, entityIdsToDiscard,
             visibleOnly, collidableOnly, precisionPicking,
-            element, distance, face, surfaceNormal,  intersectedObject, false };
+            element, distance, face, surfaceNormal,  intersectedObject, false, nullptr };
     distance = FLT_MAX;
 
     bool requireLock = lockType == Octree::Lock;
@@ -781,6 +787,88 @@ bool EntityTree::findRayIntersection(const glm::vec3& origin, const glm::vec3& d
     return args.found;
 }
 
+void EntityTree::findRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+                                    QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
+                                    bool visibleOnly, bool collidableOnly, bool precisionPicking,
+                                    std::vector<TriangleSet::RayIntersection>& results, std::vector<EntityItemID>& entityIDs,
+                                    Octree::lockType lockType, bool* accurateResult) {
+    assert(origins.size() == directions.size());
+    size_t numRays = origins.size();
+    results.assign(numRays, TriangleSet::RayIntersection());
+    entityIDs.assign(numRays, EntityItemID());
+
+    bool requireLock = lockType == Octree::Lock;
+    bool lockResult = withReadLock([&]{
+        // each ray walks the tree as findRayIntersection() does, except that the detailed tests of entities such as
+        // models are collected instead of done
+        DeferredRayIntersections deferred;
+        for (size_t i = 0; i < numRays; i++) {
+            TriangleSet::RayIntersection& result = results[i];
+            OctreeElementPointer element;
+            EntityItem* intersectedEntity = nullptr;
+            size_t firstDeferred = deferred.size();
+            RayArgs args = { origins[i], directions[i], entityIdsToInclude, entityIdsToDiscard,
+                    visibleOnly, collidableOnly, precisionPicking,
+                    element, result.distance, result.face, result.surfaceNormal, (void**)&intersectedEntity, false, &deferred };
+            recurseTreeWithOperation(findRayIntersectionOp, &args);
+
+            result.intersects = args.found;
+            if (args.found && intersectedEntity) {
+                entityIDs[i] = intersectedEntity->getEntityItemID();
+            }
+            for (size_t j = firstDeferred; j < deferred.size(); j++) {
+                deferred[j].ray = i;
+            }
+        }
+
+        // then each of those entities tests all the rays that hit its box closer than anything else at once
+        std::unordered_map<EntityItem*, std::vector<size_t>> deferredByEntity;
+        for (size_t j = 0; j < deferred.size(); j++) {
+            const DeferredRayIntersection& intersection = deferred[j];
+            if (intersection.originInBox || intersection.boxDistance < results[intersection.ray].distance) {
+                deferredByEntity[intersection.entity.get()].push_back(j);
+            }
+        }
+
+        std::vector<glm::vec3> entityOrigins;
+        std::vector<glm::vec3> entityDirections;
+        std::vector<TriangleSet::RayIntersection> entityResults;
+        for (const auto& entityIntersections : deferredByEntity) {
+            const std::vector<size_t>& indices = entityIntersections.second;
+            entityOrigins.clear();
+            entityDirections.clear();
+            entityResults.clear();
+            for (size_t j : indices) {
+                const DeferredRayIntersection& intersection = deferred[j];
+                entityOrigins.push_back(origins[intersection.ray]);
+                entityDirections.push_back(directions[intersection.ray]);
+
+                TriangleSet::RayIntersection boxResult;
+                boxResult.distance = intersection.boxDistance;
+                boxResult.face = intersection.boxFace;
+                boxResult.surfaceNormal = intersection.boxSurfaceNormal;
+                entityResults.push_back(boxResult);
+            }
+
+            EntityItem* entity = entityIntersections.first;
+            entity->findDetailedRayIntersections(entityOrigins, entityDirections, entityResults, precisionPicking);
+
+            for (size_t k = 0; k < indices.size(); k++) {
+                const TriangleSet::RayIntersection& entityResult = entityResults[k];
+                size_t ray = deferred[indices[k]].ray;
+                if (entityResult.intersects && entityResult.distance < results[ray].distance) {
+                    results[ray] = entityResult;
+                    entityIDs[ray] = entity->getEntityItemID();
+                }
+            }
+        }
+    }, requireLock);
+
+    if (accurateResult) {
+        *accurateResult = lockResult; // if user asked to accuracy or result, let them know this is accurate
+    }
+}
+
 
 EntityItemPointer EntityTree::findClosestEntity(const glm::vec3& position, float targetRadius) {
     FindNearPointArgs args = { position, targetRadius, false, NULL, FLT_MAX };
@@ -1381,6 +1469,42 @@ void EntityTree::processChallengeOwnershipPacket(ReceivedMessage& message, const
     }
 }
 
+// reads the IDs of an erase message, returns the bytes read
+static int decodeEraseMessageDetails(const QByteArray& dataByteArray, QSet<EntityItemID>& entityItemIDsToDelete) {
+    #ifdef EXTRA_ERASE_DEBUGGING
+        qCDebug(entities) << "EntityTree::decodeEraseMessageDetails()";
+    #endif
+    const unsigned char* packetData = (const unsigned char*)dataByteArray.constData();
+    const unsigned char* dataAt = packetData;
+    size_t packetLength = dataByteArray.size();
+    size_t processedBytes = 0;
+
+    uint16_t numberOfIds = 0; // placeholder for now
+    memcpy(&numberOfIds, dataAt, sizeof(numberOfIds));
+    dataAt += sizeof(numberOfIds);
+    processedBytes += sizeof(numberOfIds);
+
+    for (size_t i = 0; i < numberOfIds; i++) {
+
+        if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
+            qCDebug(entities) << "EntityTree::decodeEraseMessageDetails().... bailing because not enough bytes in buffer";
+            break; // bail to prevent buffer overflow
+        }
+
+        QByteArray encodedID = dataByteArray.mid((int)processedBytes, NUM_BYTES_RFC4122_UUID);
+        QUuid entityID = QUuid::fromRfc4122(encodedID);
+        dataAt += encodedID.size();
+        processedBytes += encodedID.size();
+
+        #ifdef EXTRA_ERASE_DEBUGGING
+            qCDebug(entities) << "    ---- EntityTree::decodeEraseMessageDetails() contains id:" << entityID;
+        #endif
+
+        entityItemIDsToDelete << EntityItemID(entityID);
+    }
+    return (int)processedBytes;
+}
+
 int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                      const SharedNodePointer& senderNode) {
 
@@ -1390,255 +1514,277 @@ int EntityTree::processEditPacketData(ReceivedMessage& message, const unsigned c
     }
 
     int processedBytes = 0;
-    bool isAdd = false;
+    auto edit = decodeEditPacketData(message, editData, maxLength, processedBytes);
+    if (edit) {
+        applyDecodedEdit(*edit, senderNode);
+    }
+    return processedBytes;
+}
+
+Octree::DecodedEditPointer EntityTree::decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData,
+                                                            int maxLength, int& bytesRead) const {
+    // this only reads the packet, so it needs no lock and can run on any thread
+    std::unique_ptr<DecodedEntityEdit> edit { new DecodedEntityEdit() };
+    edit->type = message.getType();
+    bytesRead = 0;
+
     // we handle these types of "edit" packets
-    switch (message.getType()) {
+    switch (edit->type) {
         case PacketType::EntityErase: {
             QByteArray dataByteArray = QByteArray::fromRawData(reinterpret_cast<const char*>(editData), maxLength);
-            processedBytes = processEraseMessageDetails(dataByteArray, senderNode);
+            bytesRead = decodeEraseMessageDetails(dataByteArray, edit->erasedEntityIDs);
+            edit->isValid = true;
             break;
         }
 
         case PacketType::EntityAdd:
-            isAdd = true;  // fall through to next case
         case PacketType::EntityPhysics:
         case PacketType::EntityEdit: {
-            quint64 startDecode = 0, endDecode = 0;
-            quint64 startLookup = 0, endLookup = 0;
-            quint64 startUpdate = 0, endUpdate = 0;
-            quint64 startCreate = 0, endCreate = 0;
-            quint64 startFilter = 0, endFilter = 0;
-            quint64 startLogging = 0, endLogging = 0;
-
-            bool suppressDisallowedClientScript = false;
-            bool suppressDisallowedServerScript = false;
-            bool isPhysics = message.getType() == PacketType::EntityPhysics;
-
-            _totalEditMessages++;
-
-            EntityItemID entityItemID;
-            EntityItemProperties properties;
-            startDecode = usecTimestampNow();
-
-            bool validEditPacket = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, processedBytes,
-                                                                                entityItemID, properties);
-            endDecode = usecTimestampNow();
-
-            EntityItemPointer existingEntity;
-            if (!isAdd) {
-                // search for the entity by EntityItemID
-                startLookup = usecTimestampNow();
-                existingEntity = findEntityByEntityItemID(entityItemID);
-                endLookup = usecTimestampNow();
-                if (!existingEntity) {
-                    // this is not an add-entity operation, and we don't know about the identified entity.
-                    validEditPacket = false;
-                }
-            }
+            quint64 startDecode = usecTimestampNow();
+            edit->isValid = EntityItemProperties::decodeEntityEditPacket(editData, maxLength, bytesRead,
+                                                                         edit->entityItemID, edit->properties);
+            edit->decodeTime = usecTimestampNow() - startDecode;
+            break;
+        }
 
-            if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty()) {
+        default:
+            return DecodedEditPointer();
+    }
 
-                bool wasDeletedBecauseOfClientScript = false;
+    return DecodedEditPointer(std::move(edit));
+}
 
-                // check the client entity script to make sure its URL is in the whitelist
-                if (!properties.getScript().isEmpty()) {
-                    bool clientScriptPassedWhitelist = isScriptInWhitelist(properties.getScript());
+void EntityTree::applyDecodedEdit(DecodedEdit& decodedEdit, const SharedNodePointer& senderNode) {
+    auto& edit = static_cast<DecodedEntityEdit&>(decodedEdit);
 
-                    if (!clientScriptPassedWhitelist) {
-                        if (wantEditLogging()) {
-                            qCDebug(entities) << "User [" << senderNode->getUUID()
-                                << "] attempting to set entity script not on whitelist, edit rejected";
-                        }
+    if (edit.type == PacketType::EntityErase) {
+        applyEraseEdit(edit, senderNode);
+        return;
+    }
 
-                        // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
-                        if (isAdd) {
-                            QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                            _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                            validEditPacket = false;
-                            wasDeletedBecauseOfClientScript = true;
-                        } else {
-                            suppressDisallowedClientScript = true;
-                        }
-                    }
-                }
+    quint64 startLookup = 0, endLookup = 0;
+    quint64 startUpdate = 0, endUpdate = 0;
+    quint64 startCreate = 0, endCreate = 0;
+    quint64 startFilter = 0, endFilter = 0;
+    quint64 startLogging = 0, endLogging = 0;
 
-                // check all server entity scripts to make sure their URLs are in the whitelist
-                if (!properties.getServerScripts().isEmpty()) {
-                    bool serverScriptPassedWhitelist = isScriptInWhitelist(properties.getServerScripts());
+    bool suppressDisallowedClientScript = false;
+    bool suppressDisallowedServerScript = false;
+    bool isAdd = edit.type == PacketType::EntityAdd;
+    bool isPhysics = edit.type == PacketType::EntityPhysics;
 
-                    if (!serverScriptPassedWhitelist) {
-                        if (wantEditLogging()) {
-                            qCDebug(entities) << "User [" << senderNode->getUUID()
-                                << "] attempting to set server entity script not on whitelist, edit rejected";
-                        }
+    _totalEditMessages++;
 
-                        // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
-                        if (isAdd) {
-                            // Make sure we didn't already need to send back a delete because the client script failed
-                            // the whitelist check
-                            if (!wasDeletedBecauseOfClientScript) {
-                                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                                validEditPacket = false;
-                            }
-                        } else {
-                            suppressDisallowedServerScript = true;
-                        }
-                    }
-                }
+    EntityItemID& entityItemID = edit.entityItemID;
+    EntityItemProperties& properties = edit.properties;
+    bool validEditPacket = edit.isValid;
 
-            }
+    EntityItemPointer existingEntity;
+    if (!isAdd) {
+        // search for the entity by EntityItemID
+        startLookup = usecTimestampNow();
+        existingEntity = findEntityByEntityItemID(entityItemID);
+        endLookup = usecTimestampNow();
+        if (!existingEntity) {
+            // this is not an add-entity operation, and we don't know about the identified entity.
+            validEditPacket = false;
+        }
+    }
+
+    if (validEditPacket && !_entityScriptSourceWhitelist.isEmpty()) {
 
-            if ((isAdd || properties.lifetimeChanged()) &&
-                ((!senderNode->getCanRez() && senderNode->getCanRezTmp()) ||
-                (!senderNode->getCanRezCertified() && senderNode->getCanRezTmpCertified()))) {
-                // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
-                if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
-                    properties.getLifetime() > _maxTmpEntityLifetime) {
-                    properties.setLifetime(_maxTmpEntityLifetime);
-                    bumpTimestamp(properties);
+        bool wasDeletedBecauseOfClientScript = false;
+
+        // check the client entity script to make sure its URL is in the whitelist
+        if (!properties.getScript().isEmpty()) {
+            bool clientScriptPassedWhitelist = isScriptInWhitelist(properties.getScript());
+
+            if (!clientScriptPassedWhitelist) {
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID()
+                        << "] attempting to set entity script not on whitelist, edit rejected";
+                }
+
+                // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
+                if (isAdd) {
+                    QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                    _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                    validEditPacket = false;
+                    wasDeletedBecauseOfClientScript = true;
+                } else {
+                    suppressDisallowedClientScript = true;
                 }
             }
+        }
+
+        // check all server entity scripts to make sure their URLs are in the whitelist
+        if (!properties.getServerScripts().isEmpty()) {
+            bool serverScriptPassedWhitelist = isScriptInWhitelist(properties.getServerScripts());
 
-            // If we got a valid edit packet, then it could be a new entity or it could be an update to
-            // an existing entity... handle appropriately
-            if (validEditPacket) {
-                startFilter = usecTimestampNow();
-                bool wasChanged = false;
-                // Having (un)lock rights bypasses the filter, unless it's a physics result.
-                FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
-                bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
-                if (!allowed) {
-                    auto timestamp = properties.getLastEdited();
-                    properties = EntityItemProperties();
-                    properties.setLastEdited(timestamp);
+            if (!serverScriptPassedWhitelist) {
+                if (wantEditLogging()) {
+                    qCDebug(entities) << "User [" << senderNode->getUUID()
+                        << "] attempting to set server entity script not on whitelist, edit rejected";
                 }
-                if (!allowed || wasChanged) {
-                    bumpTimestamp(properties);
-                    // For now, free ownership on any modification.
-                    properties.clearSimulationOwner();
+
+                // If this was an add, we also want to tell the client that sent this edit that the entity was not added.
+                if (isAdd) {
+                    // Make sure we didn't already need to send back a delete because the client script failed
+                    // the whitelist check
+                    if (!wasDeletedBecauseOfClientScript) {
+                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+                        validEditPacket = false;
+                    }
+                } else {
+                    suppressDisallowedServerScript = true;
                 }
-                endFilter = usecTimestampNow();
+            }
+        }
 
-                if (existingEntity && !isAdd) {
+    }
 
-                    if (suppressDisallowedClientScript) {
-                        bumpTimestamp(properties);
-                        properties.setScript(existingEntity->getScript());
-                    }
+    if ((isAdd || properties.lifetimeChanged()) &&
+        ((!senderNode->getCanRez() && senderNode->getCanRezTmp()) ||
+        (!senderNode->getCanRezCertified() && senderNode->getCanRezTmpCertified()))) {
+        // this node is only allowed to rez temporary entities.  if need be, cap the lifetime.
+        if (properties.getLifetime() == ENTITY_ITEM_IMMORTAL_LIFETIME ||
+            properties.getLifetime() > _maxTmpEntityLifetime) {
+            properties.setLifetime(_maxTmpEntityLifetime);
+            bumpTimestamp(properties);
+        }
+    }
+
+    // If we got a valid edit packet, then it could be a new entity or it could be an update to
+    // an existing entity... handle appropriately
+    if (validEditPacket) {
+        startFilter = usecTimestampNow();
+        bool wasChanged = false;
+        // Having (un)lock rights bypasses the filter, unless it's a physics result.
+        FilterType filterType = isPhysics ? FilterType::Physics : (isAdd ? FilterType::Add : FilterType::Edit);
+        bool allowed = (!isPhysics && senderNode->isAllowedEditor()) || filterProperties(existingEntity, properties, properties, wasChanged, filterType);
+        if (!allowed) {
+            auto timestamp = properties.getLastEdited();
+            properties = EntityItemProperties();
+            properties.setLastEdited(timestamp);
+        }
+        if (!allowed || wasChanged) {
+            bumpTimestamp(properties);
+            // For now, free ownership on any modification.
+            properties.clearSimulationOwner();
+        }
+        endFilter = usecTimestampNow();
+
+        if (existingEntity && !isAdd) {
 
-                    if (suppressDisallowedServerScript) {
-                        bumpTimestamp(properties);
-                        properties.setServerScripts(existingEntity->getServerScripts());
+            if (suppressDisallowedClientScript) {
+                bumpTimestamp(properties);
+                properties.setScript(existingEntity->getScript());
+            }
+
+            if (suppressDisallowedServerScript) {
+                bumpTimestamp(properties);
+                properties.setServerScripts(existingEntity->getServerScripts());
+            }
+
+            // if the EntityItem exists, then update it
+            startLogging = usecTimestampNow();
+            if (wantEditLogging()) {
+                qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                qCDebug(entities) << "   properties:" << properties;
+            }
+            if (wantTerseEditLogging()) {
+                QList<QString> changedProperties = properties.listChangedProperties();
+                fixupTerseEditLogging(properties, changedProperties);
+                qCDebug(entities) << senderNode->getUUID() << "edit" <<
+                    existingEntity->getDebugName() << changedProperties;
+            }
+            endLogging = usecTimestampNow();
+
+            startUpdate = usecTimestampNow();
+            if (!isPhysics) {
+                properties.setLastEditedBy(senderNode->getUUID());
+            }
+            updateEntity(existingEntity, properties, senderNode);
+            existingEntity->markAsChangedOnServer();
+            endUpdate = usecTimestampNow();
+            _totalUpdates++;
+        } else if (isAdd) {
+            bool failedAdd = !allowed;
+            bool isCertified = !properties.getCertificateID().isEmpty();
+            if (!allowed) {
+                qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
+            } else if (!isCertified && !senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'uncertified rez rights' [" << senderNode->getUUID()
+                    << "] attempted to add an uncertified entity with ID:" << entityItemID;
+            } else if (isCertified && !senderNode->getCanRezCertified() && !senderNode->getCanRezTmpCertified()) {
+                failedAdd = true;
+                qCDebug(entities) << "User without 'certified rez rights' [" << senderNode->getUUID()
+                    << "] attempted to add a certified entity with ID:" << entityItemID;
+            } else {
+                // this is a new entity... assign a new entityID
+                properties.setCreated(properties.getLastEdited());
+                properties.setLastEditedBy(senderNode->getUUID());
+                startCreate = usecTimestampNow();
+                EntityItemPointer newEntity = addEntity(entityItemID, properties);
+                endCreate = usecTimestampNow();
+                _totalCreates++;
+
+                if (newEntity && isCertified && getIsServer()) {
+                    if (!properties.verifyStaticCertificateProperties()) {
+                        qCDebug(entities) << "User" << senderNode->getUUID()
+                            << "attempted to add a certified entity with ID" << entityItemID << "which failed"
+                            << "static certificate verification.";
+                        // Delete the entity we just added if it doesn't pass static certificate verification
+                        deleteEntity(entityItemID, true);
+                    } else {
+                        validatePop(properties.getCertificateID(), entityItemID, senderNode, false);
                     }
+                }
+
+                if (newEntity) {
+                    newEntity->markAsChangedOnServer();
+                    notifyNewlyCreatedEntity(*newEntity, senderNode);
 
-                    // if the EntityItem exists, then update it
                     startLogging = usecTimestampNow();
                     if (wantEditLogging()) {
-                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] editing entity. ID:" << entityItemID;
+                        qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
+                                          << newEntity->getEntityItemID();
                         qCDebug(entities) << "   properties:" << properties;
                     }
                     if (wantTerseEditLogging()) {
                         QList<QString> changedProperties = properties.listChangedProperties();
                         fixupTerseEditLogging(properties, changedProperties);
-                        qCDebug(entities) << senderNode->getUUID() << "edit" <<
-                            existingEntity->getDebugName() << changedProperties;
+                        qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
                     }
                     endLogging = usecTimestampNow();
 
-                    startUpdate = usecTimestampNow();
-                    if (!isPhysics) {
-                        properties.setLastEditedBy(senderNode->getUUID());
-                    }
-                    updateEntity(existingEntity, properties, senderNode);
-                    existingEntity->markAsChangedOnServer();
-                    endUpdate = usecTimestampNow();
-                    _totalUpdates++;
-                } else if (isAdd) {
-                    bool failedAdd = !allowed;
-                    bool isCertified = !properties.getCertificateID().isEmpty();
-                    if (!allowed) {
-                        qCDebug(entities) << "Filtered entity add. ID:" << entityItemID;
-                    } else if (!isCertified && !senderNode->getCanRez() && !senderNode->getCanRezTmp()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'uncertified rez rights' [" << senderNode->getUUID()
-                            << "] attempted to add an uncertified entity with ID:" << entityItemID;
-                    } else if (isCertified && !senderNode->getCanRezCertified() && !senderNode->getCanRezTmpCertified()) {
-                        failedAdd = true;
-                        qCDebug(entities) << "User without 'certified rez rights' [" << senderNode->getUUID()
-                            << "] attempted to add a certified entity with ID:" << entityItemID;
-                    } else {
-                        // this is a new entity... assign a new entityID
-                        properties.setCreated(properties.getLastEdited());
-                        properties.setLastEditedBy(senderNode->getUUID());
-                        startCreate = usecTimestampNow();
-                        EntityItemPointer newEntity = addEntity(entityItemID, properties);
-                        endCreate = usecTimestampNow();
-                        _totalCreates++;
-
-                        if (newEntity && isCertified && getIsServer()) {
-                            if (!properties.verifyStaticCertificateProperties()) {
-                                qCDebug(entities) << "User" << senderNode->getUUID()
-                                    << "attempted to add a certified entity with ID" << entityItemID << "which failed"
-                                    << "static certificate verification.";
-                                // Delete the entity we just added if it doesn't pass static certificate verification
-                                deleteEntity(entityItemID, true);
-                            } else {
-                                validatePop(properties.getCertificateID(), entityItemID, senderNode, false);
-                            }
-                        }
-
-                        if (newEntity) {
-                            newEntity->markAsChangedOnServer();
-                            notifyNewlyCreatedEntity(*newEntity, senderNode);
-
-                            startLogging = usecTimestampNow();
-                            if (wantEditLogging()) {
-                                qCDebug(entities) << "User [" << senderNode->getUUID() << "] added entity. ID:"
-                                                  << newEntity->getEntityItemID();
-                                qCDebug(entities) << "   properties:" << properties;
-                            }
-                            if (wantTerseEditLogging()) {
-                                QList<QString> changedProperties = properties.listChangedProperties();
-                                fixupTerseEditLogging(properties, changedProperties);
-                                qCDebug(entities) << senderNode->getUUID() << "add" << entityItemID << changedProperties;
-                            }
-                            endLogging = usecTimestampNow();
-
-                        } else {
-                            failedAdd = true;
-                            qCDebug(entities) << "Add entity failed ID:" << entityItemID;
-                        }
-                    }
-                    if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
-                        QWriteLocker locker(&_recentlyDeletedEntitiesLock);
-                        _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
-                    }
                 } else {
-                    static QString repeatedMessage =
-                        LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
-                    qCDebug(entities) << "Edit failed. [" << message.getType() <<"] " <<
-                            "entity id:" << entityItemID << 
-                            "existingEntity pointer:" << existingEntity.get();
+                    failedAdd = true;
+                    qCDebug(entities) << "Add entity failed ID:" << entityItemID;
                 }
             }
-
-
-            _totalDecodeTime += endDecode - startDecode;
-            _totalLookupTime += endLookup - startLookup;
-            _totalUpdateTime += endUpdate - startUpdate;
-            _totalCreateTime += endCreate - startCreate;
-            _totalLoggingTime += endLogging - startLogging;
-            _totalFilterTime += endFilter - startFilter;
-
-            break;
+            if (failedAdd) { // Let client know it failed, so that they don't have an entity that no one else sees.
+                QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+                _recentlyDeletedEntityItemIDs.insert(usecTimestampNow(), entityItemID);
+            }
+        } else {
+            static QString repeatedMessage =
+                LogHandler::getInstance().addRepeatedMessageRegex("^Edit failed.*");
+            qCDebug(entities) << "Edit failed. [" << edit.type <<"] " <<
+                    "entity id:" << entityItemID << 
+                    "existingEntity pointer:" << existingEntity.get();
         }
-
-        default:
-            processedBytes = 0;
-            break;
     }
-    return processedBytes;
+
+
+    _totalDecodeTime += edit.decodeTime;
+    _totalLookupTime += endLookup - startLookup;
+    _totalUpdateTime += endUpdate - startUpdate;
+    _totalCreateTime += endCreate - startCreate;
+    _totalLoggingTime += endLogging - startLogging;
+    _totalFilterTime += endFilter - startFilter;
 }
 
 
@@ -1892,50 +2038,24 @@ int EntityTree::processEraseMessage(ReceivedMessage& message, const SharedNodePo
 // NOTE: Caller must lock the tree before calling this.
 // TODO: consider consolidating processEraseMessageDetails() and processEraseMessage()
 int EntityTree::processEraseMessageDetails(const QByteArray& dataByteArray, const SharedNodePointer& sourceNode) {
-    #ifdef EXTRA_ERASE_DEBUGGING
-        qCDebug(entities) << "EntityTree::processEraseMessageDetails()";
-    #endif
-    const unsigned char* packetData = (const unsigned char*)dataByteArray.constData();
-    const unsigned char* dataAt = packetData;
-    size_t packetLength = dataByteArray.size();
-    size_t processedBytes = 0;
-
-    uint16_t numberOfIds = 0; // placeholder for now
-    memcpy(&numberOfIds, dataAt, sizeof(numberOfIds));
-    dataAt += sizeof(numberOfIds);
-    processedBytes += sizeof(numberOfIds);
-
-    if (numberOfIds > 0) {
-        QSet<EntityItemID> entityItemIDsToDelete;
-
-        for (size_t i = 0; i < numberOfIds; i++) {
-
-
-            if (processedBytes + NUM_BYTES_RFC4122_UUID > packetLength) {
-                qCDebug(entities) << "EntityTree::processEraseMessageDetails().... bailing because not enough bytes in buffer";
-                break; // bail to prevent buffer overflow
-            }
-
-            QByteArray encodedID = dataByteArray.mid((int)processedBytes, NUM_BYTES_RFC4122_UUID);
-            QUuid entityID = QUuid::fromRfc4122(encodedID);
-            dataAt += encodedID.size();
-            processedBytes += encodedID.size();
-
-            #ifdef EXTRA_ERASE_DEBUGGING
-                qCDebug(entities) << "    ---- EntityTree::processEraseMessageDetails() contains id:" << entityID;
-            #endif
-
-            EntityItemID entityItemID(entityID);
-            entityItemIDsToDelete << entityItemID;
+    DecodedEntityEdit edit;
+    edit.type = PacketType::EntityErase;
+    int processedBytes = decodeEraseMessageDetails(dataByteArray, edit.erasedEntityIDs);
+    applyEraseEdit(edit, sourceNode);
+    return processedBytes;
+}
 
-            if (wantEditLogging() || wantTerseEditLogging()) {
-                qCDebug(entities) << "User [" << sourceNode->getUUID() << "] deleting entity. ID:" << entityItemID;
-            }
+void EntityTree::applyEraseEdit(const DecodedEntityEdit& edit, const SharedNodePointer& senderNode) {
+    if (edit.erasedEntityIDs.isEmpty()) {
+        return;
+    }
 
+    if (wantEditLogging() || wantTerseEditLogging()) {
+        foreach (const EntityItemID& entityItemID, edit.erasedEntityIDs) {
+            qCDebug(entities) << "User [" << senderNode->getUUID() << "] deleting entity. ID:" << entityItemID;
         }
-        deleteEntities(entityItemIDsToDelete, true, true);
     }
-    return (int)processedBytes;
+    deleteEntities(edit.erasedEntityIDs, true, true);
 }
 
 EntityTreeElementPointer EntityTree::getContainingElement(const EntityItemID& entityItemID)  /*const*/ {
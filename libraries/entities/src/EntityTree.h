@@ -93,6 +93,10 @@ public:
     void fixupTerseEditLogging(EntityItemProperties& properties, QList<QString>& changedProperties);
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& senderNode) override;
+    virtual bool canDecodeEditPackets() const override { return getIsServer(); }
+    virtual DecodedEditPointer decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                    int& bytesRead) const override;
+    virtual void applyDecodedEdit(DecodedEdit& edit, const SharedNodePointer& senderNode) override;
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override;
@@ -104,6 +108,15 @@ public:
         BoxFace& face, glm::vec3& surfaceNormal, void** intersectedObject = NULL,
         Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
 
+    // Same as findRayIntersection() for a batch of rays, such as the entity picks of a frame.  Entities whose detailed
+    // tests can be batched, such as models, test all the rays of the batch that reach them at once.  results[i] and
+    // entityIDs[i] are the result of origins[i] and directions[i].
+    void findRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+        QVector<EntityItemID> entityIdsToInclude, QVector<EntityItemID> entityIdsToDiscard,
+        bool visibleOnly, bool collidableOnly, bool precisionPicking,
+        std::vector<TriangleSet::RayIntersection>& results, std::vector<EntityItemID>& entityIDs,
+        Octree::lockType lockType = Octree::TryLock, bool* accurateResult = NULL);
+
     virtual bool rootElementHasData() const override { return true; }
 
     // the root at least needs to store the number of entities in the packet/buffer
@@ -342,6 +355,18 @@ protected:
     bool _wantTerseEditLogging = false;
 
 
+    // an add, edit or erase decoded from an edit packet, see decodeEditPacketData
+    class DecodedEntityEdit : public DecodedEdit {
+    public:
+        PacketType type { PacketType::Unknown };
+        bool isValid { false };
+        EntityItemID entityItemID;
+        EntityItemProperties properties;
+        QSet<EntityItemID> erasedEntityIDs;
+        quint64 decodeTime { 0 };
+    };
+    void applyEraseEdit(const DecodedEntityEdit& edit, const SharedNodePointer& senderNode);
+
     // some performance tracking properties - only used in server trees
     int _totalEditMessages = 0;
     int _totalUpdates = 0;
@@ -14,6 +14,7 @@
 #include <glm/gtx/transform.hpp>
 
 #include <GeometryUtil.h>
+#include <OctreeElementArena.h>
 #include <OctreeUtils.h>
 #include <Extents.h>
 
@@ -32,7 +33,7 @@ EntityTreeElement::~EntityTreeElement() {
 }
 
 OctreeElementPointer EntityTreeElement::createNewElement(unsigned char* octalCode) {
-    auto newChild = EntityTreeElementPointer(new EntityTreeElement(octalCode));
+    auto newChild = std::allocate_shared<EntityTreeElement>(OctreeElementAllocator<EntityTreeElement>(), octalCode);
     newChild->setTree(_myTree);
     return newChild;
 }
@@ -303,7 +304,9 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     uint16_t numberOfEntities = 0;
     uint16_t actualNumberOfEntities = 0;
     int numberOfEntitiesOffset = 0;
-    withReadLock([&] {
+    // encode from a snapshot of the entities, edits to this element don't wait for the encode
+    const EntityItems entityItems = getEntitiesSnapshot();
+    {
         QVector<uint16_t> indexesOfEntitiesToInclude;
 
         // It's possible that our element has been previous completed. In this case we'll simply not include any of our
@@ -317,8 +320,8 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             auto jsonFilters = entityNodeData->getJSONParameters();
 
 
-            for (uint16_t i = 0; i < _entityItems.size(); i++) {
-                EntityItemPointer entity = _entityItems[i];
+            for (uint16_t i = 0; i < entityItems.size(); i++) {
+                EntityItemPointer entity = entityItems[i];
                 bool includeThisEntity = true;
 
                 if (!params.forceSendScene && entity->getLastChangedOnServer() < entityNodeData->getLastTimeBagEmpty()) {
@@ -418,7 +421,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
 
         if (successAppendEntityCount) {
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
-                EntityItemPointer entity = _entityItems[i];
+                EntityItemPointer entity = entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
                 OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
                     params, entityTreeElementExtraEncodeData);
@@ -450,7 +453,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             // we we couldn't add the entity count, then we couldn't add anything for this element and we're in a NONE state
             appendElementState = OctreeElement::NONE;
         }
-    });
+    }
 
     // If we were provided with extraEncodeData, and we allocated and/or got entityTreeElementExtraEncodeData
     // then we need to do some additional processing, namely make sure our extraEncodeData is up to date for
@@ -592,7 +595,7 @@ bool EntityTreeElement::findRayIntersection(const glm::vec3& origin, const glm::
     bool& keepSearching, OctreeElementPointer& element, float& distance,
     BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
     const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly,
-    void** intersectedObject, bool precisionPicking) {
+    void** intersectedObject, bool precisionPicking, DeferredRayIntersections* deferred) {
 
     keepSearching = true; // assume that we will continue searching after this.
 
@@ -618,7 +621,7 @@ bool EntityTreeElement::findRayIntersection(const glm::vec3& origin, const glm::
 
         if (findDetailedRayIntersection(origin, direction, keepSearching, element, distanceToElementDetails,
                 face, localSurfaceNormal, entityIdsToInclude, entityIdsToDiscard, visibleOnly, collidableOnly,
-                intersectedObject, precisionPicking, distanceToElementCube)) {
+                intersectedObject, precisionPicking, distanceToElementCube, deferred)) {
 
             if (distanceToElementDetails < distance) {
                 distance = distanceToElementDetails;
@@ -634,7 +637,8 @@ bool EntityTreeElement::findRayIntersection(const glm::vec3& origin, const glm::
 bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, const glm::vec3& direction, bool& keepSearching,
                                     OctreeElementPointer& element, float& distance, BoxFace& face, glm::vec3& surfaceNormal,
                                     const QVector<EntityItemID>& entityIdsToInclude, const QVector<EntityItemID>& entityIDsToDiscard,
-                                    bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking, float distanceToElementCube) {
+                                    bool visibleOnly, bool collidableOnly, void** intersectedObject, bool precisionPicking, float distanceToElementCube,
+                                    DeferredRayIntersections* deferred) {
 
     // only called if we do intersect our bounding cube, but find if we actually intersect with entities...
     int entityNumber = 0;
@@ -680,9 +684,19 @@ bool EntityTreeElement::findDetailedRayIntersection(const glm::vec3& origin, con
         // and testing intersection there.
         if (entityFrameBox.findRayIntersection(entityFrameOrigin, entityFrameDirection, localDistance,
                                                 localFace, localSurfaceNormal)) {
-            if (entityFrameBox.contains(entityFrameOrigin) || localDistance < distance) {
+            bool originInBox = entityFrameBox.contains(entityFrameOrigin);
+            if (originInBox || localDistance < distance) {
                 // now ask the entity if we actually intersect
-                if (entity->supportsDetailedRayIntersection()) {
+                if (deferred && entity->supportsDetailedRayIntersection() && entity->supportsBatchedRayIntersection()) {
+                    // the caller tests it later, together with the other rays of its batch that hit it
+                    DeferredRayIntersection deferredIntersection;
+                    deferredIntersection.entity = entity;
+                    deferredIntersection.boxDistance = localDistance;
+                    deferredIntersection.boxFace = localFace;
+                    deferredIntersection.boxSurfaceNormal = localSurfaceNormal;
+                    deferredIntersection.originInBox = originInBox;
+                    deferred->push_back(deferredIntersection);
+                } else if (entity->supportsDetailedRayIntersection()) {
                     if (entity->findDetailedRayIntersection(origin, direction, keepSearching, element, localDistance,
                         localFace, localSurfaceNormal, intersectedObject, precisionPicking)) {
 
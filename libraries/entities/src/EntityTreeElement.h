@@ -29,6 +29,18 @@ using EntityTreeElementWeakPointer = std::weak_ptr<EntityTreeElement>;
 using EntityTreeElementPointer = std::shared_ptr<EntityTreeElement>;
 using EntityItemFilter = std::function<bool(EntityItemPointer&)>;
 
+// An entity whose box is hit by one of a batch of rays, and whose detailed test is left for the end of the batch so it
+// can be done together with the batch's other rays that hit it.  See EntityItem::supportsBatchedRayIntersection().
+struct DeferredRayIntersection {
+    EntityItemPointer entity;
+    size_t ray { 0 };
+    float boxDistance { 0.0f };
+    BoxFace boxFace { UNKNOWN_FACE };
+    glm::vec3 boxSurfaceNormal;
+    bool originInBox { false };
+};
+using DeferredRayIntersections = std::vector<DeferredRayIntersection>;
+
 class EntityTreeUpdateArgs {
 public:
     EntityTreeUpdateArgs() :
@@ -150,23 +162,29 @@ public:
         bool& keepSearching, OctreeElementPointer& node, float& distance,
         BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
         const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly = false, bool collidableOnly = false,
-        void** intersectedObject = NULL, bool precisionPicking = false);
+        void** intersectedObject = NULL, bool precisionPicking = false, DeferredRayIntersections* deferred = nullptr);
+    // when deferred is given, the entities that support batched ray intersection are added to it instead of being tested
     virtual bool findDetailedRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
                          bool& keepSearching, OctreeElementPointer& element, float& distance,
                          BoxFace& face, glm::vec3& surfaceNormal, const QVector<EntityItemID>& entityIdsToInclude,
                          const QVector<EntityItemID>& entityIdsToDiscard, bool visibleOnly, bool collidableOnly,
-                         void** intersectedObject, bool precisionPicking, float distanceToElementCube);
+                         void** intersectedObject, bool precisionPicking, float distanceToElementCube,
+                         DeferredRayIntersections* deferred = nullptr);
     virtual bool findSpherePenetration(const glm::vec3& center, float radius,
                         glm::vec3& penetration, void** penetratedObject) const override;
 
 
+    // A snapshot of this element's entities.  EntityItems is copy-on-write, so taking one only bumps a reference count
+    // and later adds and removes copy the list instead of waiting for the holders of a snapshot to finish.
+    EntityItems getEntitiesSnapshot() const { return resultWithReadLock<EntityItems>([&] { return _entityItems; }); }
+
+    // f runs on a snapshot, without holding the element lock, so long traversals (sending, persisting) don't block edits
     template <typename F>
     void forEachEntity(F f) const {
-        withReadLock([&] {
-            foreach(EntityItemPointer entityItem, _entityItems) {
-                f(entityItem);
-            }
-        });
+        const EntityItems entityItems = getEntitiesSnapshot();
+        for (const EntityItemPointer& entityItem : entityItems) {
+            f(entityItem);
+        }
     }
 
     virtual uint16_t size() const;
@@ -0,0 +1,118 @@
+//
+//  AssetCache.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCache.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+
+#include "NetworkLogging.h"
+
+const char* AssetCache::ASSET_CACHE_EXT = "atp";
+
+AssetCache::AssetCache(const std::string& dirname) :
+    FileCache(dirname, ASSET_CACHE_EXT) { }
+
+std::unique_ptr<cache::File> AssetCache::createFile(Metadata&& metadata, const std::string& filepath) {
+    return std::unique_ptr<cache::File>(new AssetCacheFile(std::move(metadata), filepath));
+}
+
+AssetCacheFilePointer AssetCache::getAssetFile(const AssetHash& hash) {
+    return std::static_pointer_cast<AssetCacheFile>(getFile(hash.toLower().toStdString()));
+}
+
+bool AssetCache::contains(const AssetHash& hash) {
+    return (bool)getAssetFile(hash);
+}
+
+QByteArray AssetCache::read(const AssetHash& hash) {
+    return read(hash, ByteRange());
+}
+
+QByteArray AssetCache::read(const AssetHash& hash, ByteRange byteRange) {
+    auto file = getAssetFile(hash);
+    if (!file) {
+        return QByteArray();
+    }
+
+    int64_t length = (int64_t)file->getLength();
+    byteRange.fixupRange(length);
+    if (length < byteRange.fromInclusive || length < byteRange.toExclusive) {
+        qCDebug(asset_client) << "Byte range" << byteRange.fromInclusive << ":" << byteRange.toExclusive
+            << "is outside of cached asset" << hash;
+        return QByteArray();
+    }
+
+    int64_t offset = (byteRange.fromInclusive >= 0) ? byteRange.fromInclusive : length + byteRange.fromInclusive;
+    QByteArray data;
+    if (!file->read(offset, byteRange.size(), data)) {
+        qCWarning(asset_client) << "Cached asset" << hash << "failed verification, removing it from the cache";
+        removeFile(file);
+        return QByteArray();
+    }
+    return data;
+}
+
+bool AssetCache::write(const AssetHash& hash, const QByteArray& data) {
+    auto file = std::static_pointer_cast<AssetCacheFile>(writeFile(data.constData(),
+        Metadata(hash.toLower().toStdString(), data.size())));
+    if (!file) {
+        return false;
+    }
+
+    file->_verified = true;
+    return true;
+}
+
+AssetCacheFile::AssetCacheFile(Metadata&& metadata, const std::string& filepath) :
+    cache::File(std::move(metadata), filepath) { }
+
+bool AssetCacheFile::read(int64_t offset, int64_t size, QByteArray& data) {
+    std::lock_guard<std::mutex> lock(_readMutex);
+    if (_corrupted) {
+        return false;
+    }
+
+    QFile file(QString::fromStdString(getFilepath()));
+    if (!file.open(QIODevice::ReadOnly) || file.size() != (qint64)getLength()) {
+        _corrupted = true;
+        return false;
+    }
+
+    // the first read maps the whole file to hash it, later ones only the range they copy
+    bool mapWholeFile = !_verified;
+    qint64 mapOffset = mapWholeFile ? 0 : offset;
+    qint64 mapSize = mapWholeFile ? (qint64)getLength() : size;
+    const uchar* mapped = (mapSize > 0) ? file.map(mapOffset, mapSize) : reinterpret_cast<const uchar*>("");
+    if (!mapped) {
+        _corrupted = true;
+        return false;
+    }
+
+    if (!_verified) {
+        // hash the mapping in place, fromRawData does not copy
+        auto contents = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), (int)getLength());
+        auto hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha256).toHex();
+        if (hash != QByteArray(getKey().c_str())) {
+            if (mapSize > 0) {
+                file.unmap(const_cast<uchar*>(mapped));
+            }
+            _corrupted = true;
+            return false;
+        }
+        _verified = true;
+    }
+
+    data = QByteArray(reinterpret_cast<const char*>(mapped + (offset - mapOffset)), (int)size);
+    if (mapSize > 0) {
+        file.unmap(const_cast<uchar*>(mapped));
+    }
+    return true;
+}
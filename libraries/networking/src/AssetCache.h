@@ -0,0 +1,74 @@
+//
+//  AssetCache.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCache_h
+#define hifi_AssetCache_h
+
+#include <atomic>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+
+#include <shared/FileCache.h>
+
+#include "AssetUtils.h"
+#include "ByteRange.h"
+
+class AssetCacheFile;
+using AssetCacheFilePointer = std::shared_ptr<AssetCacheFile>;
+
+// Local store for downloaded ATP assets, keyed by their SHA-256 hash. Assets are immutable and content-addressed,
+// so there is no metadata to keep: each asset is one file named after its hash, least recently used files are
+// ejected once the cache is over budget, and reads map the file instead of streaming it through a QIODevice.
+class AssetCache : public cache::FileCache {
+    Q_OBJECT
+
+public:
+    static const char* ASSET_CACHE_EXT;
+
+    AssetCache(const std::string& dirname);
+
+    bool contains(const AssetHash& hash);
+
+    // returns the cached asset, or a null QByteArray if it is not in the cache or failed verification
+    QByteArray read(const AssetHash& hash);
+
+    // returns a range of the cached asset, resolved the same way the asset-server resolves request ranges
+    QByteArray read(const AssetHash& hash, ByteRange byteRange);
+
+    // the caller is responsible for having verified that the data matches the hash
+    bool write(const AssetHash& hash, const QByteArray& data);
+
+protected:
+    std::unique_ptr<cache::File> createFile(Metadata&& metadata, const std::string& filepath) override final;
+
+private:
+    AssetCacheFilePointer getAssetFile(const AssetHash& hash);
+};
+
+class AssetCacheFile : public cache::File {
+public:
+    // copies size bytes from offset into data, checking the contents against the key the first time the file is read;
+    // the file is only open and mapped for the read, so files the cache keeps hold no descriptors or address space
+    bool read(int64_t offset, int64_t size, QByteArray& data);
+
+private:
+    friend class AssetCache;
+
+    AssetCacheFile(Metadata&& metadata, const std::string& filepath);
+
+    std::mutex _readMutex;
+    bool _corrupted { false };
+
+    // files written during this session were verified on receipt
+    std::atomic<bool> _verified { false };
+};
+
+#endif // hifi_AssetCache_h
@@ -12,8 +12,11 @@
 #include "AssetClient.h"
 
 #include <cstdint>
+#include <limits>
 
 #include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QThread>
 #include <QtScript/QScriptEngine>
@@ -30,9 +33,31 @@
 #include "NodeList.h"
 #include "PacketReceiver.h"
 #include "ResourceCache.h"
+#include "ResourceManager.h"
 
 MessageID AssetClient::_currentID = 0;
 
+static const QString ATP_CACHE_DIRNAME = "atp";
+
+// the network cache and the asset cache split the disk budget of the resource caches between them
+static const qint64 NETWORK_CACHE_MAX_SIZE = MAXIMUM_CACHE_SIZE / 2;
+static const qint64 ASSET_CACHE_MAX_SIZE = MAXIMUM_CACHE_SIZE - NETWORK_CACHE_MAX_SIZE;
+
+// ATP assets used to be kept in the network cache, where nothing looks them up anymore
+static void purgeATPEntries(QNetworkDiskCache* cache) {
+    int numPurged = 0;
+    QDirIterator it(cache->cacheDirectory(), QStringList() << "*.d", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QUrl url = cache->fileMetaData(it.next()).url();
+        if (url.scheme() == URL_SCHEME_ATP && cache->remove(url)) {
+            ++numPurged;
+        }
+    }
+    if (numPurged > 0) {
+        qCInfo(asset_client) << "Removed" << numPurged << "ATP assets from the network cache";
+    }
+}
+
 AssetClient::AssetClient() {
     _cacheDir = qApp->property(hifi::properties::APP_LOCAL_DATA_PATH).toString();
     setCustomDeleter([](Dependency* dependency){
@@ -55,23 +80,43 @@ AssetClient::AssetClient() {
 void AssetClient::init() {
     Q_ASSERT(QThread::currentThread() == thread());
 
-    // Setup disk cache if not already
-    auto& networkAccessManager = NetworkAccessManager::getInstance();
-    if (!networkAccessManager.cache()) {
-        if (_cacheDir.isEmpty()) {
+    if (_cacheDir.isEmpty()) {
 #ifdef Q_OS_ANDROID
-            QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
 #else
-            QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+        QString cachePath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
 #endif
-            _cacheDir = !cachePath.isEmpty() ? cachePath : "interfaceCache";
-        }
+        _cacheDir = !cachePath.isEmpty() ? cachePath : "interfaceCache";
+    }
+
+    // Setup disk cache if not already
+    auto& networkAccessManager = NetworkAccessManager::getInstance();
+    if (!networkAccessManager.cache()) {
         QNetworkDiskCache* cache = new QNetworkDiskCache();
-        cache->setMaximumCacheSize(MAXIMUM_CACHE_SIZE);
+        cache->setMaximumCacheSize(NETWORK_CACHE_MAX_SIZE);
         cache->setCacheDirectory(_cacheDir);
         networkAccessManager.setCache(cache);
         qInfo() << "ResourceManager disk cache setup at" << _cacheDir
-                 << "(size:" << MAXIMUM_CACHE_SIZE / BYTES_PER_GIGABYTES << "GB)";
+                 << "(size:" << NETWORK_CACHE_MAX_SIZE / BYTES_PER_GIGABYTES << "GB)";
+    }
+
+    // ATP assets are content-addressed, so they get their own hash keyed store rather than the network cache
+    if (!_assetCache) {
+        QString assetCacheDir = QDir(_cacheDir).filePath(ATP_CACHE_DIRNAME);
+
+        // the first start with an asset cache clears out the assets the network cache was holding
+        auto* networkCache = qobject_cast<QNetworkDiskCache*>(networkAccessManager.cache());
+        if (networkCache && !QDir(assetCacheDir).exists()) {
+            purgeATPEntries(networkCache);
+        }
+
+        auto assetCache = std::make_shared<AssetCache>(assetCacheDir.toStdString());
+        assetCache->initialize();
+        assetCache->setMaxSize(ASSET_CACHE_MAX_SIZE);
+        std::atomic_store(&_assetCache, assetCache);
+        qInfo() << "AssetClient asset cache setup at" << assetCacheDir
+                 << "(assets:" << assetCache->getNumTotalFiles()
+                 << "size:" << assetCache->getSizeTotalFiles() / BYTES_PER_MEGABYTES << "MB)";
     }
 }
 
@@ -105,6 +150,11 @@ void AssetClient::clearCache() {
     } else {
         qCWarning(asset_client) << "No disk cache to clear.";
     }
+
+    if (auto assetCache = getAssetCache()) {
+        qInfo() << "AssetClient::clearCache(): Clearing asset cache.";
+        assetCache->wipe();
+    }
 }
 
 void AssetClient::handleAssetMappingOperationReply(QSharedPointer<ReceivedMessage> message, SharedNodePointer senderNode) {
@@ -364,6 +414,9 @@ void AssetClient::handleAssetGetReply(QSharedPointer<ReceivedMessage> message, S
     // Store message in case we need to disconnect from it later.
     callbacks.message = message;
 
+    if (!message->isComplete() && length > 0 && length <= std::numeric_limits<int>::max()) {
+        callbacks.data.reserve((int)length);
+    }
 
     auto weakNode = senderNode.toWeakRef();
     connect(message.data(), &ReceivedMessage::progress, this, [this, weakNode, messageID, length](qint64 size) {
@@ -411,9 +464,21 @@ void AssetClient::handleProgressCallback(const QWeakPointer<Node>& node, Message
     }
 
     auto& callbacks = requestIt->second;
+    drainReceivedAssetData(callbacks);
     callbacks.progressCallback(size, length);
 }
 
+void AssetClient::drainReceivedAssetData(GetAssetRequestData& request) {
+    if (!request.message) {
+        return;
+    }
+
+    // the chunks are appended to the pre-sized buffer and released, so the message never holds a second full copy
+    request.message->consumeReceivedData([&request](const QByteArray& chunk) {
+        request.data.append(chunk);
+    });
+}
+
 void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, MessageID messageID, DataOffset length) {
     auto senderNode = node.toStrongRef();
 
@@ -447,10 +512,14 @@ void AssetClient::handleCompleteCallback(const QWeakPointer<Node>& node, Message
         return;
     }
 
-    if (message->failed() || length != message->getBytesLeftToRead()) {
+    if (!message->failed()) {
+        drainReceivedAssetData(callbacks);
+    }
+
+    if (message->failed() || length != callbacks.data.size()) {
         callbacks.completeCallback(false, AssetServerError::NoError, QByteArray());
     } else {
-        callbacks.completeCallback(true, AssetServerError::NoError, message->readAll());
+        callbacks.completeCallback(true, AssetServerError::NoError, callbacks.data);
     }
 
     // We should never get to this point without the associated senderNode and messageID
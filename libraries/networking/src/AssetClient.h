@@ -20,6 +20,7 @@
 
 #include <DependencyManager.h>
 
+#include "AssetCache.h"
 #include "AssetUtils.h"
 #include "ByteRange.h"
 #include "ClientServerUtils.h"
@@ -62,6 +63,9 @@ public:
     Q_INVOKABLE AssetUpload* createUpload(const QString& filename);
     Q_INVOKABLE AssetUpload* createUpload(const QByteArray& data);
 
+    // null until init() has run
+    std::shared_ptr<AssetCache> getAssetCache() const { return std::atomic_load(&_assetCache); }
+
 public slots:
     void init();
 
@@ -104,8 +108,14 @@ private:
         QSharedPointer<ReceivedMessage> message;
         ReceivedAssetCallback completeCallback;
         ProgressCallback progressCallback;
+
+        // the asset data of multi-packet replies is moved here from the message as it arrives,
+        // pre-sized from the length in the reply header so it is never reallocated
+        QByteArray data;
     };
 
+    void drainReceivedAssetData(GetAssetRequestData& request);
+
     static MessageID _currentID;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, MappingOperationCallback>> _pendingMappingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetAssetRequestData>> _pendingRequests;
@@ -113,6 +123,7 @@ private:
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
 
     QString _cacheDir;
+    std::shared_ptr<AssetCache> _assetCache;
 
     friend class AssetRequest;
     friend class AssetUpload;
@@ -60,22 +60,25 @@ void AssetRequest::start() {
         return;
     }
     
-    // Try to load from cache
-    _data = loadFromCache(getUrl());
-    if (!_data.isNull()) {
-        _error = NoError;
+    auto assetClient = DependencyManager::get<AssetClient>();
 
-        _loadedFromCache = true;
+    // Try to load from cache, ranged requests are served out of a fully cached asset
+    if (auto assetCache = assetClient->getAssetCache()) {
+        _data = assetCache->read(_hash, _byteRange);
+        if (!_data.isNull()) {
+            _error = NoError;
 
-        _state = Finished;
-        emit finished(this);
+            _loadedFromCache = true;
 
-        return;
+            _state = Finished;
+            emit finished(this);
+
+            return;
+        }
     }
 
     _state = WaitingForData;
 
-    auto assetClient = DependencyManager::get<AssetClient>();
     auto that = QPointer<AssetRequest>(this); // Used to track the request's lifetime
     auto hash = _hash;
 
@@ -115,7 +118,9 @@ void AssetRequest::start() {
                 emit progress(_totalReceived, data.size());
 
                 if (!_byteRange.isSet()) {
-                    saveToCache(getUrl(), data);
+                    if (auto assetCache = DependencyManager::get<AssetClient>()->getAssetCache()) {
+                        assetCache->write(_hash, data);
+                    }
                 }
             }
         }
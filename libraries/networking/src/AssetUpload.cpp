@@ -105,7 +105,9 @@ void AssetUpload::start() {
         }
         
         if (_error == NoError && hash == hashData(_data).toHex()) {
-            saveToCache(getATPUrl(hash), _data);
+            if (auto assetCache = DependencyManager::get<AssetClient>()->getAssetCache()) {
+                assetCache->write(hash, _data);
+            }
         }
         
         emit finished(this, hash);
@@ -25,6 +25,7 @@
 
 #include <LogHandler.h>
 #include <shared/NetworkUtils.h>
+#include <shared/QtHelpers.h>
 #include <NumericalConstants.h>
 #include <SettingHandle.h>
 #include <SharedUtil.h>
@@ -37,6 +38,9 @@
 #include "NetworkLogging.h"
 #include "udt/Packet.h"
 
+const SharedNodePointer NodeTable::NULL_NODE;
+std::atomic<uint64_t> NodeTable::_latestVersion { 0 };
+
 static Setting::Handle<quint16> LIMITED_NODELIST_LOCAL_PORT("LimitedNodeList.LocalPort", 0);
 
 const std::set<NodeType_t> SOLO_NODE_TYPES = {
@@ -193,6 +197,23 @@ void LimitedNodeList::setSocketLocalPort(quint16 socketLocalPort) {
     }
 }
 
+bool LimitedNodeList::startPacketCapture(const QString& filePath) {
+    if (QThread::currentThread() != thread()) {
+        bool result = false;
+        BLOCKING_INVOKE_METHOD(this, "startPacketCapture", Q_RETURN_ARG(bool, result), Q_ARG(QString, filePath));
+        return result;
+    }
+    return _nodeSocket.startCapture(filePath);
+}
+
+void LimitedNodeList::stopPacketCapture() {
+    if (QThread::currentThread() != thread()) {
+        BLOCKING_INVOKE_METHOD(this, "stopPacketCapture");
+        return;
+    }
+    _nodeSocket.stopCapture();
+}
+
 QUdpSocket& LimitedNodeList::getDTLSSocket() {
     if (!_dtlsSocket) {
         // DTLS socket getter called but no DTLS socket exists, create it now
@@ -539,11 +560,59 @@ NodeData* LimitedNodeList::getOrCreateLinkedData(SharedNodePointer node) {
 }
 
 SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
+    return getNodeTable()->nodeWithUUID(nodeUUID);
+}
+
+NodeIndex LimitedNodeList::allocateNodeIndex() {
+    QMutexLocker locker(&_nodeTableMutex);
 
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
- }
+    // hand out the smallest free index so the indices stay dense
+    if (!_freeNodeIndices.empty()) {
+        auto it = _freeNodeIndices.begin();
+        NodeIndex nodeIndex = *it;
+        _freeNodeIndices.erase(it);
+        return nodeIndex;
+    }
+
+    return _nextNodeIndex++;
+}
+
+void LimitedNodeList::releaseNodeIndex(NodeIndex nodeIndex) {
+    QMutexLocker locker(&_nodeTableMutex);
+    _freeNodeIndices.insert(nodeIndex);
+}
+
+void LimitedNodeList::publishNodeTable() {
+    QMutexLocker locker(&_nodeTableMutex);
+
+    auto nodeTable = std::make_shared<NodeTable>();
+    nodeTable->_nodes.reserve(_nodeHash.size());
+
+    for (const auto& pair : _nodeHash) {
+        const SharedNodePointer& node = pair.second;
+        NodeIndex nodeIndex = node->getNodeIndex();
+
+        if (nodeIndex >= nodeTable->_nodesByIndex.size()) {
+            nodeTable->_nodesByIndex.resize(nodeIndex + 1);
+        }
+
+        nodeTable->_nodes.push_back(node);
+        nodeTable->_nodesByIndex[nodeIndex] = node;
+        nodeTable->_indexByUUID.emplace(node->getUUID(), nodeIndex);
+    }
+
+    // the nodes that didn't make it to the new table are gone, their indices can be reused
+    auto previousTable = std::atomic_load(&_nodeTable);
+    for (const auto& node : *previousTable) {
+        NodeIndex nodeIndex = node->getNodeIndex();
+        if (nodeTable->nodeWithIndex(nodeIndex) != node) {
+            _freeNodeIndices.insert(nodeIndex);
+        }
+    }
+
+    nodeTable->_version = ++NodeTable::_latestVersion;
+    std::atomic_store(&_nodeTable, NodeTable::Pointer(std::move(nodeTable)));
+}
 
 void LimitedNodeList::eraseAllNodes() {
     QSet<SharedNodePointer> killedNodes;
@@ -562,6 +631,8 @@ void LimitedNodeList::eraseAllNodes() {
                 killedNodes.insert(it->second);
                 it = _nodeHash.unsafe_erase(it);
             }
+
+            publishNodeTable();
         }
     }
 
@@ -589,6 +660,7 @@ bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
         {
             QWriteLocker writeLocker(&_nodeMutex);
             _nodeHash.unsafe_erase(it);
+            publishNodeTable();
         }
 
         handleNodeKill(matchingNode);
@@ -641,6 +713,7 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
         newNode->setIsUpstream(isUpstream || NodeType::isUpstream(nodeType));
         newNode->setConnectionSecret(connectionSecret);
         newNode->setPermissions(permissions);
+        newNode->setNodeIndex(allocateNodeIndex());
 
         // move the newly constructed node to the LNL thread
         newNode->moveToThread(thread());
@@ -667,6 +740,8 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
                 auto oldSoloNode = previousSoloIt->second;
 
                 _nodeHash.unsafe_erase(previousSoloIt);
+                // published now, as the new node may lose the race to be inserted and never publish a table
+                publishNodeTable();
                 handleNodeKill(oldSoloNode);
 
                 // convert the current lock back to a read lock for insertion of new node
@@ -677,10 +752,18 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         // insert the new node and release our read lock
 #if defined(Q_OS_ANDROID) || (defined(__clang__) && defined(Q_OS_LINUX))
-        _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+        auto insertResult = _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
 #else
-        _nodeHash.emplace(newNode->getUUID(), newNodePointer);
+        auto insertResult = _nodeHash.emplace(newNode->getUUID(), newNodePointer);
 #endif
+        if (!insertResult.second) {
+            // another thread added this node since we looked it up, the node in the list is theirs
+            // and ours never makes it to a node table, so give its index back now
+            releaseNodeIndex(newNode->getNodeIndex());
+            return insertResult.first->second;
+        }
+
+        publishNodeTable();
         readLocker.unlock();
 
         qCDebug(networking) << "Added" << *newNode;
@@ -1123,11 +1206,11 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    auto nodeTable = getNodeTable();
+    auto it = std::find_if(nodeTable->cbegin(), nodeTable->cend(), [&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
+    return (it != nodeTable->cend()) ? *it : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
@@ -24,6 +24,7 @@
 #endif
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSet>
@@ -40,6 +41,7 @@
 #include "Node.h"
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "NodeTable.h"
 #include "PacketReceiver.h"
 #include "ReceivedMessage.h"
 #include "udt/ControlPacket.h"
@@ -148,7 +150,10 @@ public:
 
     std::function<void(Node*)> linkedDataCreateCallback;
 
-    size_t size() const { QReadLocker readLock(&_nodeMutex); return _nodeHash.size(); }
+    size_t size() const { return getNodeTable()->size(); }
+
+    // the current nodes, the snapshot doesn't change while it's held
+    NodeTable::Pointer getNodeTable() const { return std::atomic_load(&_nodeTable); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
@@ -187,72 +192,58 @@ public:
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
 
     using value_type = SharedNodePointer;
-    using const_iterator = std::vector<value_type>::const_iterator;
+    using const_iterator = NodeTable::const_iterator;
 
-    // Cede control of iteration under a single read lock (e.g. for use by thread pools)
-    // Use this for nested loops instead of taking nested read locks!
-    //   This allows multiple threads (i.e. a thread pool) to share a lock
-    //   without deadlocking when a dying node attempts to acquire a write lock
+    // Cede control of iteration over the current nodes (e.g. for use by thread pools)
+    // The nodes are a snapshot, so nested loops and any number of threads can iterate them without locks
     template<typename NestedNodeLambda>
     void nestedEach(NestedNodeLambda functor, 
                     int* lockWaitOut = nullptr, 
                     int* nodeTransformOut = nullptr, 
                     int* functorOut = nullptr) {
         auto start = usecTimestampNow();
-        {
-            QReadLocker readLock(&_nodeMutex);
-            auto endLock = usecTimestampNow();
-            if (lockWaitOut) {
-                *lockWaitOut = (endLock - start);
-            }
-
-            // Size of _nodeHash could change at any time,
-            // so reserve enough memory for the current size
-            // and then back insert all the nodes found
-            std::vector<SharedNodePointer> nodes;
-            nodes.reserve(_nodeHash.size());
-            std::transform(_nodeHash.cbegin(), _nodeHash.cend(), std::back_inserter(nodes), [&](const NodeHash::value_type& it) {
-                return it.second;
-            });
-            auto endTransform = usecTimestampNow();
-            if (nodeTransformOut) {
-                *nodeTransformOut = (endTransform - endLock);
-            }
+        auto nodeTable = getNodeTable();
+        auto endLoad = usecTimestampNow();
+        if (lockWaitOut) {
+            *lockWaitOut = (endLoad - start);
+        }
+        if (nodeTransformOut) {
+            *nodeTransformOut = 0;
+        }
 
-            functor(nodes.cbegin(), nodes.cend());
-            auto endFunctor = usecTimestampNow();
-            if (functorOut) {
-                *functorOut = (endFunctor - endTransform);
-            }
+        functor(nodeTable->cbegin(), nodeTable->cend());
+        auto endFunctor = usecTimestampNow();
+        if (functorOut) {
+            *functorOut = (endFunctor - endLoad);
         }
     }
 
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodeTable = getNodeTable();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
+        for (const auto& node : *nodeTable) {
+            functor(node);
         }
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodeTable = getNodeTable();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        for (const auto& node : *nodeTable) {
+            if (predicate(node)) {
+                functor(node);
             }
         }
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodeTable = getNodeTable();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
+        for (const auto& node : *nodeTable) {
+            if (!functor(node)) {
                 break;
             }
         }
@@ -260,25 +251,21 @@ public:
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
+        auto nodeTable = getNodeTable();
 
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        for (const auto& node : *nodeTable) {
+            if (predicate(node)) {
+                return node;
             }
         }
 
         return SharedNodePointer();
     }
 
-    // This is unsafe because it does not take a lock
-    // Must only be called when you know that a read lock on the node mutex is held
-    // and will be held for the duration of your iteration
+    // Kept for the callers that used to hold the node mutex while iterating, the node table makes it safe
     template<typename NodeLambda>
     void unsafeEachNode(NodeLambda functor) {
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
-        }
+        eachNode(functor);
     }
 
     void putLocalPortIntoSharedMemory(const QString key, QObject* parent, quint16 localPort);
@@ -293,6 +280,17 @@ public:
     void setConnectionMaxBandwidth(int maxBandwidth) { _nodeSocket.setConnectionMaxBandwidth(maxBandwidth); }
 
     void setPacketFilterOperator(udt::PacketFilterOperator filterOperator) { _nodeSocket.setPacketFilterOperator(filterOperator); }
+
+    // records every packet this node receives, for PacketReplayer to play back later
+    Q_INVOKABLE bool startPacketCapture(const QString& filePath);
+    Q_INVOKABLE void stopPacketCapture();
+
+    // while replaying, the socket only takes packets from replayPacket, which must be called on the node list thread,
+    // and packets sent are counted rather than written to the network, with retransmissions counted separately
+    void setIsReplayingPackets(bool isReplaying) { _nodeSocket.setIsReplaying(isReplaying); }
+    void replayPacket(const udt::CapturedDatagram& datagram) { _nodeSocket.replayDatagram(datagram); }
+    quint64 getNumReplayBytesSent() const { return _nodeSocket.getNumReplayBytesWritten(); }
+    quint64 getNumReplayBytesRetransmitted() const { return _nodeSocket.getNumReplayBytesRetransmitted(); }
     bool packetVersionMatch(const udt::Packet& packet);
 
     bool isPacketVerifiedWithSource(const udt::Packet& packet, Node* sourceNode = nullptr);
@@ -376,9 +374,20 @@ protected:
 
     bool sockAddrBelongsToNode(const HifiSockAddr& sockAddr) { return findNodeWithAddr(sockAddr) != SharedNodePointer(); }
 
+    // publishes a new node table from _nodeHash, the caller must hold _nodeMutex
+    void publishNodeTable();
+    NodeIndex allocateNodeIndex();
+    // for an index whose node was never published
+    void releaseNodeIndex(NodeIndex nodeIndex);
+
     QUuid _sessionUUID;
+    // _nodeHash is the writers' side of the node list, readers use the node table
     NodeHash _nodeHash;
     mutable QReadWriteLock _nodeMutex;
+    NodeTable::Pointer _nodeTable { std::make_shared<NodeTable>() };
+    QMutex _nodeTableMutex; // serializes publishNodeTable() and the node index allocation
+    std::set<NodeIndex> _freeNodeIndices;
+    NodeIndex _nextNodeIndex { 0 };
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -413,6 +422,8 @@ protected:
         while (it != _nodeHash.end()) {
             functor(it);
         }
+
+        publishNodeTable();
     }
 
 
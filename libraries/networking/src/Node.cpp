@@ -15,8 +15,10 @@
 #include <QtCore/QDataStream>
 #include <QtCore/QDebug>
 
+#include <DependencyManager.h>
 #include <UUID.h>
 
+#include "LimitedNodeList.h"
 #include "NetworkLogging.h"
 #include "NodePermissions.h"
 #include "SharedUtil.h"
@@ -140,6 +142,7 @@ void Node::addIgnoredNode(const QUuid& otherNodeID) {
 
         // add the session UUID to the set of ignored ones for this listening node
         _ignoredNodeIDSet.insert(otherNodeID);
+        updateIgnoredNodeIndices();
     } else {
         qCWarning(networking) << "Node::addIgnoredNode called with null ID or ID of ignoring node.";
     }
@@ -154,11 +157,73 @@ void Node::removeIgnoredNode(const QUuid& otherNodeID) {
 
         // remove the session UUID from the set of ignored ones for this listening node
         _ignoredNodeIDSet.unsafe_erase(otherNodeID);
+        updateIgnoredNodeIndices();
     } else {
         qCWarning(networking) << "Node::removeIgnoredNode called with null ID or ID of ignoring node.";
     }
 }
 
+bool Node::isIgnoringNode(const Node& otherNode) const {
+    auto ignoredNodeIndices = std::atomic_load(&_ignoredNodeIndices);
+
+    if (ignoredNodeIndices->isIgnored.empty() && !ignoredNodeIndices->hasUnresolvedIDs) {
+        // nothing is ignored
+        return false;
+    }
+
+    if (ignoredNodeIndices->nodeTableVersion != NodeTable::getLatestVersion()) {
+        // nodes came or went since the indices were resolved, an ignored node may be back with another index.
+        // Resolve them again for the next calls, and answer this one from the UUID set.
+        QReadLocker lock { &_ignoredNodeIDSetLock };
+        updateIgnoredNodeIndices();
+        return _ignoredNodeIDSet.find(otherNode.getUUID()) != _ignoredNodeIDSet.cend();
+    }
+
+    if (!ignoredNodeIndices->hasUnresolvedIDs) {
+        auto nodeIndex = otherNode.getNodeIndex();
+        if (nodeIndex >= ignoredNodeIndices->isIgnored.size() || !ignoredNodeIndices->isIgnored[nodeIndex]) {
+            return false;
+        }
+    }
+
+    // the index may have been handed to another node since it was ignored, so the UUID has the final say
+    return isIgnoringNodeWithID(otherNode.getUUID());
+}
+
+void Node::updateIgnoredNodeIndices() const {
+    // the caller holds _ignoredNodeIDSetLock, this mutex orders concurrent inserts' updates
+    QMutexLocker locker(&_ignoredNodeIndicesMutex);
+
+    auto ignoredNodeIndices = std::make_shared<IgnoredNodeIndices>();
+
+    NodeTable::Pointer nodeTable;
+    if (DependencyManager::isSet<LimitedNodeList>()) {
+        nodeTable = DependencyManager::get<LimitedNodeList>()->getNodeTable();
+        ignoredNodeIndices->nodeTableVersion = nodeTable->getVersion();
+    } else {
+        // there's nothing to resolve from, every ID is unresolved
+        ignoredNodeIndices->nodeTableVersion = NodeTable::getLatestVersion();
+    }
+    for (const auto& ignoredNodeID : _ignoredNodeIDSet) {
+        SharedNodePointer ignoredNode;
+        if (nodeTable) {
+            ignoredNode = nodeTable->nodeWithUUID(ignoredNodeID);
+        }
+
+        if (ignoredNode) {
+            auto nodeIndex = ignoredNode->getNodeIndex();
+            if (nodeIndex >= ignoredNodeIndices->isIgnored.size()) {
+                ignoredNodeIndices->isIgnored.resize(nodeIndex + 1, false);
+            }
+            ignoredNodeIndices->isIgnored[nodeIndex] = true;
+        } else {
+            ignoredNodeIndices->hasUnresolvedIDs = true;
+        }
+    }
+
+    std::atomic_store(&_ignoredNodeIndices, std::shared_ptr<const IgnoredNodeIndices>(std::move(ignoredNodeIndices)));
+}
+
 void Node::parseIgnoreRadiusRequestMessage(QSharedPointer<ReceivedMessage> message) {
     bool enabled;
     message->readPrimitive(&enabled);
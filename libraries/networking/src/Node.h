@@ -12,9 +12,11 @@
 #ifndef hifi_Node_h
 #define hifi_Node_h
 
+#include <limits>
 #include <memory>
 #include <ostream>
 #include <stdint.h>
+#include <vector>
 
 #include <QtCore/QDebug>
 #include <QtCore/QMutex>
@@ -34,6 +36,10 @@
 #include "MovingPercentile.h"
 #include "NodePermissions.h"
 
+// small integer identifying a node while it's in the node list, see NodeTable
+using NodeIndex = uint32_t;
+const NodeIndex INVALID_NODE_INDEX = std::numeric_limits<NodeIndex>::max();
+
 class Node : public NetworkPeer {
     Q_OBJECT
 public:
@@ -48,6 +54,9 @@ public:
     char getType() const { return _type; }
     void setType(char type);
 
+    NodeIndex getNodeIndex() const { return _nodeIndex; }
+    void setNodeIndex(NodeIndex nodeIndex) { _nodeIndex = nodeIndex; }
+
     bool isReplicated() const { return _isReplicated; }
     void setIsReplicated(bool isReplicated) { _isReplicated = isReplicated; }
 
@@ -82,6 +91,8 @@ public:
     void addIgnoredNode(const QUuid& otherNodeID);
     void removeIgnoredNode(const QUuid& otherNodeID);
     bool isIgnoringNodeWithID(const QUuid& nodeID) const { QReadLocker lock { &_ignoredNodeIDSetLock }; return _ignoredNodeIDSet.find(nodeID) != _ignoredNodeIDSet.cend(); }
+    // same as isIgnoringNodeWithID(otherNode.getUUID()), without hashing the UUID when the node isn't ignored
+    bool isIgnoringNode(const Node& otherNode) const;
     void parseIgnoreRadiusRequestMessage(QSharedPointer<ReceivedMessage> message);
 
     friend QDataStream& operator<<(QDataStream& out, const Node& node);
@@ -99,7 +110,17 @@ private:
     Node(const Node &otherNode);
     Node& operator=(Node otherNode);
 
+    // the node indices of the ignored nodes, republished each time the ignore set changes, and when they're used
+    // after the node table they were resolved from was replaced
+    struct IgnoredNodeIndices {
+        std::vector<bool> isIgnored;
+        bool hasUnresolvedIDs { false }; // some ignored IDs weren't in the node list, their nodes have no index here
+        uint64_t nodeTableVersion { 0 };
+    };
+    void updateIgnoredNodeIndices() const;
+
     NodeType_t _type;
+    NodeIndex _nodeIndex { INVALID_NODE_INDEX };
 
     QUuid _connectionSecret;
     std::unique_ptr<NodeData> _linkedData;
@@ -112,6 +133,8 @@ private:
     bool _isUpstream { false };
     tbb::concurrent_unordered_set<QUuid, UUIDHasher> _ignoredNodeIDSet;
     mutable QReadWriteLock _ignoredNodeIDSetLock;
+    mutable std::shared_ptr<const IgnoredNodeIndices> _ignoredNodeIndices { std::make_shared<IgnoredNodeIndices>() };
+    mutable QMutex _ignoredNodeIndicesMutex;
     std::vector<QString> _replicatedUsernames { };
 
     std::atomic_bool _ignoreRadiusEnabled;
@@ -0,0 +1,71 @@
+//
+//  NodeTable.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeTable_h
+#define hifi_NodeTable_h
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <UUIDHasher.h>
+
+#include "Node.h"
+
+// An immutable snapshot of the nodes of a LimitedNodeList.  A new one is published each time a node is added or
+// removed, so it can be read from any thread without locks, and it keeps its nodes alive while it's held.
+//
+// Each node has a NodeIndex, unique among the nodes of the table and kept as long as the node stays in the list.  The
+// indices are small and dense, so they can be used as array indices for per-node data.  The index of a removed node
+// is reused for later nodes, per-node data should be reset when a node is killed.
+class NodeTable {
+public:
+    using Pointer = std::shared_ptr<const NodeTable>;
+    using const_iterator = std::vector<SharedNodePointer>::const_iterator;
+
+    size_t size() const { return _nodes.size(); }
+    const_iterator cbegin() const { return _nodes.cbegin(); }
+    const_iterator cend() const { return _nodes.cend(); }
+    const_iterator begin() const { return _nodes.cbegin(); }
+    const_iterator end() const { return _nodes.cend(); }
+
+    // tables published later have larger versions
+    uint64_t getVersion() const { return _version; }
+    // the version of the latest table published by any node list, so holders of data resolved from a table can tell
+    // when nodes may have come or gone since
+    static uint64_t getLatestVersion() { return _latestVersion; }
+
+    // one past the largest node index in the table
+    NodeIndex getIndexCount() const { return (NodeIndex)_nodesByIndex.size(); }
+
+    // null if there is no such node
+    const SharedNodePointer& nodeWithIndex(NodeIndex nodeIndex) const {
+        return nodeIndex < _nodesByIndex.size() ? _nodesByIndex[nodeIndex] : NULL_NODE;
+    }
+    const SharedNodePointer& nodeWithUUID(const QUuid& nodeUUID) const {
+        auto it = _indexByUUID.find(nodeUUID);
+        return it != _indexByUUID.end() ? _nodesByIndex[it->second] : NULL_NODE;
+    }
+
+private:
+    friend class LimitedNodeList;
+
+    static const SharedNodePointer NULL_NODE;
+    static std::atomic<uint64_t> _latestVersion;
+
+    uint64_t _version { 0 };
+
+    std::vector<SharedNodePointer> _nodes;
+    std::vector<SharedNodePointer> _nodesByIndex;
+    std::unordered_map<QUuid, NodeIndex, UUIDHasher> _indexByUUID;
+};
+
+#endif // hifi_NodeTable_h
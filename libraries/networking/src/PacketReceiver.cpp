@@ -13,12 +13,38 @@
 #include "PacketReceiver.h"
 
 #include <QMutexLocker>
+#include <QThread>
 
 #include "DependencyManager.h"
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "SharedUtil.h"
 
+QSharedPointer<PacketDispatchQueue> PacketDispatchQueue::create(QThread* thread) {
+    QSharedPointer<PacketDispatchQueue> queue(new PacketDispatchQueue(nullptr), &QObject::deleteLater);
+    queue->moveToThread(thread);
+    return queue;
+}
+
+void PacketDispatchQueue::push(Call call) {
+    _calls.push(std::move(call));
+
+    // only the first push after a drain needs to wake up the listening thread
+    if (!_drainScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
+    }
+}
+
+void PacketDispatchQueue::drain() {
+    // clear the flag before popping so that a call pushed while we drain is either popped here or schedules another drain
+    _drainScheduled = false;
+
+    Call call;
+    while (_calls.try_pop(call)) {
+        call();
+    }
+}
+
 PacketReceiver::PacketReceiver(QObject* parent) : QObject(parent) {
     qRegisterMetaType<QSharedPointer<NLPacket>>();
     qRegisterMetaType<QSharedPointer<NLPacketList>>();
@@ -169,13 +195,82 @@ void PacketReceiver::registerVerifiedListener(PacketType type, QObject* object,
     Q_ASSERT_X(object, "PacketReceiver::registerVerifiedListener", "No object to register");
     QMutexLocker locker(&_packetListenerLock);
 
-    if (_messageListenerMap.contains(type)) {
+    Listener& listener = _messageListeners[(size_t)type];
+    if (listener.isRegistered()) {
         qCWarning(networking) << "Registering a packet listener for packet type" << type
             << "that will remove a previously registered listener";
     }
     
     // add the mapping
-    _messageListenerMap[type] = { QPointer<QObject>(object), slot, deliverPending };
+    listener = Listener();
+    listener.object = object;
+    listener.method = slot;
+    listener.deliverPending = deliverPending;
+}
+
+bool PacketReceiver::registerHandler(PacketType type, QObject* listener, MessageHandler handler,
+                                     Delivery delivery, bool deliverPending) {
+    return registerHandlers({ type }, listener, std::move(handler), delivery, deliverPending, true);
+}
+
+bool PacketReceiver::registerHandlerForTypes(const PacketTypeList& types, QObject* listener, MessageHandler handler,
+                                             Delivery delivery) {
+    return registerHandlers(types, listener, std::move(handler), delivery, false, true);
+}
+
+bool PacketReceiver::registerHandlers(const PacketTypeList& types, QObject* listener, MessageHandler handler,
+                                      Delivery delivery, bool deliverPending, bool wantsNode) {
+    Q_ASSERT_X(!types.empty(), "PacketReceiver::registerHandlers", "No types to register");
+    Q_ASSERT_X(listener, "PacketReceiver::registerHandlers", "No object to register");
+    Q_ASSERT_X(handler, "PacketReceiver::registerHandlers", "No handler to register");
+
+    if (!listener || !handler) {
+        qCWarning(networking) << "FAILED to Register a packet handler for packet types" << QVector<PacketType>::fromStdVector(types);
+        return false;
+    }
+
+    QMutexLocker locker(&_packetListenerLock);
+
+    QSharedPointer<PacketDispatchQueue> queue;
+    if (delivery == Delivery::Queued) {
+        queue = dispatchQueueForListener(listener);
+    }
+    auto sharedHandler = std::make_shared<const MessageHandler>(std::move(handler));
+
+    for (PacketType type : types) {
+        Listener& entry = _messageListeners[(size_t)type];
+        if (entry.isRegistered()) {
+            qCWarning(networking) << "Registering a packet handler for packet type" << type
+                << "that will remove a previously registered listener";
+        }
+
+        qCDebug(networking) << "Registering a packet handler for packet type" << type;
+
+        entry = Listener();
+        entry.object = listener;
+        entry.deliverPending = deliverPending;
+        entry.handler = sharedHandler;
+        entry.queue = queue;
+        entry.requiresNode = wantsNode && !PacketTypeEnum::getNonSourcedPackets().contains(type);
+    }
+
+    return true;
+}
+
+QSharedPointer<PacketDispatchQueue> PacketReceiver::dispatchQueueForListener(QObject* listener) {
+    // called with _packetListenerLock held, all the queued handlers of a listener share its queue
+    auto& queue = _dispatchQueues[listener];
+    if (!queue) {
+        queue = PacketDispatchQueue::create(listener->thread());
+
+        // forget the queue with its listener, so a new object at the same address doesn't pick it up; the queue itself
+        // goes once the listener table and any packet being dispatched to it let go of it
+        connect(listener, &QObject::destroyed, this, [this, listener] {
+            QMutexLocker locker(&_packetListenerLock);
+            _dispatchQueues.remove(listener);
+        }, Qt::DirectConnection);
+    }
+    return queue;
 }
 
 void PacketReceiver::unregisterListener(QObject* listener) {
@@ -184,16 +279,15 @@ void PacketReceiver::unregisterListener(QObject* listener) {
     {
         QMutexLocker packetListenerLocker(&_packetListenerLock);
         
-        // clear any registrations for this listener in _messageListenerMap
-        auto it = _messageListenerMap.begin();
-        
-        while (it != _messageListenerMap.end()) {
-            if (it.value().object == listener) {
-                it = _messageListenerMap.erase(it);
-            } else {
-                ++it;
+        // clear any registrations for this listener in _messageListeners
+        for (auto& entry : _messageListeners) {
+            if (entry.object == listener) {
+                entry = Listener();
             }
         }
+
+        // calls already queued still check that the listener is alive before running
+        _dispatchQueues.remove(listener);
     }
     
     QMutexLocker directConnectSetLocker(&_directConnectSetMutex);
@@ -206,8 +300,6 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
         return;
     }
     
-    auto nodeList = DependencyManager::get<LimitedNodeList>();
-    
     // setup an NLPacket from the packet we were passed
     auto nlPacket = NLPacket::fromBase(std::move(packet));
     auto receivedMessage = QSharedPointer<ReceivedMessage>::create(*nlPacket);
@@ -256,30 +348,79 @@ void PacketReceiver::handleMessageFailure(HifiSockAddr from, udt::Packet::Messag
     }
 }
 
+void PacketReceiver::dispatchToHandler(const QPointer<QObject>& object, const SharedMessageHandler& handler,
+                                       const QSharedPointer<PacketDispatchQueue>& queue,
+                                       QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+    if (queue) {
+        // our reference keeps the queue alive through the push, even if the listener is unregistered meanwhile
+        queue->push([object, handler, message, node] {
+            // the queue runs on the listener's thread, so this check can't race with its destruction
+            if (object) {
+                (*handler)(message, node);
+            }
+        });
+    } else {
+        (*handler)(message, node);
+    }
+}
+
 void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> receivedMessage, bool justReceived) {
-    auto nodeList = DependencyManager::get<LimitedNodeList>();
-    
     SharedNodePointer matchingNode;
     
     if (!receivedMessage->getSourceID().isNull()) {
-        matchingNode = nodeList->nodeWithUUID(receivedMessage->getSourceID());
+        matchingNode = DependencyManager::get<LimitedNodeList>()->nodeWithUUID(receivedMessage->getSourceID());
+    }
+
+    size_t typeIndex = (size_t)receivedMessage->getType();
+    if (typeIndex >= NUM_LISTENER_SLOTS) {
+        qCWarning(networking) << "Dropping message with unknown packet type" << receivedMessage->getType();
+        return;
     }
     
     QMutexLocker packetListenerLocker(&_packetListenerLock);
     
     bool listenerIsDead = false;
     
-    auto it = _messageListenerMap.find(receivedMessage->getType());
-            
-    if (it != _messageListenerMap.end() && it->method.isValid()) {
-         
-        auto listener = it.value();
+    Listener& entry = _messageListeners[typeIndex];
 
-        if ((listener.deliverPending && !justReceived) || (!listener.deliverPending && !receivedMessage->isComplete())) {
+    if (entry.handler) {
+        // typed listener, no QMetaMethod lookup or argument marshalling needed
+        if ((entry.deliverPending && !justReceived) || (!entry.deliverPending && !receivedMessage->isComplete())) {
             return;
         }
-    
-        if (listener.object) {
+
+        if (!entry.object) {
+            qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
+                << " has been destroyed. Removing from listener map.";
+            entry = Listener();
+            return;
+        }
+
+        if (matchingNode) {
+            matchingNode->recordBytesReceived(receivedMessage->getSize());
+        } else if (entry.requiresNode) {
+            return;
+        }
+
+        // take references to what the call needs, then release the lock before calling out:
+        // a direct handler may register or unregister listeners, which replaces the entry
+        QPointer<QObject> object = entry.object;
+        SharedMessageHandler handler = entry.handler;
+        QSharedPointer<PacketDispatchQueue> queue = entry.queue;
+        packetListenerLocker.unlock();
+
+        dispatchToHandler(object, handler, queue, receivedMessage, matchingNode);
+
+    } else if (entry.method.isValid()) {
+
+        if ((entry.deliverPending && !justReceived) || (!entry.deliverPending && !receivedMessage->isComplete())) {
+            return;
+        }
+
+        // the lock is held until the slot is invoked, so only the pointer needs a copy to outlive a dead listener's entry
+        QPointer<QObject> object = entry.object;
+
+        if (object) {
             
             bool success = false;
 
@@ -288,7 +429,7 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
             {
                 QMutexLocker directConnectLocker(&_directConnectSetMutex);
  
-                connectionType = _directlyConnectedObjects.contains(listener.object) ? Qt::DirectConnection : Qt::AutoConnection;
+                connectionType = _directlyConnectedObjects.contains(object) ? Qt::DirectConnection : Qt::AutoConnection;
             }
             
             PacketType packetType = receivedMessage->getType();
@@ -296,27 +437,27 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
             if (matchingNode) {
                 matchingNode->recordBytesReceived(receivedMessage->getSize());
 
-                QMetaMethod metaMethod = listener.method;
+                QMetaMethod metaMethod = entry.method;
                 
                 static const QByteArray QSHAREDPOINTER_NODE_NORMALIZED = QMetaObject::normalizedType("QSharedPointer<Node>");
                 static const QByteArray SHARED_NODE_NORMALIZED = QMetaObject::normalizedType("SharedNodePointer");
                 
                 // one final check on the QPointer before we go to invoke
-                if (listener.object) {
+                if (object) {
                     if (metaMethod.parameterTypes().contains(SHARED_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
+                        success = metaMethod.invoke(object,
                                                     connectionType,
                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
                                                     Q_ARG(SharedNodePointer, matchingNode));
                         
                     } else if (metaMethod.parameterTypes().contains(QSHAREDPOINTER_NODE_NORMALIZED)) {
-                        success = metaMethod.invoke(listener.object,
+                        success = metaMethod.invoke(object,
                                                     connectionType,
                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage),
                                                     Q_ARG(QSharedPointer<Node>, matchingNode));
                         
                     } else {
-                        success = metaMethod.invoke(listener.object,
+                        success = metaMethod.invoke(object,
                                                     connectionType,
                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
                     }
@@ -325,9 +466,9 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
                 }
             } else {
                 // one final check on the QPointer before we invoke
-                if (listener.object) {
-                    success = listener.method.invoke(listener.object,
-                                                     Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
+                if (object) {
+                    success = entry.method.invoke(object,
+                                                  Q_ARG(QSharedPointer<ReceivedMessage>, receivedMessage));
                 } else {
                     listenerIsDead = true;
                 }
@@ -336,7 +477,7 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
             
             if (!success) {
                 qCDebug(networking).nospace() << "Error delivering packet " << packetType << " to listener "
-                    << listener.object << "::" << qPrintable(listener.method.methodSignature());
+                    << object << "::" << qPrintable(entry.method.methodSignature());
             }
             
         } else {
@@ -346,18 +487,18 @@ void PacketReceiver::handleVerifiedMessage(QSharedPointer<ReceivedMessage> recei
         if (listenerIsDead) {
             qCDebug(networking).nospace() << "Listener for packet " << receivedMessage->getType()
                 << " has been destroyed. Removing from listener map.";
-            it = _messageListenerMap.erase(it);
+            entry = Listener();
             
             // if it exists, remove the listener from _directlyConnectedObjects
             {
                 QMutexLocker directConnectLocker(&_directConnectSetMutex);
-                _directlyConnectedObjects.remove(listener.object);
+                _directlyConnectedObjects.remove(object);
             }
         }
-    } else if (it == _messageListenerMap.end()) {
+    } else if (!_missingListenerReported[typeIndex]) {
         qCWarning(networking) << "No listener found for packet type" << receivedMessage->getType();
         
-        // insert a dummy listener so we don't print this again
-        _messageListenerMap.insert(receivedMessage->getType(), { nullptr, QMetaMethod(), false });
+        // remember that we reported it so we don't print this again
+        _missingListenerReported[typeIndex] = true;
     }
 }
@@ -13,6 +13,10 @@
 #ifndef hifi_PacketReceiver_h
 #define hifi_PacketReceiver_h
 
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
@@ -22,6 +26,9 @@
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
 #include <QtCore/QSet>
+#include <QtCore/QSharedPointer>
+
+#include <TBBHelpers.h>
 
 #include "NLPacket.h"
 #include "NLPacketList.h"
@@ -40,10 +47,38 @@ namespace std {
     };
 }
 
+// Runs handlers queued from the packet receiving thread on the thread of the listening object.
+// Calls are batched: a burst of packets costs one queued metacall, not one per packet.
+class PacketDispatchQueue : public QObject {
+    Q_OBJECT
+public:
+    using Call = std::function<void()>;
+
+    // queues are shared between the listener table and the receiving thread, the last reference deletes it on its thread
+    static QSharedPointer<PacketDispatchQueue> create(QThread* thread);
+
+    PacketDispatchQueue(QObject* parent) : QObject(parent) {}
+
+    void push(Call call);
+
+private slots:
+    void drain();
+
+private:
+    tbb::concurrent_queue<Call> _calls;
+    std::atomic<bool> _drainScheduled { false };
+};
+
 class PacketReceiver : public QObject {
     Q_OBJECT
 public:
     using PacketTypeList = std::vector<PacketType>;
+    using MessageHandler = std::function<void(QSharedPointer<ReceivedMessage>, SharedNodePointer)>;
+
+    enum class Delivery {
+        Direct,     // the handler is called on the packet receiving thread, it must be thread safe
+        Queued      // the handler is called on the thread of the listening object
+    };
     
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
@@ -62,6 +97,38 @@ public:
     // for the message is received.
     bool registerListener(PacketType type, QObject* listener, const char* slot, bool deliverPending = false);
     bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
+
+    // Typed listeners are plain function calls, without the slot lookup and QMetaMethod::invoke argument marshalling
+    // of the listeners above.  Handlers for sourced packet types are only called when the sending node is known.
+    bool registerHandler(PacketType type, QObject* listener, MessageHandler handler,
+                         Delivery delivery = Delivery::Queued, bool deliverPending = false);
+    bool registerHandlerForTypes(const PacketTypeList& types, QObject* listener, MessageHandler handler,
+                                 Delivery delivery = Delivery::Queued);
+
+    template <typename T>
+    bool registerListener(PacketType type, T* listener,
+                          void (T::*method)(QSharedPointer<ReceivedMessage>, SharedNodePointer),
+                          Delivery delivery = Delivery::Queued, bool deliverPending = false) {
+        return registerHandler(type, listener, bindHandler(listener, method), delivery, deliverPending);
+    }
+    template <typename T>
+    bool registerListener(PacketType type, T* listener, void (T::*method)(QSharedPointer<ReceivedMessage>),
+                          Delivery delivery = Delivery::Queued, bool deliverPending = false) {
+        return registerHandlers({ type }, listener, bindHandler(listener, method), delivery, deliverPending, false);
+    }
+    template <typename T>
+    bool registerListenerForTypes(const PacketTypeList& types, T* listener,
+                                  void (T::*method)(QSharedPointer<ReceivedMessage>, SharedNodePointer),
+                                  Delivery delivery = Delivery::Queued) {
+        return registerHandlerForTypes(types, listener, bindHandler(listener, method), delivery);
+    }
+    template <typename T>
+    bool registerListenerForTypes(const PacketTypeList& types, T* listener,
+                                  void (T::*method)(QSharedPointer<ReceivedMessage>),
+                                  Delivery delivery = Delivery::Queued) {
+        return registerHandlers(types, listener, bindHandler(listener, method), delivery, false, false);
+    }
+
     void unregisterListener(QObject* listener);
     
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
@@ -69,12 +136,43 @@ public:
     void handleMessageFailure(HifiSockAddr from, udt::Packet::MessageNumber messageNumber);
     
 private:
+    // typed handlers are shared rather than copied, so that taking one out of the table per packet is cheap
+    using SharedMessageHandler = std::shared_ptr<const MessageHandler>;
+
     struct Listener {
         QPointer<QObject> object;
         QMetaMethod method;
-        bool deliverPending;
+        bool deliverPending { false };
+
+        // typed listeners
+        SharedMessageHandler handler;
+        QSharedPointer<PacketDispatchQueue> queue; // null for Delivery::Direct
+        bool requiresNode { false };
+
+        bool isRegistered() const { return method.isValid() || handler; }
     };
 
+    template <typename T>
+    static MessageHandler bindHandler(T* listener, void (T::*method)(QSharedPointer<ReceivedMessage>, SharedNodePointer)) {
+        return [listener, method](QSharedPointer<ReceivedMessage> message, SharedNodePointer node) {
+            (listener->*method)(message, node);
+        };
+    }
+    template <typename T>
+    static MessageHandler bindHandler(T* listener, void (T::*method)(QSharedPointer<ReceivedMessage>)) {
+        return [listener, method](QSharedPointer<ReceivedMessage> message, SharedNodePointer) {
+            (listener->*method)(message);
+        };
+    }
+
+    // if wantsNode is true the handler is only called for messages of sourced types once their node is known
+    bool registerHandlers(const PacketTypeList& types, QObject* listener, MessageHandler handler,
+                          Delivery delivery, bool deliverPending, bool wantsNode);
+    QSharedPointer<PacketDispatchQueue> dispatchQueueForListener(QObject* listener);
+    static void dispatchToHandler(const QPointer<QObject>& object, const SharedMessageHandler& handler,
+                                  const QSharedPointer<PacketDispatchQueue>& queue,
+                                  QSharedPointer<ReceivedMessage> message, SharedNodePointer node);
+
     void handleVerifiedMessage(QSharedPointer<ReceivedMessage> message, bool justReceived);
 
     // these are brutal hacks for now - ideally GenericThread / ReceivedPacketProcessor
@@ -85,8 +183,12 @@ private:
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
     void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot, bool deliverPending = false);
 
+    static const size_t NUM_LISTENER_SLOTS = (size_t)PacketType::NUM_PACKET_TYPE;
+
     QMutex _packetListenerLock;
-    QHash<PacketType, Listener> _messageListenerMap;
+    std::array<Listener, NUM_LISTENER_SLOTS> _messageListeners; // indexed by PacketType
+    std::array<bool, NUM_LISTENER_SLOTS> _missingListenerReported {};
+    QHash<QObject*, QSharedPointer<PacketDispatchQueue>> _dispatchQueues;
     int _inPacketCount = 0;
     int _inByteCount = 0;
     bool _shouldDropPackets = false;
@@ -0,0 +1,206 @@
+//
+//  PacketReplayer.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketReplayer.h"
+
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <DependencyManager.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+#include "LimitedNodeList.h"
+#include "NetworkLogging.h"
+
+const int REPLAY_INTERVAL_MSECS = 1;
+
+// user and kernel CPU time used by every thread of the process
+static quint64 processCPUUsecs() {
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return 0;
+    }
+    auto toUsecs = [](const FILETIME& time) {
+        // in units of 100ns
+        return (((quint64)time.dwHighDateTime << 32) | time.dwLowDateTime) / 10;
+    };
+    return toUsecs(kernelTime) + toUsecs(userTime);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    auto toUsecs = [](const struct timeval& time) {
+        return (quint64)time.tv_sec * USECS_PER_SECOND + (quint64)time.tv_usec;
+    };
+    return toUsecs(usage.ru_utime) + toUsecs(usage.ru_stime);
+#endif
+}
+
+static quint64 processMemoryBytes() {
+    MemoryInfo info;
+    return getMemoryInfo(info) ? info.processUsedMemoryBytes : 0;
+}
+
+PacketReplayer::PacketReplayer(const QString& capturePath, float speed, int frameMsecs, const QString& reportPath,
+                               QObject* parent) :
+    QObject(parent),
+    _capturePath(capturePath),
+    _speed(std::max(speed, 0.01f)),
+    _frameUsecs(std::max(frameMsecs, 1) * USECS_PER_MSEC),
+    _reportPath(reportPath)
+{
+    // stop listening to the network right away, so nothing outside the capture gets in before the replay starts
+    DependencyManager::get<LimitedNodeList>()->setIsReplayingPackets(true);
+
+    _replayTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_replayTimer, &QTimer::timeout, this, &PacketReplayer::replayDuePackets);
+}
+
+void PacketReplayer::start() {
+    if (!_reader.open(_capturePath)) {
+        emit finished();
+        return;
+    }
+
+    qCDebug(networking) << "Replaying" << _capturePath << "at" << _speed << "times captured speed";
+
+    _hasNextPacket = _reader.readNext(_nextPacket);
+
+    _currentFrameEndUsecs = _frameUsecs;
+    _frameStartCPUUsecs = processCPUUsecs();
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    _frameStartBytesSent = nodeList->getNumReplayBytesSent();
+    _frameStartBytesRetransmitted = nodeList->getNumReplayBytesRetransmitted();
+
+    _elapsed.start();
+    _replayTimer.start(REPLAY_INTERVAL_MSECS);
+}
+
+void PacketReplayer::replayDuePackets() {
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    quint64 captureUsecs = (quint64)((double)(_elapsed.nsecsElapsed() / NSECS_PER_USEC) * _speed);
+
+    while (true) {
+        if (_hasNextPacket && _nextPacket.timeUsecs < _currentFrameEndUsecs && _nextPacket.timeUsecs <= captureUsecs) {
+            _currentFrame.numPackets++;
+            _currentFrame.bytesReceived += _nextPacket.data.size();
+            nodeList->replayPacket(_nextPacket);
+
+            _hasNextPacket = _reader.readNext(_nextPacket);
+        } else if (_currentFrameEndUsecs <= captureUsecs) {
+            endFrame();
+        } else {
+            break;
+        }
+    }
+
+    if (!_hasNextPacket) {
+        finish();
+    }
+}
+
+void PacketReplayer::endFrame() {
+    auto nodeList = DependencyManager::get<LimitedNodeList>();
+    quint64 nowCPUUsecs = processCPUUsecs();
+    quint64 bytesSent = nodeList->getNumReplayBytesSent();
+    quint64 bytesRetransmitted = nodeList->getNumReplayBytesRetransmitted();
+
+    _currentFrame.cpuUsecs = nowCPUUsecs - _frameStartCPUUsecs;
+    _currentFrame.bytesSent = bytesSent - _frameStartBytesSent;
+    _currentFrame.bytesRetransmitted = bytesRetransmitted - _frameStartBytesRetransmitted;
+    _currentFrame.processMemoryBytes = processMemoryBytes();
+    _frames.push_back(_currentFrame);
+
+    _currentFrame = FrameStats();
+    _currentFrameEndUsecs += _frameUsecs;
+    _frameStartCPUUsecs = nowCPUUsecs;
+    _frameStartBytesSent = bytesSent;
+    _frameStartBytesRetransmitted = bytesRetransmitted;
+}
+
+void PacketReplayer::finish() {
+    _replayTimer.stop();
+    _reader.close();
+
+    if (_currentFrame.numPackets > 0) {
+        endFrame();
+    }
+
+    if (_frames.empty()) {
+        qCWarning(networking) << "Replayed nothing from" << _capturePath;
+        emit finished();
+        return;
+    }
+
+    int numPackets = 0;
+    quint64 bytesReceived = 0;
+    quint64 bytesSent = 0;
+    quint64 bytesRetransmitted = 0;
+    std::vector<quint64> cpuUsecs;
+    cpuUsecs.reserve(_frames.size());
+    for (auto& frame : _frames) {
+        numPackets += frame.numPackets;
+        bytesReceived += frame.bytesReceived;
+        bytesSent += frame.bytesSent;
+        bytesRetransmitted += frame.bytesRetransmitted;
+        cpuUsecs.push_back(frame.cpuUsecs);
+    }
+    std::sort(cpuUsecs.begin(), cpuUsecs.end());
+
+    quint64 totalCPUUsecs = 0;
+    for (auto usecs : cpuUsecs) {
+        totalCPUUsecs += usecs;
+    }
+
+    auto percentile = [&](float fraction) {
+        return cpuUsecs[std::min((size_t)(fraction * cpuUsecs.size()), cpuUsecs.size() - 1)];
+    };
+
+    qint64 memoryGrowth = (qint64)_frames.back().processMemoryBytes - (qint64)_frames.front().processMemoryBytes;
+
+    qCDebug(networking).noquote() << QString("Replayed %1 packets (%2 bytes) over %3 frames of %4ms, sent %5 bytes")
+        .arg(numPackets).arg(bytesReceived).arg((int)_frames.size()).arg(_frameUsecs / USECS_PER_MSEC).arg(bytesSent);
+    if (bytesRetransmitted > 0) {
+        // the peers in the capture never ack what we send, so reliable packets are resent until their connections end
+        qCDebug(networking).noquote() << QString("Not counted: %1 bytes of retransmissions").arg(bytesRetransmitted);
+    }
+    qCDebug(networking).noquote() << QString("CPU per frame: mean %1us median %2us 99th %3us max %4us")
+        .arg(totalCPUUsecs / _frames.size()).arg(percentile(0.5f)).arg(percentile(0.99f)).arg(cpuUsecs.back());
+    qCDebug(networking).noquote() << QString("Process memory grew by %1 bytes").arg(memoryGrowth);
+
+    if (!_reportPath.isEmpty()) {
+        QFile reportFile(_reportPath);
+        if (reportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            QTextStream report(&reportFile);
+            report << "frame,capture_msecs,packets,bytes_received,bytes_sent,bytes_retransmitted,cpu_usecs,process_memory_bytes\n";
+            for (int i = 0; i < (int)_frames.size(); ++i) {
+                auto& frame = _frames[i];
+                report << i << "," << i * _frameUsecs / USECS_PER_MSEC << "," << frame.numPackets << ","
+                    << frame.bytesReceived << "," << frame.bytesSent << "," << frame.bytesRetransmitted << "," << frame.cpuUsecs << ","
+                    << frame.processMemoryBytes << "\n";
+            }
+        } else {
+            qCWarning(networking) << "Could not write the replay report to" << _reportPath;
+        }
+    }
+
+    emit finished();
+}
@@ -0,0 +1,84 @@
+//
+//  PacketReplayer.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketReplayer_h
+#define hifi_PacketReplayer_h
+
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include "udt/PacketCapture.h"
+
+// Plays a packet capture into the node list as though it were arriving from the network again, at the pace it was
+// captured or sped up, and measures what handling it costs: for each frame of capture time, the CPU time the process
+// used, its memory and the bytes it sent in response. Retransmissions are counted apart from what was sent, since
+// nothing in the capture acks the replies and reliable packets would otherwise be counted again and again.
+//   The replayer has to live on the node list thread. Whatever is being measured keeps its own clocks, so a sped up
+// replay measures how it copes with bursts of input rather than running it faster.
+class PacketReplayer : public QObject {
+    Q_OBJECT
+public:
+    struct FrameStats {
+        int numPackets { 0 };
+        quint64 bytesReceived { 0 };
+        quint64 bytesSent { 0 };
+        quint64 bytesRetransmitted { 0 };
+        quint64 cpuUsecs { 0 };
+        quint64 processMemoryBytes { 0 };
+    };
+
+    static const int DEFAULT_FRAME_MSECS = 10;
+
+    // a non-empty reportPath also writes every frame's stats there, as CSV
+    PacketReplayer(const QString& capturePath, float speed = 1.0f, int frameMsecs = DEFAULT_FRAME_MSECS,
+                   const QString& reportPath = QString(), QObject* parent = nullptr);
+
+    const std::vector<FrameStats>& getFrameStats() const { return _frames; }
+
+public slots:
+    void start();
+
+signals:
+    void finished();
+
+private slots:
+    void replayDuePackets();
+
+private:
+    void endFrame();
+    void finish();
+
+    QString _capturePath;
+    float _speed;
+    quint64 _frameUsecs;
+    QString _reportPath;
+
+    udt::PacketCaptureReader _reader;
+    udt::CapturedDatagram _nextPacket;
+    bool _hasNextPacket { false };
+
+    QTimer _replayTimer { this };
+    QElapsedTimer _elapsed;
+
+    FrameStats _currentFrame;
+    quint64 _currentFrameEndUsecs { 0 };
+    quint64 _frameStartCPUUsecs { 0 };
+    quint64 _frameStartBytesSent { 0 };
+    quint64 _frameStartBytesRetransmitted { 0 };
+
+    std::vector<FrameStats> _frames;
+};
+
+#endif // hifi_PacketReplayer_h
@@ -12,16 +12,20 @@
 
 #include "ReceivedMessage.h"
 
+#include <algorithm>
+
 #include "QSharedPointer"
 
 int receivedMessageMetaTypeId = qRegisterMetaType<ReceivedMessage*>("ReceivedMessage*");
 int sharedPtrReceivedMessageMetaTypeId = qRegisterMetaType<QSharedPointer<ReceivedMessage>>("QSharedPointer<ReceivedMessage>");
 
 static const int HEAD_DATA_SIZE = 512;
+static const int CHUNK_CAPACITY = 256 * 1024;
 
 ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
     : _data(packetList.getMessage()),
       _headData(_data.mid(0, HEAD_DATA_SIZE)),
+      _size(_data.size()),
       _numPackets(packetList.getNumPackets()),
       _sourceID(packetList.getSourceID()),
       _packetType(packetList.getType()),
@@ -33,6 +37,7 @@ ReceivedMessage::ReceivedMessage(const NLPacketList& packetList)
 ReceivedMessage::ReceivedMessage(NLPacket& packet)
     : _data(packet.readAll()),
       _headData(_data.mid(0, HEAD_DATA_SIZE)),
+      _size(_data.size()),
       _numPackets(1),
       _sourceID(packet.getSourceID()),
       _packetType(packet.getType()),
@@ -46,6 +51,7 @@ ReceivedMessage::ReceivedMessage(QByteArray byteArray, PacketType packetType, Pa
                 const HifiSockAddr& senderSockAddr, QUuid sourceID) :
     _data(byteArray),
     _headData(_data.mid(0, HEAD_DATA_SIZE)),
+    _size(_data.size()),
     _numPackets(1),
     _sourceID(sourceID),
     _packetType(packetType),
@@ -70,7 +76,18 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
 
     ++_numPackets;
 
-    _data.append(packet.getPayload(), packet.getPayloadSize());
+    {
+        QMutexLocker locker(&_chunksLock);
+
+        const qint64 payloadSize = packet.getPayloadSize();
+        if (_chunks.empty() || _chunks.back().size() + payloadSize > _chunks.back().capacity()) {
+            _chunks.emplace_back();
+            _chunks.back().reserve(std::max<int>(CHUNK_CAPACITY, payloadSize));
+        }
+        _chunks.back().append(packet.getPayload(), payloadSize);
+        _size += payloadSize;
+        _hasChunks = true;
+    }
 
     if (_numPackets % EMIT_PROGRESS_EVERY_X_PACKETS == 0) {
         emit progress(getSize());
@@ -82,13 +99,75 @@ void ReceivedMessage::appendPacket(NLPacket& packet) {
     }
 }
 
+void ReceivedMessage::coalesce() const {
+    if (!_hasChunks) {
+        return;
+    }
+
+    QMutexLocker locker(&_chunksLock);
+
+    int chunksSize = 0;
+    for (const auto& chunk : _chunks) {
+        chunksSize += chunk.size();
+    }
+    _data.reserve(_data.size() + chunksSize);
+
+    for (auto& chunk : _chunks) {
+        _data.append(chunk);
+        // release each chunk as soon as it has been copied to keep the peak memory close to the message size
+        chunk = QByteArray();
+    }
+    _chunks.clear();
+    _hasChunks = false;
+}
+
+qint64 ReceivedMessage::consumeReceivedData(const std::function<void(const QByteArray& chunk)>& consumer) {
+    QMutexLocker locker(&_chunksLock);
+
+    qint64 consumed = 0;
+
+    qint64 dataStart = std::min<qint64>(std::max<qint64>(_position - _dataOffset, 0), _data.size());
+    if (dataStart < _data.size()) {
+        consumer(QByteArray::fromRawData(_data.constData() + dataStart, _data.size() - dataStart));
+        consumed += _data.size() - dataStart;
+    }
+    _data = QByteArray();
+
+    for (auto& chunk : _chunks) {
+        consumer(chunk);
+        consumed += chunk.size();
+    }
+    _chunks.clear();
+    _hasChunks = false;
+
+    _position += consumed;
+    _dataOffset = _position;
+    return consumed;
+}
+
+qint64 ReceivedMessage::dataIndex() const {
+    coalesce();
+    qint64 index = _position - _dataOffset;
+    Q_ASSERT_X(index >= 0, "ReceivedMessage::dataIndex", "Reading data that has already been consumed");
+    return index;
+}
+
+qint64 ReceivedMessage::readableSize(qint64 index, qint64 size) const {
+    if (index < 0) {
+        return 0;
+    }
+    return std::max<qint64>(0, std::min<qint64>(size, _data.size() - index));
+}
+
 qint64 ReceivedMessage::peek(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
+    qint64 index = dataIndex();
+    size = readableSize(index, size);
+    memcpy(data, _data.constData() + index, size);
     return size;
 }
 
 qint64 ReceivedMessage::read(char* data, qint64 size) {
-    memcpy(data, _data.constData() + _position, size);
+    size = peek(data, size);
     _position += size;
     return size;
 }
@@ -100,12 +179,13 @@ qint64 ReceivedMessage::readHead(char* data, qint64 size) {
 }
 
 QByteArray ReceivedMessage::peek(qint64 size) {
-    return _data.mid(_position, size);
+    qint64 index = dataIndex();
+    return _data.mid(index, readableSize(index, size));
 }
 
 QByteArray ReceivedMessage::read(qint64 size) {
-    auto data = _data.mid(_position, size);
-    _position += size;
+    auto data = peek(size);
+    _position += data.size();
     return data;
 }
 
@@ -123,13 +203,17 @@ QString ReceivedMessage::readString() {
     uint32_t size;
     readPrimitive(&size);
     //Q_ASSERT(size <= _size - _position);
-    auto string = QString::fromUtf8(_data.constData() + _position, size);
-    _position += size;
+    qint64 index = dataIndex();
+    qint64 stringSize = readableSize(index, size);
+    auto string = QString::fromUtf8(_data.constData() + index, stringSize);
+    _position += stringSize;
     return string;
 }
 
 QByteArray ReceivedMessage::readWithoutCopy(qint64 size) {
-    QByteArray data { QByteArray::fromRawData(_data.constData() + _position, size) };
+    qint64 index = dataIndex();
+    size = readableSize(index, size);
+    QByteArray data { QByteArray::fromRawData(_data.constData() + index, size) };
     _position += size;
     return data;
 }
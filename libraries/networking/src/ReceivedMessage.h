@@ -13,9 +13,12 @@
 #define hifi_ReceivedMessage_h
 
 #include <QByteArray>
+#include <QMutex>
 #include <QObject>
 
 #include <atomic>
+#include <functional>
+#include <vector>
 
 #include "NLPacketList.h"
 
@@ -27,8 +30,8 @@ public:
     ReceivedMessage(QByteArray byteArray, PacketType packetType, PacketVersion packetVersion,
                     const HifiSockAddr& senderSockAddr, QUuid sourceID = QUuid());
 
-    QByteArray getMessage() const { return _data; }
-    const char* getRawMessage() const { return _data.constData(); }
+    QByteArray getMessage() const { coalesce(); return _data; }
+    const char* getRawMessage() const { coalesce(); return _data.constData(); }
 
     PacketType getType() const { return _packetType; }
     PacketVersion getVersion() const { return _packetVersion; }
@@ -48,9 +51,9 @@ public:
     // Get the number of packets that were used to send this message
     qint64 getNumPackets() const { return _numPackets; }
 
-    qint64 getSize() const { return _data.size(); }
+    qint64 getSize() const { return _size; }
 
-    qint64 getBytesLeftToRead() const { return _data.size() -  _position; }
+    qint64 getBytesLeftToRead() const { return _size -  _position; }
 
     void seek(qint64 position) { _position = position; }
 
@@ -74,6 +77,13 @@ public:
     // exceed that of the ReceivedMessage.
     QByteArray readWithoutCopy(qint64 size);
 
+    // Hands the bytes from the current position up to what has been received so far to consumer, one chunk at a time,
+    // without copying them into a contiguous buffer, then releases them.  Meant for readers that stream large
+    // multi-packet messages somewhere else (a pre-sized buffer, a file) while they arrive.  The position moves past the
+    // consumed bytes: later reads only see data received after them, and seeking back into them reads nothing.
+    // The chunks passed to consumer are only valid for the duration of the call.  Returns the number of bytes consumed.
+    qint64 consumeReceivedData(const std::function<void(const QByteArray& chunk)>& consumer);
+
     template<typename T> qint64 peekPrimitive(T* data);
     template<typename T> qint64 readPrimitive(T* data);
 
@@ -87,10 +97,25 @@ private slots:
     void onComplete();
 
 private:
-    QByteArray _data;
+    // moves the chunks appended since the last call to the end of _data
+    void coalesce() const;
+    // coalesces, then returns where the current position is in _data
+    qint64 dataIndex() const;
+    // how much of size can be read from _data at index
+    qint64 readableSize(qint64 index, qint64 size) const;
+
+    // The payload of the first packet, and everything coalesced since.  The payloads of the following packets of a
+    // multi-packet message are appended to _chunks, fixed capacity buffers that are never reallocated, so a large
+    // message costs one copy into its final buffer on first contiguous access instead of repeated regrowth of _data.
+    mutable QByteArray _data;
+    mutable std::vector<QByteArray> _chunks;
+    mutable QMutex _chunksLock;
+    mutable std::atomic<bool> _hasChunks { false };
     QByteArray _headData;
 
+    std::atomic<qint64> _size { 0 };
     std::atomic<qint64> _position { 0 };
+    std::atomic<qint64> _dataOffset { 0 }; // position of the first byte of _data, past any consumed data
     std::atomic<qint64> _numPackets { 0 };
 
     QUuid _sourceID;
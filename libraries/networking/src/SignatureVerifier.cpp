@@ -0,0 +1,85 @@
+//
+//  SignatureVerifier.cpp
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SignatureVerifier.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+
+#include <SharedUtil.h>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+namespace {
+
+class VerificationTask : public QRunnable {
+public:
+    VerificationTask(std::function<void()> task) : _task(task) {}
+    void run() override { _task(); }
+
+private:
+    std::function<void()> _task;
+};
+
+}
+
+SignatureVerifier::SignatureVerifier(int maxThreads, QObject* parent) :
+    QObject(parent)
+{
+    _workers.setMaxThreadCount(std::max(1, std::min(QThread::idealThreadCount(), maxThreads)));
+}
+
+SignatureVerifier::~SignatureVerifier() {
+    // the verifications post their results to this object, they have to be done before it goes
+    _workers.waitForDone();
+}
+
+bool SignatureVerifier::verify(const QString& name, const QByteArray& publicKey, const QByteArray& hash,
+                               const QByteArray& signature) {
+    std::shared_ptr<RSA> rsaPublicKey = _publicKeys.value(name);
+    if (!rsaPublicKey) {
+        const unsigned char* publicKeyData = reinterpret_cast<const unsigned char*>(publicKey.constData());
+        RSA* parsedKey = d2i_RSA_PUBKEY(NULL, &publicKeyData, publicKey.size());
+        if (!parsedKey) {
+            return false;
+        }
+
+        rsaPublicKey = std::shared_ptr<RSA>(parsedKey, RSA_free);
+        _publicKeys.insert(name, rsaPublicKey);
+    }
+
+    ++_numPending;
+    _workers.start(new VerificationTask([this, name, rsaPublicKey, hash, signature] {
+        quint64 start = usecTimestampNow();
+        int verifyResult = RSA_verify(NID_sha256,
+                                      reinterpret_cast<const unsigned char*>(hash.constData()), hash.size(),
+                                      reinterpret_cast<const unsigned char*>(signature.constData()), signature.size(),
+                                      rsaPublicKey.get());
+        quint64 verifyUsecs = usecTimestampNow() - start;
+
+        QMetaObject::invokeMethod(this, "verificationComplete", Qt::QueuedConnection, Q_ARG(QString, name),
+                                  Q_ARG(bool, verifyResult == 1), Q_ARG(quint64, verifyUsecs));
+    }));
+
+    return true;
+}
+
+void SignatureVerifier::verificationComplete(QString name, bool isValid, quint64 verifyUsecs) {
+    --_numPending;
+    emit verified(name, isValid, verifyUsecs);
+}
@@ -0,0 +1,55 @@
+//
+//  SignatureVerifier.h
+//  libraries/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SignatureVerifier_h
+#define hifi_SignatureVerifier_h
+
+#include <memory>
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+
+typedef struct rsa_st RSA;
+
+// Verifies RSA signatures of SHA-256 hashes on a small pool of worker threads, so that a burst of them doesn't hold up
+// the thread handling the requests.  The verifier is used from the thread it lives on, which the results are delivered
+// to.  Public keys are parsed once per name, and kept until they are forgotten.
+class SignatureVerifier : public QObject {
+    Q_OBJECT
+public:
+    static const int DEFAULT_MAX_THREADS = 4;
+
+    SignatureVerifier(int maxThreads = DEFAULT_MAX_THREADS, QObject* parent = nullptr);
+    ~SignatureVerifier();
+
+    // Queues the verification of signature against hash, with publicKey (DER encoded) or the key already parsed for
+    // name.  verified is emitted once it's done.  Returns false, and queues nothing, if the key can't be parsed.
+    bool verify(const QString& name, const QByteArray& publicKey, const QByteArray& hash, const QByteArray& signature);
+
+    // drops the parsed key of name, verifications already queued still use it
+    void forgetKey(const QString& name) { _publicKeys.remove(name); }
+
+    int getNumPending() const { return _numPending; }
+    int getNumCachedKeys() const { return _publicKeys.size(); }
+
+signals:
+    void verified(QString name, bool isValid, quint64 verifyUsecs);
+
+private slots:
+    void verificationComplete(QString name, bool isValid, quint64 verifyUsecs);
+
+private:
+    QHash<QString, std::shared_ptr<RSA>> _publicKeys; // shared with the verifications using them
+    int _numPending { 0 };
+    QThreadPool _workers;
+};
+
+#endif // hifi_SignatureVerifier_h
@@ -732,8 +732,9 @@ void Connection::processACK2(ControlPacketPointer controlPacket) {
     SequenceNumber subSequenceNumber;
     controlPacket->readPrimitive(&subSequenceNumber);
 
-    // check if we had that subsequence number in our map
-    auto it = std::find_if_not(_sentACKs.begin(), _sentACKs.end(), [&subSequenceNumber](const ACKListPair& pair){
+    // check if we had that subsequence number in our map, the sub sequence numbers are sent in increasing order
+    auto it = std::lower_bound(_sentACKs.begin(), _sentACKs.end(), subSequenceNumber,
+                               [](const ACKListPair& pair, const SequenceNumber& subSequenceNumber) {
         return pair.first < subSequenceNumber;
     });
     
@@ -953,36 +954,70 @@ void PendingReceivedMessage::enqueuePacket(std::unique_ptr<Packet> packet) {
                "PendingReceivedMessage::enqueuePacket",
                "called with a packet that is not part of a message");
     
+    auto messagePartNumber = packet->getMessagePartNumber();
+
+    if (messagePartNumber < _nextPartNumber) {
+        qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: This is a duplicate packet";
+        return;
+    }
+
+    // parts can't legitimately arrive further ahead than the packets in flight, don't let a bad part number
+    // make us allocate an enormous window
+    static const Packet::MessagePartNumber MAX_PART_OFFSET = 4 * udt::MAX_PACKETS_IN_FLIGHT;
+
+    auto offset = messagePartNumber - _nextPartNumber;
+    if (offset >= MAX_PART_OFFSET) {
+        qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: Dropping a packet too far ahead of the message";
+        return;
+    }
+    if (offset >= _window.size()) {
+        growWindow(offset);
+    }
+
+    auto& slot = _window[messagePartNumber & _windowMask];
+    if (slot) {
+        qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: This is a duplicate packet";
+        return;
+    }
+
     if (packet->getPacketPosition() == Packet::PacketPosition::LAST ||
         packet->getPacketPosition() == Packet::PacketPosition::ONLY) {
         _hasLastPacket = true;
-        _numPackets = packet->getMessagePartNumber() + 1;
+        _numPackets = messagePartNumber + 1;
     }
 
-    // Insert into the packets list in sorted order. Because we generally expect to receive packets in order, begin
-    // searching from the end of the list.
-    auto messagePartNumber = packet->getMessagePartNumber();
-    auto it = std::find_if(_packets.rbegin(), _packets.rend(),
-        [&](const std::unique_ptr<Packet>& value) { return messagePartNumber >= value->getMessagePartNumber(); });
+    slot = std::move(packet);
+}
 
-    if (it != _packets.rend() && ((*it)->getMessagePartNumber() == messagePartNumber)) {
-        qCDebug(networking) << "PendingReceivedMessage::enqueuePacket: This is a duplicate packet";
-        return;
+void PendingReceivedMessage::growWindow(Packet::MessagePartNumber offset) {
+    static const size_t MIN_WINDOW_SIZE = 64;
+
+    size_t newSize = std::max(MIN_WINDOW_SIZE, _window.size());
+    while (newSize <= offset) {
+        newSize *= 2;
     }
-    
-    _packets.insert(it.base(), std::move(packet));
+
+    // re-slot the parts we are holding for the new modulo
+    std::vector<std::unique_ptr<Packet>> newWindow(newSize);
+    Packet::MessagePartNumber newMask = (Packet::MessagePartNumber)(newSize - 1);
+    for (auto& packet : _window) {
+        if (packet) {
+            newWindow[packet->getMessagePartNumber() & newMask] = std::move(packet);
+        }
+    }
+
+    _window.swap(newWindow);
+    _windowMask = newMask;
 }
 
 bool PendingReceivedMessage::hasAvailablePackets() const {
-    return _packets.size() > 0
-        && _nextPartNumber == _packets.front()->getMessagePartNumber();
+    return !_window.empty() && _window[_nextPartNumber & _windowMask];
 }
 
 std::unique_ptr<Packet> PendingReceivedMessage::removeNextPacket() {
     if (hasAvailablePackets()) {
+        auto p = std::move(_window[_nextPartNumber & _windowMask]);
         _nextPartNumber++;
-        auto p = std::move(_packets.front());
-        _packets.pop_front();
         return p;
     }
     return std::unique_ptr<Packet>();
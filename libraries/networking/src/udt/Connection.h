@@ -12,8 +12,10 @@
 #ifndef hifi_Connection_h
 #define hifi_Connection_h
 
-#include <list>
+#include <deque>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <QtCore/QObject>
 
@@ -37,13 +39,20 @@ class Socket;
 class PendingReceivedMessage {
 public:
     void enqueuePacket(std::unique_ptr<Packet> packet);
-    bool isComplete() const { return _hasLastPacket && _numPackets == _packets.size(); }
+    bool isComplete() const { return _hasLastPacket && _nextPartNumber == _numPackets; }
     bool hasAvailablePackets() const;
     std::unique_ptr<Packet> removeNextPacket();
-    
-    std::list<std::unique_ptr<Packet>> _packets;
 
 private:
+    // grows the window to a power of two that can hold part numbers up to _nextPartNumber + offset
+    void growWindow(Packet::MessagePartNumber offset);
+
+    // Receive window of the parts that arrived ahead of _nextPartNumber, a ring buffer indexed by part number
+    // modulo its size.  An occupied slot marks its part as received, so inserting, finding duplicates and
+    // removing the next part in order are all constant time.
+    std::vector<std::unique_ptr<Packet>> _window;
+    Packet::MessagePartNumber _windowMask { 0 };
+
     bool _hasLastPacket { false };
     Packet::MessagePartNumber _nextPartNumber = 0;
     unsigned int _numPackets { 0 };
@@ -54,7 +63,7 @@ class Connection : public QObject {
 public:
     using SequenceNumberTimePair = std::pair<SequenceNumber, p_high_resolution_clock::time_point>;
     using ACKListPair = std::pair<SequenceNumber, SequenceNumberTimePair>;
-    using SentACKList = std::list<ACKListPair>;
+    using SentACKList = std::deque<ACKListPair>;
     using ControlPacketPointer = std::unique_ptr<ControlPacket>;
     
     Connection(Socket* parentSocket, HifiSockAddr destination, std::unique_ptr<CongestionControl> congestionControl);
@@ -173,7 +182,7 @@ private:
    
     std::unique_ptr<SendQueue> _sendQueue;
     
-    std::map<MessageNumber, PendingReceivedMessage> _pendingReceivedMessages;
+    std::unordered_map<MessageNumber, PendingReceivedMessage> _pendingReceivedMessages;
     
     int _packetsSinceACK { 0 }; // The number of packets that have been received during the current ACK interval
 
@@ -11,11 +11,19 @@
 
 #include "LossList.h"
 
+#include <algorithm>
+
 #include "ControlPacket.h"
 
 using namespace udt;
 using namespace std;
 
+LossList::Ranges::iterator LossList::findRange(SequenceNumber seq) {
+    return lower_bound(_lossList.begin(), _lossList.end(), seq, [](const Range& range, const SequenceNumber& seq) {
+        return range.second < seq;
+    });
+}
+
 void LossList::append(SequenceNumber seq) {
     Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
                "SequenceNumber appended is not greater than the last SequenceNumber in the list");
@@ -47,9 +55,7 @@ void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
+    auto it = findRange(start);
     
     if (it == _lossList.end() || end < it->first) {
         // No overlap, simply insert
@@ -68,29 +74,28 @@ void LossList::insert(SequenceNumber start, SequenceNumber end) {
             it->second = end;
         }
         
-        auto it2 = it;
-        ++it2;
+        auto first = it + 1;
+        auto last = first;
         // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
+        while (last != _lossList.end() && it->second >= last->first - 1) {
             // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
+            if (it->second < last->second) {
+                _length += seqlen(it->second + 1, last->second);
+                it->second = last->second;
             }
             
-            // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
+            // the overlapping range is merged into the current one
+            _length -= seqlen(last->first, last->second);
+            ++last;
         }
+        _lossList.erase(first, last);
     }
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
+    auto it = findRange(seq);
     
-    if (it != end(_lossList)) {
+    if (it != _lossList.end() && it->first <= seq) {
         if (it->first == it->second) {
             _lossList.erase(it);
         } else if (seq == it->first) {
@@ -100,7 +105,7 @@ bool LossList::remove(SequenceNumber seq) {
         } else {
             auto temp = it->second;
             it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
+            _lossList.insert(it + 1, make_pair(seq + 1, temp));
         }
         _length -= 1;
         
@@ -116,43 +121,40 @@ void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
+    auto it = findRange(start);
     
-    // If we found one
-    if (it != _lossList.end()) {
-        
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
-            } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
-            }
+    if (it == _lossList.end() || end < it->first) {
+        return;
+    }
+    
+    if (it->first < start) {
+        if (end < it->second) {
+            // Cut it in half if the range we are removing is contained within one segment
+            _length -= seqlen(start, end);
+            auto temp = it->second;
+            it->second = start - 1;
+            _lossList.insert(it + 1, make_pair(end + 1, temp));
+            return;
         }
         
-        // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
-                // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
-            } else {
-                // Cut it in half if the range we are removing is contained within one segment
-                _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
-            }
-        }
+        // Beginning of segment not contained, modify end of segment.
+        _length -= seqlen(start, it->second);
+        it->second = start - 1;
+        ++it;
+    }
+    
+    // Remove every segment fully contained in the range at once
+    auto last = it;
+    while (last != _lossList.end() && last->second <= end) {
+        _length -= seqlen(last->first, last->second);
+        ++last;
+    }
+    it = _lossList.erase(it, last);
+    
+    // There might be more to remove, truncate beginning of segment
+    if (it != _lossList.end() && it->first <= end) {
+        _length -= seqlen(it->first, end);
+        it->first = end + 1;
     }
 }
 
@@ -163,7 +165,14 @@ SequenceNumber LossList::getFirstSequenceNumber() const {
 
 SequenceNumber LossList::popFirstSequenceNumber() {
     auto front = getFirstSequenceNumber();
-    remove(front);
+    
+    if (_lossList.front().first == _lossList.front().second) {
+        _lossList.pop_front();
+    } else {
+        ++_lossList.front().first;
+    }
+    _length -= 1;
+    
     return front;
 }
 
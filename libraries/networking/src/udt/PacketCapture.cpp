@@ -0,0 +1,92 @@
+//
+//  PacketCapture.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketCapture.h"
+
+#include "../NetworkLogging.h"
+
+using namespace udt;
+
+static const quint32 PACKET_CAPTURE_MAGIC = 0x48465043; // "HFPC"
+static const quint32 PACKET_CAPTURE_VERSION = 1;
+
+// pin the stream format, so that captures stay readable across Qt upgrades
+static const QDataStream::Version PACKET_CAPTURE_STREAM_VERSION = QDataStream::Qt_5_6;
+
+bool PacketCaptureWriter::open(const QString& filePath) {
+    close();
+
+    _file.setFileName(filePath);
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(networking) << "Could not open packet capture" << filePath << "for writing -" << _file.errorString();
+        return false;
+    }
+
+    _stream.setDevice(&_file);
+    _stream.setVersion(PACKET_CAPTURE_STREAM_VERSION);
+    _stream << PACKET_CAPTURE_MAGIC << PACKET_CAPTURE_VERSION;
+    _numDatagrams = 0;
+
+    return true;
+}
+
+void PacketCaptureWriter::close() {
+    if (_file.isOpen()) {
+        _stream.setDevice(nullptr);
+        _file.close();
+    }
+}
+
+void PacketCaptureWriter::write(quint64 timeUsecs, const HifiSockAddr& senderSockAddr, const char* data, qint64 size) {
+    _stream << timeUsecs << senderSockAddr;
+    _stream.writeBytes(data, (uint)size);
+    ++_numDatagrams;
+}
+
+bool PacketCaptureReader::open(const QString& filePath) {
+    close();
+
+    _file.setFileName(filePath);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        qCWarning(networking) << "Could not open packet capture" << filePath << "for reading -" << _file.errorString();
+        return false;
+    }
+
+    _stream.setDevice(&_file);
+    _stream.setVersion(PACKET_CAPTURE_STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    _stream >> magic >> version;
+
+    if (magic != PACKET_CAPTURE_MAGIC || version != PACKET_CAPTURE_VERSION) {
+        qCWarning(networking) << filePath << "is not a packet capture this build can read";
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void PacketCaptureReader::close() {
+    if (_file.isOpen()) {
+        _stream.setDevice(nullptr);
+        _file.close();
+    }
+}
+
+bool PacketCaptureReader::readNext(CapturedDatagram& datagram) {
+    if (!_file.isOpen() || _stream.atEnd()) {
+        return false;
+    }
+
+    _stream >> datagram.timeUsecs >> datagram.senderSockAddr >> datagram.data;
+    return _stream.status() == QDataStream::Ok;
+}
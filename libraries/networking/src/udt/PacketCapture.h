@@ -0,0 +1,64 @@
+//
+//  PacketCapture.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketCapture_h
+#define hifi_PacketCapture_h
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+
+#include "../HifiSockAddr.h"
+
+namespace udt {
+
+// A datagram as a Socket read it, with the time it arrived relative to the start of its capture.
+struct CapturedDatagram {
+    quint64 timeUsecs { 0 };
+    HifiSockAddr senderSockAddr;
+    QByteArray data;
+};
+
+// A capture file is a header followed by one record per datagram, in the order they were read:
+//      quint32 magic, quint32 version, then { quint64 timeUsecs, HifiSockAddr sender, QByteArray data } ...
+class PacketCaptureWriter {
+public:
+    bool open(const QString& filePath);
+    void close();
+    bool isOpen() const { return _file.isOpen(); }
+
+    void write(quint64 timeUsecs, const HifiSockAddr& senderSockAddr, const char* data, qint64 size);
+
+    int getNumDatagrams() const { return _numDatagrams; }
+
+private:
+    QFile _file;
+    QDataStream _stream;
+    int _numDatagrams { 0 };
+};
+
+class PacketCaptureReader {
+public:
+    bool open(const QString& filePath);
+    void close();
+
+    // returns false at the end of the capture, or on a truncated record
+    bool readNext(CapturedDatagram& datagram);
+
+private:
+    QFile _file;
+    QDataStream _stream;
+};
+
+}
+
+#endif // hifi_PacketCapture_h
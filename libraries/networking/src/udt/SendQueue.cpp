@@ -142,6 +142,10 @@ void SendQueue::stop() {
 int SendQueue::sendPacket(const Packet& packet) {
     return _socket->writeDatagram(packet.getData(), packet.getDataSize(), _destination);
 }
+
+int SendQueue::sendRetransmittedPacket(const Packet& packet) {
+    return _socket->writeRetransmittedDatagram(packet.getData(), packet.getDataSize(), _destination);
+}
     
 void SendQueue::ack(SequenceNumber ack) {
     // this is a response from the client, re-set our timeout expiry and our last response time
@@ -509,10 +513,10 @@ bool SendQueue::maybeResendPacket() {
                     packet->obfuscate(level);
 
                     // send it off
-                    sendPacket(*packet);
+                    sendRetransmittedPacket(*packet);
                 } else {
                     // send it off
-                    sendPacket(resendPacket);
+                    sendRetransmittedPacket(resendPacket);
 
                     // unlock the sent packets
                     sentLocker.unlock();
@@ -98,6 +98,7 @@ private:
     void sendHandshake();
     
     int sendPacket(const Packet& packet);
+    int sendRetransmittedPacket(const Packet& packet);
     bool sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket, SequenceNumber sequenceNumber);
     
     int maybeSendNewPacket(); // Figures out what packet to send next
@@ -14,6 +14,7 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <mutex>
@@ -25,6 +26,7 @@
 #include "../HifiSockAddr.h"
 #include "TCPVegasCC.h"
 #include "Connection.h"
+#include "PacketCapture.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -65,6 +67,8 @@ public:
     qint64 writePacketList(std::unique_ptr<PacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
+    // for resends of reliable packets, which are kept out of the replay byte count
+    qint64 writeRetransmittedDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     
     void bind(const QHostAddress& address, quint16 port = 0);
     void rebind(quint16 port);
@@ -80,6 +84,16 @@ public:
     void addUnfilteredHandler(const HifiSockAddr& senderSockAddr, BasePacketHandler handler)
         { _unfilteredHandlers[senderSockAddr] = handler; }
     
+    // records every datagram read from the network until stopCapture, both must be called on the socket's thread
+    bool startCapture(const QString& filePath);
+    void stopCapture();
+
+    // while replaying, datagrams only come in through replayDatagram and writes are counted instead of sent
+    void setIsReplaying(bool isReplaying) { _isReplaying = isReplaying; }
+    void replayDatagram(const CapturedDatagram& datagram);
+    quint64 getNumReplayBytesWritten() const { return _numReplayBytesWritten; }
+    quint64 getNumReplayBytesRetransmitted() const { return _numReplayBytesRetransmitted; }
+
     void setCongestionControlFactory(std::unique_ptr<CongestionControlVirtualFactory> ccFactory);
     void setConnectionMaxBandwidth(int maxBandwidth);
 
@@ -109,6 +123,8 @@ private slots:
 
 private:
     void setSystemBufferSizes();
+    void processDatagram(std::unique_ptr<char[]> buffer, int packetSizeWithHeader, const HifiSockAddr& senderSockAddr,
+                         p_high_resolution_clock::time_point receiveTime);
     Connection* findOrCreateConnection(const HifiSockAddr& sockAddr);
     bool socketMatchesNodeOrDomain(const HifiSockAddr& sockAddr);
    
@@ -148,6 +164,13 @@ private:
     int _lastPacketSizeRead { 0 };
     SequenceNumber _lastReceivedSequenceNumber;
     HifiSockAddr _lastPacketSockAddr;
+
+    PacketCaptureWriter _capture;
+    p_high_resolution_clock::time_point _captureStartTime;
+
+    std::atomic<bool> _isReplaying { false };
+    std::atomic<quint64> _numReplayBytesWritten { 0 };
+    std::atomic<quint64> _numReplayBytesRetransmitted { 0 };
     
     friend UDTTest;
 };
@@ -212,6 +212,18 @@ public:
     virtual bool handlesEditPacketType(PacketType packetType) const { return false; }
     virtual int processEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
                                       const SharedNodePointer& sourceNode) { return 0; }
+
+    // Trees that can split an edit into a decode step, which doesn't need the tree lock and can run on any thread,
+    // and an apply step under the write lock, let the server decode edits in parallel and apply them in batches
+    class DecodedEdit {
+    public:
+        virtual ~DecodedEdit() {}
+    };
+    using DecodedEditPointer = std::unique_ptr<DecodedEdit>;
+    virtual bool canDecodeEditPackets() const { return false; }
+    virtual DecodedEditPointer decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                                    int& bytesRead) const { bytesRead = 0; return DecodedEditPointer(); }
+    virtual void applyDecodedEdit(DecodedEdit& edit, const SharedNodePointer& sourceNode) { }
     virtual void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
     virtual void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) { return; }
@@ -0,0 +1,156 @@
+//
+//  OctreeEditBatch.cpp
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEditBatch.h"
+
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+
+#include <SharedUtil.h>
+
+namespace {
+
+class EditDecodeTask : public QRunnable {
+public:
+    EditDecodeTask(std::function<void()> task) : _task(task) {}
+    void run() override { _task(); }
+
+private:
+    std::function<void()> _task;
+};
+
+}
+
+OctreeEditBatch::OctreeEditBatch(PacketAppliedCallback packetAppliedCallback) :
+    _packetAppliedCallback(packetAppliedCallback)
+{
+    _decodePool.setMaxThreadCount(MAX_DECODE_THREADS);
+}
+
+void OctreeEditBatch::resetStats() {
+    _totalBatches = 0;
+    _totalEdits = 0;
+    _totalDecodeTime = 0;
+    _totalLockWaitTime = 0;
+    _totalApplyTime = 0;
+}
+
+void OctreeEditBatch::addEditPacket(const OctreePointer& tree, QSharedPointer<ReceivedMessage> message,
+                                    SharedNodePointer sendingNode, unsigned short int sequence, quint64 transitTime) {
+    EditPacket packet;
+    packet.message = message;
+    packet.sendingNode = sendingNode;
+    packet.sequence = sequence;
+    packet.transitTime = transitTime;
+    _packets.push_back(std::move(packet));
+
+    if (_packets.size() >= MAX_PACKETS_PER_BATCH) {
+        flush(tree);
+    }
+}
+
+void OctreeEditBatch::processChallengeOwnershipPacket(const OctreePointer& tree, ReceivedMessage& message,
+                                                      const SharedNodePointer& sendingNode) {
+    // the challenge is about the entities as the edits before it left them
+    flush(tree);
+
+    tree->withWriteLock([&] {
+        switch (message.getType()) {
+            case PacketType::ChallengeOwnership:
+                tree->processChallengeOwnershipPacket(message, sendingNode);
+                break;
+            case PacketType::ChallengeOwnershipRequest:
+                tree->processChallengeOwnershipRequestPacket(message, sendingNode);
+                break;
+            case PacketType::ChallengeOwnershipReply:
+                tree->processChallengeOwnershipReplyPacket(message, sendingNode);
+                break;
+            default:
+                break;
+        }
+    });
+}
+
+void OctreeEditBatch::decodeEditPacket(const Octree& tree, EditPacket& packet) {
+    auto& message = packet.message;
+
+    quint64 startDecode = usecTimestampNow();
+    while (message->getBytesLeftToRead() > 0) {
+        auto editData = reinterpret_cast<const unsigned char*>(message->getRawMessage() + message->getPosition());
+        int maxSize = message->getBytesLeftToRead();
+
+        int editDataBytesRead = 0;
+        auto edit = tree.decodeEditPacketData(*message, editData, maxSize, editDataBytesRead);
+        if (edit) {
+            packet.edits.push_back(std::move(edit));
+        }
+
+        if (editDataBytesRead <= 0) {
+            // nothing more we can make sense of in this packet
+            break;
+        }
+
+        // skip to next edit record in the packet
+        message->seek(message->getPosition() + editDataBytesRead);
+    }
+    packet.decodeTime = usecTimestampNow() - startDecode;
+}
+
+void OctreeEditBatch::flush(const OctreePointer& tree) {
+    if (_packets.empty()) {
+        return;
+    }
+
+    // decode the packets in parallel, without the tree lock, the calling thread takes its share
+    quint64 startDecode = usecTimestampNow();
+    std::atomic<size_t> nextPacket { 0 };
+    auto decodePackets = [&] {
+        size_t i;
+        while ((i = nextPacket++) < _packets.size()) {
+            decodeEditPacket(*tree, _packets[i]);
+        }
+    };
+    int numHelpers = std::min((int)_packets.size() - 1, _decodePool.maxThreadCount());
+    for (int i = 0; i < numHelpers; ++i) {
+        _decodePool.start(new EditDecodeTask(decodePackets));
+    }
+    decodePackets();
+    _decodePool.waitForDone();
+    quint64 endDecode = usecTimestampNow();
+
+    // apply them all, in the order they arrived, under a single write lock
+    quint64 startApply = 0;
+    size_t editsInBatch = 0;
+    tree->withWriteLock([&] {
+        startApply = usecTimestampNow();
+        for (auto& packet : _packets) {
+            quint64 startPacket = usecTimestampNow();
+            for (auto& edit : packet.edits) {
+                tree->applyDecodedEdit(*edit, packet.sendingNode);
+            }
+            packet.applyTime = usecTimestampNow() - startPacket;
+            editsInBatch += packet.edits.size();
+        }
+    });
+    quint64 endApply = usecTimestampNow();
+    quint64 lockWaitTime = startApply - endDecode;
+
+    _totalBatches++;
+    _totalEdits += editsInBatch;
+    _totalDecodeTime += endDecode - startDecode;
+    _totalLockWaitTime += lockWaitTime;
+    _totalApplyTime += endApply - startApply;
+
+    for (const auto& packet : _packets) {
+        _packetAppliedCallback(packet, lockWaitTime);
+    }
+    _packets.clear();
+}
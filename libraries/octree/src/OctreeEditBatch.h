@@ -0,0 +1,86 @@
+//
+//  OctreeEditBatch.h
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditBatch_h
+#define hifi_OctreeEditBatch_h
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <QtCore/QThreadPool>
+
+#include <ReceivedMessage.h>
+
+#include "Octree.h"
+
+// Collects a server's edit packets for a tree that canDecodeEditPackets(), then decodes them in parallel and applies
+// them in the order they arrived, under one write lock per batch.
+//   Whatever has to see the edits that arrived before it must flush the batch first: ownership challenges go through
+// processChallengeOwnershipPacket() for that, and the sequence numbers NACKs are computed from are only tracked once
+// a packet is applied.
+class OctreeEditBatch {
+public:
+    struct EditPacket {
+        QSharedPointer<ReceivedMessage> message;
+        SharedNodePointer sendingNode;
+        unsigned short int sequence { 0 };
+        quint64 transitTime { 0 };
+        quint64 decodeTime { 0 };
+        quint64 applyTime { 0 };
+        std::vector<Octree::DecodedEditPointer> edits;
+    };
+
+    // called for each packet once its edits are applied, in the order they arrived
+    using PacketAppliedCallback = std::function<void(const EditPacket& packet, quint64 lockWaitTime)>;
+
+    static const size_t MAX_PACKETS_PER_BATCH = 256;
+    static const int MAX_DECODE_THREADS = 4;
+
+    OctreeEditBatch(PacketAppliedCallback packetAppliedCallback);
+
+    bool isEmpty() const { return _packets.empty(); }
+    size_t size() const { return _packets.size(); }
+
+    // queues an edit packet whose header has been read, and applies the batch once it's full, so that the time edits
+    // wait for their batch stays bounded
+    void addEditPacket(const OctreePointer& tree, QSharedPointer<ReceivedMessage> message,
+                       SharedNodePointer sendingNode, unsigned short int sequence, quint64 transitTime);
+
+    // decodes and applies all the queued packets
+    void flush(const OctreePointer& tree);
+
+    // applies the queued packets, then processes a ChallengeOwnership, ChallengeOwnershipRequest or
+    // ChallengeOwnershipReply packet
+    void processChallengeOwnershipPacket(const OctreePointer& tree, ReceivedMessage& message,
+                                         const SharedNodePointer& sendingNode);
+
+    quint64 getTotalBatches() const { return _totalBatches; }
+    float getAverageEditsPerBatch() const { return _totalBatches == 0 ? 0.0f : (float)_totalEdits / _totalBatches; }
+    quint64 getAverageDecodeTimePerBatch() const { return _totalBatches == 0 ? 0 : _totalDecodeTime / _totalBatches; }
+    quint64 getAverageLockWaitTimePerBatch() const { return _totalBatches == 0 ? 0 : _totalLockWaitTime / _totalBatches; }
+    quint64 getAverageApplyTimePerBatch() const { return _totalBatches == 0 ? 0 : _totalApplyTime / _totalBatches; }
+    void resetStats();
+
+private:
+    void decodeEditPacket(const Octree& tree, EditPacket& packet);
+
+    PacketAppliedCallback _packetAppliedCallback;
+    std::vector<EditPacket> _packets;
+    QThreadPool _decodePool;
+
+    std::atomic<uint64_t> _totalBatches { 0 };
+    std::atomic<uint64_t> _totalEdits { 0 };
+    std::atomic<uint64_t> _totalDecodeTime { 0 };
+    std::atomic<uint64_t> _totalLockWaitTime { 0 };
+    std::atomic<uint64_t> _totalApplyTime { 0 };
+};
+
+#endif // hifi_OctreeEditBatch_h
@@ -86,11 +86,14 @@ void OctreeElement::init(unsigned char * octalCode) {
 
 #ifdef SIMPLE_EXTERNAL_CHILDREN
     _childrenSingle.reset();
-#endif
-
     for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
         _externalChildren[i].reset();
     }
+#endif
+
+#ifdef PACKED_CHILDREN
+    _packedChildren = nullptr;
+#endif
 
     _isDirty = true;
     _shouldRender = false;
@@ -281,6 +284,13 @@ OctreeElementPointer OctreeElement::getChildAtIndex(int childIndex) const {
         } break;
     }
 #endif // def SIMPLE_EXTERNAL_CHILDREN
+
+#ifdef PACKED_CHILDREN
+    if (!oneAtBit(_childBitmask, childIndex)) {
+        return NULL;
+    }
+    return _packedChildren[getPackedChildSlot(childIndex)];
+#endif // def PACKED_CHILDREN
 }
 
 void OctreeElement::deleteAllChildren() {
@@ -292,12 +302,22 @@ void OctreeElement::deleteAllChildren() {
         }
     }
 
+#ifdef SIMPLE_EXTERNAL_CHILDREN
     if (_childrenExternal) {
         // if the children_t union represents _children.external we need to delete it here
         for (int i = 0; i < NUMBER_OF_CHILDREN; i ++) {
             _externalChildren[i].reset();
         }
     }
+#endif
+
+#ifdef PACKED_CHILDREN
+    if (_packedChildren) {
+        _externalChildrenMemoryUsage -= getChildCount() * sizeof(OctreeElementPointer);
+        delete[] _packedChildren;
+        _packedChildren = nullptr;
+    }
+#endif
 }
 
 void OctreeElement::setChildAtIndex(int childIndex, const OctreeElementPointer& child) {
@@ -376,6 +396,53 @@ void OctreeElement::setChildAtIndex(int childIndex, const OctreeElementPointer&
     }
 
 #endif // def SIMPLE_EXTERNAL_CHILDREN
+
+#ifdef PACKED_CHILDREN
+    bool hadChild = oneAtBit(_childBitmask, childIndex);
+    int slot = getPackedChildSlot(childIndex);
+
+    if (hadChild && child) {
+        // replacing an existing child doesn't change the layout
+        _packedChildren[slot] = child;
+        return;
+    } else if (!hadChild && !child) {
+        return;
+    }
+
+    int previousChildCount = getChildCount();
+    if (child) {
+        setAtBit(_childBitmask, childIndex);
+    } else {
+        clearAtBit(_childBitmask, childIndex);
+    }
+    int newChildCount = getChildCount();
+
+    // track our population data
+    _childrenCount[previousChildCount]--;
+    _childrenCount[newChildCount]++;
+
+    // rebuild the packed array with the child inserted at, or removed from, its slot
+    OctreeElementPointer* newChildren = (newChildCount > 0) ? new OctreeElementPointer[newChildCount] : nullptr;
+    for (int i = 0; i < slot; i++) {
+        newChildren[i] = std::move(_packedChildren[i]);
+    }
+    if (child) {
+        newChildren[slot] = child;
+        for (int i = slot; i < previousChildCount; i++) {
+            newChildren[i + 1] = std::move(_packedChildren[i]);
+        }
+    } else {
+        for (int i = slot + 1; i < previousChildCount; i++) {
+            newChildren[i - 1] = std::move(_packedChildren[i]);
+        }
+    }
+    delete[] _packedChildren;
+    _packedChildren = newChildren;
+
+    _childrenExternal = (newChildCount > 0);
+    _externalChildrenMemoryUsage += newChildCount * sizeof(OctreeElementPointer);
+    _externalChildrenMemoryUsage -= previousChildCount * sizeof(OctreeElementPointer);
+#endif // def PACKED_CHILDREN
 }
 
 
@@ -13,7 +13,8 @@
 #define hifi_OctreeElement_h
 
 //#define SIMPLE_CHILD_ARRAY
-#define SIMPLE_EXTERNAL_CHILDREN
+//#define SIMPLE_EXTERNAL_CHILDREN
+#define PACKED_CHILDREN
 
 #include <atomic>
 
@@ -248,6 +249,14 @@ protected:
     // } _children;
 #endif
 
+#ifdef PACKED_CHILDREN
+    /// Children stored contiguously in child index order, exactly getChildCount() entries, null for leaves, 8 bytes
+    OctreeElementPointer* _packedChildren;
+    int getPackedChildSlot(int childIndex) const {
+        return numberOfOnes((unsigned char)(_childBitmask & ((1 << childIndex) - 1)));
+    }
+#endif
+
     uint16_t _sourceUUIDKey; /// Client only, stores node id of voxel server that sent his voxel, 2 bytes
 
     // Support for _sourceUUID, we use these static member variables to track the UUIDs that are
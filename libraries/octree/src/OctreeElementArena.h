@@ -0,0 +1,224 @@
+//
+//  OctreeElementArena.h
+//  libraries/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeElementArena_h
+#define hifi_OctreeElementArena_h
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Slab storage for fixed size blocks. Octree elements are created and destroyed in large numbers, and allocating
+// each one (plus its shared_ptr control block) from the general heap scatters siblings across memory. The arena
+// hands out slots from large contiguous slabs and recycles freed slots through intrusive free lists, so elements
+// created together during a tree build or a packet read end up next to each other.
+//
+// Each thread allocates from and frees to its own cache of free slots without any locking. The caches trade slots
+// with a shared pool in batches of BLOCKS_PER_BATCH, so the pool's mutex is taken at most once every BLOCKS_PER_BATCH
+// allocations or frees on a thread, and a thread keeps fewer than 2 * BLOCKS_PER_BATCH free slots to itself. A
+// thread's cache goes back to the pool when the thread exits.
+//
+// Slabs are never released: the arena's footprint stays at the high water mark of live blocks, rounded up to whole
+// slabs, and freed slots are reused by later allocations of the same type. Releasing a slab would need a live count
+// per slab on every free, and with the free slots of a pruned tree scattered across slabs it would rarely be empty.
+// getReservedBytes reports that footprint.
+template <size_t BlockSize, size_t BlockAlignment>
+class OctreeElementSlabArena {
+public:
+    static const size_t BLOCKS_PER_SLAB = 4096;
+    static const size_t BLOCKS_PER_BATCH = 64;
+
+    static OctreeElementSlabArena& getInstance() {
+        // intentionally leaked, elements owned by static trees may still be released after other statics are gone
+        static OctreeElementSlabArena* instance = new OctreeElementSlabArena();
+        return *instance;
+    }
+
+    void* allocate() {
+        ThreadCache* cache = getThreadCache();
+        if (!cache) {
+            // this thread's cache is already gone, it is exiting
+            Batch batch = takeBatch();
+            FreeBlock* block = batch.head;
+            batch.head = block->next;
+            if (--batch.count > 0) {
+                returnBatch(batch);
+            }
+            return block;
+        }
+
+        if (!cache->freeList) {
+            Batch batch = takeBatch();
+            cache->freeList = batch.head;
+            cache->count = batch.count;
+        }
+        FreeBlock* block = cache->freeList;
+        cache->freeList = block->next;
+        --cache->count;
+        return block;
+    }
+
+    void deallocate(void* pointer) {
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        ThreadCache* cache = getThreadCache();
+        if (!cache) {
+            block->next = nullptr;
+            returnBatch({ block, 1 });
+            return;
+        }
+
+        block->next = cache->freeList;
+        cache->freeList = block;
+        if (++cache->count >= 2 * BLOCKS_PER_BATCH) {
+            // keep the most recently freed blocks, they are the likeliest to still be in the cache
+            FreeBlock* last = cache->freeList;
+            for (size_t i = 1; i < BLOCKS_PER_BATCH; ++i) {
+                last = last->next;
+            }
+            returnBatch({ last->next, cache->count - BLOCKS_PER_BATCH });
+            last->next = nullptr;
+            cache->count = BLOCKS_PER_BATCH;
+        }
+    }
+
+    // the blocks handed out of the shared pool, including the free ones threads hold in their caches
+    size_t getBlocksInUse() const { return _blocksInUse; }
+    size_t getReservedBytes() const { return _reservedBytes; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // a null terminated run of free blocks
+    struct Batch {
+        FreeBlock* head;
+        size_t count;
+    };
+
+    class ThreadCache {
+    public:
+        ThreadCache(bool& isDestroyed) : _isDestroyed(isDestroyed) {}
+        ~ThreadCache() {
+            _isDestroyed = true;
+            if (freeList) {
+                getInstance().returnBatch({ freeList, count });
+            }
+        }
+
+        FreeBlock* freeList { nullptr };
+        size_t count { 0 };
+
+    private:
+        bool& _isDestroyed;
+    };
+
+    static const size_t SLOT_ALIGNMENT = BlockAlignment > alignof(FreeBlock) ? BlockAlignment : alignof(FreeBlock);
+    static const size_t SLOT_SIZE_UNALIGNED = BlockSize > sizeof(FreeBlock) ? BlockSize : sizeof(FreeBlock);
+    static const size_t SLOT_SIZE = (SLOT_SIZE_UNALIGNED + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+
+    using Slot = typename std::aligned_storage<SLOT_SIZE, SLOT_ALIGNMENT>::type;
+
+    OctreeElementSlabArena() = default;
+
+    // null once the calling thread's cache has been destroyed, blocks can still be released while a thread exits
+    static ThreadCache* getThreadCache() {
+        // trivially destructible, so it can still be read after the cache is destroyed
+        thread_local bool isCacheDestroyed { false };
+        thread_local ThreadCache cache { isCacheDestroyed };
+        return isCacheDestroyed ? nullptr : &cache;
+    }
+
+    Batch takeBatch() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_batches.empty()) {
+            addSlab();
+        }
+        Batch batch = _batches.back();
+        _batches.pop_back();
+        _blocksInUse += batch.count;
+        return batch;
+    }
+
+    void returnBatch(Batch batch) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _batches.push_back(batch);
+        _blocksInUse -= batch.count;
+    }
+
+    // called with _mutex held
+    void addSlab() {
+        _slabs.emplace_back(new Slot[BLOCKS_PER_SLAB]);
+        Slot* slab = _slabs.back().get();
+        _reservedBytes += BLOCKS_PER_SLAB * sizeof(Slot);
+
+        // thread each batch's slots in address order, and push the batches so the first one is taken first, so
+        // consecutive allocations are adjacent
+        for (size_t batchStart = BLOCKS_PER_SLAB; batchStart > 0; batchStart -= BLOCKS_PER_BATCH) {
+            FreeBlock* head = nullptr;
+            for (size_t i = batchStart; i > batchStart - BLOCKS_PER_BATCH; --i) {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(&slab[i - 1]);
+                block->next = head;
+                head = block;
+            }
+            _batches.push_back({ head, BLOCKS_PER_BATCH });
+        }
+    }
+
+    static_assert(BLOCKS_PER_SLAB % BLOCKS_PER_BATCH == 0, "a slab must split into whole batches");
+
+    std::mutex _mutex;
+    std::vector<Batch> _batches;
+    std::vector<std::unique_ptr<Slot[]>> _slabs;
+    std::atomic<size_t> _blocksInUse { 0 };
+    std::atomic<size_t> _reservedBytes { 0 };
+};
+
+// Standard allocator front end for the slab arena, meant for std::allocate_shared so that an element and its
+// control block share one arena slot. Single object allocations of any rebound type come from the arena sized for
+// that type; anything else falls through to the global heap.
+template <typename T>
+class OctreeElementAllocator {
+public:
+    using value_type = T;
+
+    OctreeElementAllocator() = default;
+    template <typename U>
+    OctreeElementAllocator(const OctreeElementAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (count == 1) {
+            return static_cast<T*>(Arena::getInstance().allocate());
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        if (count == 1) {
+            Arena::getInstance().deallocate(pointer);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    template <typename U>
+    bool operator==(const OctreeElementAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const OctreeElementAllocator<U>&) const { return false; }
+
+private:
+    using Arena = OctreeElementSlabArena<sizeof(T), alignof(T)>;
+};
+
+#endif // hifi_OctreeElementArena_h
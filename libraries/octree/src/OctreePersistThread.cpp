@@ -309,7 +309,10 @@ void OctreePersistThread::persist() {
         if(lockFile.is_open()) {
             qCDebug(octree) << "saving Octree lock file created at:" << lockFileName;
 
-            _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+            // the save walks the elements' child arrays, which edits rebuild, so it holds the tree's read lock
+            _tree->withReadLock([&] {
+                _tree->writeToFile(qPrintable(_filename), NULL, _persistAsFileType);
+            });
             time(&_lastPersistTime);
             _tree->clearDirtyBit(); // tree is clean after saving
             qCDebug(octree) << "DONE saving Octree to file...";
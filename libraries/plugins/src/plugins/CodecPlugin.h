@@ -10,20 +10,67 @@
 //
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+
 #include "Plugin.h"
 
+// Codecs work on caller owned buffers, so the audio mixer can encode a mix straight into the payload of the
+// outgoing packet. The QByteArray overloads are conveniences for callers off the hot path.
 class Encoder {
 public:
     virtual ~Encoder() { }
-    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) = 0;
+
+    /// Upper bound on the number of bytes encode() writes for numSamples interleaved samples.
+    virtual int getMaxEncodedSize(int numSamples) const = 0;
+
+    /// Encodes numSamples interleaved samples into encoded.
+    /// Returns the number of bytes written, or -1 if encodedCapacity is too small.
+    virtual int encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) = 0;
+
+    /// True if each frame is encoded without reference to previous frames, so that encoders fed the same samples
+    /// produce the same bytes and an encoded frame can be handed to more than one decoder.
+    virtual bool isStateless() const { return false; }
+
+    void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) {
+        int numSamples = decodedBuffer.size() / (int)sizeof(int16_t);
+        encodedBuffer.resize(getMaxEncodedSize(numSamples));
+        int encodedSize = encode(reinterpret_cast<const int16_t*>(decodedBuffer.constData()), numSamples,
+            reinterpret_cast<uint8_t*>(encodedBuffer.data()), encodedBuffer.size());
+        encodedBuffer.resize(std::max(encodedSize, 0));
+    }
 };
 
 class Decoder {
 public:
     virtual ~Decoder() { }
-    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) = 0;
 
-    virtual void lostFrame(QByteArray& decodedBuffer) = 0;
+    /// Upper bound on the number of samples decode() produces from encoded.
+    /// With no encoded data, the number of samples lostFrame() produces.
+    virtual int getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const = 0;
+
+    /// Decodes encodedSize bytes into samples.
+    /// Returns the number of samples written, or -1 if maxSamples is too small.
+    virtual int decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) = 0;
+
+    /// Conceals a frame that never arrived.
+    /// Returns the number of samples written, or -1 if maxSamples is too small.
+    virtual int lostFrame(int16_t* samples, int maxSamples) = 0;
+
+    void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) {
+        auto encoded = reinterpret_cast<const uint8_t*>(encodedBuffer.constData());
+        decodedBuffer.resize(getMaxDecodedSamples(encoded, encodedBuffer.size()) * (int)sizeof(int16_t));
+        int numSamples = decode(encoded, encodedBuffer.size(),
+            reinterpret_cast<int16_t*>(decodedBuffer.data()), decodedBuffer.size() / (int)sizeof(int16_t));
+        decodedBuffer.resize(std::max(numSamples, 0) * (int)sizeof(int16_t));
+    }
+
+    void lostFrame(QByteArray& decodedBuffer) {
+        decodedBuffer.resize(getMaxDecodedSamples(nullptr, 0) * (int)sizeof(int16_t));
+        int numSamples = lostFrame(reinterpret_cast<int16_t*>(decodedBuffer.data()),
+            decodedBuffer.size() / (int)sizeof(int16_t));
+        decodedBuffer.resize(std::max(numSamples, 0) * (int)sizeof(int16_t));
+    }
 };
 
 class CodecPlugin : public Plugin {
@@ -32,4 +79,7 @@ public:
     virtual Decoder* createDecoder(int sampleRate, int numChannels) = 0;
     virtual void releaseEncoder(Encoder* encoder) = 0;
     virtual void releaseDecoder(Decoder* decoder) = 0;
+
+    /// Target bitrate, in bits per second, for encoders created after this call. Fixed rate codecs ignore it.
+    virtual void setBitrate(int bitrate) { }
 };
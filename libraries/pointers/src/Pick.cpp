@@ -7,6 +7,8 @@
 //
 #include "Pick.h"
 
+#include <algorithm>
+
 const PickFilter PickFilter::NOTHING;
 
 int pickTypeMetaTypeId = qRegisterMetaType<PickQuery::PickType>("PickType");
@@ -79,4 +81,22 @@ void PickQuery::setIncludeItems(const QVector<QUuid>& includeItems) {
     withWriteLock([&] {
         _includeItems = includeItems;
     });
-}
\ No newline at end of file
+}
+void PickQuery::recordUpdateTime(uint64_t usecs) {
+    withWriteLock([&] {
+        _lastUpdateUsecs = usecs;
+        _maxUpdateUsecs = std::max(_maxUpdateUsecs, usecs);
+        _averageUpdateUsecs.updateAverage((float)usecs);
+    });
+}
+
+QVariantMap PickQuery::getUpdateStats() const {
+    QVariantMap stats;
+    withReadLock([&] {
+        stats["updates"] = _averageUpdateUsecs.getSampleCount();
+        stats["lastUsecs"] = (quint64)_lastUpdateUsecs;
+        stats["averageUsecs"] = _averageUpdateUsecs.getAverage();
+        stats["maxUsecs"] = (quint64)_maxUpdateUsecs;
+    });
+    return stats;
+}
@@ -11,12 +11,14 @@
 #include <memory>
 #include <stdint.h>
 #include <bitset>
+#include <vector>
 
 #include <QtCore/QUuid>
 #include <QVector>
 #include <QVariant>
 
 #include <shared/ReadWriteLockable.h>
+#include <SimpleMovingAverage.h>
 
 enum IntersectionType {
     NONE = 0,
@@ -196,6 +198,14 @@ public:
     virtual bool isRightHand() const { return false; }
     virtual bool isMouse() const { return false; }
 
+    // Whether intersections of this type may be computed on a worker thread, concurrently with the other picks of the
+    // frame.  The others are computed on the thread calling PickManager::update().
+    virtual bool canIntersectConcurrently(IntersectionType type) const { return false; }
+
+    // time spent computing the intersections of this pick in an update, in usecs
+    void recordUpdateTime(uint64_t usecs);
+    QVariantMap getUpdateStats() const;
+
 private:
     PickFilter _filter;
     const float _maxDistance;
@@ -204,6 +214,10 @@ private:
 
     QVector<QUuid> _ignoreItems;
     QVector<QUuid> _includeItems;
+
+    uint64_t _lastUpdateUsecs { 0 };
+    uint64_t _maxUpdateUsecs { 0 };
+    SimpleMovingAverage _averageUpdateUsecs;
 };
 Q_DECLARE_METATYPE(PickQuery::PickType)
 
@@ -218,6 +232,17 @@ public:
     virtual PickResultPointer getOverlayIntersection(const T& pick) = 0;
     virtual PickResultPointer getAvatarIntersection(const T& pick) = 0;
     virtual PickResultPointer getHUDIntersection(const T& pick) = 0;
+
+    // Same as getEntityIntersection() for a batch of mathematical picks, computed with this pick's filter and lists.
+    // Picks that can intersect a batch faster than one pick at a time, such as rays against models, override it.
+    virtual std::vector<PickResultPointer> getEntityIntersections(const std::vector<T>& picks) {
+        std::vector<PickResultPointer> results;
+        results.reserve(picks.size());
+        for (const auto& pick : picks) {
+            results.push_back(getEntityIntersection(pick));
+        }
+        return results;
+    }
 };
 
 namespace std {
@@ -0,0 +1,69 @@
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#include "PickBatch.h"
+
+#include <algorithm>
+
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+
+namespace {
+
+class PickWorker : public QRunnable {
+public:
+    PickWorker(std::function<void()> work, QSemaphore& done) : _work(work), _done(done) {}
+
+    void run() override {
+        _work();
+        _done.release();
+    }
+
+private:
+    std::function<void()> _work;
+    QSemaphore& _done;
+};
+
+}
+
+void PickBatch::addJob(Job job, bool concurrent) {
+    if (concurrent) {
+        _concurrentJobs.push_back(job);
+    } else {
+        _jobs.push_back(job);
+    }
+}
+
+void PickBatch::runConcurrentJobs() {
+    size_t index;
+    while ((index = _nextConcurrentJob++) < _concurrentJobs.size()) {
+        _concurrentJobs[index]();
+    }
+}
+
+void PickBatch::run(QThreadPool& workers) {
+    _nextConcurrentJob = 0;
+
+    // a single concurrent job isn't worth a worker when there is nothing else to do meanwhile
+    int numWorkers = 0;
+    if (_concurrentJobs.size() > 1 || !_jobs.empty()) {
+        numWorkers = (int)std::min((size_t)workers.maxThreadCount(), _concurrentJobs.size());
+    }
+
+    QSemaphore done;
+    for (int i = 0; i < numWorkers; i++) {
+        workers.start(new PickWorker([this] { runConcurrentJobs(); }, done));
+    }
+
+    for (auto& job : _jobs) {
+        job();
+    }
+    runConcurrentJobs();
+    done.acquire(numWorkers);
+
+    _concurrentJobs.clear();
+    _jobs.clear();
+}
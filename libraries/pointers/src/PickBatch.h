@@ -0,0 +1,36 @@
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+#ifndef hifi_PickBatch_h
+#define hifi_PickBatch_h
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <QtCore/QThreadPool>
+
+// The intersection work of one PickManager::update().  Concurrent jobs are spread over a pool of worker threads,
+// the others are run on the calling thread, which then helps with the concurrent ones.
+class PickBatch {
+public:
+    using Job = std::function<void()>;
+
+    // concurrent jobs must be thread safe
+    void addJob(Job job, bool concurrent);
+
+    // runs all the jobs and returns once they are done, leaving the batch empty
+    void run(QThreadPool& workers);
+
+private:
+    void runConcurrentJobs();
+
+    std::vector<Job> _concurrentJobs;
+    std::vector<Job> _jobs;
+    std::atomic<size_t> _nextConcurrentJob { 0 };
+};
+
+#endif // hifi_PickBatch_h
@@ -9,8 +9,12 @@
 #define hifi_PickCacheOptimizer_h
 
 #include <unordered_map>
+#include <vector>
+
+#include <SharedUtil.h>
 
 #include "Pick.h"
+#include "PickBatch.h"
 
 typedef struct PickCacheKey {
     PickFilter::Flags mask;
@@ -31,102 +35,198 @@ namespace std {
     };
 }
 
+// the new result of each pick, published together once all of them are computed
+using PickUpdates = std::vector<std::pair<std::shared_ptr<PickQuery>, PickResultPointer>>;
+
 // T is a mathematical representation of a Pick (a MathPick)
 // For example: RayPicks use T = PickRay
 template<typename T>
 class PickCacheOptimizer {
 
 public:
-    void update(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD);
+    // Queues the intersections needed by the enabled picks into batch.  Picks with the same mathematical pick and
+    // filter share their intersections.
+    void queue(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD, PickBatch& batch);
+
+    // Once the batch has run, combines the intersections into the new result of each pick.
+    void finish(PickUpdates& updates);
 
 protected:
-    typedef std::unordered_map<T, std::unordered_map<PickCacheKey, PickResultPointer>> PickCache;
+    struct Intersection {
+        std::shared_ptr<Pick<T>> pick;  // the first pick that needed it, whose filter and lists it's computed with
+        T mathPick;
+        IntersectionType type;
+        PickResultPointer result;
+        uint64_t usecs { 0 };
+    };
 
-    // Returns true if this pick exists in the cache, and if it does, update res if the cached result is closer
-    bool checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key);
-    void cacheResult(const bool intersects, const PickResultPointer& resTemp, const PickCacheKey& key, PickResultPointer& res, T& mathPick, PickCache& cache, const std::shared_ptr<Pick<T>> pick);
+    struct PendingPick {
+        std::shared_ptr<Pick<T>> pick;
+        T mathPick;
+        PickResultPointer result;
+        bool evaluated { false };
+        std::vector<size_t> intersections;  // indices in _intersections, in entity, overlay, avatar, HUD order
+    };
+
+    void queueIntersection(PendingPick& pending, IntersectionType type, const PickCacheKey& key, PickBatch& batch);
+    void queueEntityBatches(PickBatch& batch);
+    static PickResultPointer intersect(Pick<T>& pick, IntersectionType type, const T& mathPick);
+
+    std::vector<PendingPick> _pendingPicks;
+    std::vector<Intersection> _intersections;
+    std::unordered_map<T, std::unordered_map<PickCacheKey, size_t>> _intersectionIndices;
+    // the entity intersections with the same filter and lists, computed as one batch
+    std::unordered_map<PickCacheKey, std::vector<size_t>> _entityBatches;
 };
 
 template<typename T>
-bool PickCacheOptimizer<T>::checkAndCompareCachedResults(T& pick, PickCache& cache, PickResultPointer& res, const PickCacheKey& key) {
-    if (cache.find(pick) != cache.end() && cache[pick].find(key) != cache[pick].end()) {
-        res = res->compareAndProcessNewResult(cache[pick][key]);
-        return true;
+PickResultPointer PickCacheOptimizer<T>::intersect(Pick<T>& pick, IntersectionType type, const T& mathPick) {
+    switch (type) {
+        case ENTITY:
+            return pick.getEntityIntersection(mathPick);
+        case OVERLAY:
+            return pick.getOverlayIntersection(mathPick);
+        case AVATAR:
+            return pick.getAvatarIntersection(mathPick);
+        case HUD:
+            return pick.getHUDIntersection(mathPick);
+        default:
+            return PickResultPointer();
     }
-    return false;
 }
 
 template<typename T>
-void PickCacheOptimizer<T>::cacheResult(const bool intersects, const PickResultPointer& resTemp, const PickCacheKey& key, PickResultPointer& res, T& mathPick, PickCache& cache, const std::shared_ptr<Pick<T>> pick) {
-    if (intersects) {
-        cache[mathPick][key] = resTemp;
-        res = res->compareAndProcessNewResult(resTemp);
-    } else {
-        cache[mathPick][key] = pick->getDefaultResult(mathPick.toVariantMap());
+void PickCacheOptimizer<T>::queueIntersection(PendingPick& pending, IntersectionType type, const PickCacheKey& key, PickBatch& batch) {
+    auto& indices = _intersectionIndices[pending.mathPick];
+    auto cached = indices.find(key);
+    if (cached != indices.end()) {
+        pending.intersections.push_back(cached->second);
+        return;
+    }
+
+    size_t index = _intersections.size();
+    Intersection intersection;
+    intersection.pick = pending.pick;
+    intersection.mathPick = pending.mathPick;
+    intersection.type = type;
+    _intersections.push_back(intersection);
+    indices[key] = index;
+    pending.intersections.push_back(index);
+
+    if (type == ENTITY) {
+        _entityBatches[key].push_back(index);
+        return;
     }
+
+    // _intersections isn't resized once the batch runs
+    batch.addJob([this, index] {
+        Intersection& intersection = _intersections[index];
+        uint64_t start = usecTimestampNow();
+        intersection.result = intersect(*intersection.pick, intersection.type, intersection.mathPick);
+        intersection.usecs = usecTimestampNow() - start;
+    }, pending.pick->canIntersectConcurrently(type));
 }
 
+// The rays of a batch that reach the same model are tested against its triangles together, so the entity intersections
+// that can be computed with the same filter and lists are one job, rather than one job per mathematical pick.
 template<typename T>
-void PickCacheOptimizer<T>::update(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD) {
-    PickCache results;
-    for (const auto& pickPair : picks) {
-        std::shared_ptr<Pick<T>> pick = std::static_pointer_cast<Pick<T>>(pickPair.second);
+void PickCacheOptimizer<T>::queueEntityBatches(PickBatch& batch) {
+    for (auto& entityBatch : _entityBatches) {
+        std::vector<size_t> indices = std::move(entityBatch.second);
+        // the first pick that needed an intersection of the batch computes them all
+        const auto& pick = _intersections[indices.front()].pick;
+
+        batch.addJob([this, indices] {
+            std::vector<T> mathPicks;
+            mathPicks.reserve(indices.size());
+            for (size_t index : indices) {
+                mathPicks.push_back(_intersections[index].mathPick);
+            }
 
-        T mathematicalPick = pick->getMathematicalPick();
-        PickResultPointer res = pick->getDefaultResult(mathematicalPick.toVariantMap());
+            uint64_t start = usecTimestampNow();
+            std::vector<PickResultPointer> results = _intersections[indices.front()].pick->getEntityIntersections(mathPicks);
+            // each intersection is charged an even share of the batch
+            uint64_t usecs = (usecTimestampNow() - start) / indices.size();
+
+            for (size_t i = 0; i < indices.size(); i++) {
+                Intersection& intersection = _intersections[indices[i]];
+                intersection.result = results[i];
+                intersection.usecs = usecs;
+            }
+        }, pick->canIntersectConcurrently(ENTITY));
+    }
+    _entityBatches.clear();
+}
 
-        if (!pick->isEnabled() || pick->getFilter().doesPickNothing() || pick->getMaxDistance() < 0.0f || !mathematicalPick) {
-            pick->setPickResult(res);
+template<typename T>
+void PickCacheOptimizer<T>::queue(std::unordered_map<unsigned int, std::shared_ptr<PickQuery>>& picks, bool shouldPickHUD, PickBatch& batch) {
+    _pendingPicks.reserve(picks.size());
+    for (const auto& pickPair : picks) {
+        PendingPick pending;
+        pending.pick = std::static_pointer_cast<Pick<T>>(pickPair.second);
+        pending.mathPick = pending.pick->getMathematicalPick();
+        pending.result = pending.pick->getDefaultResult(pending.mathPick.toVariantMap());
+
+        PickFilter filter = pending.pick->getFilter();
+        if (!pending.pick->isEnabled() || filter.doesPickNothing() || pending.pick->getMaxDistance() < 0.0f || !pending.mathPick) {
+            _pendingPicks.push_back(pending);
             continue;
         }
+        pending.evaluated = true;
 
-        if (pick->getFilter().doesPickEntities()) {
-            PickCacheKey entityKey = { pick->getFilter().getEntityFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, entityKey)) {
-                PickResultPointer entityRes = pick->getEntityIntersection(mathematicalPick);
-                if (entityRes) {
-                    cacheResult(entityRes->doesIntersect(), entityRes, entityKey, res, mathematicalPick, results, pick);
-                }
-            }
+        QVector<QUuid> include = pending.pick->getIncludeItems();
+        QVector<QUuid> ignore = pending.pick->getIgnoreItems();
+        if (filter.doesPickEntities()) {
+            queueIntersection(pending, ENTITY, { filter.getEntityFlags(), include, ignore }, batch);
         }
-
-        if (pick->getFilter().doesPickOverlays()) {
-            PickCacheKey overlayKey = { pick->getFilter().getOverlayFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, overlayKey)) {
-                PickResultPointer overlayRes = pick->getOverlayIntersection(mathematicalPick);
-                if (overlayRes) {
-                    cacheResult(overlayRes->doesIntersect(), overlayRes, overlayKey, res, mathematicalPick, results, pick);
-                }
-            }
+        if (filter.doesPickOverlays()) {
+            queueIntersection(pending, OVERLAY, { filter.getOverlayFlags(), include, ignore }, batch);
+        }
+        if (filter.doesPickAvatars()) {
+            queueIntersection(pending, AVATAR, { filter.getAvatarFlags(), include, ignore }, batch);
+        }
+        // Can't intersect with HUD in desktop mode
+        if (filter.doesPickHUD() && shouldPickHUD) {
+            queueIntersection(pending, HUD, { filter.getHUDFlags(), QVector<QUuid>(), QVector<QUuid>() }, batch);
         }
+        _pendingPicks.push_back(pending);
+    }
+    queueEntityBatches(batch);
+}
 
-        if (pick->getFilter().doesPickAvatars()) {
-            PickCacheKey avatarKey = { pick->getFilter().getAvatarFlags(), pick->getIncludeItems(), pick->getIgnoreItems() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, avatarKey)) {
-                PickResultPointer avatarRes = pick->getAvatarIntersection(mathematicalPick);
-                if (avatarRes) {
-                    cacheResult(avatarRes->doesIntersect(), avatarRes, avatarKey, res, mathematicalPick, results, pick);
-                }
-            }
+template<typename T>
+void PickCacheOptimizer<T>::finish(PickUpdates& updates) {
+    for (auto& pending : _pendingPicks) {
+        auto& pick = pending.pick;
+        if (!pending.evaluated) {
+            updates.emplace_back(pick, pending.result);
+            continue;
         }
 
-        // Can't intersect with HUD in desktop mode
-        if (pick->getFilter().doesPickHUD() && shouldPickHUD) {
-            PickCacheKey hudKey = { pick->getFilter().getHUDFlags(), QVector<QUuid>(), QVector<QUuid>() };
-            if (!checkAndCompareCachedResults(mathematicalPick, results, res, hudKey)) {
-                PickResultPointer hudRes = pick->getHUDIntersection(mathematicalPick);
-                if (hudRes) {
-                    cacheResult(true, hudRes, hudKey, res, mathematicalPick, results, pick);
-                }
+        PickResultPointer res = pending.result;
+        uint64_t usecs = 0;
+        for (size_t index : pending.intersections) {
+            const Intersection& intersection = _intersections[index];
+            if (intersection.pick == pick) {
+                usecs += intersection.usecs;
+            }
+            // a missed intersection leaves the result as it is, the HUD is always hit
+            if (intersection.result && (intersection.type == HUD || intersection.result->doesIntersect())) {
+                res = res->compareAndProcessNewResult(intersection.result);
             }
         }
+        pick->recordUpdateTime(usecs);
 
         if (pick->getMaxDistance() == 0.0f || (pick->getMaxDistance() > 0.0f && res->checkOrFilterAgainstMaxDistance(pick->getMaxDistance()))) {
-            pick->setPickResult(res);
+            updates.emplace_back(pick, res);
         } else {
-            pick->setPickResult(pick->getDefaultResult(mathematicalPick.toVariantMap()));
+            updates.emplace_back(pick, pick->getDefaultResult(pending.mathPick.toVariantMap()));
         }
     }
+
+    _pendingPicks.clear();
+    _intersections.clear();
+    _intersectionIndices.clear();
 }
 
-#endif // hifi_PickCacheOptimizer_h
\ No newline at end of file
+#endif // hifi_PickCacheOptimizer_h
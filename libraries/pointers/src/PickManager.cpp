@@ -7,9 +7,16 @@
 //
 #include "PickManager.h"
 
+#include <algorithm>
+
+#include <QtCore/QThread>
+
 PickManager::PickManager() {
     setShouldPickHUDOperator([]() { return false; });
     setCalculatePos2DFromHUDOperator([](const glm::vec3& intersection) { return glm::vec2(NAN); });
+
+    // the thread calling update() does its share of the work
+    _workers.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
 }
 
 unsigned int PickManager::addPick(PickQuery::PickType type, const std::shared_ptr<PickQuery> pick) {
@@ -46,11 +53,22 @@ void PickManager::removePick(unsigned int uid) {
 }
 
 PickResultPointer PickManager::getPrevPickResult(unsigned int uid) const {
+    // update() publishes the results under the write lock, so they all come from the same frame
+    return resultWithReadLock<PickResultPointer>([&] {
+        auto pick = findPick(uid);
+        if (pick) {
+            return pick->getPrevPickResult();
+        }
+        return PickResultPointer();
+    });
+}
+
+QVariantMap PickManager::getUpdateStats(unsigned int uid) const {
     auto pick = findPick(uid);
     if (pick) {
-        return pick->getPrevPickResult();
+        return pick->getUpdateStats();
     }
-    return PickResultPointer();
+    return QVariantMap();
 }
 
 void PickManager::enablePick(unsigned int uid) const {
@@ -95,8 +113,19 @@ void PickManager::update() {
     });
 
     bool shouldPickHUD = _shouldPickHUDOperator();
-    _rayPickCacheOptimizer.update(cachedPicks[PickQuery::Ray], shouldPickHUD);
-    _stylusPickCacheOptimizer.update(cachedPicks[PickQuery::Stylus], false);
+    _rayPickCacheOptimizer.queue(cachedPicks[PickQuery::Ray], shouldPickHUD, _batch);
+    _stylusPickCacheOptimizer.queue(cachedPicks[PickQuery::Stylus], false, _batch);
+    _batch.run(_workers);
+
+    PickUpdates updates;
+    _rayPickCacheOptimizer.finish(updates);
+    _stylusPickCacheOptimizer.finish(updates);
+
+    withWriteLock([&] {
+        for (const auto& update : updates) {
+            update.first->setPickResult(update.second);
+        }
+    });
 }
 
 bool PickManager::isLeftHand(unsigned int uid) {
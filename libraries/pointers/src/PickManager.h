@@ -8,6 +8,8 @@
 #ifndef hifi_PickManager_h
 #define hifi_PickManager_h
 
+#include <QtCore/QThreadPool>
+
 #include <DependencyManager.h>
 #include "RegisteredMetaTypes.h"
 
@@ -28,6 +30,7 @@ public:
     void disablePick(unsigned int uid) const;
 
     PickResultPointer getPrevPickResult(unsigned int uid) const;
+    QVariantMap getUpdateStats(unsigned int uid) const;
 
     template <typename T>
     std::shared_ptr<T> getPrevPickResultTyped(unsigned int uid) const {
@@ -59,6 +62,9 @@ protected:
 
     PickCacheOptimizer<PickRay> _rayPickCacheOptimizer;
     PickCacheOptimizer<StylusTip> _stylusPickCacheOptimizer;
+
+    PickBatch _batch;
+    QThreadPool _workers;
 };
 
 #endif // hifi_PickManager_h
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 #include "impl/FileClip.h"
 #include "impl/BufferClip.h"
+#include "impl/ChunkedClip.h"
 
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
@@ -22,6 +23,12 @@
 using namespace recording;
 
 Clip::Pointer Clip::fromFile(const QString& filePath) {
+    // current recordings are streamed from the mapped file chunk by chunk
+    if (auto chunkedData = ChunkedClipData::fromFile(filePath)) {
+        return std::make_shared<ChunkedClip>(chunkedData);
+    }
+
+    // older recordings without a chunk index
     auto result = std::make_shared<FileClip>(filePath);
     if (result->frameCount() == 0) {
         return Clip::Pointer();
@@ -92,6 +99,7 @@ bool writeFrame(QIODevice& output, const Frame& frame, bool compressed = true) {
 
 const QString Clip::FRAME_TYPE_MAP = QStringLiteral("frameTypes");
 const QString Clip::FRAME_COMREPSSION_FLAG = QStringLiteral("compressed");
+const QString Clip::FILE_FORMAT_VERSION = QStringLiteral("version");
 
 bool Clip::write(QIODevice& output) {
     auto frameTypes = Frame::getFrameTypes();
@@ -104,18 +112,14 @@ bool Clip::write(QIODevice& output) {
     rootObject.insert(FRAME_TYPE_MAP, frameTypeObj);
     // Always mark new files as compressed
     rootObject.insert(FRAME_COMREPSSION_FLAG, true);
+    rootObject.insert(FILE_FORMAT_VERSION, ChunkedClipData::FORMAT_VERSION);
     QByteArray headerFrameData = QJsonDocument(rootObject).toBinaryData();
     // Never compress the header frame
+    qint64 start = output.pos();
     if (!writeFrame(output, Frame({ Frame::TYPE_HEADER, 0, headerFrameData }), false)) {
         return false;
     }
 
-    seek(0);
-
-    for (auto frame = nextFrame(); frame; frame = nextFrame()) {
-        if (!writeFrame(output, *frame)) {
-            return false;
-        }
-    }
-    return true;
+    // frames are compressed in chunks, followed by the chunk index
+    return ChunkedClipData::writeChunks(output, start, *this);
 }
@@ -25,11 +25,28 @@ void NetworkClip::init(const QByteArray& clipData) {
 }
 
 void NetworkClipLoader::downloadFinished(const QByteArray& data) {
-    _clip->init(data);
+    // local recordings are mapped rather than held in memory
+    if (_url.isLocalFile()) {
+        _chunkedData = ChunkedClipData::fromFile(_url.toLocalFile());
+    }
+    if (!_chunkedData) {
+        _chunkedData = ChunkedClipData::fromBuffer(data, _url.toString());
+    }
+    if (!_chunkedData) {
+        // older recordings without a chunk index
+        _clip->init(data);
+    }
     finishedLoading(true);
     emit clipLoaded();
 }
 
+ClipPointer NetworkClipLoader::getClip() {
+    if (_chunkedData) {
+        return std::make_shared<ChunkedClip>(_chunkedData);
+    }
+    return _clip;
+}
+
 ClipCache::ClipCache(QObject* parent) :
     ResourceCache(parent)
 {
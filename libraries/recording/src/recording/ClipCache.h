@@ -13,6 +13,7 @@
 
 #include "Forward.h"
 #include "impl/PointerClip.h"
+#include "impl/ChunkedClip.h"
 
 namespace recording {
 
@@ -34,7 +35,9 @@ class NetworkClipLoader : public Resource {
 public:
     NetworkClipLoader(const QUrl& url);
     virtual void downloadFinished(const QByteArray& data) override;
-    ClipPointer getClip() { return _clip; }
+    // Chunked recordings hand every caller its own play cursor over the one shared copy of the data,
+    // so any number of decks can play the same recording independently.
+    ClipPointer getClip();
     bool completed() { return _failedToLoad || isLoaded(); }
 
 signals:
@@ -42,6 +45,7 @@ signals:
 
 private:
     const NetworkClip::Pointer _clip;
+    ChunkedClipData::Pointer _chunkedData;
 };
 
 using NetworkClipLoaderPointer = QSharedPointer<NetworkClipLoader>;
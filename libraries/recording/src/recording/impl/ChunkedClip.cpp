@@ -0,0 +1,380 @@
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ChunkedClip.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QDebug>
+#include <QtCore/QJsonObject>
+
+#include "../Frame.h"
+#include "../Logging.h"
+#include "PointerClip.h"
+
+using namespace recording;
+
+static const quint32 TRAILER_MAGIC = 0x48465243; // "HFRC"
+static const size_t FRAME_HEADER_SIZE = sizeof(FrameType) + sizeof(Frame::Time) + sizeof(FrameSize);
+static const size_t INDEX_ENTRY_SIZE = sizeof(Frame::Time) + sizeof(quint32) + sizeof(quint64);
+// index offset, chunk count, frame count, last frame time, magic
+static const size_t TRAILER_SIZE = sizeof(quint64) + sizeof(quint32) + sizeof(quint32) + sizeof(Frame::Time) + sizeof(quint32);
+
+template <typename T>
+static inline const uchar* readValue(const uchar* src, T& value) {
+    memcpy(&value, src, sizeof(T));
+    return src + sizeof(T);
+}
+
+template <typename T>
+static inline void appendValue(QByteArray& dst, const T& value) {
+    dst.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+ChunkedClipData::Pointer ChunkedClipData::fromFile(const QString& filePath) {
+    Pointer result(new ChunkedClipData());
+    result->_name = filePath;
+    result->_file.setFileName(filePath);
+    if (!result->_file.open(QIODevice::ReadOnly)) {
+        return Pointer();
+    }
+    auto size = result->_file.size();
+    result->_mappedData = result->_file.map(0, size, QFile::MapPrivateOption);
+    if (!result->_mappedData || !result->init(result->_mappedData, size)) {
+        return Pointer();
+    }
+    return result;
+}
+
+ChunkedClipData::Pointer ChunkedClipData::fromBuffer(const QByteArray& buffer, const QString& name) {
+    Pointer result(new ChunkedClipData());
+    result->_name = name;
+    result->_buffer = buffer;
+    if (!result->init(reinterpret_cast<const uchar*>(result->_buffer.constData()), result->_buffer.size())) {
+        return Pointer();
+    }
+    return result;
+}
+
+ChunkedClipData::~ChunkedClipData() {
+    if (_mappedData) {
+        _file.unmap(_mappedData);
+    }
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
+
+bool ChunkedClipData::init(const uchar* data, size_t size) {
+    if (size < FRAME_HEADER_SIZE + TRAILER_SIZE) {
+        return false;
+    }
+
+    // the header frame is never compressed
+    FrameType headerType;
+    Frame::Time headerTime;
+    FrameSize headerSize;
+    const uchar* current = data;
+    current = readValue(current, headerType);
+    current = readValue(current, headerTime);
+    current = readValue(current, headerSize);
+    if (headerType != Frame::TYPE_HEADER || FRAME_HEADER_SIZE + headerSize > size - TRAILER_SIZE) {
+        return false;
+    }
+    _header = QJsonDocument::fromBinaryData(QByteArray((const char*)current, headerSize));
+    if (_header.object()[Clip::FILE_FORMAT_VERSION].toInt() != FORMAT_VERSION) {
+        // older recordings are read by PointerClip
+        return false;
+    }
+    size_t firstChunkOffset = FRAME_HEADER_SIZE + headerSize;
+
+    quint64 indexOffset;
+    quint32 chunkCount;
+    quint32 frameCount;
+    Frame::Time lastFrameTime;
+    quint32 magic;
+    current = data + size - TRAILER_SIZE;
+    current = readValue(current, indexOffset);
+    current = readValue(current, chunkCount);
+    current = readValue(current, frameCount);
+    current = readValue(current, lastFrameTime);
+    current = readValue(current, magic);
+    if (magic != TRAILER_MAGIC || indexOffset < firstChunkOffset ||
+        indexOffset + (quint64)chunkCount * INDEX_ENTRY_SIZE + TRAILER_SIZE != size) {
+        qCWarning(recordingLog) << "Invalid chunk index in recording" << _name;
+        return false;
+    }
+
+    _chunks.resize(chunkCount);
+    current = data + indexOffset;
+    quint64 previousOffset = 0;
+    for (auto& chunk : _chunks) {
+        current = readValue(current, chunk.firstFrameTime);
+        current = readValue(current, chunk.firstFrameIndex);
+        current = readValue(current, chunk.fileOffset);
+        if (chunk.fileOffset < firstChunkOffset || chunk.fileOffset + sizeof(quint32) > indexOffset ||
+            (previousOffset && chunk.fileOffset <= previousOffset)) {
+            qCWarning(recordingLog) << "Invalid chunk offset in recording" << _name;
+            _chunks.clear();
+            return false;
+        }
+        previousOffset = chunk.fileOffset;
+    }
+
+    _translationMap = parseTranslationMap(_header);
+    if (_translationMap.empty()) {
+        qCWarning(recordingLog) << "Header missing frame type map, invalid file" << _name;
+        _chunks.clear();
+        return false;
+    }
+
+    _data = data;
+    _size = indexOffset;
+    _frameCount = frameCount;
+    _lastFrameTime = lastFrameTime;
+    qCDebug(recordingLog) << "Opened recording" << _name << "with" << _frameCount << "frames in" << _chunks.size() << "chunks";
+    return true;
+}
+
+bool ChunkedClipData::decodeChunk(size_t chunkIndex, DecodedChunk& result) const {
+    result.data.clear();
+    result.headers.clear();
+    result.ranges.clear();
+    if (chunkIndex >= _chunks.size()) {
+        return false;
+    }
+
+    quint64 offset = _chunks[chunkIndex].fileOffset;
+    quint64 end = (chunkIndex + 1 < _chunks.size()) ? _chunks[chunkIndex + 1].fileOffset : _size;
+    quint32 compressedSize;
+    readValue(_data + offset, compressedSize);
+    offset += sizeof(quint32);
+    if (offset + compressedSize > end) {
+        qCWarning(recordingLog) << "Truncated chunk" << chunkIndex << "in recording" << _name;
+        return false;
+    }
+    result.data = qUncompress(_data + offset, compressedSize);
+
+    const uchar* start = reinterpret_cast<const uchar*>(result.data.constData());
+    const uchar* current = start;
+    const uchar* dataEnd = start + result.data.size();
+    while ((size_t)(dataEnd - current) >= FRAME_HEADER_SIZE) {
+        FrameHeader header;
+        FrameSize size;
+        current = readValue(current, header.type);
+        current = readValue(current, header.timeOffset);
+        current = readValue(current, size);
+        if (dataEnd - current < size) {
+            break;
+        }
+        int frameOffset = (int)(current - start);
+        current += size;
+
+        // skip frame types this process doesn't know about
+        auto itr = _translationMap.find(header.type);
+        if (itr == _translationMap.end()) {
+            continue;
+        }
+        header.type = itr.value();
+        result.headers.push_back(header);
+        result.ranges.push_back({ frameOffset, size });
+    }
+    return true;
+}
+
+bool ChunkedClipData::writeChunks(QIODevice& output, qint64 start, Clip& clip) {
+    auto frameTypeNames = Frame::getFrameTypeNames();
+    std::vector<ChunkIndexEntry> chunks;
+    ChunkIndexEntry currentChunk;
+    QByteArray chunkData;
+    chunkData.reserve(TARGET_CHUNK_SIZE + std::numeric_limits<FrameSize>::max() + (int)FRAME_HEADER_SIZE);
+    quint32 frameCount = 0;
+    Frame::Time lastFrameTime = 0;
+
+    auto flushChunk = [&]() -> bool {
+        if (chunkData.isEmpty()) {
+            return true;
+        }
+        QByteArray compressed = qCompress(chunkData);
+        chunkData.truncate(0);
+        currentChunk.fileOffset = output.pos() - start;
+        quint32 compressedSize = compressed.size();
+        if (output.write((const char*)&compressedSize, sizeof(quint32)) != sizeof(quint32) ||
+            output.write(compressed) != compressed.size()) {
+            return false;
+        }
+        chunks.push_back(currentChunk);
+        return true;
+    };
+
+    clip.seek(0);
+    for (auto frame = clip.nextFrame(); frame; frame = clip.nextFrame()) {
+        // frames of unregistered types could never be read back
+        if (frame->type == Frame::TYPE_HEADER || !frameTypeNames.contains(frame->type)) {
+            continue;
+        }
+        if (frame->data.size() > std::numeric_limits<FrameSize>::max()) {
+            qCWarning(recordingLog) << "Dropping oversized frame of type" << frame->type << "at" << frame->timeOffset;
+            continue;
+        }
+
+        if (chunkData.isEmpty()) {
+            currentChunk.firstFrameTime = frame->timeOffset;
+            currentChunk.firstFrameIndex = frameCount;
+        }
+        appendValue(chunkData, frame->type);
+        appendValue(chunkData, frame->timeOffset);
+        appendValue(chunkData, (FrameSize)frame->data.size());
+        chunkData.append(frame->data);
+        ++frameCount;
+        lastFrameTime = frame->timeOffset;
+
+        if (chunkData.size() >= TARGET_CHUNK_SIZE && !flushChunk()) {
+            return false;
+        }
+    }
+    if (!flushChunk()) {
+        return false;
+    }
+
+    QByteArray index;
+    index.reserve((int)(chunks.size() * INDEX_ENTRY_SIZE + TRAILER_SIZE));
+    quint64 indexOffset = output.pos() - start;
+    for (const auto& chunk : chunks) {
+        appendValue(index, chunk.firstFrameTime);
+        appendValue(index, chunk.firstFrameIndex);
+        appendValue(index, chunk.fileOffset);
+    }
+    appendValue(index, indexOffset);
+    appendValue(index, (quint32)chunks.size());
+    appendValue(index, frameCount);
+    appendValue(index, lastFrameTime);
+    appendValue(index, TRAILER_MAGIC);
+    return output.write(index) == index.size();
+}
+
+ChunkedClip::ChunkedClip(const ChunkedClipData::Pointer& data) : _data(data) {
+}
+
+QString ChunkedClip::getName() const {
+    return _data->getName();
+}
+
+Clip::Pointer ChunkedClip::duplicate() const {
+    auto result = newClip();
+    ChunkedClip reader(_data);
+    for (auto frame = reader.nextFrame(); frame; frame = reader.nextFrame()) {
+        result->addFrame(frame);
+    }
+    return result;
+}
+
+float ChunkedClip::duration() const {
+    return Frame::frameTimeToSeconds(_data->getLastFrameTime());
+}
+
+size_t ChunkedClip::frameCount() const {
+    return _data->getFrameCount();
+}
+
+void ChunkedClip::seekFrameTime(Frame::Time offset) {
+    Locker lock(_mutex);
+    const auto& chunks = _data->getChunks();
+
+    // the first chunk starting at or after offset, frames at offset may also end the chunk before it
+    auto itr = std::lower_bound(chunks.begin(), chunks.end(), offset,
+        [](const ChunkIndexEntry& a, Frame::Time b)->bool {
+            return a.firstFrameTime < b;
+        }
+    );
+    _chunkIndex = itr - chunks.begin();
+    if (_chunkIndex > 0) {
+        --_chunkIndex;
+    }
+    _frameInChunk = 0;
+    if (!loadCurrentChunk()) {
+        return;
+    }
+
+    const auto& headers = _decoded.headers;
+    auto frameItr = std::lower_bound(headers.begin(), headers.end(), offset,
+        [](const FrameHeader& a, Frame::Time b)->bool {
+            return a.timeOffset < b;
+        }
+    );
+    _frameInChunk = frameItr - headers.begin();
+}
+
+Frame::Time ChunkedClip::positionFrameTime() const {
+    Locker lock(_mutex);
+    if (!loadCurrentChunk()) {
+        return Frame::INVALID_TIME;
+    }
+    return _decoded.headers[_frameInChunk].timeOffset;
+}
+
+FrameConstPointer ChunkedClip::peekFrame() const {
+    Locker lock(_mutex);
+    return readCurrentFrame();
+}
+
+FrameConstPointer ChunkedClip::nextFrame() {
+    Locker lock(_mutex);
+    auto result = readCurrentFrame();
+    if (result) {
+        ++_frameInChunk;
+    }
+    return result;
+}
+
+void ChunkedClip::skipFrame() {
+    Locker lock(_mutex);
+    if (loadCurrentChunk()) {
+        ++_frameInChunk;
+    }
+}
+
+void ChunkedClip::addFrame(FrameConstPointer) {
+    throw std::runtime_error("Chunked clips are read only, use duplicate to create a read/write clip");
+}
+
+void ChunkedClip::reset() {
+    _chunkIndex = 0;
+    _frameInChunk = 0;
+}
+
+// Internal only function, needs no locking
+bool ChunkedClip::loadCurrentChunk() const {
+    const size_t chunkCount = _data->getChunks().size();
+    while (_chunkIndex < chunkCount) {
+        if (_decodedChunkIndex != _chunkIndex) {
+            _data->decodeChunk(_chunkIndex, _decoded);
+            _decodedChunkIndex = _chunkIndex;
+        }
+        if (_frameInChunk < _decoded.headers.size()) {
+            return true;
+        }
+        ++_chunkIndex;
+        _frameInChunk = 0;
+    }
+    return false;
+}
+
+// Internal only function, needs no locking
+FrameConstPointer ChunkedClip::readCurrentFrame() const {
+    FramePointer result;
+    if (loadCurrentChunk()) {
+        const auto& header = _decoded.headers[_frameInChunk];
+        const auto& range = _decoded.ranges[_frameInChunk];
+        result = std::make_shared<Frame>();
+        result->type = header.type;
+        result->timeOffset = header.timeOffset;
+        result->data = _decoded.data.mid(range.first, range.second);
+    }
+    return result;
+}
@@ -0,0 +1,122 @@
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+#ifndef hifi_Recording_Impl_ChunkedClip_h
+#define hifi_Recording_Impl_ChunkedClip_h
+
+#include "../Clip.h"
+
+#include <vector>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
+
+namespace recording {
+
+// Version 2 recordings store their frames in independently compressed chunks, followed by an index of the chunks
+// and a fixed size trailer pointing at the index:
+//
+//   [header frame] [chunk 0] ... [chunk N-1] [chunk index] [trailer]
+//
+// so a clip can be opened by reading the header and the index only, and a seek only needs to decompress one chunk.
+struct ChunkIndexEntry {
+    Frame::Time firstFrameTime;
+    quint32 firstFrameIndex;
+    quint64 fileOffset;     // offset of the chunk's size field
+};
+
+// The immutable, shareable part of a version 2 recording, either a mapped file or a downloaded buffer.
+// Any number of ChunkedClip cursors may play from the same data concurrently.
+class ChunkedClipData {
+public:
+    using Pointer = std::shared_ptr<ChunkedClipData>;
+
+    // null if the file can't be opened or isn't a version 2 recording
+    static Pointer fromFile(const QString& filePath);
+    static Pointer fromBuffer(const QByteArray& buffer, const QString& name);
+
+    ~ChunkedClipData();
+
+    const QString& getName() const { return _name; }
+    const QJsonDocument& getHeader() const { return _header; }
+    const std::vector<ChunkIndexEntry>& getChunks() const { return _chunks; }
+    size_t getFrameCount() const { return _frameCount; }
+    Frame::Time getLastFrameTime() const { return _lastFrameTime; }
+
+    // decompressed frames of one chunk, with the frame types already translated to the current registry
+    struct DecodedChunk {
+        QByteArray data;
+        std::vector<FrameHeader> headers;
+        std::vector<std::pair<int, int>> ranges; // offset, size into data
+    };
+    bool decodeChunk(size_t chunkIndex, DecodedChunk& result) const;
+
+    // writes the frames of clip, chunk index and trailer.  The header frame must already have been written at start.
+    static bool writeChunks(QIODevice& output, qint64 start, Clip& clip);
+
+    static const int FORMAT_VERSION = 2;
+    static const int TARGET_CHUNK_SIZE = 64 * 1024;
+
+private:
+    ChunkedClipData() {}
+    bool init(const uchar* data, size_t size);
+
+    QString _name;
+    QFile _file;
+    uchar* _mappedData { nullptr };
+    QByteArray _buffer;
+    const uchar* _data { nullptr };
+    size_t _size { 0 };
+
+    QJsonDocument _header;
+    QMap<FrameType, FrameType> _translationMap;
+    std::vector<ChunkIndexEntry> _chunks;
+    size_t _frameCount { 0 };
+    Frame::Time _lastFrameTime { 0 };
+};
+
+// A read only play cursor over shared ChunkedClipData, holding at most one decompressed chunk.
+class ChunkedClip : public Clip {
+public:
+    using Pointer = std::shared_ptr<ChunkedClip>;
+
+    ChunkedClip(const ChunkedClipData::Pointer& data);
+
+    virtual QString getName() const override;
+
+    virtual Clip::Pointer duplicate() const override;
+
+    virtual float duration() const override;
+    virtual size_t frameCount() const override;
+
+    virtual void seekFrameTime(Frame::Time offset) override;
+    virtual Frame::Time positionFrameTime() const override;
+
+    virtual FrameConstPointer peekFrame() const override;
+    virtual FrameConstPointer nextFrame() override;
+    virtual void skipFrame() override;
+    virtual void addFrame(FrameConstPointer) override;
+
+protected:
+    virtual void reset() override;
+
+    // makes sure _decoded holds the chunk of the current position, moving on past empty chunks
+    bool loadCurrentChunk() const;
+    FrameConstPointer readCurrentFrame() const;
+
+    const ChunkedClipData::Pointer _data;
+    mutable ChunkedClipData::DecodedChunk _decoded;
+    mutable size_t _decodedChunkIndex { (size_t)-1 };
+    mutable size_t _chunkIndex { 0 };
+    mutable size_t _frameInChunk { 0 };
+};
+
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include <mutex>
 
 #include <QtCore/QJsonDocument>
+#include <QtCore/QMap>
 
 #include "../Frame.h"
 
@@ -29,6 +30,11 @@ struct PointerFrameHeader : public FrameHeader {
 
 using PointerFrameHeaderList = std::list<PointerFrameHeader>;
 
+using FrameTranslationMap = QMap<FrameType, FrameType>;
+
+// map from the frame type enums stored in a clip header to the ones registered in this process
+FrameTranslationMap parseTranslationMap(const QJsonDocument& doc);
+
 class PointerClip : public ArrayClip<PointerFrameHeader> {
 public:
     using Pointer = std::shared_ptr<PointerClip>;
@@ -20,7 +20,7 @@ using namespace render;
 CauterizedMeshPartPayload::CauterizedMeshPartPayload(ModelPointer model, int meshIndex, int partIndex, int shapeIndex, const Transform& transform, const Transform& offsetTransform)
     : ModelMeshPartPayload(model, meshIndex, partIndex, shapeIndex, transform, offsetTransform) {}
 
-void CauterizedMeshPartPayload::updateClusterBuffer(const std::vector<glm::mat4>& clusterMatrices, const std::vector<glm::mat4>& cauterizedClusterMatrices) {
+void CauterizedMeshPartPayload::updateClusterBuffer(const ClusterMatrices& clusterMatrices, const ClusterMatrices& cauterizedClusterMatrices) {
     ModelMeshPartPayload::updateClusterBuffer(clusterMatrices);
 
     if (cauterizedClusterMatrices.size() > 1) {
@@ -15,7 +15,7 @@ class CauterizedMeshPartPayload : public ModelMeshPartPayload {
 public:
     CauterizedMeshPartPayload(ModelPointer model, int meshIndex, int partIndex, int shapeIndex, const Transform& transform, const Transform& offsetTransform);
 
-    void updateClusterBuffer(const std::vector<glm::mat4>& clusterMatrices, const std::vector<glm::mat4>& cauterizedClusterMatrices);
+    void updateClusterBuffer(const ClusterMatrices& clusterMatrices, const ClusterMatrices& cauterizedClusterMatrices);
 
     void updateTransformForCauterizedMesh(const Transform& renderTransform);
 
@@ -33,9 +33,12 @@ bool CauterizedModel::updateGeometry() {
     if (_isCauterized && needsFullUpdate) {
         assert(_cauterizeMeshStates.empty());
         const FBXGeometry& fbxGeometry = getFBXGeometry();
+        uint32_t clusterOffset = 0;
         foreach (const FBXMesh& mesh, fbxGeometry.meshes) {
             Model::MeshState state;
-            state.clusterMatrices.resize(mesh.clusters.size());
+            state.clusterOffset = clusterOffset;
+            state.numClusters = (uint32_t)mesh.clusters.size();
+            clusterOffset += (uint32_t)mesh.clusters.size();
             _cauterizeMeshStates.append(state);
         }
     }
@@ -95,27 +98,19 @@ void CauterizedModel::createCollisionRenderItemSet() {
     Model::createCollisionRenderItemSet();
 }
 
-void CauterizedModel::updateClusterMatrices() {
-    PerformanceTimer perfTimer("CauterizedModel::updateClusterMatrices");
-
-    if (!_needsUpdateClusterMatrices || !isLoaded()) {
+void CauterizedModel::computeClusterMatrices(glm::mat4* destination) {
+    Model::computeClusterMatrices(destination);
+    if (!_isCauterized) {
         return;
     }
-    _needsUpdateClusterMatrices = false;
-    const FBXGeometry& geometry = getFBXGeometry();
-
-    for (int i = 0; i < (int)_meshStates.size(); i++) {
-        Model::MeshState& state = _meshStates[i];
-        const FBXMesh& mesh = geometry.meshes.at(i);
-        for (int j = 0; j < mesh.clusters.size(); j++) {
-            const FBXCluster& cluster = mesh.clusters.at(j);
-            auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
-            glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, state.clusterMatrices[j]);
-        }
-    }
 
-    // as an optimization, don't build cautrizedClusterMatrices if the boneSet is empty.
-    if (!_cauterizeBoneSet.empty()) {
+    glm::mat4* cauterizedDestination = destination + _numClusterMatrices;
+
+    // as an optimization, don't evaluate the cauterized matrices if the boneSet is empty, they are the regular ones.
+    if (_cauterizeBoneSet.empty()) {
+        memcpy(cauterizedDestination, destination, _numClusterMatrices * sizeof(glm::mat4));
+    } else {
+        const FBXGeometry& geometry = getFBXGeometry();
         static const glm::mat4 zeroScale(
             glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
             glm::vec4(0.0f, 0.0f, 0.0f, 0.0f),
@@ -124,89 +119,64 @@ void CauterizedModel::updateClusterMatrices() {
         auto cauterizeMatrix = _rig.getJointTransform(geometry.neckJointIndex) * zeroScale;
 
         for (int i = 0; i < _cauterizeMeshStates.size(); i++) {
-            Model::MeshState& state = _cauterizeMeshStates[i];
+            const Model::MeshState& state = _cauterizeMeshStates[i];
             const FBXMesh& mesh = geometry.meshes.at(i);
+            glm::mat4* clusterMatrices = cauterizedDestination + state.clusterOffset;
             for (int j = 0; j < mesh.clusters.size(); j++) {
                 const FBXCluster& cluster = mesh.clusters.at(j);
                 auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
                 if (_cauterizeBoneSet.find(cluster.jointIndex) != _cauterizeBoneSet.end()) {
                     jointMatrix = cauterizeMatrix;
                 }
-                glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, state.clusterMatrices[j]);
+                glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, clusterMatrices[j]);
             }
         }
     }
-
-    // post the blender if we're not currently waiting for one to finish
-    if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
-        _blendedBlendshapeCoefficients = _blendshapeCoefficients;
-        DependencyManager::get<ModelBlender>()->noteRequiresBlend(getThisPointer());
-    }
 }
 
-void CauterizedModel::updateRenderItems() {
+uint32_t CauterizedModel::getNumRenderClusterMatrices() const {
+    // the cauterized matrices are published right after the regular ones
     if (_isCauterized) {
-        if (!_addedToScene) {
-            return;
-        }
-
-        glm::vec3 scale = getScale();
-        if (_collisionGeometry) {
-            // _collisionGeometry is already scaled
-            scale = glm::vec3(1.0f);
-        }
-        _needsUpdateClusterMatrices = true;
-        _renderItemsNeedUpdate = false;
-
-        // queue up this work for later processing, at the end of update and just before rendering.
-        // the application will ensure only the last lambda is actually invoked.
-        void* key = (void*)this;
-        std::weak_ptr<CauterizedModel> weakSelf = std::dynamic_pointer_cast<CauterizedModel>(shared_from_this());
-        AbstractViewStateInterface::instance()->pushPostUpdateLambda(key, [weakSelf]() {
-            // do nothing, if the model has already been destroyed.
-            auto self = weakSelf.lock();
-            if (!self || !self->isLoaded()) {
-                return;
-            }
-
-            // lazy update of cluster matrices used for rendering.  We need to update them here, so we can correctly update the bounding box.
-            self->updateClusterMatrices();
-
-            render::ScenePointer scene = AbstractViewStateInterface::instance()->getMain3DScene();
+        return 2 * _numClusterMatrices;
+    }
+    return _numClusterMatrices;
+}
 
-            Transform modelTransform;
-            modelTransform.setTranslation(self->getTranslation());
-            modelTransform.setRotation(self->getRotation());
+void CauterizedModel::updateRenderItemClusters(render::Transaction& transaction, const ClusterMatrixPoolPointer& pool, uint32_t offset) {
+    if (!_isCauterized) {
+        Model::updateRenderItemClusters(transaction, pool, offset);
+        return;
+    }
 
-            render::Transaction transaction;
-            for (int i = 0; i < (int)self->_modelMeshRenderItemIDs.size(); i++) {
+    Transform modelTransform;
+    modelTransform.setTranslation(getTranslation());
+    modelTransform.setRotation(getRotation());
 
-                auto itemID = self->_modelMeshRenderItemIDs[i];
-                auto meshIndex = self->_modelMeshRenderItemShapes[i].meshIndex;
-                auto clusterMatrices(self->getMeshState(meshIndex).clusterMatrices);
-                auto clusterMatricesCauterized(self->getCauterizeMeshState(meshIndex).clusterMatrices);
+    uint32_t cauterizedOffset = offset + _numClusterMatrices;
+    for (int i = 0; i < (int)_modelMeshRenderItemIDs.size(); i++) {
 
-                transaction.updateItem<CauterizedMeshPartPayload>(itemID, [modelTransform, clusterMatrices, clusterMatricesCauterized](CauterizedMeshPartPayload& data) {
-                    data.updateClusterBuffer(clusterMatrices, clusterMatricesCauterized);
+        auto itemID = _modelMeshRenderItemIDs[i];
+        auto meshIndex = _modelMeshRenderItemShapes[i].meshIndex;
+        const auto& state = _meshStates[meshIndex];
+        const auto& cauterizedState = _cauterizeMeshStates[meshIndex];
+        ClusterMatrices clusterMatrices(pool, offset + state.clusterOffset, state.numClusters);
+        ClusterMatrices clusterMatricesCauterized(pool, cauterizedOffset + cauterizedState.clusterOffset, cauterizedState.numClusters);
 
-                    Transform renderTransform = modelTransform;
-                    if (clusterMatrices.size() == 1) {
-                        renderTransform = modelTransform.worldTransform(Transform(clusterMatrices[0]));
-                    }
-                    data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
+        transaction.updateItem<CauterizedMeshPartPayload>(itemID, [modelTransform, clusterMatrices, clusterMatricesCauterized](CauterizedMeshPartPayload& data) {
+            data.updateClusterBuffer(clusterMatrices, clusterMatricesCauterized);
 
-                    renderTransform = modelTransform;
-                    if (clusterMatricesCauterized.size() == 1) {
-                        renderTransform = modelTransform.worldTransform(Transform(clusterMatricesCauterized[0]));
-                    }
-                    data.updateTransformForCauterizedMesh(renderTransform);
-                });
+            Transform renderTransform = modelTransform;
+            if (clusterMatrices.size() == 1) {
+                renderTransform = modelTransform.worldTransform(Transform(clusterMatrices[0]));
             }
+            data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
 
-            scene->enqueueTransaction(transaction);
+            renderTransform = modelTransform;
+            if (clusterMatricesCauterized.size() == 1) {
+                renderTransform = modelTransform.worldTransform(Transform(clusterMatricesCauterized[0]));
+            }
+            data.updateTransformForCauterizedMesh(renderTransform);
         });
-    } else {
-        Model::updateRenderItems();
     }
 }
 
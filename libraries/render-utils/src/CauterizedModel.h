@@ -34,12 +34,13 @@ public:
     void createVisibleRenderItemSet() override;
     void createCollisionRenderItemSet() override;
 
-    virtual void updateClusterMatrices() override;
-    void updateRenderItems() override;
-
     const Model::MeshState& getCauterizeMeshState(int index) const;
 
 protected:
+    void computeClusterMatrices(glm::mat4* destination) override;
+    uint32_t getNumRenderClusterMatrices() const override;
+    void updateRenderItemClusters(render::Transaction& transaction, const ClusterMatrixPoolPointer& pool, uint32_t offset) override;
+
     std::unordered_set<int> _cauterizeBoneSet;
     QVector<Model::MeshState> _cauterizeMeshStates;
     bool _isCauterized { false };
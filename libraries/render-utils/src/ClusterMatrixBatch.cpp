@@ -0,0 +1,53 @@
+//
+//  ClusterMatrixBatch.cpp
+//  libraries/render-utils/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ClusterMatrixBatch.h"
+
+#include <TBBHelpers.h>
+
+// A pool is usually referenced by the transactions of one or two frames, keep a few around to recycle them
+static const size_t MAX_RECYCLED_POOLS = 4;
+
+uint32_t ClusterMatrixBatch::add(uint32_t numMatrices, Evaluator evaluator) {
+    uint32_t offset = _numMatrices;
+    _entries.push_back({ offset, evaluator });
+    _numMatrices += numMatrices;
+    return offset;
+}
+
+ClusterMatrixPoolPointer ClusterMatrixBatch::acquirePool() {
+    for (auto& pool : _pools) {
+        // we are the only owner left, no view on this pool is alive anymore
+        if (pool.use_count() == 1) {
+            return pool;
+        }
+    }
+
+    auto pool = std::make_shared<ClusterMatrixPool>();
+    if (_pools.size() < MAX_RECYCLED_POOLS) {
+        _pools.push_back(pool);
+    }
+    return pool;
+}
+
+ClusterMatrixPoolPointer ClusterMatrixBatch::evaluate() {
+    auto pool = acquirePool();
+    pool->resize(_numMatrices);
+
+    glm::mat4* matrices = pool->data();
+    tbb::parallel_for((size_t)0, _entries.size(), [&](size_t i) {
+        const auto& entry = _entries[i];
+        entry.evaluator(matrices + entry.offset);
+    });
+
+    _entries.clear();
+    _numMatrices = 0;
+    return pool;
+}
@@ -0,0 +1,72 @@
+//
+//  ClusterMatrixBatch.h
+//  libraries/render-utils/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ClusterMatrixBatch_h
+#define hifi_ClusterMatrixBatch_h
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// One contiguous block holding the cluster matrices of every model skinned in the same batch
+using ClusterMatrixPool = std::vector<glm::mat4>;
+using ClusterMatrixPoolPointer = std::shared_ptr<ClusterMatrixPool>;
+
+// View on the cluster matrices of one mesh within a pool.
+// Cheap to capture in a render transaction, the pool stays alive as long as a view references it.
+class ClusterMatrices {
+public:
+    ClusterMatrices() {}
+    ClusterMatrices(const ClusterMatrixPoolPointer& pool, uint32_t offset, uint32_t size) :
+        _pool(pool), _offset(offset), _size(size) {}
+
+    const glm::mat4* data() const { return _pool ? _pool->data() + _offset : nullptr; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    const glm::mat4& operator[](size_t index) const { return data()[index]; }
+
+private:
+    ClusterMatrixPoolPointer _pool;
+    uint32_t _offset { 0 };
+    uint32_t _size { 0 };
+};
+
+// Gathers the cluster matrix evaluations of many models and runs them in parallel into one pooled buffer
+class ClusterMatrixBatch {
+public:
+    using Evaluator = std::function<void(glm::mat4* destination)>;
+
+    // Reserves numMatrices in the next pool for the evaluator, returns their offset in the pool
+    uint32_t add(uint32_t numMatrices, Evaluator evaluator);
+
+    size_t getNumEntries() const { return _entries.size(); }
+    uint32_t getNumMatrices() const { return _numMatrices; }
+
+    // Runs the evaluators in parallel, each one writing its own range of the returned pool, and resets the batch.
+    // Pools are recycled once no view references them anymore.
+    ClusterMatrixPoolPointer evaluate();
+
+protected:
+    ClusterMatrixPoolPointer acquirePool();
+
+    struct Entry {
+        uint32_t offset;
+        Evaluator evaluator;
+    };
+    std::vector<Entry> _entries;
+    uint32_t _numMatrices { 0 };
+
+    std::vector<ClusterMatrixPoolPointer> _pools;
+};
+
+#endif // hifi_ClusterMatrixBatch_h
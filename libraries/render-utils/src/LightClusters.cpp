@@ -12,6 +12,8 @@
 #include "RenderUtilsLogging.h"
 
 
+#include <TBBHelpers.h>
+
 #include <gpu/Context.h>
 
 #include <gpu/StandardShaderLib.h>
@@ -238,67 +240,175 @@ bool reduceSphereToPlane(const glm::vec4& sphere, const glm::vec4& plane, glm::v
 }
 
 
-uint32_t scanLightVolumeBoxSlice(FrustumGrid& grid, const FrustumGrid::Planes planes[3], int zSlice, int yMin, int yMax, int xMin, int xMax, LightClusters::LightID lightId, const glm::vec4& eyePosRadius,
-    std::vector< std::vector<LightClusters::LightIndex>>& clusterGrid) {
-    glm::ivec3 gridPosToOffset(1, grid.dims.x, grid.dims.x * grid.dims.y);
-    uint32_t numClustersTouched = 0;
+bool LightClusters::evalClusteredLight(FrustumGrid& grid, const LightSphere& sphere, ClusteredLight& clusteredLight) const {
+    auto radius = sphere.radius;
+
+    // Bring into frustum eye space
+    auto eyeOri = grid.frustumGrid_worldToEye(glm::vec4(sphere.position, 1.0f));
+
+    // Remove light that slipped through and is not in the z range
+    float eyeZMax = eyeOri.z - radius;
+    if (eyeZMax > -grid.rangeNear) {
+        return false;
+    }
+    float eyeZMin = eyeOri.z + radius;
+    bool beyondFar = false;
+    if (eyeZMin < -grid.rangeFar) {
+        beyondFar = true;
+    }
+
+    // Get z slices
+    int zMin = grid.frustumGrid_eyeDepthToClusterLayer(eyeZMin);
+    int zMax = grid.frustumGrid_eyeDepthToClusterLayer(eyeZMax);
+    // That should never happen
+    if (zMin == -2 && zMax == -2) {
+        return false;
+    }
+
+    // Before Range NEar just apss, range neatr == true near for now
+    if ((zMin == -1) && (zMax == -1)) {
+        return false;
+    }
+
+    // CLamp the z range 
+    zMin = std::max(0, zMin);
+
+    auto xLeftDistance = radius - distanceToPlane(eyeOri, _gridPlanes[0][0]);
+    auto xRightDistance = radius + distanceToPlane(eyeOri, _gridPlanes[0].back());
+
+    auto yBottomDistance = radius - distanceToPlane(eyeOri, _gridPlanes[1][0]);
+    auto yTopDistance = radius + distanceToPlane(eyeOri, _gridPlanes[1].back());
+
+    if ((xLeftDistance < 0.f) || (xRightDistance < 0.f) || (yBottomDistance < 0.f) || (yTopDistance < 0.f)) {
+        return false;
+    }
+
+    // find 2D corners of the sphere in grid
+    int xMin { 0 };
+    int xMax { grid.dims.x - 1 };
+    int yMin { 0 };
+    int yMax { grid.dims.y - 1 };
+
+    float radius2 = radius * radius;
+
+    auto eyeOriH = glm::vec3(eyeOri);
+    auto eyeOriV = glm::vec3(eyeOri);
 
-    for (auto y = yMin; (y <= yMax); y++) {
-        for (auto x = xMin; (x <= xMax); x++) {
-            auto index = x + gridPosToOffset.y * y + gridPosToOffset.z * zSlice;
-            clusterGrid[index].emplace_back(lightId);
-            numClustersTouched++;
+    eyeOriH.y = 0.0f;
+    eyeOriV.x = 0.0f;
+
+    float eyeOriLen2H = glm::length2(eyeOriH);
+    float eyeOriLen2V = glm::length2(eyeOriV);
+
+    if ((eyeOriLen2H > radius2)) {
+        float eyeOriLenH = sqrt(eyeOriLen2H);
+
+        auto eyeOriDirH = glm::vec3(eyeOriH) / eyeOriLenH;
+
+        float eyeToTangentCircleLenH = sqrt(eyeOriLen2H - radius2);
+
+        float eyeToTangentCircleCosH = eyeToTangentCircleLenH / eyeOriLenH;
+
+        float eyeToTangentCircleSinH = radius / eyeOriLenH;
+
+
+        // rotate the eyeToOriDir (H & V) in both directions
+        glm::vec3 leftDir(eyeOriDirH.x * eyeToTangentCircleCosH + eyeOriDirH.z * eyeToTangentCircleSinH, 0.0f, eyeOriDirH.x * -eyeToTangentCircleSinH + eyeOriDirH.z * eyeToTangentCircleCosH);
+        glm::vec3 rightDir(eyeOriDirH.x * eyeToTangentCircleCosH - eyeOriDirH.z * eyeToTangentCircleSinH, 0.0f, eyeOriDirH.x * eyeToTangentCircleSinH + eyeOriDirH.z * eyeToTangentCircleCosH);
+
+        auto lc = grid.frustumGrid_eyeToClusterDirH(leftDir);
+        if (lc > xMax) {
+            lc = xMin;
+        }
+        auto rc = grid.frustumGrid_eyeToClusterDirH(rightDir);
+        if (rc < 0) {
+            rc = xMax;
         }
+        xMin = std::max(xMin, lc);
+        xMax = std::min(rc, xMax);
+        assert(xMin <= xMax);
     }
 
-    return numClustersTouched;
-}
+    if ((eyeOriLen2V > radius2)) {
+        float eyeOriLenV = sqrt(eyeOriLen2V);
 
-uint32_t scanLightVolumeBox(FrustumGrid& grid, const FrustumGrid::Planes planes[3], int zMin, int zMax, int yMin, int yMax, int xMin, int xMax, LightClusters::LightID lightId, const glm::vec4& eyePosRadius,
-    std::vector< std::vector<LightClusters::LightIndex>>& clusterGrid) {
-    glm::ivec3 gridPosToOffset(1, grid.dims.x, grid.dims.x * grid.dims.y);
-    uint32_t numClustersTouched = 0;
-
-    for (auto z = zMin; (z <= zMax); z++) {
-        for (auto y = yMin; (y <= yMax); y++) {
-            for (auto x = xMin; (x <= xMax); x++) {
-                auto index = x + gridPosToOffset.y * y + gridPosToOffset.z * z;
-                clusterGrid[index].emplace_back(lightId);
-                numClustersTouched++;
-            }
+        auto eyeOriDirV = glm::vec3(eyeOriV) / eyeOriLenV;
+
+        float eyeToTangentCircleLenV = sqrt(eyeOriLen2V - radius2);
+
+        float eyeToTangentCircleCosV = eyeToTangentCircleLenV / eyeOriLenV;
+
+        float eyeToTangentCircleSinV = radius / eyeOriLenV;
+
+
+        // rotate the eyeToOriDir (H & V) in both directions
+        glm::vec3 bottomDir(0.0f, eyeOriDirV.y * eyeToTangentCircleCosV + eyeOriDirV.z * eyeToTangentCircleSinV, eyeOriDirV.y * -eyeToTangentCircleSinV + eyeOriDirV.z * eyeToTangentCircleCosV);
+        glm::vec3 topDir(0.0f, eyeOriDirV.y * eyeToTangentCircleCosV - eyeOriDirV.z * eyeToTangentCircleSinV, eyeOriDirV.y * eyeToTangentCircleSinV + eyeOriDirV.z * eyeToTangentCircleCosV);
+
+        auto bc = grid.frustumGrid_eyeToClusterDirV(bottomDir);
+        auto tc = grid.frustumGrid_eyeToClusterDirV(topDir);
+        if (bc > yMax) {
+            bc = yMin;
         }
+        if (tc < 0) {
+            tc = yMax;
+        }
+        yMin = std::max(yMin, bc);
+        yMax = std::min(tc, yMax);
+        assert(yMin <= yMax);
     }
 
-    return numClustersTouched;
+    clusteredLight.eyePosRadius = glm::vec4(glm::vec3(eyeOri), radius);
+    clusteredLight.center = grid.frustumGrid_eyeToClusterPos(glm::vec3(eyeOri));
+    clusteredLight.zMin = zMin;
+    clusteredLight.zMax = zMax;
+    clusteredLight.yMin = yMin;
+    clusteredLight.yMax = yMax;
+    clusteredLight.xMin = xMin;
+    clusteredLight.xMax = xMax;
+    clusteredLight.id = (LightIndex)sphere.id;
+    clusteredLight.isSpot = sphere.isSpot;
+    clusteredLight.beyondFar = beyondFar;
+    return true;
 }
 
-uint32_t scanLightVolumeSphere(FrustumGrid& grid, const FrustumGrid::Planes planes[3], int zMin, int zMax, int yMin, int yMax, int xMin, int xMax, LightClusters::LightID lightId, const glm::vec4& eyePosRadius,
-    std::vector< std::vector<LightClusters::LightIndex>>& clusterGrid) {
-    glm::ivec3 gridPosToOffset(1, grid.dims.x, grid.dims.x * grid.dims.y);
-    uint32_t numClustersTouched = 0;
-    const auto& xPlanes = planes[0];
-    const auto& yPlanes = planes[1];
-    const auto& zPlanes = planes[2];
+void LightClusters::scanSlice(FrustumGrid& grid, int zSlice) {
+    const auto& xPlanes = _gridPlanes[0];
+    const auto& yPlanes = _gridPlanes[1];
+    const auto& zPlanes = _gridPlanes[2];
+
+    auto& spans = _sliceSpans[zSlice];
+    spans.clear();
 
-    // FInd the light origin cluster
-    auto centerCluster = grid.frustumGrid_eyeToClusterPos(glm::vec3(eyePosRadius));
+    for (size_t lightNum = 0; lightNum < _clusteredLights.size(); ++lightNum) {
+        const auto& light = _clusteredLights[lightNum];
+
+        if (light.beyondFar) {
+            // Beyond the far range the light fills its 2D box in its first slice
+            if (zSlice == light.zMin) {
+                for (auto y = light.yMin; (y <= light.yMax); y++) {
+                    spans.push_back({ (uint16_t)lightNum, (uint8_t)y, (uint8_t)light.xMin, (uint8_t)light.xMax });
+                }
+            }
+            continue;
+        }
 
-    int center_z = centerCluster.z;
-    int center_y = centerCluster.y;
+        if ((zSlice < light.zMin) || (zSlice > light.zMax)) {
+            continue;
+        }
 
-    for (auto z = zMin; (z <= zMax); z++) {
-        auto zSphere = eyePosRadius;
-        if (z != center_z) {
-            auto plane = (z < center_z) ? zPlanes[z + 1] : -zPlanes[z];
+        auto zSphere = light.eyePosRadius;
+        if (zSlice != light.center.z) {
+            auto plane = (zSlice < light.center.z) ? zPlanes[zSlice + 1] : -zPlanes[zSlice];
             if (!reduceSphereToPlane(zSphere, plane, zSphere)) {
                 // pass this slice!
                 continue;
             }
         }
-        for (auto y = yMin; (y <= yMax); y++) {
+        for (auto y = light.yMin; (y <= light.yMax); y++) {
             auto ySphere = zSphere;
-            if (y != center_y) {
-                auto plane = (y < center_y) ? yPlanes[y + 1] : -yPlanes[y];
+            if (y != light.center.y) {
+                auto plane = (y < light.center.y) ? yPlanes[y + 1] : -yPlanes[y];
                 if (!reduceSphereToPlane(ySphere, plane, ySphere)) {
                     // pass this slice!
                     continue;
@@ -307,15 +417,15 @@ uint32_t scanLightVolumeSphere(FrustumGrid& grid, const FrustumGrid::Planes plan
 
             glm::vec3 spherePoint(ySphere);
 
-            auto x = xMin;
-            for (; (x < xMax); ++x) {
+            auto x = light.xMin;
+            for (; (x < light.xMax); ++x) {
                 const auto& plane = xPlanes[x + 1];
                 auto testDistance = distanceToPlane(spherePoint, plane) + ySphere.w;
                 if (testDistance >= 0.0f) {
                     break;
                 }
             }
-            auto xs = xMax;
+            auto xs = light.xMax;
             for (; (xs >= x); --xs) {
                 auto plane = -xPlanes[xs];
                 auto testDistance = distanceToPlane(spherePoint, plane) + ySphere.w;
@@ -324,225 +434,152 @@ uint32_t scanLightVolumeSphere(FrustumGrid& grid, const FrustumGrid::Planes plan
                 }
             }
 
-            for (; (x <= xs); x++) {
-                auto index = grid.frustumGrid_clusterToIndex(ivec3(x, y, z));
-                if (index < (int)clusterGrid.size()) {
-                    clusterGrid[index].emplace_back(lightId);
-                    numClustersTouched++;
+            if (x <= xs) {
+                // The row is contiguous, so checking its last cluster covers the whole span
+                auto index = grid.frustumGrid_clusterToIndex(ivec3(xs, y, zSlice));
+                if (index < (int)_clusterCounts.size()) {
+                    spans.push_back({ (uint16_t)lightNum, (uint8_t)y, (uint8_t)x, (uint8_t)xs });
                 } else {
-                    qCDebug(renderutils) << "WARNING: LightClusters::scanLightVolumeSphere invalid index found ? numClusters = " << clusterGrid.size() << " index = " << index << " found from cluster xyz = " << x << " " << y << " " << z;
+                    qCDebug(renderutils) << "WARNING: LightClusters::scanSlice invalid index found ? numClusters = " << _clusterCounts.size() << " index = " << index << " found from cluster xyz = " << xs << " " << y << " " << zSlice;
                 }
             }
         }
     }
 
-    return numClustersTouched;
+    // Count the lights in each cluster of the slice, no other slice touches these counters
+    for (const auto& span : spans) {
+        bool isSpot = _clusteredLights[span.light].isSpot;
+        auto rowIndex = grid.frustumGrid_clusterToIndex(ivec3(0, span.y, zSlice));
+        for (int x = span.xMin; x <= span.xMax; x++) {
+            auto& count = _clusterCounts[rowIndex + x];
+            if (isSpot) {
+                count.numSpots++;
+            } else {
+                count.numPoints++;
+            }
+        }
+    }
 }
 
-glm::ivec3 LightClusters::updateClusters() {
+void LightClusters::fillSlice(FrustumGrid& grid, int zSlice) {
+    // The counters of the slice have been reset by the prefix pass and are now used as write cursors
+    for (const auto& span : _sliceSpans[zSlice]) {
+        const auto& light = _clusteredLights[span.light];
+        auto rowIndex = grid.frustumGrid_clusterToIndex(ivec3(0, span.y, zSlice));
+        for (int x = span.xMin; x <= span.xMax; x++) {
+            auto index = rowIndex + x;
+            auto cluster = _clusterGrid[index];
+            uint32_t offset = (cluster & 0x0000FFFF);
+            uint16_t numLightsPoint = (uint16_t)((cluster & 0x00FF0000) >> 16);
+            uint16_t numLightsSpot = (uint16_t)((cluster & 0xFF000000) >> 24);
+
+            auto& cursor = _clusterCounts[index];
+            if (light.isSpot) {
+                if (cursor.numSpots < numLightsSpot) {
+                    _clusterContent[offset + numLightsPoint + cursor.numSpots] = light.id;
+                    cursor.numSpots++;
+                }
+            } else if (cursor.numPoints < numLightsPoint) {
+                _clusterContent[offset + cursor.numPoints] = light.id;
+                cursor.numPoints++;
+            }
+        }
+    }
+}
+
+glm::ivec3 LightClusters::clusterLights(const LightSpheres& lights) {
     // Make sure resource are in good shape
     updateClusterResource();
 
-    // Clean up last info
-    uint32_t numClusters = (uint32_t)_clusterGrid.size();
-
-    std::vector< std::vector< LightIndex > > clusterGridPoint(numClusters);
-    std::vector< std::vector< LightIndex > > clusterGridSpot(numClusters);
-
-    _clusterGrid.clear();
-    _clusterGrid.resize(numClusters, EMPTY_CLUSTER);
+    auto theFrustumGrid(_frustumGridBuffer.get());
 
+    uint32_t numClusters = (uint32_t)_clusterGrid.size();
     uint32_t maxNumIndices = (uint32_t)_clusterContent.size();
-    _clusterContent.clear();
-    _clusterContent.resize(maxNumIndices, INVALID_LIGHT);
-
+    int numSlices = theFrustumGrid.dims.z + 1;
+
+    // Evaluate the grid bounds of each light once
+    _clusteredLights.clear();
+    ClusteredLight clusteredLight;
+    for (const auto& sphere : lights) {
+        if (evalClusteredLight(theFrustumGrid, sphere, clusteredLight)) {
+            _clusteredLights.push_back(clusteredLight);
+        }
+    }
 
-    auto theFrustumGrid(_frustumGridBuffer.get());
+    _sliceSpans.resize(numSlices);
+    _clusterCounts.assign(numClusters, ClusterCount());
 
-    glm::ivec3 gridPosToOffset(1, theFrustumGrid.dims.x, theFrustumGrid.dims.x * theFrustumGrid.dims.y);
+    // First pass: each slice voxelizes the lights crossing it and counts the lights per cluster
+    tbb::parallel_for(0, numSlices, [&](int zSlice) {
+        scanSlice(theFrustumGrid, zSlice);
+    });
 
+    // Lights have been counted now reexpress in terms of 2 sequential buffers
+    // Start filling from near to far and stops if it overflows
     uint32_t numClusterTouched = 0;
-    uint32_t numLightsIn = _visibleLightIndices[0];
-    uint32_t numClusteredLights = 0;
-    for (size_t lightNum = 1; lightNum < _visibleLightIndices.size(); ++lightNum) {
-        auto lightId = _visibleLightIndices[lightNum];
-        auto light = _lightStage->getLight(lightId);
-        if (!light) {
-            continue;
-        }
+    uint32_t indexOffset = 0;
+    bool overflow = false;
+    for (uint32_t i = 0; i < numClusters; i++) {
+        auto& count = _clusterCounts[i];
+        numClusterTouched += count.numPoints + count.numSpots;
 
-        auto worldOri = light->getPosition();
-        auto radius = light->getMaximumRadius();
-        bool isSpot = light->isSpot();
+        uint32_t numLightsPoint = std::min<uint32_t>(count.numPoints, 0xFF);
+        uint32_t numLightsSpot = std::min<uint32_t>(count.numSpots, 0xFF);
+        uint32_t numLights = numLightsPoint + numLightsSpot;
+        uint32_t offset = indexOffset;
 
-        // Bring into frustum eye space
-        auto eyeOri = theFrustumGrid.frustumGrid_worldToEye(glm::vec4(worldOri, 1.0f));
+        // Reset the counter so it can be used as the write cursor of the cluster
+        count = ClusterCount();
 
-        // Remove light that slipped through and is not in the z range
-        float eyeZMax = eyeOri.z - radius;
-        if (eyeZMax > -theFrustumGrid.rangeNear) {
-            continue;
-        }
-        float eyeZMin = eyeOri.z + radius;
-        bool beyondFar = false;
-        if (eyeZMin < -theFrustumGrid.rangeFar) {
-            beyondFar = true;
-        }
-
-        // Get z slices
-        int zMin = theFrustumGrid.frustumGrid_eyeDepthToClusterLayer(eyeZMin);
-        int zMax = theFrustumGrid.frustumGrid_eyeDepthToClusterLayer(eyeZMax);
-        // That should never happen
-        if (zMin == -2 && zMax == -2) {
+        // Check for overflow
+        if (overflow || ((indexOffset + numLights) > maxNumIndices)) {
+            overflow = true;
+            _clusterGrid[i] = EMPTY_CLUSTER;
             continue;
         }
 
-        // Before Range NEar just apss, range neatr == true near for now
-        if ((zMin == -1) && (zMax == -1)) {
-            continue;
-        }
+        // Encode the cluster grid: [ ContentOffset - 16bits, Num Point LIghts - 8bits, Num Spot Lights - 8bits] 
+        _clusterGrid[i] = (uint32_t)((0xFF000000 & (numLightsSpot << 24)) | (0x00FF0000 & (numLightsPoint << 16)) | (0x0000FFFF & offset));
+        indexOffset += numLights;
+    }
 
-        // CLamp the z range 
-        zMin = std::max(0, zMin);
+    // Second pass: each slice writes its light indices at the offsets of its clusters
+    tbb::parallel_for(0, numSlices, [&](int zSlice) {
+        fillSlice(theFrustumGrid, zSlice);
+    });
 
-        auto xLeftDistance = radius - distanceToPlane(eyeOri, _gridPlanes[0][0]);
-        auto xRightDistance = radius + distanceToPlane(eyeOri, _gridPlanes[0].back());
+    _clusterContentSize = indexOffset;
 
-        auto yBottomDistance = radius - distanceToPlane(eyeOri, _gridPlanes[1][0]);
-        auto yTopDistance = radius + distanceToPlane(eyeOri, _gridPlanes[1].back());
+    return glm::ivec3((int)lights.size(), (int)_clusteredLights.size(), (int)numClusterTouched);
+}
 
-        if ((xLeftDistance < 0.f) || (xRightDistance < 0.f) || (yBottomDistance < 0.f) || (yTopDistance < 0.f)) {
+glm::ivec3 LightClusters::updateClusters() {
+    // Gather the visible lights
+    _lightSpheres.clear();
+    uint32_t numLightsIn = (_visibleLightIndices.empty() ? 0 : _visibleLightIndices[0]);
+    for (uint32_t lightNum = 1; lightNum <= numLightsIn; ++lightNum) {
+        auto lightId = _visibleLightIndices[lightNum];
+        auto light = _lightStage->getLight(lightId);
+        if (!light) {
             continue;
         }
 
-        // find 2D corners of the sphere in grid
-        int xMin { 0 };
-        int xMax { theFrustumGrid.dims.x - 1 };
-        int yMin { 0 };
-        int yMax { theFrustumGrid.dims.y - 1 };
-
-        float radius2 = radius * radius;
-
-        auto eyeOriH = glm::vec3(eyeOri);
-        auto eyeOriV = glm::vec3(eyeOri);
-
-        eyeOriH.y = 0.0f;
-        eyeOriV.x = 0.0f;
-
-        float eyeOriLen2H = glm::length2(eyeOriH);
-        float eyeOriLen2V = glm::length2(eyeOriV);
-
-        if ((eyeOriLen2H > radius2)) {
-            float eyeOriLenH = sqrt(eyeOriLen2H);
-
-            auto eyeOriDirH = glm::vec3(eyeOriH) / eyeOriLenH;
-
-            float eyeToTangentCircleLenH = sqrt(eyeOriLen2H - radius2);
-
-            float eyeToTangentCircleCosH = eyeToTangentCircleLenH / eyeOriLenH;
-
-            float eyeToTangentCircleSinH = radius / eyeOriLenH;
-
-
-            // rotate the eyeToOriDir (H & V) in both directions
-            glm::vec3 leftDir(eyeOriDirH.x * eyeToTangentCircleCosH + eyeOriDirH.z * eyeToTangentCircleSinH, 0.0f, eyeOriDirH.x * -eyeToTangentCircleSinH + eyeOriDirH.z * eyeToTangentCircleCosH);
-            glm::vec3 rightDir(eyeOriDirH.x * eyeToTangentCircleCosH - eyeOriDirH.z * eyeToTangentCircleSinH, 0.0f, eyeOriDirH.x * eyeToTangentCircleSinH + eyeOriDirH.z * eyeToTangentCircleCosH);
-
-            auto lc = theFrustumGrid.frustumGrid_eyeToClusterDirH(leftDir);
-            if (lc > xMax) {
-                lc = xMin;
-            }
-            auto rc = theFrustumGrid.frustumGrid_eyeToClusterDirH(rightDir);
-            if (rc < 0) {
-                rc = xMax;
-            }
-            xMin = std::max(xMin, lc);
-            xMax = std::min(rc, xMax);
-            assert(xMin <= xMax);
-        }
-
-        if ((eyeOriLen2V > radius2)) {
-            float eyeOriLenV = sqrt(eyeOriLen2V);
-
-            auto eyeOriDirV = glm::vec3(eyeOriV) / eyeOriLenV;
-
-            float eyeToTangentCircleLenV = sqrt(eyeOriLen2V - radius2);
-
-            float eyeToTangentCircleCosV = eyeToTangentCircleLenV / eyeOriLenV;
-
-            float eyeToTangentCircleSinV = radius / eyeOriLenV;
-
-
-            // rotate the eyeToOriDir (H & V) in both directions
-            glm::vec3 bottomDir(0.0f, eyeOriDirV.y * eyeToTangentCircleCosV + eyeOriDirV.z * eyeToTangentCircleSinV, eyeOriDirV.y * -eyeToTangentCircleSinV + eyeOriDirV.z * eyeToTangentCircleCosV);
-            glm::vec3 topDir(0.0f, eyeOriDirV.y * eyeToTangentCircleCosV - eyeOriDirV.z * eyeToTangentCircleSinV, eyeOriDirV.y * eyeToTangentCircleSinV + eyeOriDirV.z * eyeToTangentCircleCosV);
-
-            auto bc = theFrustumGrid.frustumGrid_eyeToClusterDirV(bottomDir);
-            auto tc = theFrustumGrid.frustumGrid_eyeToClusterDirV(topDir);
-            if (bc > yMax) {
-                bc = yMin;
-            }
-            if (tc < 0) {
-                tc = yMax;
-            }
-            yMin = std::max(yMin, bc);
-            yMax =std::min(tc, yMax);
-            assert(yMin <= yMax);
-        }
-
-        // now voxelize
-        auto& clusterGrid = (isSpot ? clusterGridSpot : clusterGridPoint);
-        if (beyondFar) {
-            numClusterTouched += scanLightVolumeBoxSlice(theFrustumGrid, _gridPlanes, zMin, yMin, yMax, xMin, xMax, lightId, glm::vec4(glm::vec3(eyeOri), radius), clusterGrid);
-        } else {
-            numClusterTouched += scanLightVolumeSphere(theFrustumGrid, _gridPlanes, zMin, zMax, yMin, yMax, xMin, xMax, lightId, glm::vec4(glm::vec3(eyeOri), radius), clusterGrid);
-        }
-
-        numClusteredLights++;
-    }
-
-    // Lights have been gathered now reexpress in terms of 2 sequential buffers
-    // Start filling from near to far and stops if it overflows
-    bool checkBudget = false;
-    if (numClusterTouched > maxNumIndices) {
-        checkBudget = true;
+        LightSphere sphere;
+        sphere.position = light->getPosition();
+        sphere.radius = light->getMaximumRadius();
+        sphere.id = lightId;
+        sphere.isSpot = light->isSpot();
+        _lightSpheres.push_back(sphere);
     }
-    uint16_t indexOffset = 0;
-    for (int i = 0; i < (int) clusterGridPoint.size(); i++) {
-        auto& clusterPoint = clusterGridPoint[i];
-        auto& clusterSpot = clusterGridSpot[i];
-
-        uint8_t numLightsPoint = ((uint8_t)clusterPoint.size());
-        uint8_t numLightsSpot = ((uint8_t)clusterSpot.size());
-        uint16_t numLights = numLightsPoint + numLightsSpot;
-        uint16_t offset = indexOffset;
-
-        // Check for overflow
-        if (checkBudget) {
-            if ((indexOffset + numLights) > (uint16_t) maxNumIndices) {
-                break;
-            }
-        }
-
-        // Encode the cluster grid: [ ContentOffset - 16bits, Num Point LIghts - 8bits, Num Spot Lights - 8bits] 
-        _clusterGrid[i] = (uint32_t)((0xFF000000 & (numLightsSpot << 24)) | (0x00FF0000 & (numLightsPoint << 16)) | (0x0000FFFF & offset));
 
-
-        if (numLightsPoint) {
-            memcpy(_clusterContent.data() + indexOffset, clusterPoint.data(), numLightsPoint * sizeof(LightIndex));
-            indexOffset += numLightsPoint;
-        }
-        if (numLightsSpot) {
-            memcpy(_clusterContent.data() + indexOffset, clusterSpot.data(), numLightsSpot * sizeof(LightIndex));
-            indexOffset += numLightsSpot;
-        }
-    }
+    auto clusteringStats = clusterLights(_lightSpheres);
+    clusteringStats.x = numLightsIn;
 
     // update the buffers
     _clusterGridBuffer._buffer->setData(_clusterGridBuffer._size, (gpu::Byte*) _clusterGrid.data());
-    _clusterContentBuffer._buffer->setSubData(0, indexOffset * sizeof(LightIndex), (gpu::Byte*) _clusterContent.data());
-    
-    return glm::ivec3(numLightsIn, numClusteredLights, numClusterTouched);
+    _clusterContentBuffer._buffer->setSubData(0, _clusterContentSize * sizeof(LightIndex), (gpu::Byte*) _clusterContent.data());
+
+    return clusteringStats;
 }
 
 
@@ -83,6 +83,19 @@ public:
 
     glm::ivec3  updateClusters();
 
+    // A light reduced to what the clustering needs, in world space
+    struct LightSphere {
+        glm::vec3 position;
+        float radius { 0.0f };
+        LightID id { 0 };
+        bool isSpot { false };
+    };
+    using LightSpheres = std::vector<LightSphere>;
+
+    // Bin the lights in the grid and fill _clusterGrid / _clusterContent, no gpu involved.
+    // Returns (numLightsIn, numClusteredLights, numClusterTouched)
+    glm::ivec3 clusterLights(const LightSpheres& lights);
+
 
     ViewFrustum _frustum;
 
@@ -108,9 +121,51 @@ public:
     gpu::BufferView _clusterGridBuffer;
     gpu::BufferView _clusterContentBuffer;
     uint32_t _clusterContentBudget { 0 };
+    uint32_t _clusterContentSize { 0 };
 
     bool _clusterResourcesInvalid { true };
     void updateClusterResource();
+
+protected:
+    // Light bounds in the grid, evaluated once per light before the slices are scanned
+    struct ClusteredLight {
+        glm::vec4 eyePosRadius;
+        glm::ivec3 center;
+        int zMin { 0 };
+        int zMax { 0 };
+        int yMin { 0 };
+        int yMax { 0 };
+        int xMin { 0 };
+        int xMax { 0 };
+        LightIndex id { 0 };
+        bool isSpot { false };
+        bool beyondFar { false };
+    };
+
+    // A row of clusters touched by a light in a given z slice
+    struct ClusterSpan {
+        uint16_t light;
+        uint8_t y;
+        uint8_t xMin;
+        uint8_t xMax;
+    };
+    using ClusterSpans = std::vector<ClusterSpan>;
+
+    struct ClusterCount {
+        uint16_t numPoints { 0 };
+        uint16_t numSpots { 0 };
+    };
+
+    bool evalClusteredLight(FrustumGrid& grid, const LightSphere& sphere, ClusteredLight& clusteredLight) const;
+    void scanSlice(FrustumGrid& grid, int zSlice);
+    void fillSlice(FrustumGrid& grid, int zSlice);
+
+    // Scratch storage kept across frames so the clustering does not allocate in steady state.
+    // Each z slice owns its span list and the counters of its clusters, so slices can be processed in parallel.
+    LightSpheres _lightSpheres;
+    std::vector<ClusteredLight> _clusteredLights;
+    std::vector<ClusterSpans> _sliceSpans;
+    std::vector<ClusterCount> _clusterCounts;
 };
 
 using LightClustersPointer = std::shared_ptr<LightClusters>;
@@ -328,14 +328,16 @@ ModelMeshPartPayload::ModelMeshPartPayload(ModelPointer model, int meshIndex, in
     _model = model;
     auto& modelMesh = model->getGeometry()->getMeshes().at(_meshIndex);
     const Model::MeshState& state = model->getMeshState(_meshIndex);
+    assert(state.clusterOffset + state.numClusters <= model->_clusterMatrices.size());
+    const glm::mat4* clusterMatrices = model->getClusterMatrices() + state.clusterOffset;
 
     updateMeshPart(modelMesh, partIndex);
-    computeAdjustedLocalBound(state.clusterMatrices);
+    computeAdjustedLocalBound(clusterMatrices, state.numClusters);
 
     updateTransform(transform, offsetTransform);
     Transform renderTransform = transform;
-    if (state.clusterMatrices.size() == 1) {
-        renderTransform = transform.worldTransform(Transform(state.clusterMatrices[0]));
+    if (state.numClusters == 1) {
+        renderTransform = transform.worldTransform(Transform(clusterMatrices[0]));
     }
     updateTransformForSkinnedMesh(renderTransform, transform);
 
@@ -368,7 +370,7 @@ void ModelMeshPartPayload::notifyLocationChanged() {
 }
 
 
-void ModelMeshPartPayload::updateClusterBuffer(const std::vector<glm::mat4>& clusterMatrices) {
+void ModelMeshPartPayload::updateClusterBuffer(const ClusterMatrices& clusterMatrices) {
     // Once computed the cluster matrices, update the buffer(s)
     if (clusterMatrices.size() > 1) {
         if (!_clusterBuffer) {
@@ -594,11 +596,11 @@ void ModelMeshPartPayload::render(RenderArgs* args) {
     args->_details._trianglesRendered += _drawPart._numIndices / INDICES_PER_TRIANGLE;
 }
 
-void ModelMeshPartPayload::computeAdjustedLocalBound(const std::vector<glm::mat4>& clusterMatrices) {
+void ModelMeshPartPayload::computeAdjustedLocalBound(const glm::mat4* clusterMatrices, uint32_t numClusterMatrices) {
     _adjustedLocalBound = _localBound;
-    if (clusterMatrices.size() > 0) {
+    if (numClusterMatrices > 0) {
         _adjustedLocalBound.transform(clusterMatrices[0]);
-        for (int i = 1; i < (int)clusterMatrices.size(); ++i) {
+        for (int i = 1; i < (int)numClusterMatrices; ++i) {
             AABox clusterBound = _localBound;
             clusterBound.transform(clusterMatrices[i]);
             _adjustedLocalBound += clusterBound;
@@ -87,7 +87,7 @@ public:
     typedef Payload::DataPointer Pointer;
 
     void notifyLocationChanged() override;
-    void updateClusterBuffer(const std::vector<glm::mat4>& clusterMatrices);
+    void updateClusterBuffer(const ClusterMatrices& clusterMatrices);
     void updateTransformForSkinnedMesh(const Transform& renderTransform, const Transform& boundTransform);
 
     // Render Item interface
@@ -102,7 +102,7 @@ public:
 
     void initCache();
 
-    void computeAdjustedLocalBound(const std::vector<glm::mat4>& clusterMatrices);
+    void computeAdjustedLocalBound(const glm::mat4* clusterMatrices, uint32_t numClusterMatrices);
 
     gpu::BufferPointer _clusterBuffer;
     ModelWeakPointer _model;
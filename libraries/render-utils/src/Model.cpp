@@ -219,52 +219,39 @@ void Model::updateRenderItems() {
     _renderItemsNeedUpdate = false;
 
     // queue up this work for later processing, at the end of update and just before rendering.
-    // the application will ensure only the last lambda is actually invoked.
-    void* key = (void*)this;
-    std::weak_ptr<Model> weakSelf = shared_from_this();
-    AbstractViewStateInterface::instance()->pushPostUpdateLambda(key, [weakSelf]() {
-
-        // do nothing, if the model has already been destroyed.
-        auto self = weakSelf.lock();
-        if (!self || !self->isLoaded()) {
-            return;
-        }
-
-        // lazy update of cluster matrices used for rendering.
-        // We need to update them here so we can correctly update the bounding box.
-        self->updateClusterMatrices();
+    // the cluster matrices of all the models queued during the frame are evaluated together by the skinning batch.
+    DependencyManager::get<ModelSkinningBatch>()->queueModel(getThisPointer());
+}
 
-        Transform modelTransform = self->getTransform();
-        modelTransform.setScale(glm::vec3(1.0f));
+void Model::updateRenderItemClusters(render::Transaction& transaction, const ClusterMatrixPoolPointer& pool, uint32_t offset) {
+    Transform modelTransform = getTransform();
+    modelTransform.setScale(glm::vec3(1.0f));
 
-        render::Transaction transaction;
-        for (int i = 0; i < (int) self->_modelMeshRenderItemIDs.size(); i++) {
+    for (int i = 0; i < (int) _modelMeshRenderItemIDs.size(); i++) {
 
-            auto itemID = self->_modelMeshRenderItemIDs[i];
-            auto meshIndex = self->_modelMeshRenderItemShapes[i].meshIndex;
-            auto clusterMatrices(self->getMeshState(meshIndex).clusterMatrices);
+        auto itemID = _modelMeshRenderItemIDs[i];
+        auto meshIndex = _modelMeshRenderItemShapes[i].meshIndex;
+        const auto& state = _meshStates[meshIndex];
+        ClusterMatrices clusterMatrices(pool, offset + state.clusterOffset, state.numClusters);
 
-            transaction.updateItem<ModelMeshPartPayload>(itemID, [modelTransform, clusterMatrices](ModelMeshPartPayload& data) {
-                data.updateClusterBuffer(clusterMatrices);
-                Transform renderTransform = modelTransform;
-                if (clusterMatrices.size() == 1) {
-                    renderTransform = modelTransform.worldTransform(Transform(clusterMatrices[0]));
-                }
-                data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
-            });
-        }
-
-        Transform collisionMeshOffset;
-        collisionMeshOffset.setIdentity();
-        foreach(auto itemID, self->_collisionRenderItemsMap.keys()) {
-            transaction.updateItem<MeshPartPayload>(itemID, [modelTransform, collisionMeshOffset](MeshPartPayload& data) {
-                // update the model transform for this render item.
-                data.updateTransform(modelTransform, collisionMeshOffset);
-            });
-        }
+        transaction.updateItem<ModelMeshPartPayload>(itemID, [modelTransform, clusterMatrices](ModelMeshPartPayload& data) {
+            data.updateClusterBuffer(clusterMatrices);
+            Transform renderTransform = modelTransform;
+            if (clusterMatrices.size() == 1) {
+                renderTransform = modelTransform.worldTransform(Transform(clusterMatrices[0]));
+            }
+            data.updateTransformForSkinnedMesh(renderTransform, modelTransform);
+        });
+    }
 
-        AbstractViewStateInterface::instance()->getMain3DScene()->enqueueTransaction(transaction);
-    });
+    Transform collisionMeshOffset;
+    collisionMeshOffset.setIdentity();
+    foreach(auto itemID, _collisionRenderItemsMap.keys()) {
+        transaction.updateItem<MeshPartPayload>(itemID, [modelTransform, collisionMeshOffset](MeshPartPayload& data) {
+            // update the model transform for this render item.
+            data.updateTransform(modelTransform, collisionMeshOffset);
+        });
+    }
 }
 
 void Model::setRenderItemsNeedUpdate() {
@@ -306,7 +293,9 @@ bool Model::updateGeometry() {
         const FBXGeometry& fbxGeometry = getFBXGeometry();
         foreach (const FBXMesh& mesh, fbxGeometry.meshes) {
             MeshState state;
-            state.clusterMatrices.resize(mesh.clusters.size());
+            state.clusterOffset = _numClusterMatrices;
+            state.numClusters = (uint32_t)mesh.clusters.size();
+            _numClusterMatrices += (uint32_t)mesh.clusters.size();
             _meshStates.push_back(state);
 
             // Note: we add empty buffers for meshes that lack blendshapes so we can access the buffers by index
@@ -412,6 +401,87 @@ bool Model::findRayIntersectionAgainstSubMeshes(const glm::vec3& origin, const g
     return intersectedSomething;
 }
 
+void Model::findRayIntersectionsAgainstSubMeshes(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+                                                  std::vector<TriangleSet::RayIntersection>& results,
+                                                  bool pickAgainstTriangles, bool allowBackface) {
+    assert(origins.size() == directions.size());
+    results.assign(origins.size(), TriangleSet::RayIntersection());
+
+    // if we aren't active, we can't ray pick yet...
+    if (!isActive()) {
+        return;
+    }
+
+    glm::mat4 modelToWorldMatrix = glm::translate(_translation) * glm::mat4_cast(_rotation);
+    glm::mat4 worldToModelMatrix = glm::inverse(modelToWorldMatrix);
+
+    Extents modelExtents = getMeshExtents(); // NOTE: unrotated
+
+    glm::vec3 dimensions = modelExtents.maximum - modelExtents.minimum;
+    glm::vec3 corner = -(dimensions * _registrationPoint); // since we're going to do the ray picking in the model frame of reference
+    AABox modelFrameBox(corner, dimensions);
+
+    // only the rays that hit the model's box go on to the sub meshes
+    std::vector<size_t> rays;
+    for (size_t i = 0; i < origins.size(); i++) {
+        glm::vec3 modelFrameOrigin = glm::vec3(worldToModelMatrix * glm::vec4(origins[i], 1.0f));
+        glm::vec3 modelFrameDirection = glm::vec3(worldToModelMatrix * glm::vec4(directions[i], 0.0f));
+        float boxDistance;
+        BoxFace boxFace;
+        glm::vec3 boxNormal;
+        if (modelFrameBox.findRayIntersection(modelFrameOrigin, modelFrameDirection, boxDistance, boxFace, boxNormal)) {
+            rays.push_back(i);
+        }
+    }
+    if (rays.empty()) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    if (!_triangleSetsValid) {
+        calculateTriangleSets();
+    }
+
+    glm::mat4 meshToModelMatrix = glm::scale(_scale) * glm::translate(_offset);
+    glm::mat4 meshToWorldMatrix = createMatFromQuatAndPos(_rotation, _translation) * meshToModelMatrix;
+    glm::mat4 worldToMeshMatrix = glm::inverse(meshToWorldMatrix);
+
+    std::vector<glm::vec3> meshFrameOrigins;
+    std::vector<glm::vec3> meshFrameDirections;
+    meshFrameOrigins.reserve(rays.size());
+    meshFrameDirections.reserve(rays.size());
+    for (size_t ray : rays) {
+        meshFrameOrigins.push_back(glm::vec3(worldToMeshMatrix * glm::vec4(origins[ray], 1.0f)));
+        meshFrameDirections.push_back(glm::vec3(worldToMeshMatrix * glm::vec4(directions[ray], 0.0f)));
+    }
+
+    std::vector<TriangleSet::RayIntersection> triangleSetResults;
+    for (auto& triangleSet : _modelSpaceMeshTriangleSets) {
+        triangleSet.findRayIntersections(meshFrameOrigins, meshFrameDirections, triangleSetResults,
+            pickAgainstTriangles, allowBackface);
+
+        for (size_t i = 0; i < rays.size(); i++) {
+            const TriangleSet::RayIntersection& triangleSetResult = triangleSetResults[i];
+            if (!triangleSetResult.intersects) {
+                continue;
+            }
+
+            glm::vec3 meshIntersectionPoint = meshFrameOrigins[i] + (meshFrameDirections[i] * triangleSetResult.distance);
+            glm::vec3 worldIntersectionPoint = glm::vec3(meshToWorldMatrix * glm::vec4(meshIntersectionPoint, 1.0f));
+            float worldDistance = glm::distance(origins[rays[i]], worldIntersectionPoint);
+
+            TriangleSet::RayIntersection& result = results[rays[i]];
+            if (worldDistance < result.distance) {
+                result.intersects = true;
+                result.distance = worldDistance;
+                result.face = triangleSetResult.face;
+                result.surfaceNormal = glm::vec3(meshToWorldMatrix * glm::vec4(triangleSetResult.surfaceNormal, 0.0f));
+            }
+        }
+    }
+}
+
 bool Model::convexHullContains(glm::vec3 point) {
     // if we aren't active, we can't compute that yet...
     if (!isActive()) {
@@ -1096,8 +1166,6 @@ void Model::simulate(float deltaTime, bool fullUpdate) {
         // update the world space transforms for all joints
         glm::mat4 parentTransform = glm::scale(_scale) * glm::translate(_offset);
         updateRig(deltaTime, parentTransform);
-
-        computeMeshPartLocalBounds();
     }
 }
 
@@ -1108,14 +1176,13 @@ void Model::updateRig(float deltaTime, glm::mat4 parentTransform) {
     _rig.updateAnimations(deltaTime, parentTransform, rigToWorldTransform);
 }
 
-void Model::computeMeshPartLocalBounds() {
+void Model::computeMeshPartLocalBounds(const glm::mat4* clusterMatrices) {
     for (auto& part : _modelMeshRenderItems) {
         const Model::MeshState& state = _meshStates.at(part->_meshIndex);
-        part->computeAdjustedLocalBound(state.clusterMatrices);
+        part->computeAdjustedLocalBound(clusterMatrices + state.clusterOffset, state.numClusters);
     }
 }
 
-// virtual
 void Model::updateClusterMatrices() {
     DETAILED_PERFORMANCE_TIMER("Model::updateClusterMatrices");
 
@@ -1123,18 +1190,29 @@ void Model::updateClusterMatrices() {
         return;
     }
     _needsUpdateClusterMatrices = false;
+    _clusterMatrices.resize(getNumRenderClusterMatrices());
+    computeClusterMatrices(_clusterMatrices.data());
+    requestBlendIfNeeded();
+}
+
+// virtual
+void Model::computeClusterMatrices(glm::mat4* destination) {
     const FBXGeometry& geometry = getFBXGeometry();
     for (int i = 0; i < (int) _meshStates.size(); i++) {
-        MeshState& state = _meshStates[i];
+        const MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
+        glm::mat4* clusterMatrices = destination + state.clusterOffset;
         for (int j = 0; j < mesh.clusters.size(); j++) {
             const FBXCluster& cluster = mesh.clusters.at(j);
             auto jointMatrix = _rig.getJointTransform(cluster.jointIndex);
-            glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, state.clusterMatrices[j]);
+            glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, clusterMatrices[j]);
         }
     }
+}
 
+void Model::requestBlendIfNeeded() {
     // post the blender if we're not currently waiting for one to finish
+    const FBXGeometry& geometry = getFBXGeometry();
     if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
         _blendedBlendshapeCoefficients = _blendshapeCoefficients;
         DependencyManager::get<ModelBlender>()->noteRequiresBlend(getThisPointer());
@@ -1200,6 +1278,9 @@ void Model::deleteGeometry() {
     _deleteGeometryCounter++;
     _blendedVertexBuffers.clear();
     _meshStates.clear();
+    _numClusterMatrices = 0;
+    _clusterMatrices.clear();
+    _needsUpdateClusterMatrices = true;
     _rig.destroyAnimGraph();
     _blendedBlendshapeCoefficients.clear();
     _renderGeometry.reset();
@@ -1224,6 +1305,9 @@ const render::ItemIDs& Model::fetchRenderItemIDs() const {
 }
 
 void Model::createRenderItemSet() {
+    // new render items take their initial matrices from _clusterMatrices, which the skinning batch doesn't keep
+    // up to date, so evaluate them for the current geometry and pose before handing any out
+    _needsUpdateClusterMatrices = true;
     updateClusterMatrices();
     if (_collisionGeometry) {
         if (_collisionRenderItems.empty()) {
@@ -1342,6 +1426,64 @@ ModelBlender::ModelBlender() :
     _pendingBlenders(0) {
 }
 
+void ModelSkinningBatch::queueModel(const ModelPointer& model) {
+    {
+        Lock lock(_mutex);
+        _queuedModels[model.get()] = model;
+    }
+
+    // the application will ensure only the last lambda is actually invoked.
+    AbstractViewStateInterface::instance()->pushPostUpdateLambda((void*)this, []() {
+        auto skinningBatch = DependencyManager::get<ModelSkinningBatch>();
+        if (skinningBatch) {
+            skinningBatch->update();
+        }
+    });
+}
+
+void ModelSkinningBatch::update() {
+    PROFILE_RANGE(render, __FUNCTION__);
+
+    // do nothing for the models that have already been destroyed or are not loaded anymore
+    {
+        Lock lock(_mutex);
+        for (auto& entry : _queuedModels) {
+            auto model = entry.second.lock();
+            if (model && model->isLoaded()) {
+                _models.push_back(model);
+            }
+        }
+        _queuedModels.clear();
+    }
+    if (_models.empty()) {
+        return;
+    }
+
+    // lazy update of cluster matrices used for rendering, all the models in parallel.
+    // We need to update them here so we can correctly update the bounding box.
+    _offsets.clear();
+    for (auto& model : _models) {
+        Model* self = model.get();
+        // every queued model is dirty, its matrices are evaluated straight into its range of the pool
+        _offsets.push_back(_batch.add(self->getNumRenderClusterMatrices(), [self](glm::mat4* destination) {
+            self->_needsUpdateClusterMatrices = false;
+            self->computeClusterMatrices(destination);
+            self->computeMeshPartLocalBounds(destination);
+        }));
+    }
+    auto pool = _batch.evaluate();
+
+    render::Transaction transaction;
+    for (size_t i = 0; i < _models.size(); i++) {
+        auto& model = _models[i];
+        model->requestBlendIfNeeded();
+        model->updateRenderItemClusters(transaction, pool, _offsets[i]);
+    }
+    AbstractViewStateInterface::instance()->getMain3DScene()->enqueueTransaction(transaction);
+
+    _models.clear();
+}
+
 ModelBlender::~ModelBlender() {
 }
 
@@ -31,6 +31,7 @@
 #include <SpatiallyNestable.h>
 #include <TriangleSet.h>
 
+#include "ClusterMatrixBatch.h"
 #include "GeometryCache.h"
 #include "TextureCache.h"
 #include "Rig.h"
@@ -129,7 +130,7 @@ public:
     bool getSnapModelToRegistrationPoint() { return _snapModelToRegistrationPoint; }
 
     virtual void simulate(float deltaTime, bool fullUpdate = true);
-    virtual void updateClusterMatrices();
+    void updateClusterMatrices();
 
     /// Returns a reference to the shared geometry.
     const Geometry::Pointer& getGeometry() const { return _renderGeometry; }
@@ -161,6 +162,12 @@ public:
                                              BoxFace& face, glm::vec3& surfaceNormal, 
                                              QString& extraInfo, bool pickAgainstTriangles = false, bool allowBackface = false);
 
+    // Same as findRayIntersectionAgainstSubMeshes() for a batch of rays, each sub mesh being tested against all the
+    // rays that hit the model's box at once.  results[i] is the result of origins[i] and directions[i].
+    void findRayIntersectionsAgainstSubMeshes(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+                                              std::vector<TriangleSet::RayIntersection>& results,
+                                              bool pickAgainstTriangles = false, bool allowBackface = false);
+
     void setOffset(const glm::vec3& offset);
     const glm::vec3& getOffset() const { return _offset; }
 
@@ -246,11 +253,16 @@ public:
 
     class MeshState {
     public:
-        std::vector<glm::mat4> clusterMatrices;
+        uint32_t clusterOffset { 0 }; // offset of the matrices in the block published to the skinning batch
+        uint32_t numClusters { 0 };
     };
 
     const MeshState& getMeshState(int index) { return _meshStates.at(index); }
 
+    /// The cluster matrices last evaluated by updateClusterMatrices(), laid out like the block published to the
+    /// skinning batch. Only used to set up new render items, the batch evaluates straight into its own pool.
+    const glm::mat4* getClusterMatrices() const { return _clusterMatrices.data(); }
+
     uint32_t getGeometryCounter() const { return _deleteGeometryCounter; }
     const QMap<render::ItemID, render::PayloadPointer>& getRenderItems() const { return _modelMeshRenderItemsMap; }
 
@@ -323,7 +335,7 @@ protected:
     void setScaleInternal(const glm::vec3& scale);
     void snapToRegistrationPoint();
 
-    void computeMeshPartLocalBounds();
+    void computeMeshPartLocalBounds(const glm::mat4* clusterMatrices);
     virtual void updateRig(float deltaTime, glm::mat4 parentTransform);
 
     /// Restores the indexed joint to its default position.
@@ -344,6 +356,24 @@ protected:
     // hook for derived classes to be notified when setUrl invalidates the current model.
     virtual void onInvalidate() {};
 
+    friend class ModelSkinningBatch;
+
+    /// Evaluates the cluster matrices of the meshes from the joint transforms, straight into destination.
+    /// Only touches this model's states so the skinning batch can run it on a worker thread.
+    virtual void computeClusterMatrices(glm::mat4* destination);
+
+    /// Posts the blender if the blendshapes changed and we're not currently waiting for one to finish.
+    void requestBlendIfNeeded();
+
+    /// Number of cluster matrices published to the render items through the skinning batch.
+    virtual uint32_t getNumRenderClusterMatrices() const { return _numClusterMatrices; }
+
+    /// Updates the render items with views on the published cluster matrices, found at offset in the pool.
+    virtual void updateRenderItemClusters(render::Transaction& transaction, const ClusterMatrixPoolPointer& pool, uint32_t offset);
+
+    uint32_t _numClusterMatrices { 0 };
+    std::vector<glm::mat4> _clusterMatrices;
+
 
 protected:
 
@@ -452,5 +482,32 @@ private:
     Mutex _mutex;
 };
 
+/// Evaluates the cluster matrices of all the models whose render items need an update, once per frame
+class ModelSkinningBatch : public Dependency {
+    SINGLETON_DEPENDENCY
+
+public:
+
+    /// Adds the specified model to the batch evaluated at the end of the application update.
+    void queueModel(const ModelPointer& model);
+
+    /// Evaluates the cluster matrices of the queued models in parallel into one shared pool,
+    /// and updates their render items with views on that pool.
+    void update();
+
+private:
+    using Mutex = std::mutex;
+    using Lock = std::unique_lock<Mutex>;
+
+    ModelSkinningBatch() {}
+
+    std::unordered_map<Model*, ModelWeakPointer> _queuedModels;
+    Mutex _mutex;
+
+    std::vector<ModelPointer> _models;
+    std::vector<uint32_t> _offsets;
+    ClusterMatrixBatch _batch;
+};
+
 
 #endif // hifi_Model_h
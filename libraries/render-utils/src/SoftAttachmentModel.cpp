@@ -31,21 +31,13 @@ int SoftAttachmentModel::getJointIndexOverride(int i) const {
 
 // virtual
 // use the _rigOverride matrices instead of the Model::_rig
-void SoftAttachmentModel::updateClusterMatrices() {
-    if (!_needsUpdateClusterMatrices) {
-        return;
-    }
-    if (!isLoaded()) {
-        return;
-    }
-
-    _needsUpdateClusterMatrices = false;
-
+void SoftAttachmentModel::computeClusterMatrices(glm::mat4* destination) {
     const FBXGeometry& geometry = getFBXGeometry();
 
     for (int i = 0; i < (int) _meshStates.size(); i++) {
-        MeshState& state = _meshStates[i];
+        const MeshState& state = _meshStates[i];
         const FBXMesh& mesh = geometry.meshes.at(i);
+        glm::mat4* clusterMatrices = destination + state.clusterOffset;
 
         for (int j = 0; j < mesh.clusters.size(); j++) {
             const FBXCluster& cluster = mesh.clusters.at(j);
@@ -58,13 +50,7 @@ void SoftAttachmentModel::updateClusterMatrices() {
             } else {
                 jointMatrix = _rig.getJointTransform(cluster.jointIndex);
             }
-            glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, state.clusterMatrices[j]);
+            glm_mat4u_mul(jointMatrix, cluster.inverseBindMatrix, clusterMatrices[j]);
         }
     }
-
-    // post the blender if we're not currently waiting for one to finish
-    if (geometry.hasBlendedMeshes() && _blendshapeCoefficients != _blendedBlendshapeCoefficients) {
-        _blendedBlendshapeCoefficients = _blendshapeCoefficients;
-        DependencyManager::get<ModelBlender>()->noteRequiresBlend(getThisPointer());
-    }
 }
@@ -27,9 +27,10 @@ public:
     ~SoftAttachmentModel();
 
     void updateRig(float deltaTime, glm::mat4 parentTransform) override;
-    void updateClusterMatrices() override;
 
 protected:
+    void computeClusterMatrices(glm::mat4* destination) override;
+
     int getJointIndexOverride(int i) const;
 
     const Rig& _rigOverride;
@@ -35,6 +35,7 @@ SpatiallyNestable::SpatiallyNestable(NestableType nestableType, QUuid id) :
 
 SpatiallyNestable::~SpatiallyNestable() {
     forEachChild([&](SpatiallyNestablePointer object) {
+        object->invalidateWorldTransform();
         object->parentDeleted();
     });
 }
@@ -66,12 +67,17 @@ const QUuid SpatiallyNestable::getParentID() const {
 }
 
 void SpatiallyNestable::setParentID(const QUuid& parentID) {
+    bool changed = false;
     _idLock.withWriteLock([&] {
         if (_parentID != parentID) {
             _parentID = parentID;
             _parentKnowsMe = false;
+            changed = true;
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
 
     bool success = false;
     getParentPointer(success);
@@ -117,6 +123,7 @@ SpatiallyNestablePointer SpatiallyNestable::getParentPointer(bool& success) cons
         parent->forgetChild(getThisPointer());
         _parentKnowsMe = false;
         _parent.reset();
+        invalidateWorldTransform();
     }
 
     // we have a _parentID but no parent pointer, or our parent pointer was to the wrong thing
@@ -132,6 +139,7 @@ SpatiallyNestablePointer SpatiallyNestable::getParentPointer(bool& success) cons
 
     parent = _parent.lock();
     if (parent) {
+        invalidateWorldTransform();
 
         // it's possible for an entity with a parent of AVATAR_SELF_ID can be imported into a side-tree
         // such as the clipboard's.  if this is the case, we don't want the parent to consider this a
@@ -160,7 +168,10 @@ void SpatiallyNestable::forgetChild(SpatiallyNestablePointer newChild) const {
 }
 
 void SpatiallyNestable::setParentJointIndex(quint16 parentJointIndex) {
-    _parentJointIndex = parentJointIndex;
+    if (_parentJointIndex != parentJointIndex) {
+        _parentJointIndex = parentJointIndex;
+        invalidateWorldTransform();
+    }
 }
 
 glm::vec3 SpatiallyNestable::worldToLocal(const glm::vec3& position,
@@ -405,6 +416,9 @@ void SpatiallyNestable::setWorldPosition(const glm::vec3& position, bool& succes
             _translationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -458,6 +472,9 @@ void SpatiallyNestable::setWorldOrientation(const glm::quat& orientation, bool&
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged(tellPhysics);
     }
@@ -592,15 +609,59 @@ glm::vec3 SpatiallyNestable::getParentAngularVelocity(bool& success) const {
 }
 
 const Transform SpatiallyNestable::getTransform(bool& success, int depth) const {
+    // the generation is read before anything the transform is computed from, so an invalidation racing with the
+    // computation below leaves behind an entry that is already out of date rather than a stale one that looks current
+    uint32_t generation = _worldTransformGeneration;
+    auto cached = std::atomic_load(&_cachedWorldTransform);
+    if (cached && cached->generation == generation) {
+        success = true;
+        return cached->transform;
+    }
+
     Transform result;
     // return a world-space transform for this object's location
-    Transform parentTransform = getParentTransform(success, depth);
+    Transform parentTransform;
+    bool cacheable = false;
+    SpatiallyNestablePointer parent = getParentPointer(success);
+    if (success) {
+        if (parent) {
+            parentTransform = parent->getTransform(_parentJointIndex, success, depth + 1);
+
+            // joints move without telling their children, and a parent that doesn't know us won't invalidate us
+            cacheable = success && _parentJointIndex == INVALID_JOINT_INDEX && _parentKnowsMe &&
+                parent->_worldTransformTracked;
+        } else {
+            cacheable = true;
+        }
+    }
     _transformLock.withReadLock([&] {
         Transform::mult(result, parentTransform, _transform);
     });
+
+    _worldTransformTracked = cacheable;
+    if (cacheable) {
+        std::atomic_store(&_cachedWorldTransform,
+                          std::make_shared<const CachedWorldTransform>(CachedWorldTransform { result, generation }));
+    }
     return result;
 }
 
+void SpatiallyNestable::invalidateWorldTransform() const {
+    invalidateWorldTransform(0);
+}
+
+void SpatiallyNestable::invalidateWorldTransform(int depth) const {
+    ++_worldTransformGeneration;
+
+    // children's world transforms are computed from ours.  Stop at the parenting chain limit in case of a loop,
+    // getTransform() breaks those.
+    if (depth < maxParentingChain) {
+        forEachChild([&](const SpatiallyNestablePointer& child) {
+            child->invalidateWorldTransform(depth + 1);
+        });
+    }
+}
+
 const Transform SpatiallyNestable::getTransform() const {
     bool success;
     Transform result = getTransform(success);
@@ -657,6 +718,9 @@ void SpatiallyNestable::setTransform(const Transform& transform, bool& success)
             _rotationChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -711,6 +775,9 @@ void SpatiallyNestable::setSNScale(const glm::vec3& scale, bool& success) {
             _scaleChanged = usecTimestampNow();
         }
     });
+    if (changed) {
+        invalidateWorldTransform();
+    }
     if (success && changed) {
         locationChanged();
     }
@@ -743,6 +810,7 @@ void SpatiallyNestable::setLocalTransform(const Transform& transform) {
     });
 
     if (changed) {
+        invalidateWorldTransform();
         locationChanged();
     }
 }
@@ -770,6 +838,7 @@ void SpatiallyNestable::setLocalPosition(const glm::vec3& position, bool tellPhy
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         locationChanged(tellPhysics);
     }
 }
@@ -797,6 +866,7 @@ void SpatiallyNestable::setLocalOrientation(const glm::quat& orientation) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         locationChanged();
     }
 }
@@ -853,6 +923,7 @@ void SpatiallyNestable::setLocalSNScale(const glm::vec3& scale) {
         }
     });
     if (changed) {
+        invalidateWorldTransform();
         dimensionsChanged();
     }
 }
@@ -1144,6 +1215,7 @@ void SpatiallyNestable::setLocalTransformAndVelocities(
     });
 
     if (changed) {
+        invalidateWorldTransform();
         locationChanged(false);
     }
 }
@@ -12,6 +12,9 @@
 #ifndef hifi_SpatiallyNestable_h
 #define hifi_SpatiallyNestable_h
 
+#include <atomic>
+#include <memory>
+
 #include <QUuid>
 
 #include "Transform.h"
@@ -78,6 +81,11 @@ public:
 
     virtual Transform getParentTransform(bool& success, int depth = 0) const;
 
+    // getTransform() caches the world transform of objects whose whole parent chain is made of plain (non-joint)
+    // parenting, every change along such a chain invalidates the caches below it.  Call this when something else
+    // the world transform depends on has changed.
+    void invalidateWorldTransform() const;
+
     virtual glm::vec3 getWorldPosition(bool& success) const;
     virtual glm::vec3 getWorldPosition() const;
     virtual void setWorldPosition(const glm::vec3& position, bool& success, bool tellPhysics = true);
@@ -231,6 +239,18 @@ private:
     mutable bool _parentKnowsMe { false };
     bool _isDead { false };
     bool _queryAACubeIsPuffed { false };
+
+    void invalidateWorldTransform(int depth) const;
+
+    struct CachedWorldTransform {
+        Transform transform;
+        uint32_t generation;
+    };
+
+    // read and written with std::atomic_load / std::atomic_store, valid while its generation is current
+    mutable std::shared_ptr<const CachedWorldTransform> _cachedWorldTransform;
+    mutable std::atomic<uint32_t> _worldTransformGeneration { 0 };
+    mutable std::atomic<bool> _worldTransformTracked { false }; // were all the changes our world transform depends on invalidating it
 };
 
 
@@ -12,6 +12,204 @@
 #include "GLMHelpers.h"
 #include "TriangleSet.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+//
+// LANE_WIDTH wide float vector used by the ray tests below.
+//
+
+static const int LANE_WIDTH = 4;
+
+// on x86 architecture, assume that SSE2 is present
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+struct Lanes {
+    __m128 v;
+};
+struct LaneMask {
+    __m128 v;
+};
+
+static inline Lanes load(const float* src) { return { _mm_loadu_ps(src) }; }
+static inline void store(float* dst, Lanes a) { _mm_storeu_ps(dst, a.v); }
+static inline Lanes splat(float a) { return { _mm_set1_ps(a) }; }
+static inline Lanes operator+(Lanes a, Lanes b) { return { _mm_add_ps(a.v, b.v) }; }
+static inline Lanes operator-(Lanes a, Lanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+static inline Lanes operator*(Lanes a, Lanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+static inline Lanes operator/(Lanes a, Lanes b) { return { _mm_div_ps(a.v, b.v) }; }
+static inline Lanes min(Lanes a, Lanes b) { return { _mm_min_ps(a.v, b.v) }; }
+static inline Lanes max(Lanes a, Lanes b) { return { _mm_max_ps(a.v, b.v) }; }
+static inline Lanes abs(Lanes a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+
+// a with the sign of b applied, i.e. -a where b is negative
+static inline Lanes mulSign(Lanes a, Lanes b) {
+    return { _mm_xor_ps(a.v, _mm_and_ps(b.v, _mm_set1_ps(-0.0f))) };
+}
+
+static inline LaneMask operator<=(Lanes a, Lanes b) { return { _mm_cmple_ps(a.v, b.v) }; }
+static inline LaneMask operator>=(Lanes a, Lanes b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+static inline LaneMask operator>(Lanes a, Lanes b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+static inline LaneMask operator&(LaneMask a, LaneMask b) { return { _mm_and_ps(a.v, b.v) }; }
+static inline int toBits(LaneMask a) { return _mm_movemask_ps(a.v); }
+
+#else   // portable reference code
+
+struct Lanes {
+    float v[LANE_WIDTH];
+};
+struct LaneMask {
+    bool v[LANE_WIDTH];
+};
+
+#define LANES_FOR_EACH(expr) Lanes r; for (int i = 0; i < LANE_WIDTH; i++) { r.v[i] = expr; } return r
+#define MASK_FOR_EACH(expr) LaneMask r; for (int i = 0; i < LANE_WIDTH; i++) { r.v[i] = expr; } return r
+
+static inline Lanes load(const float* src) { LANES_FOR_EACH(src[i]); }
+static inline void store(float* dst, Lanes a) { for (int i = 0; i < LANE_WIDTH; i++) { dst[i] = a.v[i]; } }
+static inline Lanes splat(float a) { LANES_FOR_EACH(a); }
+static inline Lanes operator+(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] + b.v[i]); }
+static inline Lanes operator-(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] - b.v[i]); }
+static inline Lanes operator*(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] * b.v[i]); }
+static inline Lanes operator/(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] / b.v[i]); }
+// same operand order as the SSE versions: b is returned when either is a NaN
+static inline Lanes min(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+static inline Lanes max(Lanes a, Lanes b) { LANES_FOR_EACH(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+static inline Lanes abs(Lanes a) { LANES_FOR_EACH(std::fabs(a.v[i])); }
+static inline Lanes mulSign(Lanes a, Lanes b) { LANES_FOR_EACH(std::signbit(b.v[i]) ? -a.v[i] : a.v[i]); }
+
+static inline LaneMask operator<=(Lanes a, Lanes b) { MASK_FOR_EACH(a.v[i] <= b.v[i]); }
+static inline LaneMask operator>=(Lanes a, Lanes b) { MASK_FOR_EACH(a.v[i] >= b.v[i]); }
+static inline LaneMask operator>(Lanes a, Lanes b) { MASK_FOR_EACH(a.v[i] > b.v[i]); }
+static inline LaneMask operator&(LaneMask a, LaneMask b) { MASK_FOR_EACH(a.v[i] && b.v[i]); }
+static inline int toBits(LaneMask a) {
+    int bits = 0;
+    for (int i = 0; i < LANE_WIDTH; i++) {
+        bits |= a.v[i] ? (1 << i) : 0;
+    }
+    return bits;
+}
+
+#undef LANES_FOR_EACH
+#undef MASK_FOR_EACH
+
+#endif
+
+struct LaneVec3 {
+    Lanes x, y, z;
+};
+
+static inline LaneVec3 load(const float src[3][LANE_WIDTH]) { return { load(src[0]), load(src[1]), load(src[2]) }; }
+static inline LaneVec3 splat(const glm::vec3& a) { return { splat(a.x), splat(a.y), splat(a.z) }; }
+static inline LaneVec3 operator-(const LaneVec3& a, const LaneVec3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+static inline Lanes dot(const LaneVec3& a, const LaneVec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static inline LaneVec3 cross(const LaneVec3& a, const LaneVec3& b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+// Möller–Trumbore, LANE_WIDTH ray/triangle pairs at a time.  Returns the mask of the pairs that intersect no farther
+// than maxDistance, their distances are stored in distances.  Degenerate triangles never intersect.
+static inline int intersectTriangles(const LaneVec3& v0, const LaneVec3& edge1, const LaneVec3& edge2,
+        const LaneVec3& origin, const LaneVec3& direction, Lanes maxDistance, bool allowBackface, float distances[LANE_WIDTH]) {
+    LaneVec3 p = cross(direction, edge2);
+    Lanes determinant = dot(edge1, p);
+    LaneVec3 s = origin - v0;
+    Lanes u = dot(s, p);
+    LaneVec3 q = cross(s, edge1);
+    Lanes v = dot(direction, q);
+    Lanes t = dot(edge2, q);
+
+    // u, v and t are still scaled by the determinant, which is positive when the ray hits the front face
+    if (allowBackface) {
+        u = mulSign(u, determinant);
+        v = mulSign(v, determinant);
+        t = mulSign(t, determinant);
+        determinant = abs(determinant);
+    }
+    const Lanes zero = splat(0.0f);
+    LaneMask hit = (determinant > zero) & (u >= zero) & (v >= zero) & (u + v <= determinant) &
+        (t >= zero) & (t <= maxDistance * determinant);
+
+    int bits = toBits(hit);
+    if (bits) {
+        store(distances, t / determinant);
+    }
+    return bits;
+}
+
+// slab test, LANE_WIDTH ray/box pairs at a time.  Returns the mask of the pairs that intersect no farther than
+// maxDistance, the distances at which the rays enter the boxes (0 for rays starting inside) are stored in distances.
+static inline int intersectBounds(const LaneVec3& minimum, const LaneVec3& maximum,
+        const LaneVec3& origin, const LaneVec3& inverseDirection, Lanes maxDistance, float distances[LANE_WIDTH]) {
+    Lanes nearDistance = splat(0.0f);
+    Lanes farDistance = maxDistance;
+
+    Lanes t0 = (minimum.x - origin.x) * inverseDirection.x;
+    Lanes t1 = (maximum.x - origin.x) * inverseDirection.x;
+    nearDistance = max(min(t0, t1), nearDistance);
+    farDistance = min(max(t0, t1), farDistance);
+
+    t0 = (minimum.y - origin.y) * inverseDirection.y;
+    t1 = (maximum.y - origin.y) * inverseDirection.y;
+    nearDistance = max(min(t0, t1), nearDistance);
+    farDistance = min(max(t0, t1), farDistance);
+
+    t0 = (minimum.z - origin.z) * inverseDirection.z;
+    t1 = (maximum.z - origin.z) * inverseDirection.z;
+    nearDistance = max(min(t0, t1), nearDistance);
+    farDistance = min(max(t0, t1), farDistance);
+
+    store(distances, nearDistance);
+    return toBits(nearDistance <= farDistance);
+}
+
+static const size_t MAX_LEAF_TRIANGLES = 2 * LANE_WIDTH;
+static const int MAX_BVH_DEPTH = 48;
+static const int MAX_TRAVERSAL_STACK = (MAX_BVH_DEPTH + 1) * (LANE_WIDTH - 1) + 1;
+static const int NUM_SAH_BINS = 16;
+
+struct TriangleSet::BuildTriangle {
+    glm::vec3 minimum;
+    glm::vec3 maximum;
+    glm::vec3 centroid;
+    uint32_t index;
+};
+
+namespace {
+
+struct TraversalEntry {
+    int32_t child;
+    uint32_t numPackets;
+    float distance;
+};
+
+// pushes the hit children of a node farthest first, so that the nearest one is traversed first and
+// tightens the best distance for the others
+template <typename Node>
+void pushChildren(const Node& node, int hits, const float distances[LANE_WIDTH], TraversalEntry* stack, int& stackSize) {
+    int begin = stackSize;
+    for (int i = 0; i < node.numChildren; i++) {
+        if (hits & (1 << i)) {
+            TraversalEntry entry { node.child[i], node.numPackets[i], distances[i] };
+            int j = stackSize++;
+            while (j > begin && stack[j - 1].distance < entry.distance) {
+                stack[j] = stack[j - 1];
+                j--;
+            }
+            stack[j] = entry;
+        }
+    }
+}
+
+float halfArea(const glm::vec3& minimum, const glm::vec3& maximum) {
+    glm::vec3 dimensions = maximum - minimum;
+    return dimensions.x * dimensions.y + dimensions.y * dimensions.z + dimensions.z * dimensions.x;
+}
+
+}
 
 void TriangleSet::insert(const Triangle& t) {
     _isBalanced = false;
@@ -27,7 +225,8 @@ void TriangleSet::clear() {
     _bounds.clear();
     _isBalanced = false;
 
-    _triangleOctree.clear();
+    _nodes.clear();
+    _packets.clear();
 }
 
 bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
@@ -37,18 +236,115 @@ bool TriangleSet::findRayIntersection(const glm::vec3& origin, const glm::vec3&
     distance = std::numeric_limits<float>::max();
 
     if (!_isBalanced) {
-        balanceOctree();
+        balanceTree();
     }
 
-    int trianglesTouched = 0;
-    auto result = _triangleOctree.findRayIntersection(origin, direction, distance, face, surfaceNormal, precision, trianglesTouched, allowBackface);
+    float boundsDistance;
+    BoxFace boundsFace;
+    glm::vec3 boundsNormal;
+    if (_nodes.empty() || !_bounds.findRayIntersection(origin, direction, boundsDistance, boundsFace, boundsNormal)) {
+        return false;
+    }
+    if (!precision) {
+        distance = boundsDistance;
+        face = boundsFace;
+        surfaceNormal = boundsNormal;
+        return true;
+    }
 
-    #if WANT_DEBUGGING
-    if (precision) {
-        qDebug() << "trianglesTouched :" << trianglesTouched << "out of:" << _triangleOctree._population << "_triangles.size:" << _triangles.size();
+    float bestDistance;
+    uint32_t bestTriangle;
+    if (!traceRay(origin, direction, allowBackface, bestDistance, bestTriangle)) {
+        return false;
+    }
+    distance = bestDistance;
+    face = boundsFace;
+    surfaceNormal = _triangles[bestTriangle].getNormal();
+    return true;
+}
+
+bool TriangleSet::traceRay(const glm::vec3& origin, const glm::vec3& direction, bool allowBackface,
+    float& distance, uint32_t& triangle) const {
+
+    const LaneVec3 rayOrigin = splat(origin);
+    const LaneVec3 rayDirection = splat(direction);
+    const LaneVec3 inverseDirection = splat(1.0f / direction);
+
+    float bestDistance = std::numeric_limits<float>::max();
+    bool intersects = false;
+
+    TraversalEntry stack[MAX_TRAVERSAL_STACK];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, 0, 0.0f };
+    float distances[LANE_WIDTH];
+
+    while (stackSize > 0) {
+        const TraversalEntry entry = stack[--stackSize];
+        if (entry.distance > bestDistance) {
+            continue;
+        }
+
+        if (BVHNode::isLeaf(entry.child)) {
+            int32_t end = ~entry.child + (int32_t)entry.numPackets;
+            for (int32_t i = ~entry.child; i < end; i++) {
+                const TrianglePacket& packet = _packets[i];
+                int hits = intersectTriangles(load(packet.v0), load(packet.edge1), load(packet.edge2),
+                    rayOrigin, rayDirection, splat(bestDistance), allowBackface, distances);
+                for (int lane = 0; hits; lane++, hits >>= 1) {
+                    if ((hits & 1) && distances[lane] < bestDistance) {
+                        bestDistance = distances[lane];
+                        triangle = packet.triangle[lane];
+                        intersects = true;
+                    }
+                }
+            }
+            continue;
+        }
+
+        const BVHNode& node = _nodes[entry.child];
+        int hits = intersectBounds(load(node.bounds), load(node.bounds + 3), rayOrigin, inverseDirection,
+            splat(bestDistance), distances);
+        hits &= (1 << node.numChildren) - 1;
+        pushChildren(node, hits, distances, stack, stackSize);
+    }
+
+    if (intersects) {
+        distance = bestDistance;
+    }
+    return intersects;
+}
+
+void TriangleSet::findRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+    std::vector<RayIntersection>& results, bool precision, bool allowBackface) {
+
+    assert(origins.size() == directions.size());
+    results.assign(origins.size(), RayIntersection());
+
+    if (!_isBalanced) {
+        balanceTree();
+    }
+    if (_nodes.empty()) {
+        return;
+    }
+
+    for (size_t i = 0; i < origins.size(); i++) {
+        RayIntersection& result = results[i];
+        float boundsDistance;
+        if (!_bounds.findRayIntersection(origins[i], directions[i], boundsDistance, result.face, result.surfaceNormal)) {
+            continue;
+        }
+        if (!precision) {
+            result.intersects = true;
+            result.distance = boundsDistance;
+            continue;
+        }
+
+        uint32_t triangle;
+        if (traceRay(origins[i], directions[i], allowBackface, result.distance, triangle)) {
+            result.intersects = true;
+            result.surfaceNormal = _triangles[triangle].getNormal();
+        }
     }
-    #endif
-    return result;
 }
 
 bool TriangleSet::convexHullContains(const glm::vec3& point) const {
@@ -71,17 +367,27 @@ bool TriangleSet::convexHullContains(const glm::vec3& point) const {
 void TriangleSet::debugDump() {
     qDebug() << __FUNCTION__;
     qDebug() << "bounds:" << getBounds();
-    qDebug() << "triangles:" << size() << "at top level....";
-    qDebug() << "----- _triangleOctree -----";
-    _triangleOctree.debugDump();
+    qDebug() << "triangles:" << size() << "nodes:" << _nodes.size() << "packets:" << _packets.size();
 }
 
-void TriangleSet::balanceOctree() {
-    _triangleOctree.reset(_bounds, 0);
-
-    // insert all the triangles
-    for (size_t i = 0; i < _triangles.size(); i++) {
-        _triangleOctree.insert(i);
+void TriangleSet::balanceTree() {
+    static_assert(BVH_WIDTH == LANE_WIDTH, "a BVH node is tested with one vector of lanes");
+
+    _nodes.clear();
+    _packets.clear();
+
+    if (!_triangles.empty()) {
+        std::vector<BuildTriangle> buildTriangles(_triangles.size());
+        for (size_t i = 0; i < _triangles.size(); i++) {
+            const Triangle& triangle = _triangles[i];
+            BuildTriangle& buildTriangle = buildTriangles[i];
+            buildTriangle.minimum = glm::min(triangle.v0, glm::min(triangle.v1, triangle.v2));
+            buildTriangle.maximum = glm::max(triangle.v0, glm::max(triangle.v1, triangle.v2));
+            buildTriangle.centroid = 0.5f * (buildTriangle.minimum + buildTriangle.maximum);
+            buildTriangle.index = (uint32_t)i;
+        }
+        _packets.reserve(2 * _triangles.size() / LANE_WIDTH + 1);
+        buildNode(buildTriangles, 0, buildTriangles.size(), 0);
     }
 
     _isBalanced = true;
@@ -91,176 +397,157 @@ void TriangleSet::balanceOctree() {
     #endif
 }
 
+// Splits [begin, end) in two along the axis where the triangle centroids spread the most, at the bin boundary with
+// the lowest surface area heuristic cost.  Returns end if the centroids can't be told apart.
+size_t TriangleSet::splitTriangles(std::vector<BuildTriangle>& triangles, size_t begin, size_t end) {
+    glm::vec3 centroidMinimum(std::numeric_limits<float>::max());
+    glm::vec3 centroidMaximum(-std::numeric_limits<float>::max());
+    for (size_t i = begin; i < end; i++) {
+        centroidMinimum = glm::min(centroidMinimum, triangles[i].centroid);
+        centroidMaximum = glm::max(centroidMaximum, triangles[i].centroid);
+    }
+    glm::vec3 extent = centroidMaximum - centroidMinimum;
+    int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+    if (!(extent[axis] > 0.0f)) {
+        return end;
+    }
 
-// Determine of the given ray (origin/direction) in model space intersects with any triangles
-// in the set. If an intersection occurs, the distance and surface normal will be provided.
-bool TriangleSet::TriangleOctreeCell::findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
-            float& distance, BoxFace& face, glm::vec3& surfaceNormal, bool precision, int& trianglesTouched, bool allowBackface) {
-
-    bool intersectedSomething = false;
-    float boxDistance = distance;
-    float bestDistance = distance;
-
-    if (_bounds.findRayIntersection(origin, direction, boxDistance, face, surfaceNormal)) {
+    struct Bin {
+        glm::vec3 minimum { std::numeric_limits<float>::max() };
+        glm::vec3 maximum { -std::numeric_limits<float>::max() };
+        size_t count { 0 };
+    };
+    Bin bins[NUM_SAH_BINS];
+    const float binScale = (float)NUM_SAH_BINS / extent[axis];
+    auto binOf = [&](const BuildTriangle& triangle) {
+        return std::min((int)((triangle.centroid[axis] - centroidMinimum[axis]) * binScale), NUM_SAH_BINS - 1);
+    };
+    for (size_t i = begin; i < end; i++) {
+        Bin& bin = bins[binOf(triangles[i])];
+        bin.minimum = glm::min(bin.minimum, triangles[i].minimum);
+        bin.maximum = glm::max(bin.maximum, triangles[i].maximum);
+        bin.count++;
+    }
 
-        // if our bounding box intersects at a distance greater than the current known
-        // best distance, and our origin isn't inside the boounds, then we can safely 
-        // not check any of our triangles
-        if (boxDistance > bestDistance && !_bounds.contains(origin)) {
-            return false;
+    // cost of everything right of each bin boundary, then sweep from the left for the cheapest boundary
+    float rightCosts[NUM_SAH_BINS];
+    Bin side;
+    for (int boundary = NUM_SAH_BINS - 1; boundary > 0; boundary--) {
+        side.minimum = glm::min(side.minimum, bins[boundary].minimum);
+        side.maximum = glm::max(side.maximum, bins[boundary].maximum);
+        side.count += bins[boundary].count;
+        rightCosts[boundary] = side.count > 0 ? halfArea(side.minimum, side.maximum) * side.count : 0.0f;
+    }
+    const size_t count = end - begin;
+    float bestCost = std::numeric_limits<float>::max();
+    int bestBoundary = 0;
+    side = Bin();
+    for (int boundary = 1; boundary < NUM_SAH_BINS; boundary++) {
+        side.minimum = glm::min(side.minimum, bins[boundary - 1].minimum);
+        side.maximum = glm::max(side.maximum, bins[boundary - 1].maximum);
+        side.count += bins[boundary - 1].count;
+        if (side.count == 0 || side.count == count) {
+            continue;
         }
-
-        if (precision) {
-            for (const auto& triangleIndex : _triangleIndices) {
-                const auto& triangle = _allTriangles[triangleIndex];
-                float thisTriangleDistance;
-                trianglesTouched++;
-                if (findRayTriangleIntersection(origin, direction, triangle, thisTriangleDistance, allowBackface)) {
-                    if (thisTriangleDistance < bestDistance) {
-                        bestDistance = thisTriangleDistance;
-                        intersectedSomething = true;
-                        surfaceNormal = triangle.getNormal();
-                        distance = bestDistance;
-                    }
-                }
-            }
-        } else {
-            intersectedSomething = true;
-            distance = boxDistance;
+        float cost = halfArea(side.minimum, side.maximum) * side.count + rightCosts[boundary];
+        if (cost < bestCost) {
+            bestCost = cost;
+            bestBoundary = boundary;
         }
     }
+    if (bestBoundary == 0) {
+        return end;
+    }
 
-    return intersectedSomething;
-}
-
-static const int MAX_DEPTH = 4; // for now
-static const int MAX_CHILDREN = 8;
-
-TriangleSet::TriangleOctreeCell::TriangleOctreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth) :
-    _allTriangles(allTriangles)
-{
-    reset(bounds, depth);
-}
-
-void TriangleSet::TriangleOctreeCell::clear() {
-    _population = 0;
-    _triangleIndices.clear();
-    _bounds.clear();
-    _children.clear();
-}
-
-void TriangleSet::TriangleOctreeCell::reset(const AABox& bounds, int depth) {
-    clear();
-    _bounds = bounds;
-    _depth = depth;
+    auto middle = std::partition(triangles.begin() + begin, triangles.begin() + end,
+        [&](const BuildTriangle& triangle) { return binOf(triangle) < bestBoundary; });
+    return middle - triangles.begin();
 }
 
-void TriangleSet::TriangleOctreeCell::debugDump() {
-    qDebug() << __FUNCTION__;
-    qDebug() << "bounds:" << getBounds();
-    qDebug() << "depth:" << _depth;
-    qDebug() << "population:" << _population << "this level or below" 
-             << " ---- triangleIndices:" << _triangleIndices.size() << "in this cell";
-
-    qDebug() << "child cells:" << _children.size();
-    if (_depth < MAX_DEPTH) {
-        int childNum = 0;
-        for (auto& child : _children) {
-            qDebug() << "child:" << childNum;
-            child.second.debugDump();
-            childNum++;
+int32_t TriangleSet::buildNode(std::vector<BuildTriangle>& triangles, size_t begin, size_t end, int depth) {
+    int32_t nodeIndex = (int32_t)_nodes.size();
+    _nodes.emplace_back();
+
+    // split the range into up to BVH_WIDTH parts, the most populated part first
+    struct Part {
+        size_t begin;
+        size_t end;
+        bool canSplit;
+    };
+    Part parts[BVH_WIDTH];
+    int numParts = 0;
+    parts[numParts++] = { begin, end, true };
+    while (numParts < BVH_WIDTH) {
+        int largest = -1;
+        for (int i = 0; i < numParts; i++) {
+            size_t count = parts[i].end - parts[i].begin;
+            if (parts[i].canSplit && count > MAX_LEAF_TRIANGLES &&
+                    (largest < 0 || count > parts[largest].end - parts[largest].begin)) {
+                largest = i;
+            }
+        }
+        if (largest < 0) {
+            break;
         }
+        size_t middle = splitTriangles(triangles, parts[largest].begin, parts[largest].end);
+        if (middle == parts[largest].begin || middle == parts[largest].end) {
+            parts[largest].canSplit = false;
+            continue;
+        }
+        parts[numParts++] = { middle, parts[largest].end, true };
+        parts[largest].end = middle;
     }
-}
-
-void TriangleSet::TriangleOctreeCell::insert(size_t triangleIndex) {
-    const Triangle& triangle = _allTriangles[triangleIndex];
-    _population++;
-    // if we're not yet at the max depth, then check which child the triangle fits in
-    if (_depth < MAX_DEPTH) {
-
-        for (int child = 0; child < MAX_CHILDREN; child++) {
-            AABox childBounds = getBounds().getOctreeChild((AABox::OctreeChild)child);
 
+    for (int i = 0; i < numParts; i++) {
+        const Part& part = parts[i];
+        glm::vec3 minimum(std::numeric_limits<float>::max());
+        glm::vec3 maximum(-std::numeric_limits<float>::max());
+        for (size_t j = part.begin; j < part.end; j++) {
+            minimum = glm::min(minimum, triangles[j].minimum);
+            maximum = glm::max(maximum, triangles[j].maximum);
+        }
 
-            // if the child AABox would contain the triangle...
-            if (childBounds.contains(triangle)) {
-                // if the child cell doesn't yet exist, create it...
-                if (_children.find((AABox::OctreeChild)child) == _children.end()) {
-                    _children.insert(
-                        std::pair<AABox::OctreeChild, TriangleOctreeCell>
-                        ((AABox::OctreeChild)child, TriangleOctreeCell(_allTriangles, childBounds, _depth + 1)));
-                }
+        size_t count = part.end - part.begin;
+        int32_t child;
+        uint32_t numPackets = 0;
+        if (count <= MAX_LEAF_TRIANGLES || !part.canSplit || depth >= MAX_BVH_DEPTH) {
+            child = buildLeaf(triangles, part.begin, part.end);
+            numPackets = (uint32_t)((count + LANE_WIDTH - 1) / LANE_WIDTH);
+        } else {
+            child = buildNode(triangles, part.begin, part.end, depth + 1);
+        }
 
-                // insert the triangleIndex in the child cell
-                _children.at((AABox::OctreeChild)child).insert(triangleIndex);
-                return;
-            }
+        // the recursion above may have moved _nodes
+        BVHNode& node = _nodes[nodeIndex];
+        for (int axis = 0; axis < 3; axis++) {
+            node.bounds[axis][i] = minimum[axis];
+            node.bounds[axis + 3][i] = maximum[axis];
         }
+        node.child[i] = child;
+        node.numPackets[i] = numPackets;
     }
-    // either we're at max depth, or the triangle doesn't fit in one of our
-    // children and so we want to just record it here
-    _triangleIndices.push_back(triangleIndex);
+    _nodes[nodeIndex].numChildren = numParts;
+    return nodeIndex;
 }
 
-bool TriangleSet::TriangleOctreeCell::findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
-                float& distance, BoxFace& face, glm::vec3& surfaceNormal, bool precision, int& trianglesTouched, bool allowBackface) {
-
-    if (_population < 1) {
-        return false; // no triangles below here, so we can't intersect
-    }
-
-    float bestLocalDistance = distance;
-    BoxFace bestLocalFace;
-    glm::vec3 bestLocalNormal;
-    bool intersects = false;
-
-    // if the ray intersects our bounding box, then continue
-    if (getBounds().findRayIntersection(origin, direction, bestLocalDistance, bestLocalFace, bestLocalNormal)) {
-
-        // if the intersection with our bounding box, is greater than the current best distance (the distance passed in)
-        // then we know that none of our triangles can represent a better intersection and we can return
-
-        if (bestLocalDistance > distance) {
-            return false;
-        }
-
-        bestLocalDistance = distance;
-
-        float childDistance = distance;
-        BoxFace childFace;
-        glm::vec3 childNormal;
-
-        // if we're not yet at the max depth, then check which child the triangle fits in
-        if (_depth < MAX_DEPTH) {
-            for (auto& child : _children) {
-                // check each child, if there's an intersection, it will return some distance that we need
-                // to compare against the other results, because there might be multiple intersections and
-                // we will always choose the best (shortest) intersection
-                if (child.second.findRayIntersection(origin, direction, childDistance, childFace, childNormal, precision, trianglesTouched)) {
-                    if (childDistance < bestLocalDistance) {
-                        bestLocalDistance = childDistance;
-                        bestLocalFace = childFace;
-                        bestLocalNormal = childNormal;
-                        intersects = true;
-                    }
-                }
-            }
-        }
-        // also check our local triangle set
-        if (findRayIntersectionInternal(origin, direction, childDistance, childFace, childNormal, precision, trianglesTouched, allowBackface)) {
-            if (childDistance < bestLocalDistance) {
-                bestLocalDistance = childDistance;
-                bestLocalFace = childFace;
-                bestLocalNormal = childNormal;
-                intersects = true;
+int32_t TriangleSet::buildLeaf(std::vector<BuildTriangle>& triangles, size_t begin, size_t end) {
+    int32_t firstPacket = (int32_t)_packets.size();
+    for (size_t i = begin; i < end; i += LANE_WIDTH) {
+        // zero initialized, so the unused lanes hold degenerate triangles
+        _packets.emplace_back();
+        TrianglePacket& packet = _packets.back();
+        for (int lane = 0; lane < LANE_WIDTH && i + lane < end; lane++) {
+            uint32_t index = triangles[i + lane].index;
+            const Triangle& triangle = _triangles[index];
+            glm::vec3 edge1 = triangle.v1 - triangle.v0;
+            glm::vec3 edge2 = triangle.v2 - triangle.v0;
+            for (int axis = 0; axis < 3; axis++) {
+                packet.v0[axis][lane] = triangle.v0[axis];
+                packet.edge1[axis][lane] = edge1[axis];
+                packet.edge2[axis][lane] = edge2[axis];
             }
+            packet.triangle[lane] = index;
         }
     }
-    if (intersects) {
-        distance = bestLocalDistance;
-        face = bestLocalFace;
-        surfaceNormal = bestLocalNormal;
-    }
-    return intersects;
+    return ~firstPacket;
 }
@@ -9,81 +9,85 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <limits>
 #include <vector>
 
 #include "AABox.h"
 #include "GeometryUtil.h"
 
 class TriangleSet {
-
-    class TriangleOctreeCell {
-    public:
-        TriangleOctreeCell(std::vector<Triangle>& allTriangles) :
-            _allTriangles(allTriangles)
-        { }
-
-        void insert(size_t triangleIndex);
-        void reset(const AABox& bounds, int depth = 0);
-        void clear();
-
-        bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
-            float& distance, BoxFace& face, glm::vec3& surfaceNormal, bool precision, int& trianglesTouched, bool allowBackface = false);
-
-        const AABox& getBounds() const { return _bounds; }
-
-        void debugDump();
-
-    protected:
-        TriangleOctreeCell(std::vector<Triangle>& allTriangles, const AABox& bounds, int depth);
-
-        // checks our internal list of triangles
-        bool findRayIntersectionInternal(const glm::vec3& origin, const glm::vec3& direction,
-            float& distance, BoxFace& face, glm::vec3& surfaceNormal, bool precision, int& trianglesTouched, bool allowBackface = false);
-
-        std::vector<Triangle>& _allTriangles;
-        std::map<AABox::OctreeChild, TriangleOctreeCell> _children;
-        int _depth{ 0 };
-        int _population{ 0 };
-        AABox _bounds;
-        std::vector<size_t> _triangleIndices;
-
-        friend class TriangleSet;
-    };
-
 public:
-    TriangleSet() :
-        _triangleOctree(_triangles)
-    {}
-
     void debugDump();
 
     void insert(const Triangle& t);
 
+    // Determine if the given ray (origin/direction) in model space intersects with any triangles in the set. If an
+    // intersection occurs, the distance and surface normal will be provided.  Without precision only the bounds of
+    // the set are tested.
+    // note: this might side-effect internal structures
     bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
         float& distance, BoxFace& face, glm::vec3& surfaceNormal, bool precision, bool allowBackface = false);
 
-    void balanceOctree();
+    struct RayIntersection {
+        bool intersects { false };
+        float distance { std::numeric_limits<float>::max() };
+        BoxFace face { UNKNOWN_FACE };
+        glm::vec3 surfaceNormal;
+    };
+
+    // Same as findRayIntersection() for a batch of rays, such as all the picks of a frame that hit the same model.
+    // results[i] is the result of origins[i] and directions[i].
+    // note: this might side-effect internal structures
+    void findRayIntersections(const std::vector<glm::vec3>& origins, const std::vector<glm::vec3>& directions,
+        std::vector<RayIntersection>& results, bool precision, bool allowBackface = false);
+
+    // builds the BVH, done by the first ray query after the set has changed
+    void balanceTree();
 
     void reserve(size_t size) { _triangles.reserve(size); } // reserve space in the datastructure for size number of triangles
     size_t size() const { return _triangles.size(); }
     void clear();
 
-    // Determine if the given ray (origin/direction) in model space intersects with any triangles in the set. If an 
-    // intersection occurs, the distance and surface normal will be provided.
-    // note: this might side-effect internal structures
-    bool findRayIntersection(const glm::vec3& origin, const glm::vec3& direction,
-        float& distance, BoxFace& face, glm::vec3& surfaceNormal, bool precision, int& trianglesTouched);
-
     // Determine if a point is "inside" all the triangles of a convex hull. It is the responsibility of the caller to
-    // determine that the triangle set is indeed a convex hull. If the triangles added to this set are not in fact a 
+    // determine that the triangle set is indeed a convex hull. If the triangles added to this set are not in fact a
     // convex hull, the result of this method is meaningless and undetermined.
     bool convexHullContains(const glm::vec3& point) const;
     const AABox& getBounds() const { return _bounds; }
 
 protected:
+    // The triangles are kept in a 4-wide bounding volume hierarchy, built with the surface area heuristic and stored
+    // in two flat arrays.  Each node holds the bounds of its (up to) 4 children as structure-of-arrays so a ray is
+    // tested against all of them at once.  The triangles of a leaf are stored the same way, 4 to a packet.
+    static const int BVH_WIDTH = 4;
+
+    struct BVHNode {
+        float bounds[6][BVH_WIDTH];     // min x, y, z then max x, y, z of each child
+        int32_t child[BVH_WIDTH];       // index of a child node, or ~(index of the first packet) for leaves
+        uint32_t numPackets[BVH_WIDTH]; // leaves only
+        int numChildren { 0 };
+
+        static bool isLeaf(int32_t child) { return child < 0; }
+    };
+
+    struct TrianglePacket {
+        float v0[3][BVH_WIDTH];
+        float edge1[3][BVH_WIDTH];      // v1 - v0
+        float edge2[3][BVH_WIDTH];      // v2 - v0
+        uint32_t triangle[BVH_WIDTH];   // index in _triangles, unused lanes hold degenerate triangles
+    };
+
+    // nearest triangle hit by the ray, the set must be balanced
+    bool traceRay(const glm::vec3& origin, const glm::vec3& direction, bool allowBackface,
+        float& distance, uint32_t& triangle) const;
+
+    struct BuildTriangle;
+    static size_t splitTriangles(std::vector<BuildTriangle>& triangles, size_t begin, size_t end);
+    int32_t buildNode(std::vector<BuildTriangle>& triangles, size_t begin, size_t end, int depth);
+    int32_t buildLeaf(std::vector<BuildTriangle>& triangles, size_t begin, size_t end);
 
-    bool _isBalanced{ false };
-    TriangleOctreeCell _triangleOctree;
+    bool _isBalanced { false };
     std::vector<Triangle> _triangles;
+    std::vector<BVHNode> _nodes;
+    std::vector<TrianglePacket> _packets;
     AABox _bounds;
 };
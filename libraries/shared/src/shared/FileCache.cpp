@@ -274,6 +274,12 @@ void FileCache::eject(FilePointer file) {
     }
 }
 
+void FileCache::removeFile(const FilePointer& file) {
+    Lock lock(_mutex);
+    eject(file);
+    emit dirty();
+}
+
 void FileCache::clean() {
     size_t overbudgetAmount = getOverbudgetAmount();
 
@@ -102,6 +102,10 @@ public:
     /// create a file
     virtual std::unique_ptr<File> createFile(Metadata&& metadata, const std::string& filepath);
 
+protected:
+    /// drop a file from the cache, it is unlinked once the last reference to it is released
+    void removeFile(const FilePointer& file);
+
 private:
     using Mutex = std::recursive_mutex;
     using Lock = std::unique_lock<Mutex>;
@@ -44,9 +44,14 @@ public:
         _encodedSize = (AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * sizeof(int16_t) * numChannels) / 4;  // codec reduces by 1/4th
     }
 
-    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
-        encodedBuffer.resize(_encodedSize);
-        AudioEncoder::process((const int16_t*)decodedBuffer.constData(), (int16_t*)encodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+    virtual int getMaxEncodedSize(int numSamples) const override { return _encodedSize; }
+
+    virtual int encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) override {
+        if (encodedCapacity < _encodedSize) {
+            return -1;
+        }
+        AudioEncoder::process(samples, (int16_t*)encoded, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
+        return _encodedSize;
     }
 private:
     int _encodedSize;
@@ -55,21 +60,29 @@ private:
 class HiFiDecoder : public Decoder, public AudioDecoder {
 public:
     HiFiDecoder(int sampleRate, int numChannels) : AudioDecoder(sampleRate, numChannels) { 
-        _decodedSize = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * sizeof(int16_t) * numChannels;
+        _decodedSamples = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * numChannels;
     }
 
-    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
-        decodedBuffer.resize(_decodedSize);
-        AudioDecoder::process((const int16_t*)encodedBuffer.constData(), (int16_t*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, true);
+    virtual int getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const override { return _decodedSamples; }
+
+    virtual int decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) override {
+        if (maxSamples < _decodedSamples) {
+            return -1;
+        }
+        AudioDecoder::process((const int16_t*)encoded, samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, true);
+        return _decodedSamples;
     }
 
-    virtual void lostFrame(QByteArray& decodedBuffer) override {
-        decodedBuffer.resize(_decodedSize);
+    virtual int lostFrame(int16_t* samples, int maxSamples) override {
+        if (maxSamples < _decodedSamples) {
+            return -1;
+        }
         // this performs packet loss interpolation
-        AudioDecoder::process(nullptr, (int16_t*)decodedBuffer.data(), AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, false);
+        AudioDecoder::process(nullptr, samples, AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL, false);
+        return _decodedSamples;
     }
 private:
-    int _decodedSize;
+    int _decodedSamples;
 };
 
 Encoder* HiFiCodec::createEncoder(int sampleRate, int numChannels) {
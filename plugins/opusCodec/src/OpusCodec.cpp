@@ -0,0 +1,225 @@
+//
+//  OpusCodec.cpp
+//  plugins/opusCodec/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OpusCodec.h"
+
+#include <algorithm>
+
+#include <QtCore/QLoggingCategory>
+
+#include <opus/opus.h>
+
+#include <AudioConstants.h>
+
+Q_DECLARE_LOGGING_CATEGORY(codec_opus)
+Q_LOGGING_CATEGORY(codec_opus, "hifi.codec.opus")
+
+const char* OpusCodec::NAME { "opus" };
+const int OpusCodec::DEFAULT_BITRATE { 64000 };
+
+// largest packet opus produces for a single frame
+static const int MAX_OPUS_PACKET_SIZE = 1275;
+
+// the mixer runs one encoder per listener, a mid complexity keeps its CPU use close to the other codecs
+static const int ENCODER_COMPLEXITY = 5;
+
+// released coders kept around for reuse, beyond this they are freed
+static const size_t MAX_POOLED_CODERS = 256;
+
+class OpusAudioEncoder : public Encoder {
+public:
+    OpusAudioEncoder(int sampleRate, int numChannels) : _sampleRate(sampleRate), _numChannels(numChannels) {
+        int error = OPUS_OK;
+        // the low delay mode skips the speech layer, which suits 10 ms frames of mixed, spatialized audio
+        _encoder = opus_encoder_create(sampleRate, numChannels, OPUS_APPLICATION_RESTRICTED_LOWDELAY, &error);
+        if (error != OPUS_OK) {
+            qCWarning(codec_opus) << "Failed to create encoder:" << opus_strerror(error);
+            _encoder = nullptr;
+            return;
+        }
+        opus_encoder_ctl(_encoder, OPUS_SET_COMPLEXITY(ENCODER_COMPLEXITY));
+    }
+
+    virtual ~OpusAudioEncoder() {
+        if (_encoder) {
+            opus_encoder_destroy(_encoder);
+        }
+    }
+
+    bool isValid() const { return _encoder != nullptr; }
+    bool matches(int sampleRate, int numChannels) const {
+        return _sampleRate == sampleRate && _numChannels == numChannels;
+    }
+
+    void reset(int bitrate) {
+        opus_encoder_ctl(_encoder, OPUS_RESET_STATE);
+        opus_encoder_ctl(_encoder, OPUS_SET_BITRATE(bitrate));
+    }
+
+    virtual int getMaxEncodedSize(int numSamples) const override {
+        return std::min(numSamples * (int)sizeof(int16_t), MAX_OPUS_PACKET_SIZE);
+    }
+
+    virtual int encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) override {
+        int encodedSize = opus_encode(_encoder, samples, numSamples / _numChannels,
+            encoded, std::min(encodedCapacity, MAX_OPUS_PACKET_SIZE));
+        return (encodedSize >= 0) ? encodedSize : -1;
+    }
+
+private:
+    OpusEncoder* _encoder { nullptr };
+    const int _sampleRate;
+    const int _numChannels;
+};
+
+class OpusAudioDecoder : public Decoder {
+public:
+    OpusAudioDecoder(int sampleRate, int numChannels) : _sampleRate(sampleRate), _numChannels(numChannels) {
+        int error = OPUS_OK;
+        _decoder = opus_decoder_create(sampleRate, numChannels, &error);
+        if (error != OPUS_OK) {
+            qCWarning(codec_opus) << "Failed to create decoder:" << opus_strerror(error);
+            _decoder = nullptr;
+        }
+    }
+
+    virtual ~OpusAudioDecoder() {
+        if (_decoder) {
+            opus_decoder_destroy(_decoder);
+        }
+    }
+
+    bool isValid() const { return _decoder != nullptr; }
+    bool matches(int sampleRate, int numChannels) const {
+        return _sampleRate == sampleRate && _numChannels == numChannels;
+    }
+
+    void reset() {
+        opus_decoder_ctl(_decoder, OPUS_RESET_STATE);
+    }
+
+    virtual int getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const override {
+        if (encoded && encodedSize > 0) {
+            int samplesPerChannel = opus_packet_get_nb_samples(encoded, encodedSize, _sampleRate);
+            if (samplesPerChannel > 0) {
+                return samplesPerChannel * _numChannels;
+            }
+        }
+        return AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL * _numChannels;
+    }
+
+    virtual int decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) override {
+        int samplesPerChannel = opus_decode(_decoder, encoded, encodedSize, samples, maxSamples / _numChannels, 0);
+        return (samplesPerChannel >= 0) ? samplesPerChannel * _numChannels : -1;
+    }
+
+    virtual int lostFrame(int16_t* samples, int maxSamples) override {
+        // a partial frame would leave the concealment out of step with the stream
+        int frameSize = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+        if (maxSamples < frameSize * _numChannels) {
+            return -1;
+        }
+        // a null packet asks opus to conceal the loss from its current state
+        int samplesPerChannel = opus_decode(_decoder, nullptr, 0, samples, frameSize, 0);
+        return (samplesPerChannel >= 0) ? samplesPerChannel * _numChannels : -1;
+    }
+
+private:
+    OpusDecoder* _decoder { nullptr };
+    const int _sampleRate;
+    const int _numChannels;
+};
+
+OpusCodec::OpusCodec() : _bitrate(DEFAULT_BITRATE) {
+}
+
+OpusCodec::~OpusCodec() {
+}
+
+void OpusCodec::init() {
+}
+
+void OpusCodec::deinit() {
+}
+
+bool OpusCodec::activate() {
+    CodecPlugin::activate();
+    return true;
+}
+
+void OpusCodec::deactivate() {
+    CodecPlugin::deactivate();
+}
+
+bool OpusCodec::isSupported() const {
+    return true;
+}
+
+Encoder* OpusCodec::createEncoder(int sampleRate, int numChannels) {
+    std::unique_ptr<OpusAudioEncoder> encoder;
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        auto it = std::find_if(_encoderPool.rbegin(), _encoderPool.rend(),
+            [&](const std::unique_ptr<OpusAudioEncoder>& pooled) { return pooled->matches(sampleRate, numChannels); });
+        if (it != _encoderPool.rend()) {
+            encoder = std::move(*it);
+            _encoderPool.erase(std::next(it).base());
+        }
+    }
+
+    if (!encoder) {
+        encoder.reset(new OpusAudioEncoder(sampleRate, numChannels));
+        if (!encoder->isValid()) {
+            return nullptr;
+        }
+    }
+
+    encoder->reset(_bitrate);
+    return encoder.release();
+}
+
+Decoder* OpusCodec::createDecoder(int sampleRate, int numChannels) {
+    std::unique_ptr<OpusAudioDecoder> decoder;
+    {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        auto it = std::find_if(_decoderPool.rbegin(), _decoderPool.rend(),
+            [&](const std::unique_ptr<OpusAudioDecoder>& pooled) { return pooled->matches(sampleRate, numChannels); });
+        if (it != _decoderPool.rend()) {
+            decoder = std::move(*it);
+            _decoderPool.erase(std::next(it).base());
+        }
+    }
+
+    if (!decoder) {
+        decoder.reset(new OpusAudioDecoder(sampleRate, numChannels));
+        if (!decoder->isValid()) {
+            return nullptr;
+        }
+    }
+
+    decoder->reset();
+    return decoder.release();
+}
+
+void OpusCodec::releaseEncoder(Encoder* encoder) {
+    std::unique_ptr<OpusAudioEncoder> released(static_cast<OpusAudioEncoder*>(encoder));
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    if (released && _encoderPool.size() < MAX_POOLED_CODERS) {
+        _encoderPool.push_back(std::move(released));
+    }
+}
+
+void OpusCodec::releaseDecoder(Decoder* decoder) {
+    std::unique_ptr<OpusAudioDecoder> released(static_cast<OpusAudioDecoder*>(decoder));
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    if (released && _decoderPool.size() < MAX_POOLED_CODERS) {
+        _decoderPool.push_back(std::move(released));
+    }
+}
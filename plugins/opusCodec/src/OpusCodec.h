@@ -0,0 +1,64 @@
+//
+//  OpusCodec.h
+//  plugins/opusCodec/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OpusCodec_h
+#define hifi_OpusCodec_h
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <plugins/CodecPlugin.h>
+
+class OpusAudioEncoder;
+class OpusAudioDecoder;
+
+class OpusCodec : public CodecPlugin {
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_BITRATE;
+
+    OpusCodec();
+    virtual ~OpusCodec();
+
+    // Plugin functions
+    bool isSupported() const override;
+    const QString getName() const override { return NAME; }
+
+    void init() override;
+    void deinit() override;
+
+    /// Called when a plugin is being activated for use.  May be called multiple times.
+    bool activate() override;
+    /// Called when a plugin is no longer being used.  May be called multiple times.
+    void deactivate() override;
+
+    virtual Encoder* createEncoder(int sampleRate, int numChannels) override;
+    virtual Decoder* createDecoder(int sampleRate, int numChannels) override;
+    virtual void releaseEncoder(Encoder* encoder) override;
+    virtual void releaseDecoder(Decoder* decoder) override;
+
+    virtual void setBitrate(int bitrate) override { _bitrate = bitrate; }
+
+private:
+    static const char* NAME;
+
+    std::atomic<int> _bitrate;
+
+    // Coders of departed listeners are reset and kept for the next ones, so a mixer with clients coming and going
+    // doesn't allocate and initialize codec state on every connection.
+    std::mutex _poolMutex;
+    std::vector<std::unique_ptr<OpusAudioEncoder>> _encoderPool;
+    std::vector<std::unique_ptr<OpusAudioDecoder>> _decoderPool;
+};
+
+#endif // hifi_OpusCodec_h
@@ -9,8 +9,11 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <qapplication.h>
 
+#include <AudioConstants.h>
 #include <PerfStat.h>
 
 #include "PCMCodecManager.h"
@@ -55,6 +58,29 @@ void PCMCodec::releaseDecoder(Decoder* decoder) {
     // do nothing
 }
 
+int PCMCodec::encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) {
+    int encodedSize = numSamples * (int)sizeof(int16_t);
+    if (encodedSize > encodedCapacity) {
+        return -1;
+    }
+    memcpy(encoded, samples, encodedSize);
+    return encodedSize;
+}
+
+int PCMCodec::decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) {
+    int numSamples = encodedSize / (int)sizeof(int16_t);
+    if (numSamples > maxSamples) {
+        return -1;
+    }
+    memcpy(samples, encoded, numSamples * sizeof(int16_t));
+    return numSamples;
+}
+
+int PCMCodec::lostFrame(int16_t* samples, int maxSamples) {
+    memset(samples, 0, maxSamples * sizeof(int16_t));
+    return maxSamples;
+}
+
 const char* zLibCodec::NAME { "zlib" };
 
 void zLibCodec::init() {
@@ -92,3 +118,58 @@ void zLibCodec::releaseDecoder(Decoder* decoder) {
     // do nothing... it wasn't allocated
 }
 
+// qCompress prefixes its output with the uncompressed length, as a big endian 32 bit integer
+static const int QCOMPRESS_HEADER_SIZE = 4;
+
+int zLibCodec::getMaxEncodedSize(int numSamples) const {
+    // zlib's compressBound() plus the qCompress header
+    int decodedSize = numSamples * (int)sizeof(int16_t);
+    return decodedSize + (decodedSize >> 12) + (decodedSize >> 14) + (decodedSize >> 25) + 13 + QCOMPRESS_HEADER_SIZE;
+}
+
+int zLibCodec::encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) {
+    // qCompress only produces a QByteArray, so this still copies into the caller's buffer
+    QByteArray compressed = qCompress(reinterpret_cast<const uchar*>(samples), numSamples * (int)sizeof(int16_t));
+    if (compressed.size() > encodedCapacity) {
+        return -1;
+    }
+    memcpy(encoded, compressed.constData(), compressed.size());
+    return compressed.size();
+}
+
+// the uncompressed length claimed by the qCompress header, or -1 if there is no header or the length is more than a frame
+static int readDecodedSize(const uint8_t* encoded, int encodedSize) {
+    static const uint32_t MAX_DECODED_SIZE = AudioConstants::NETWORK_FRAME_BYTES_STEREO;
+    if (encodedSize < QCOMPRESS_HEADER_SIZE) {
+        return -1;
+    }
+    uint32_t decodedSize = ((uint32_t)encoded[0] << 24) | ((uint32_t)encoded[1] << 16) |
+        ((uint32_t)encoded[2] << 8) | (uint32_t)encoded[3];
+    return decodedSize <= MAX_DECODED_SIZE ? (int)decodedSize : -1;
+}
+
+int zLibCodec::getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const {
+    return std::max(readDecodedSize(encoded, encodedSize), 0) / (int)sizeof(int16_t);
+}
+
+int zLibCodec::decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) {
+    // qUncompress allocates whatever the header claims, so a corrupt or hostile header is rejected before it runs
+    int decodedSize = readDecodedSize(encoded, encodedSize);
+    if (decodedSize < 0 || decodedSize / (int)sizeof(int16_t) > maxSamples) {
+        return -1;
+    }
+
+    QByteArray decompressed = qUncompress(encoded, encodedSize);
+    int numSamples = decompressed.size() / (int)sizeof(int16_t);
+    if (numSamples > maxSamples) {
+        return -1;
+    }
+    memcpy(samples, decompressed.constData(), numSamples * sizeof(int16_t));
+    return numSamples;
+}
+
+int zLibCodec::lostFrame(int16_t* samples, int maxSamples) {
+    memset(samples, 0, maxSamples * sizeof(int16_t));
+    return maxSamples;
+}
+
@@ -35,17 +35,15 @@ public:
     virtual void releaseEncoder(Encoder* encoder) override;
     virtual void releaseDecoder(Decoder* decoder) override;
 
-    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
-        encodedBuffer = decodedBuffer;
-    }
-
-    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
-        decodedBuffer = encodedBuffer;
-    }
+    virtual int getMaxEncodedSize(int numSamples) const override { return numSamples * (int)sizeof(int16_t); }
+    virtual int encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) override;
+    virtual bool isStateless() const override { return true; }
 
-    virtual void lostFrame(QByteArray& decodedBuffer) override {
-        memset(decodedBuffer.data(), 0, decodedBuffer.size());
+    virtual int getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const override {
+        return encodedSize / (int)sizeof(int16_t);
     }
+    virtual int decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) override;
+    virtual int lostFrame(int16_t* samples, int maxSamples) override;
 
 private:
     static const char* NAME;
@@ -72,17 +70,13 @@ public:
     virtual void releaseEncoder(Encoder* encoder) override;
     virtual void releaseDecoder(Decoder* decoder) override;
 
-    virtual void encode(const QByteArray& decodedBuffer, QByteArray& encodedBuffer) override {
-        encodedBuffer = qCompress(decodedBuffer);
-    }
+    virtual int getMaxEncodedSize(int numSamples) const override;
+    virtual int encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) override;
+    virtual bool isStateless() const override { return true; }
 
-    virtual void decode(const QByteArray& encodedBuffer, QByteArray& decodedBuffer) override {
-        decodedBuffer = qUncompress(encodedBuffer);
-    }
-
-    virtual void lostFrame(QByteArray& decodedBuffer) override {
-        memset(decodedBuffer.data(), 0, decodedBuffer.size());
-    }
+    virtual int getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const override;
+    virtual int decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) override;
+    virtual int lostFrame(int16_t* samples, int maxSamples) override;
 
 private:
     static const char* NAME;
@@ -0,0 +1,295 @@
+//
+//  AnimPoseBatchTests.cpp
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AnimPoseBatchTests.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <AnimCrowd.h>
+#include <AnimPoseBatch.h>
+#include <AnimSkeleton.h>
+#include <AnimUtil.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AnimPoseBatchTests)
+
+const float EPSILON = 0.0001f;
+const int NUM_JOINTS = 60;  // about the size of a full avatar skeleton
+
+static float randFloat(float min, float max) {
+    return min + (max - min) * ((float)qrand() / (float)RAND_MAX);
+}
+
+static AnimPose randPose() {
+    glm::vec3 axis = glm::normalize(glm::vec3(randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(0.1f, 1.0f)));
+    glm::quat rot = glm::angleAxis(randFloat(-PI, PI), axis);
+    glm::vec3 trans(randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f), randFloat(-1.0f, 1.0f));
+    // skeletons are uniformly scaled
+    return AnimPose(glm::vec3(randFloat(0.5f, 2.0f)), rot, trans);
+}
+
+static AnimPoseVec randPoses(int numJoints) {
+    AnimPoseVec poses;
+    for (int i = 0; i < numJoints; i++) {
+        poses.push_back(randPose());
+    }
+    return poses;
+}
+
+static float poseError(const AnimPose& a, const AnimPose& b) {
+    // q and -q are the same rotation
+    float rotError = 1.0f - fabsf(glm::dot(a.rot(), b.rot()));
+    return glm::max(glm::max(glm::distance(a.scale(), b.scale()), glm::distance(a.trans(), b.trans())), rotError);
+}
+
+// a simple tree, every joint hangs off one of the joints before it.
+static AnimSkeleton::Pointer makeTestSkeleton(int numJoints) {
+    std::vector<FBXJoint> joints;
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.translation = glm::vec3(0.0f);
+    joint.preTransform = glm::mat4();
+    joint.preRotation = glm::quat();
+    joint.rotation = glm::quat();
+    joint.postRotation = glm::quat();
+    joint.postTransform = glm::mat4();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.inverseDefaultRotation = glm::quat();
+    joint.inverseBindRotation = glm::quat();
+    joint.isSkeletonJoint = true;
+
+    for (int i = 0; i < numJoints; i++) {
+        joint.name = QString("joint%1").arg(i);
+        joint.parentIndex = i - 1 - (i % 3 == 2 ? 1 : 0);
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.transform = (joint.parentIndex >= 0 ? joints[joint.parentIndex].transform : glm::mat4()) * glm::translate(joint.translation);
+        joint.bindTransform = joint.transform;
+        joints.push_back(joint);
+    }
+    return std::make_shared<AnimSkeleton>(joints);
+}
+
+void AnimPoseBatchTests::testGetSetPoses() {
+    const int NUM_AVATARS = 5;
+    AnimPoseBatch batch(NUM_JOINTS, NUM_AVATARS);
+    QCOMPARE(batch.getStride() % AnimPoseBatch::LANE_WIDTH, 0);
+    QVERIFY(batch.getStride() >= NUM_AVATARS);
+
+    // freshly sized batches hold identity poses
+    QVERIFY(poseError(batch.getPose(NUM_JOINTS - 1, NUM_AVATARS - 1), AnimPose::identity) < EPSILON);
+
+    std::vector<AnimPoseVec> poses;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        poses.push_back(randPoses(NUM_JOINTS));
+        batch.setPoses(i, poses.back());
+    }
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        AnimPoseVec result;
+        batch.getPoses(i, result);
+        QCOMPARE((int)result.size(), NUM_JOINTS);
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            QVERIFY(poseError(result[j], poses[i][j]) < EPSILON);
+        }
+    }
+}
+
+void AnimPoseBatchTests::testBlend() {
+    // not a multiple of LANE_WIDTH, to cover the padding lanes
+    const int NUM_AVATARS = 7;
+    AnimPoseBatch a(NUM_JOINTS, NUM_AVATARS);
+    AnimPoseBatch b(NUM_JOINTS, NUM_AVATARS);
+    AnimPoseBatch result(NUM_JOINTS, NUM_AVATARS);
+    std::vector<AnimPoseVec> aPoses, bPoses;
+    std::vector<float> alphas;
+    std::vector<float> jointWeights;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        aPoses.push_back(randPoses(NUM_JOINTS));
+        bPoses.push_back(randPoses(NUM_JOINTS));
+        a.setPoses(i, aPoses.back());
+        b.setPoses(i, bPoses.back());
+        alphas.push_back(randFloat(0.0f, 1.0f));
+    }
+    for (int j = 0; j < NUM_JOINTS; j++) {
+        jointWeights.push_back(j % 2 ? 1.0f : 0.5f);
+    }
+
+    ::blend(a, b, alphas.data(), result);
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        AnimPoseVec expected(NUM_JOINTS);
+        ::blend(NUM_JOINTS, &aPoses[i][0], &bPoses[i][0], alphas[i], &expected[0]);
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            QVERIFY(poseError(result.getPose(j, i), expected[j]) < EPSILON);
+        }
+    }
+
+    // in place, with per joint weights, the way AnimOverlay blends
+    ::blend(a, b, alphas.data(), jointWeights, a);
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            AnimPose expected;
+            ::blend(1, &aPoses[i][j], &bPoses[i][j], alphas[i] * jointWeights[j], &expected);
+            QVERIFY(poseError(a.getPose(j, i), expected) < EPSILON);
+        }
+    }
+}
+
+void AnimPoseBatchTests::testSampleFrames() {
+    const int NUM_AVATARS = 6;
+    const int NUM_FRAMES = 10;
+    std::vector<AnimPoseVec> frames;
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        frames.push_back(randPoses(NUM_JOINTS));
+    }
+
+    std::vector<int> prevIndices, nextIndices;
+    std::vector<float> alphas;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        prevIndices.push_back(i);
+        nextIndices.push_back((i + 1) % NUM_FRAMES);
+        alphas.push_back(randFloat(0.0f, 1.0f));
+    }
+
+    AnimPoseBatch result(NUM_JOINTS, NUM_AVATARS);
+    ::sampleFrames(frames, prevIndices.data(), nextIndices.data(), alphas.data(), result);
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        AnimPoseVec expected(NUM_JOINTS);
+        ::blend(NUM_JOINTS, &frames[prevIndices[i]][0], &frames[nextIndices[i]][0], alphas[i], &expected[0]);
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            QVERIFY(poseError(result.getPose(j, i), expected[j]) < EPSILON);
+        }
+    }
+}
+
+void AnimPoseBatchTests::testConvertRelativePosesToAbsolute() {
+    const int NUM_AVATARS = 9;
+    AnimSkeleton::Pointer skeleton = makeTestSkeleton(NUM_JOINTS);
+
+    AnimPoseBatch batch(NUM_JOINTS, NUM_AVATARS);
+    std::vector<AnimPoseVec> poses;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        poses.push_back(randPoses(NUM_JOINTS));
+        batch.setPoses(i, poses.back());
+        skeleton->convertRelativePosesToAbsolute(poses.back());
+    }
+    skeleton->convertRelativePosesToAbsolute(batch);
+
+    // error accumulates down the hierarchy, so compare with a looser tolerance
+    const float ABSOLUTE_POSE_EPSILON = 0.005f;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            QVERIFY(poseError(batch.getPose(j, i), poses[i][j]) < ABSOLUTE_POSE_EPSILON);
+        }
+    }
+}
+
+void AnimPoseBatchTests::testCrowd() {
+    const int NUM_AVATARS = 7;
+    const int NUM_FRAMES = 10;
+    const float DT = 1.0f / 45.0f;
+
+    auto clip = std::make_shared<AnimCrowdClip>();
+    clip->skeleton = makeTestSkeleton(NUM_JOINTS);
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        clip->frames.push_back(randPoses(NUM_JOINTS));
+    }
+
+    AnimCrowd crowd(clip, NUM_AVATARS);
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        crowd.setFrame(i, i * 1.3f);
+    }
+
+    // run past the end of the clip, so every avatar loops at least once
+    const float ABSOLUTE_POSE_EPSILON = 0.005f;
+    const int NUM_UPDATES = 20;
+    for (int update = 1; update <= NUM_UPDATES; update++) {
+        crowd.update(DT);
+
+        for (int i = 0; i < NUM_AVATARS; i++) {
+            // the same clip, sampled and converted avatar by avatar
+            const float FRAME_EPSILON = 0.001f;
+            float expectedFrame = fmodf(i * 1.3f + update * DT * AnimCrowdClip::DEFAULT_FPS, (float)(NUM_FRAMES - 1));
+            QVERIFY(fabsf(crowd.getFrame(i) - expectedFrame) < FRAME_EPSILON);
+
+            int prevIndex = (int)crowd.getFrame(i);
+            int nextIndex = std::min(prevIndex + 1, NUM_FRAMES - 1);
+            AnimPoseVec expected(NUM_JOINTS);
+            ::blend(NUM_JOINTS, &clip->frames[prevIndex][0], &clip->frames[nextIndex][0], glm::fract(crowd.getFrame(i)),
+                    &expected[0]);
+            for (int j = 0; j < NUM_JOINTS; j++) {
+                QVERIFY(poseError(crowd.getRelativePoses().getPose(j, i), expected[j]) < EPSILON);
+            }
+
+            clip->skeleton->convertRelativePosesToAbsolute(expected);
+            for (int j = 0; j < NUM_JOINTS; j++) {
+                QVERIFY(poseError(crowd.getAbsolutePoses().getPose(j, i), expected[j]) < ABSOLUTE_POSE_EPSILON);
+            }
+        }
+    }
+}
+
+void AnimPoseBatchTests::benchmarkCrowd_data() {
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("perAvatar") << false;
+    QTest::newRow("batched") << true;
+}
+
+// sample two clips, blend them per avatar and convert to absolute, for a crowd of avatars on the same skeleton.
+void AnimPoseBatchTests::benchmarkCrowd() {
+    QFETCH(bool, batched);
+
+    const int NUM_AVATARS = 64;
+    const int NUM_FRAMES = 30;
+    AnimSkeleton::Pointer skeleton = makeTestSkeleton(NUM_JOINTS);
+    std::vector<AnimPoseVec> idle, walk;
+    for (int f = 0; f < NUM_FRAMES; f++) {
+        idle.push_back(randPoses(NUM_JOINTS));
+        walk.push_back(randPoses(NUM_JOINTS));
+    }
+    std::vector<int> prevIndices, nextIndices;
+    std::vector<float> frameAlphas, blendAlphas;
+    for (int i = 0; i < NUM_AVATARS; i++) {
+        prevIndices.push_back(i % NUM_FRAMES);
+        nextIndices.push_back((i + 1) % NUM_FRAMES);
+        frameAlphas.push_back(randFloat(0.0f, 1.0f));
+        blendAlphas.push_back(randFloat(0.0f, 1.0f));
+    }
+
+    int iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    if (batched) {
+        AnimPoseBatch idlePoses(NUM_JOINTS, NUM_AVATARS);
+        AnimPoseBatch walkPoses(NUM_JOINTS, NUM_AVATARS);
+        QBENCHMARK {
+            ::sampleFrames(idle, prevIndices.data(), nextIndices.data(), frameAlphas.data(), idlePoses);
+            ::sampleFrames(walk, prevIndices.data(), nextIndices.data(), frameAlphas.data(), walkPoses);
+            ::blend(idlePoses, walkPoses, blendAlphas.data(), idlePoses);
+            skeleton->convertRelativePosesToAbsolute(idlePoses);
+            iterations++;
+        }
+    } else {
+        AnimPoseVec idlePoses(NUM_JOINTS);
+        AnimPoseVec walkPoses(NUM_JOINTS);
+        QBENCHMARK {
+            for (int i = 0; i < NUM_AVATARS; i++) {
+                ::blend(NUM_JOINTS, &idle[prevIndices[i]][0], &idle[nextIndices[i]][0], frameAlphas[i], &idlePoses[0]);
+                ::blend(NUM_JOINTS, &walk[prevIndices[i]][0], &walk[nextIndices[i]][0], frameAlphas[i], &walkPoses[0]);
+                ::blend(NUM_JOINTS, &idlePoses[0], &walkPoses[0], blendAlphas[i], &idlePoses[0]);
+                skeleton->convertRelativePosesToAbsolute(idlePoses);
+            }
+            iterations++;
+        }
+    }
+    double elapsedMsecs = (double)timer.nsecsElapsed() / (double)(NSECS_PER_USEC * USECS_PER_MSEC);
+    if (elapsedMsecs > 0.0) {
+        qDebug() << (batched ? "batched:" : "per avatar:") << (NUM_AVATARS * iterations) / elapsedMsecs << "avatars per ms";
+    }
+}
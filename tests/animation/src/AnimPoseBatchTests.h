@@ -0,0 +1,27 @@
+//
+//  AnimPoseBatchTests.h
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AnimPoseBatchTests_h
+#define hifi_AnimPoseBatchTests_h
+
+#include <QtTest/QtTest>
+
+class AnimPoseBatchTests : public QObject {
+    Q_OBJECT
+private slots:
+    void testGetSetPoses();
+    void testBlend();
+    void testSampleFrames();
+    void testConvertRelativePosesToAbsolute();
+    void testCrowd();
+    void benchmarkCrowd_data();
+    void benchmarkCrowd();
+};
+
+#endif // hifi_AnimPoseBatchTests_h
@@ -15,6 +15,12 @@
 #include <AnimVariant.h>
 #include <AnimExpression.h>
 #include <AnimUtil.h>
+#include <AnimOverlay.h>
+#include <AnimDefaultPose.h>
+#include <NumericalConstants.h>
+#include <Rig.h>
+
+#include <glm/gtx/transform.hpp>
 
 #include <../QTestExtensions.h>
 
@@ -236,6 +242,124 @@ void AnimTests::testVariant() {
     QVERIFY(q.z == 4.0f);
 }
 
+void AnimTests::testVariantMap() {
+    AnimVariantKey alphaKey("alpha");
+    QVERIFY(alphaKey.isValid());
+    QVERIFY(alphaKey == AnimVariantKey(QString("alpha")));
+    QVERIFY(alphaKey.getName() == "alpha");
+    QVERIFY(!AnimVariantKey("").isValid());
+    QVERIFY(AnimVariantKey::findSlot("neverInternedByAnyone") == -1);
+
+    AnimVariantMap vars;
+    QVERIFY(!vars.hasKey(alphaKey));
+    QVERIFY(vars.lookup(alphaKey, 2.0f) == 2.0f);
+
+    vars.set(alphaKey, 0.5f);
+    vars.set("position", glm::vec3(1.0f, 2.0f, 3.0f));
+    QVERIFY(vars.hasKey("alpha"));
+    QVERIFY(vars.lookup("alpha", 2.0f) == 0.5f);
+    QVERIFY(vars.lookupRaw("position", glm::vec3()) == glm::vec3(1.0f, 2.0f, 3.0f));
+
+    // empty keys are never stored, and invalid keys are ignored by every accessor
+    vars.set("", 1.0f);
+    QVERIFY(!vars.hasKey(""));
+    AnimVariantKey invalidKey;
+    vars.unset(invalidKey);
+    vars.setTrigger(invalidKey);
+    QVERIFY(!vars.hasKey(invalidKey));
+    QVERIFY(vars.lookup(invalidKey, 3.0f) == 3.0f);
+
+    // triggers answer true until cleared, without touching the stored value
+    vars.set("jump", false);
+    vars.setTrigger("jump");
+    QVERIFY(vars.lookup("jump", false) == true);
+    vars.clearTriggers();
+    QVERIFY(vars.lookup("jump", true) == false);
+
+    vars.unset(alphaKey);
+    QVERIFY(!vars.hasKey(alphaKey));
+    QVERIFY(vars.hasKey("position"));
+
+    AnimVariantMap other;
+    other.set("alpha", 0.25f);
+    vars.copyVariantsFrom(other);
+    QVERIFY(vars.lookup(alphaKey, 2.0f) == 0.25f);
+    QVERIFY(vars.hasKey("position"));
+
+    vars.clearMap();
+    QVERIFY(!vars.hasKey(alphaKey));
+    QVERIFY(!vars.hasKey("position"));
+}
+
+// Rig only builds its graph from json, let the benchmark hand it one directly
+class BenchmarkRig : public Rig {
+public:
+    void setAnimNode(const AnimNode::Pointer& node) {
+        _animNode = node;
+        _animNode->setSkeleton(_animSkeleton);
+    }
+};
+
+static FBXGeometry makeBenchmarkGeometry(int numJoints) {
+    FBXGeometry geometry;
+    FBXJoint joint;
+    joint.isFree = false;
+    joint.distanceToParent = 1.0f;
+    joint.preTransform = glm::mat4();
+    joint.preRotation = glm::quat();
+    joint.rotation = glm::quat();
+    joint.postRotation = glm::quat();
+    joint.postTransform = glm::mat4();
+    joint.rotationMin = glm::vec3(-PI);
+    joint.rotationMax = glm::vec3(PI);
+    joint.inverseDefaultRotation = glm::quat();
+    joint.inverseBindRotation = glm::quat();
+    joint.isSkeletonJoint = true;
+
+    for (int i = 0; i < numJoints; i++) {
+        joint.name = QString("joint%1").arg(i);
+        joint.parentIndex = i - 1;
+        joint.translation = glm::vec3(0.0f, 0.1f, 0.0f);
+        joint.transform = (i > 0 ? geometry.joints[i - 1].transform : glm::mat4()) * glm::translate(joint.translation);
+        joint.bindTransform = joint.transform;
+        geometry.joints.push_back(joint);
+        geometry.jointIndices.insert(joint.name, i + 1);
+    }
+    return geometry;
+}
+
+void AnimTests::benchmarkRigUpdateAnimations() {
+    const int NUM_JOINTS = 60;  // about the size of a full avatar skeleton
+    const float DELTA_TIME = 1.0f / 60.0f;
+
+    BenchmarkRig rig;
+    rig.initJointStates(makeBenchmarkGeometry(NUM_JOINTS), glm::mat4());
+
+    // a small graph that reads the vars the rig writes every frame, the way the default avatar graph does
+    auto overlay = std::make_shared<AnimOverlay>("defaultPoseOverlay", AnimOverlay::FullBodyBoneSet, 0.0f);
+    overlay->setAlphaVar("defaultPoseOverlayAlpha");
+    overlay->setBoneSetVar("defaultPoseOverlayBoneSet");
+    overlay->addChild(std::make_shared<AnimDefaultPose>("defaultPose"));
+    auto moveForward = std::make_shared<AnimBlendLinear>("moveForward", 0.0f);
+    moveForward->setAlphaVar("moveForwardAlpha");
+    for (int i = 0; i < 3; i++) {
+        moveForward->addChild(std::make_shared<AnimDefaultPose>(QString("walk%1").arg(i)));
+    }
+    overlay->addChild(moveForward);
+    rig.setAnimNode(overlay);
+
+    glm::vec3 position;
+    glm::vec3 velocity(0.0f, 0.0f, -1.4f);
+    glm::quat rotation;
+    QBENCHMARK {
+        // what the avatar does every frame: set the motion vars, then evaluate the graph
+        position += velocity * DELTA_TIME;
+        rig.computeMotionAnimationState(DELTA_TIME, position, velocity, rotation, Rig::CharacterControllerState::Ground);
+        rig.updateAnimations(DELTA_TIME, glm::mat4(), glm::mat4());
+    }
+    QCOMPARE(rig.getJointStateCount(), NUM_JOINTS);
+}
+
 void AnimTests::testAccumulateTime() {
 
     float startFrame = 0.0f;
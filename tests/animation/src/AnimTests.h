@@ -25,6 +25,8 @@ private slots:
     void testClipEvaulateWithVars();
     void testLoader();
     void testVariant();
+    void testVariantMap();
+    void benchmarkRigUpdateAnimations();
     void testAccumulateTime();
     void testAnimPose();
     void testExpressionTokenizer();
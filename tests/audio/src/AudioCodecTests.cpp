@@ -0,0 +1,232 @@
+//
+//  AudioCodecTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioCodecTests.h"
+
+#include <cmath>
+
+#include <AudioConstants.h>
+#include <NLPacket.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <plugins/CodecPlugin.h>
+
+#include <OpusCodec.h>
+
+QTEST_MAIN(AudioCodecTests)
+
+// a stand-in with the cost profile of the pcm codec
+class RawCodec : public Encoder, public Decoder {
+public:
+    int getMaxEncodedSize(int numSamples) const override { return numSamples * (int)sizeof(int16_t); }
+
+    int encode(const int16_t* samples, int numSamples, uint8_t* encoded, int encodedCapacity) override {
+        int encodedSize = numSamples * (int)sizeof(int16_t);
+        if (encodedSize > encodedCapacity) {
+            return -1;
+        }
+        memcpy(encoded, samples, encodedSize);
+        return encodedSize;
+    }
+
+    int getMaxDecodedSamples(const uint8_t* encoded, int encodedSize) const override {
+        return encoded ? encodedSize / (int)sizeof(int16_t) : AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+    }
+
+    int decode(const uint8_t* encoded, int encodedSize, int16_t* samples, int maxSamples) override {
+        int numSamples = encodedSize / (int)sizeof(int16_t);
+        if (numSamples > maxSamples) {
+            return -1;
+        }
+        memcpy(samples, encoded, numSamples * sizeof(int16_t));
+        return numSamples;
+    }
+
+    int lostFrame(int16_t* samples, int maxSamples) override {
+        memset(samples, 0, maxSamples * sizeof(int16_t));
+        return maxSamples;
+    }
+};
+
+static void fillFrame(int16_t* samples, int frame) {
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; i++) {
+        samples[i] = (int16_t)(frame * 7 + i);
+    }
+}
+
+void AudioCodecTests::byteArrayRoundTripTest() {
+    RawCodec codec;
+    Encoder& encoder = codec;
+    Decoder& decoder = codec;
+
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+    fillFrame(samples, 1);
+    QByteArray decodedBuffer(reinterpret_cast<const char*>(samples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    QByteArray encodedBuffer;
+    encoder.encode(decodedBuffer, encodedBuffer);
+    QCOMPARE(encodedBuffer.size(), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    QByteArray roundTripBuffer;
+    decoder.decode(encodedBuffer, roundTripBuffer);
+    QCOMPARE(roundTripBuffer, decodedBuffer);
+
+    QByteArray lostBuffer;
+    decoder.lostFrame(lostBuffer);
+    QCOMPARE(lostBuffer, QByteArray(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 0));
+
+    // a destination that is too small is reported rather than overrun
+    uint8_t tooSmall[16];
+    QCOMPARE(encoder.encode(samples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, tooSmall, sizeof(tooSmall)), -1);
+}
+
+// a 440 Hz tone on the left, 660 Hz on the right, continuing from frame to frame
+static void fillToneFrame(int16_t* samples, int frame) {
+    const float AMPLITUDE = 8000.0f;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; i++) {
+        float t = (float)(frame * AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL + i) / AudioConstants::SAMPLE_RATE;
+        samples[2 * i] = (int16_t)(AMPLITUDE * sinf(TWO_PI * 440.0f * t));
+        samples[2 * i + 1] = (int16_t)(AMPLITUDE * sinf(TWO_PI * 660.0f * t));
+    }
+}
+
+static float rms(const int16_t* samples, int numSamples) {
+    double sum = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        sum += (double)samples[i] * samples[i];
+    }
+    return numSamples > 0 ? (float)sqrt(sum / numSamples) : 0.0f;
+}
+
+void AudioCodecTests::opusCodecTest() {
+    const int NUM_FRAMES = 50;
+    const int FRAME_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+    const int16_t SENTINEL = 0x5a5a;
+
+    OpusCodec codec;
+    auto encoder = codec.createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    auto decoder = codec.createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    QVERIFY(encoder);
+    QVERIFY(decoder);
+    QVERIFY(!encoder->isStateless());
+
+    int16_t samples[FRAME_SAMPLES];
+    std::vector<uint8_t> encoded(encoder->getMaxEncodedSize(FRAME_SAMPLES));
+    QVERIFY(encoded.size() < (size_t)AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    int16_t decoded[FRAME_SAMPLES + 1];
+    int encodedSize = 0;
+    float inputRMS = 0.0f;
+    float outputRMS = 0.0f;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        fillToneFrame(samples, frame);
+        encodedSize = encoder->encode(samples, FRAME_SAMPLES, encoded.data(), (int)encoded.size());
+        QVERIFY(encodedSize > 0);
+        QVERIFY(encodedSize <= (int)encoded.size());
+        QCOMPARE(decoder->getMaxDecodedSamples(encoded.data(), encodedSize), FRAME_SAMPLES);
+
+        decoded[FRAME_SAMPLES] = SENTINEL;
+        QCOMPARE(decoder->decode(encoded.data(), encodedSize, decoded, FRAME_SAMPLES), FRAME_SAMPLES);
+        QCOMPARE(decoded[FRAME_SAMPLES], SENTINEL);
+
+        // the codec is lossy and delays the signal, but past its start up it carries the tone's energy
+        if (frame >= NUM_FRAMES / 2) {
+            inputRMS += rms(samples, FRAME_SAMPLES);
+            outputRMS += rms(decoded, FRAME_SAMPLES);
+        }
+    }
+    QVERIFY(outputRMS > 0.5f * inputRMS);
+    QVERIFY(outputRMS < 1.5f * inputRMS);
+
+    // a lost frame is concealed with a full frame of audio carrying on from the tone
+    QCOMPARE(decoder->getMaxDecodedSamples(nullptr, 0), FRAME_SAMPLES);
+    decoded[FRAME_SAMPLES] = SENTINEL;
+    QCOMPARE(decoder->lostFrame(decoded, FRAME_SAMPLES), FRAME_SAMPLES);
+    QCOMPARE(decoded[FRAME_SAMPLES], SENTINEL);
+    QVERIFY(rms(decoded, FRAME_SAMPLES) > 0.0f);
+
+    QByteArray lostBuffer;
+    decoder->lostFrame(lostBuffer);
+    QCOMPARE(lostBuffer.size(), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    // buffers that are too small are reported rather than overrun
+    const int UNDERSIZED_SAMPLES = FRAME_SAMPLES / 2;
+    decoded[UNDERSIZED_SAMPLES] = SENTINEL;
+    QCOMPARE(decoder->decode(encoded.data(), encodedSize, decoded, UNDERSIZED_SAMPLES), -1);
+    QCOMPARE(decoded[UNDERSIZED_SAMPLES], SENTINEL);
+    QCOMPARE(decoder->lostFrame(decoded, UNDERSIZED_SAMPLES), -1);
+    QCOMPARE(decoded[UNDERSIZED_SAMPLES], SENTINEL);
+    QCOMPARE(decoder->lostFrame(decoded, FRAME_SAMPLES - 1), -1);
+
+    // released coders come back from the pool reset, and decode a fresh stream
+    codec.releaseEncoder(encoder);
+    codec.releaseDecoder(decoder);
+    encoder = codec.createEncoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    decoder = codec.createDecoder(AudioConstants::SAMPLE_RATE, AudioConstants::STEREO);
+    QVERIFY(encoder);
+    QVERIFY(decoder);
+    fillToneFrame(samples, 0);
+    encodedSize = encoder->encode(samples, FRAME_SAMPLES, encoded.data(), (int)encoded.size());
+    QVERIFY(encodedSize > 0);
+    QCOMPARE(decoder->decode(encoded.data(), encodedSize, decoded, FRAME_SAMPLES), FRAME_SAMPLES);
+    codec.releaseEncoder(encoder);
+    codec.releaseDecoder(decoder);
+}
+
+void AudioCodecTests::encodeIntoPacketBenchmark() {
+    const int NUM_FRAMES = 100000;
+    const int HEADER_SIZE = sizeof(quint16) + AudioConstants::MAX_CODEC_NAME_LENGTH_ON_WIRE;
+    const QString CODEC_NAME = "pcm";
+    RawCodec codec;
+    Encoder& encoder = codec;
+    int16_t samples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+    // the mixer's previous path: wrap the mix in a QByteArray, encode into another, then copy into the packet
+    qint64 byteArrayPayloadBytes = 0;
+    auto start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        fillFrame(samples, frame);
+        auto packet = NLPacket::create(PacketType::MixedAudio, HEADER_SIZE + AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+        packet->writePrimitive((quint16)frame);
+        packet->writeString(CODEC_NAME);
+
+        QByteArray decodedBuffer(reinterpret_cast<char*>(samples), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+        QByteArray encodedBuffer;
+        encoder.encode(decodedBuffer, encodedBuffer);
+        packet->write(encodedBuffer.constData(), encodedBuffer.size());
+        byteArrayPayloadBytes += packet->getPayloadSize();
+    }
+    auto byteArrayDuration = usecTimestampNow() - start;
+
+    // the buffer based path: encode straight into the packet payload
+    qint64 directPayloadBytes = 0;
+    start = usecTimestampNow();
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        fillFrame(samples, frame);
+        auto packet = NLPacket::create(PacketType::MixedAudio,
+            HEADER_SIZE + encoder.getMaxEncodedSize(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO));
+        packet->writePrimitive((quint16)frame);
+        packet->writeString(CODEC_NAME);
+
+        auto encoded = reinterpret_cast<uint8_t*>(packet->getPayload() + packet->pos());
+        int encodedSize = encoder.encode(samples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO,
+            encoded, (int)packet->bytesAvailableForWrite());
+        packet->setPayloadSize(packet->pos() + encodedSize);
+        directPayloadBytes += packet->getPayloadSize();
+    }
+    auto directDuration = usecTimestampNow() - start;
+
+    qDebug() << "QByteArray encode:" << NUM_FRAMES << "frames in" << (float)byteArrayDuration / USECS_PER_MSEC << "ms,"
+        << (byteArrayDuration > 0 ? (float)NUM_FRAMES * USECS_PER_SECOND / byteArrayDuration : 0.0f) << "frames/sec";
+    qDebug() << "In-packet encode:" << NUM_FRAMES << "frames in" << (float)directDuration / USECS_PER_MSEC << "ms,"
+        << (directDuration > 0 ? (float)NUM_FRAMES * USECS_PER_SECOND / directDuration : 0.0f) << "frames/sec";
+
+    QCOMPARE(directPayloadBytes, byteArrayPayloadBytes);
+}
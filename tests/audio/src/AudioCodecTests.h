@@ -0,0 +1,29 @@
+//
+//  AudioCodecTests.h
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodecTests_h
+#define hifi_AudioCodecTests_h
+
+#include <QtTest/QtTest>
+
+class AudioCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that the QByteArray conveniences round trip through the buffer based codec interface
+    void byteArrayRoundTripTest();
+
+    // Test the opus codec's round trip, loss concealment and handling of buffers that are too small
+    void opusCodecTest();
+
+    // Compare encoding mixed frames through QByteArrays against encoding straight into the packet payload
+    void encodeIntoPacketBenchmark();
+};
+
+#endif // hifi_AudioCodecTests_h
@@ -0,0 +1,206 @@
+//
+//  AudioMixerSharedMixesTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixerSharedMixesTests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <AudioMixerSharedMixes.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(AudioMixerSharedMixesTests)
+
+using Fingerprint = AudioMixerSharedMixes::Fingerprint;
+
+// the bucket sizes the fingerprint uses
+static const float GAIN_BUCKETS_PER_OCTAVE = 8.0f;
+static const float AZIMUTH_BUCKET = TWO_PI / 64.0f;
+static const float DISTANCE_BUCKETS_PER_OCTAVE = 4.0f;
+
+// how far either side of a bucket boundary to test
+static const float NUDGE = 0.05f;
+
+struct TestContribution {
+    const void* stream;
+    float gain;
+    float azimuth;
+    float distance;
+    bool isEcho;
+    bool throttle;
+};
+
+static Fingerprint fingerprint(const std::vector<TestContribution>& contributions) {
+    AudioMixerSharedMixes::FingerprintBuilder builder;
+    for (const auto& contribution : contributions) {
+        builder.addStream(contribution.stream, contribution.gain, contribution.azimuth, contribution.distance,
+            contribution.isEcho, contribution.throttle);
+    }
+    return builder.getFingerprint();
+}
+
+static Fingerprint fingerprint(const TestContribution& contribution) {
+    return fingerprint(std::vector<TestContribution> { contribution });
+}
+
+void AudioMixerSharedMixesTests::fingerprintOrderTest() {
+    int streams[8];
+    std::vector<TestContribution> contributions;
+    for (int i = 0; i < 8; ++i) {
+        contributions.push_back({ &streams[i], 0.1f * (i + 1), 0.3f * i, 1.0f + i, i == 0, i == 7 });
+    }
+    Fingerprint expected = fingerprint(contributions);
+
+    std::mt19937 random(1);
+    for (int i = 0; i < 20; ++i) {
+        std::shuffle(contributions.begin(), contributions.end(), random);
+        QCOMPARE(fingerprint(contributions), expected);
+    }
+
+    // but the set of contributions matters
+    auto fewer = contributions;
+    fewer.pop_back();
+    QVERIFY(fingerprint(fewer) != expected);
+
+    auto repeated = contributions;
+    repeated.push_back(contributions.front());
+    QVERIFY(fingerprint(repeated) != expected);
+
+    // as does which stream contributes what
+    auto swapped = contributions;
+    std::swap(swapped[0].stream, swapped[1].stream);
+    QVERIFY(fingerprint(swapped) != expected);
+
+    // and how
+    auto echoed = contributions;
+    echoed[0].isEcho = !echoed[0].isEcho;
+    QVERIFY(fingerprint(echoed) != expected);
+
+    QCOMPARE(fingerprint(std::vector<TestContribution>()), fingerprint(std::vector<TestContribution>()));
+    QVERIFY(fingerprint(std::vector<TestContribution>()) != expected);
+}
+
+void AudioMixerSharedMixesTests::fingerprintBucketTest() {
+    int stream;
+    const TestContribution BASE { &stream, 1.0f, 0.0f, 1.0f, false, false };
+
+    // gain, in steps of an eighth of an octave
+    float gainBoundary = std::exp2(0.5f / GAIN_BUCKETS_PER_OCTAVE);
+    auto below = BASE;
+    auto above = BASE;
+    below.gain = std::exp2((0.5f - NUDGE) / GAIN_BUCKETS_PER_OCTAVE);
+    above.gain = std::exp2((0.5f + NUDGE) / GAIN_BUCKETS_PER_OCTAVE);
+    QVERIFY(below.gain < gainBoundary && gainBoundary < above.gain);
+    QCOMPARE(fingerprint(below), fingerprint(BASE));
+    QVERIFY(fingerprint(above) != fingerprint(BASE));
+
+    // silent and throttled streams are heard the same at any gain
+    below.gain = 0.0f;
+    above.gain = 0.0f;
+    above.throttle = true;
+    auto throttled = BASE;
+    throttled.throttle = true;
+    QVERIFY(fingerprint(below) != fingerprint(BASE));
+    QCOMPARE(fingerprint(throttled), fingerprint(above));
+
+    // azimuth, in 64 steps around the listener
+    below = BASE;
+    above = BASE;
+    below.azimuth = (0.5f - NUDGE) * AZIMUTH_BUCKET;
+    above.azimuth = (0.5f + NUDGE) * AZIMUTH_BUCKET;
+    QCOMPARE(fingerprint(below), fingerprint(BASE));
+    QVERIFY(fingerprint(above) != fingerprint(BASE));
+    below.azimuth = -(0.5f - NUDGE) * AZIMUTH_BUCKET;
+    above.azimuth = -(0.5f + NUDGE) * AZIMUTH_BUCKET;
+    QCOMPARE(fingerprint(below), fingerprint(BASE));
+    QVERIFY(fingerprint(above) != fingerprint(BASE));
+
+    // and straight behind is the same direction whichever way it is reached
+    below.azimuth = -PI;
+    above.azimuth = PI;
+    QCOMPARE(fingerprint(below), fingerprint(above));
+    above.azimuth = PI - (0.5f + NUDGE) * AZIMUTH_BUCKET;
+    QVERIFY(fingerprint(below) != fingerprint(above));
+
+    // distance, in quarter octaves
+    float distanceBoundary = std::exp2(0.5f / DISTANCE_BUCKETS_PER_OCTAVE);
+    below = BASE;
+    above = BASE;
+    below.distance = std::exp2((0.5f - NUDGE) / DISTANCE_BUCKETS_PER_OCTAVE);
+    above.distance = std::exp2((0.5f + NUDGE) / DISTANCE_BUCKETS_PER_OCTAVE);
+    QVERIFY(below.distance < distanceBoundary && distanceBoundary < above.distance);
+    QCOMPARE(fingerprint(below), fingerprint(BASE));
+    QVERIFY(fingerprint(above) != fingerprint(BASE));
+}
+
+void AudioMixerSharedMixesTests::sharedMixTest() {
+    const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+    const QString CODEC = "pcm";
+    AudioMixerSharedMixes sharedMixes;
+
+    int stream;
+    Fingerprint mixed = fingerprint(TestContribution { &stream, 1.0f, 0.0f, 1.0f, false, false });
+    Fingerprint unmixed = fingerprint(TestContribution { &stream, 0.5f, 0.0f, 1.0f, false, false });
+
+    std::vector<float> samples(NUM_SAMPLES);
+    std::vector<int16_t> limitedSamples(NUM_SAMPLES);
+    for (int i = 0; i < NUM_SAMPLES; ++i) {
+        samples[i] = (float)i / NUM_SAMPLES;
+        limitedSamples[i] = (int16_t)(i * 8);
+    }
+
+    std::vector<float> found(NUM_SAMPLES);
+    QVERIFY(!sharedMixes.findMix(mixed, found.data()));
+    sharedMixes.insertMix(mixed, samples.data(), limitedSamples.data());
+    QVERIFY(sharedMixes.findMix(mixed, found.data()));
+    QVERIFY(found == samples);
+    QVERIFY(!sharedMixes.findMix(unmixed, found.data()));
+
+    // the first mix published for a fingerprint is the one that is shared
+    std::vector<float> otherSamples(NUM_SAMPLES, 0.25f);
+    sharedMixes.insertMix(mixed, otherSamples.data(), limitedSamples.data());
+    QVERIFY(sharedMixes.findMix(mixed, found.data()));
+    QVERIFY(found == samples);
+
+    // encoded frames are shared for limited samples within the limiter's dither of the publisher's
+    const std::vector<uint8_t> ENCODED { 1, 2, 3, 4 };
+    const int ENCODED_CAPACITY = 16;
+    uint8_t encoded[ENCODED_CAPACITY];
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, CODEC, limitedSamples.data(), encoded, ENCODED_CAPACITY), -1);
+    sharedMixes.insertEncodedFrame(mixed, CODEC, limitedSamples.data(), ENCODED.data(), (int)ENCODED.size());
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, CODEC, limitedSamples.data(), encoded, ENCODED_CAPACITY),
+        (int)ENCODED.size());
+    QVERIFY(std::equal(ENCODED.begin(), ENCODED.end(), encoded));
+
+    auto dithered = limitedSamples;
+    for (int i = 0; i < NUM_SAMPLES; ++i) {
+        dithered[i] += (i % 2 == 0) ? 1 : -1;
+    }
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, CODEC, dithered.data(), encoded, ENCODED_CAPACITY),
+        (int)ENCODED.size());
+
+    // but not once a limiter attenuates differently, or for another codec or a buffer too small
+    auto attenuated = limitedSamples;
+    attenuated[NUM_SAMPLES - 1] /= 2;
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, CODEC, attenuated.data(), encoded, ENCODED_CAPACITY), -1);
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, "zlib", limitedSamples.data(), encoded, ENCODED_CAPACITY), -1);
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, CODEC, limitedSamples.data(), encoded, 2), -1);
+
+    // and frames encoded from such samples are not published
+    sharedMixes.insertEncodedFrame(mixed, "zlib", attenuated.data(), ENCODED.data(), (int)ENCODED.size());
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, "zlib", limitedSamples.data(), encoded, ENCODED_CAPACITY), -1);
+
+    // everything is dropped at the end of the frame
+    sharedMixes.reset();
+    QVERIFY(!sharedMixes.findMix(mixed, found.data()));
+    QCOMPARE(sharedMixes.findEncodedFrame(mixed, CODEC, limitedSamples.data(), encoded, ENCODED_CAPACITY), -1);
+}
@@ -0,0 +1,29 @@
+//
+//  AudioMixerSharedMixesTests.h
+//  tests/audio/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixerSharedMixesTests_h
+#define hifi_AudioMixerSharedMixesTests_h
+
+#include <QtTest/QtTest>
+
+class AudioMixerSharedMixesTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that a fingerprint depends on the contributions to a mix and not on the order they were added in
+    void fingerprintOrderTest();
+
+    // Test that contributions either side of a gain, azimuth or distance bucket boundary fingerprint differently
+    void fingerprintBucketTest();
+
+    // Test that mixes and encoded frames are only handed out for the fingerprint and samples they were published for
+    void sharedMixTest();
+};
+
+#endif // hifi_AudioMixerSharedMixesTests_h
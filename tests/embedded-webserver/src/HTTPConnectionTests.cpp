@@ -0,0 +1,294 @@
+//
+//  HTTPConnectionTests.cpp
+//  tests/embedded-webserver/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "HTTPConnectionTests.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QTemporaryDir>
+#include <QtNetwork/QTcpSocket>
+
+#include <HTTPConnection.h>
+#include <HTTPManager.h>
+
+QTEST_MAIN(HTTPConnectionTests)
+
+static const int RESPONSE_TIMEOUT_MSECS = 5000;
+static const QList<QByteArray> CHUNKS { "first chunk, ", "second chunk, ", "and the last one" };
+
+class TestRequestHandler : public HTTPRequestHandler {
+public:
+    bool handleHTTPRequest(HTTPConnection* connection, const QUrl& url, bool) override {
+        if (url.path() == "/chunked") {
+            connection->beginChunkedResponse(HTTPConnection::StatusCode200);
+            for (const auto& chunk : CHUNKS) {
+                connection->writeChunk(chunk);
+            }
+            connection->endChunkedResponse();
+            return true;
+        } else if (url.path() == "/thread") {
+            bool isManagerThread = QThread::currentThread() == qApp->thread();
+            connection->respond(HTTPConnection::StatusCode200, isManagerThread ? "manager" : "worker");
+            return true;
+        } else if (url.path() == "/deferred") {
+            // responded to later, by the test
+            deferredConnection = connection;
+            return true;
+        }
+        return false;
+    }
+
+    bool isThreadSafeHTTPRequest(HTTPConnection*, const QUrl& url) override {
+        return url.path() == "/thread" && url.query() == "worker";
+    }
+
+    QPointer<HTTPConnection> deferredConnection;
+};
+
+struct TestResponse {
+    QByteArray statusLine;
+    Headers headers;  // with lower case names
+    QByteArray content;
+};
+
+// parses a response from the start of data, returning false if it isn't all there yet
+static bool parseResponse(const QByteArray& data, bool isClosed, TestResponse& response, int& size) {
+    int headerEnd = data.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return false;
+    }
+
+    response = TestResponse();
+    QList<QByteArray> lines = data.left(headerEnd).split('\n');
+    response.statusLine = lines.takeFirst().trimmed();
+    for (const auto& line : lines) {
+        int colon = line.indexOf(':');
+        response.headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+    }
+
+    int position = headerEnd + 4;
+    if (response.headers.value("transfer-encoding") == "chunked") {
+        int chunkSize = -1;
+        while (chunkSize != 0) {
+            int lineEnd = data.indexOf("\r\n", position);
+            if (lineEnd < 0) {
+                return false;
+            }
+            chunkSize = data.mid(position, lineEnd - position).toInt(nullptr, 16);
+            position = lineEnd + 2;
+            if (data.size() < position + chunkSize + 2) {
+                return false;
+            }
+            response.content += data.mid(position, chunkSize);
+            position += chunkSize + 2;
+        }
+    } else if (response.headers.contains("content-length")) {
+        int length = response.headers.value("content-length").toInt();
+        if (data.size() < position + length) {
+            return false;
+        }
+        response.content = data.mid(position, length);
+        position += length;
+    } else {
+        // the end of the content is marked by closing the connection
+        if (!isClosed) {
+            return false;
+        }
+        response.content = data.mid(position);
+        position = data.size();
+    }
+
+    size = position;
+    return true;
+}
+
+// reads responses until there are count of them, the server closes the connection or it times out
+static QList<TestResponse> readResponses(QTcpSocket& socket, int count) {
+    QList<TestResponse> responses;
+    QByteArray received;
+    QElapsedTimer timer;
+    timer.start();
+
+    while (responses.size() < count && timer.elapsed() < RESPONSE_TIMEOUT_MSECS) {
+        bool isClosed = socket.state() != QAbstractSocket::ConnectedState;
+        received += socket.readAll();
+
+        TestResponse response;
+        int size = 0;
+        if (parseResponse(received, isClosed, response, size)) {
+            responses << response;
+            received.remove(0, size);
+        } else if (isClosed) {
+            break;
+        } else {
+            QTest::qWait(1);
+        }
+    }
+    return responses;
+}
+
+static bool connectTo(QTcpSocket& socket, const HTTPManager& manager) {
+    socket.connectToHost(QHostAddress::LocalHost, manager.serverPort());
+    return socket.waitForConnected(RESPONSE_TIMEOUT_MSECS);
+}
+
+void HTTPConnectionTests::chunkedResponseTest() {
+    TestRequestHandler handler;
+    HTTPManager manager(QHostAddress::LocalHost, 0, QString(), &handler);
+    QByteArray expectedContent = CHUNKS.join();
+
+    {
+        QTcpSocket socket;
+        QVERIFY(connectTo(socket, manager));
+        socket.write("GET /chunked HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+        auto responses = readResponses(socket, 1);
+        QCOMPARE(responses.size(), 1);
+        QCOMPARE(responses[0].statusLine, QByteArray("HTTP/1.1 200 OK"));
+        QCOMPARE(responses[0].headers.value("transfer-encoding"), QByteArray("chunked"));
+        QCOMPARE(responses[0].content, expectedContent);
+
+        // an HTTP/1.1 connection is kept alive
+        QTest::qWait(10);
+        QCOMPARE(socket.state(), QAbstractSocket::ConnectedState);
+    }
+
+    {
+        QTcpSocket socket;
+        QVERIFY(connectTo(socket, manager));
+        socket.write("GET /chunked HTTP/1.0\r\n\r\n");
+
+        // an HTTP/1.0 client gets the content as is, ended by the server closing the connection
+        auto responses = readResponses(socket, 1);
+        QCOMPARE(responses.size(), 1);
+        QVERIFY(!responses[0].headers.contains("transfer-encoding"));
+        QCOMPARE(responses[0].headers.value("connection"), QByteArray("close"));
+        QCOMPARE(responses[0].content, expectedContent);
+        QVERIFY(socket.state() != QAbstractSocket::ConnectedState);
+    }
+}
+
+void HTTPConnectionTests::streamedFileTest() {
+    QTemporaryDir documentRoot;
+    QVERIFY(documentRoot.isValid());
+
+    // larger than what is served in one piece
+    const int FILE_SIZE = 3 * 1024 * 1024 + 123;
+    QByteArray fileContent(FILE_SIZE, 0);
+    for (int i = 0; i < FILE_SIZE; i++) {
+        fileContent[i] = (char)(i % 251);
+    }
+    QFile file(documentRoot.path() + "/large.bin");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(fileContent), (qint64)FILE_SIZE);
+    file.close();
+
+    TestRequestHandler handler;
+    HTTPManager manager(QHostAddress::LocalHost, 0, documentRoot.path() + "/", &handler);
+
+    for (auto version : { "HTTP/1.1", "HTTP/1.0" }) {
+        QTcpSocket socket;
+        QVERIFY(connectTo(socket, manager));
+        socket.write(QByteArray("GET /large.bin ") + version + "\r\n\r\n");
+
+        auto responses = readResponses(socket, 1);
+        QCOMPARE(responses.size(), 1);
+        QCOMPARE(responses[0].content.size(), FILE_SIZE);
+        QVERIFY(responses[0].content == fileContent);
+    }
+}
+
+void HTTPConnectionTests::streamedFileClientTest() {
+    QTemporaryDir documentRoot;
+    QVERIFY(documentRoot.isValid());
+
+    const int FILE_SIZE = 8 * 1024 * 1024;
+    QByteArray fileContent(FILE_SIZE, 0);
+    for (int i = 0; i < FILE_SIZE; i++) {
+        fileContent[i] = (char)(i % 253);
+    }
+    QFile file(documentRoot.path() + "/large.bin");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(fileContent), (qint64)FILE_SIZE);
+    file.close();
+
+    TestRequestHandler handler;
+    HTTPManager manager(QHostAddress::LocalHost, 0, documentRoot.path() + "/", &handler);
+
+    {
+        // the file is only read as the client makes room for it, and the connection is then ready for the next request
+        QTcpSocket socket;
+        QVERIFY(connectTo(socket, manager));
+        socket.write("GET /large.bin HTTP/1.1\r\n\r\nGET /thread HTTP/1.1\r\n\r\n");
+        QTest::qWait(200);
+
+        auto responses = readResponses(socket, 2);
+        QCOMPARE(responses.size(), 2);
+        QVERIFY(responses[0].content == fileContent);
+        QCOMPARE(responses[1].content, QByteArray("manager"));
+    }
+
+    {
+        // a client that leaves before the end stops the stream
+        QTcpSocket socket;
+        QVERIFY(connectTo(socket, manager));
+        socket.write("GET /large.bin HTTP/1.1\r\n\r\n");
+        QVERIFY(socket.waitForReadyRead(RESPONSE_TIMEOUT_MSECS));
+        socket.abort();
+    }
+
+    QTcpSocket socket;
+    QVERIFY(connectTo(socket, manager));
+    socket.write("GET /thread HTTP/1.1\r\n\r\n");
+    auto responses = readResponses(socket, 1);
+    QCOMPARE(responses.size(), 1);
+    QCOMPARE(responses[0].content, QByteArray("manager"));
+}
+
+void HTTPConnectionTests::keepAliveTest() {
+    TestRequestHandler handler;
+    HTTPManager manager(QHostAddress::LocalHost, 0, QString(), &handler);
+
+    QTcpSocket socket;
+    QVERIFY(connectTo(socket, manager));
+
+    // pipelined requests are answered in order
+    socket.write("GET /thread HTTP/1.1\r\n\r\n"
+                 "GET /thread?worker HTTP/1.1\r\n\r\n"
+                 "GET /missing HTTP/1.1\r\n\r\n"
+                 "GET /thread HTTP/1.1\r\nConnection: close\r\n\r\n");
+
+    auto responses = readResponses(socket, 4);
+    QCOMPARE(responses.size(), 4);
+    QCOMPARE(responses[0].content, QByteArray("manager"));
+    QCOMPARE(responses[1].content, QByteArray("worker"));
+    QCOMPARE(responses[2].statusLine, QByteArray("HTTP/1.1 404 Not Found"));
+    QCOMPARE(responses[3].content, QByteArray("manager"));
+    QCOMPARE(responses[3].headers.value("connection"), QByteArray("close"));
+
+    QTRY_VERIFY(socket.state() != QAbstractSocket::ConnectedState);
+}
+
+void HTTPConnectionTests::deferredResponseTest() {
+    TestRequestHandler handler;
+    HTTPManager manager(QHostAddress::LocalHost, 0, QString(), &handler);
+
+    QTcpSocket socket;
+    QVERIFY(connectTo(socket, manager));
+    socket.write("GET /deferred HTTP/1.1\r\n\r\n");
+    QTRY_VERIFY(handler.deferredConnection);
+
+    // the connection is kept for the handler while the request is pending, even once its client is gone
+    socket.abort();
+    QTest::qWait(100);
+    QVERIFY(handler.deferredConnection);
+
+    handler.deferredConnection->respond(HTTPConnection::StatusCode200, "too late");
+    QTRY_VERIFY(handler.deferredConnection.isNull());
+}
@@ -0,0 +1,37 @@
+//
+//  HTTPConnectionTests.h
+//  tests/embedded-webserver/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_HTTPConnectionTests_h
+#define hifi_HTTPConnectionTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class HTTPConnectionTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test a chunked response to HTTP/1.1 and HTTP/1.0 clients
+    void chunkedResponseTest();
+
+    // Test that large files of the document root are streamed, whole
+    void streamedFileTest();
+
+    // Test streaming to a client that reads slowly, then pipelines another request, and to one that leaves mid-stream
+    void streamedFileClientTest();
+
+    // Test several requests on a kept alive connection, some handled on a worker thread
+    void keepAliveTest();
+
+    // Test responding to a request on the manager's thread after its client has gone
+    void deferredResponseTest();
+};
+
+#endif // hifi_HTTPConnectionTests_h
@@ -0,0 +1,168 @@
+//
+//  ClusterMatrixBatchTests.cpp
+//  tests/model-skinning/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ClusterMatrixBatchTests.h"
+
+#include <functional>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <GLMHelpers.h>
+#include <ClusterMatrixBatch.h>
+
+QTEST_MAIN(ClusterMatrixBatchTests)
+
+// Roughly what a crowd of avatars looks like: a few skinned meshes each bound to most of a 60 joints skeleton
+static const int NUM_MODELS = 100;
+static const int NUM_JOINTS = 60;
+static const int NUM_MESHES = 3;
+static const int NUM_CLUSTERS = 50;
+
+struct SyntheticCluster {
+    int jointIndex;
+    glm::mat4 inverseBindMatrix;
+};
+
+struct SyntheticModel {
+    std::vector<glm::mat4> jointTransforms;
+    std::vector<std::vector<SyntheticCluster>> meshes;
+    std::vector<std::vector<glm::mat4>> clusterMatrices; // per mesh, only used by the previous path
+
+    uint32_t getNumClusterMatrices() const {
+        uint32_t numMatrices = 0;
+        for (const auto& mesh : meshes) {
+            numMatrices += (uint32_t)mesh.size();
+        }
+        return numMatrices;
+    }
+
+    // the batch path: evaluated straight into the model's range of the pool
+    void computeClusterMatrices(glm::mat4* destination) const {
+        for (const auto& mesh : meshes) {
+            for (size_t j = 0; j < mesh.size(); j++) {
+                glm_mat4u_mul(jointTransforms[mesh[j].jointIndex], mesh[j].inverseBindMatrix, destination[j]);
+            }
+            destination += mesh.size();
+        }
+    }
+
+    void computeMeshClusterMatrices() {
+        for (size_t i = 0; i < meshes.size(); i++) {
+            const auto& mesh = meshes[i];
+            for (size_t j = 0; j < mesh.size(); j++) {
+                glm_mat4u_mul(jointTransforms[mesh[j].jointIndex], mesh[j].inverseBindMatrix, clusterMatrices[i][j]);
+            }
+        }
+    }
+};
+
+static std::vector<SyntheticModel> models;
+
+void ClusterMatrixBatchTests::initTestCase() {
+    models.resize(NUM_MODELS);
+    for (int m = 0; m < NUM_MODELS; m++) {
+        auto& model = models[m];
+        model.jointTransforms.resize(NUM_JOINTS);
+        for (int j = 0; j < NUM_JOINTS; j++) {
+            model.jointTransforms[j] = glm::translate(glm::mat4(), glm::vec3((float)m, (float)j, 0.0f));
+        }
+        model.meshes.resize(NUM_MESHES);
+        model.clusterMatrices.resize(NUM_MESHES);
+        for (int i = 0; i < NUM_MESHES; i++) {
+            model.meshes[i].resize(NUM_CLUSTERS);
+            model.clusterMatrices[i].resize(NUM_CLUSTERS);
+            for (int c = 0; c < NUM_CLUSTERS; c++) {
+                model.meshes[i][c].jointIndex = (c + i) % NUM_JOINTS;
+                model.meshes[i][c].inverseBindMatrix = glm::translate(glm::mat4(), glm::vec3(0.0f, 0.0f, (float)c));
+            }
+        }
+    }
+}
+
+void ClusterMatrixBatchTests::testEvaluate() {
+    ClusterMatrixBatch batch;
+    std::vector<uint32_t> offsets;
+    for (auto& model : models) {
+        SyntheticModel* self = &model;
+        offsets.push_back(batch.add(self->getNumClusterMatrices(), [self](glm::mat4* destination) {
+            self->computeClusterMatrices(destination);
+        }));
+    }
+    QCOMPARE(batch.getNumEntries(), (size_t)NUM_MODELS);
+    QCOMPARE(batch.getNumMatrices(), (uint32_t)(NUM_MODELS * NUM_MESHES * NUM_CLUSTERS));
+
+    auto pool = batch.evaluate();
+    QCOMPARE(pool->size(), (size_t)(NUM_MODELS * NUM_MESHES * NUM_CLUSTERS));
+    QCOMPARE(batch.getNumEntries(), (size_t)0);
+
+    for (int m = 0; m < NUM_MODELS; m++) {
+        const auto& model = models[m];
+        uint32_t meshOffset = offsets[m];
+        for (int i = 0; i < NUM_MESHES; i++) {
+            ClusterMatrices view(pool, meshOffset, NUM_CLUSTERS);
+            QCOMPARE(view.size(), (size_t)NUM_CLUSTERS);
+            for (int c = 0; c < NUM_CLUSTERS; c++) {
+                const auto& cluster = model.meshes[i][c];
+                glm::mat4 expected;
+                glm_mat4u_mul(model.jointTransforms[cluster.jointIndex], cluster.inverseBindMatrix, expected);
+                QVERIFY(view[c] == expected);
+            }
+            meshOffset += NUM_CLUSTERS;
+        }
+    }
+}
+
+void ClusterMatrixBatchTests::testPoolRecycling() {
+    ClusterMatrixBatch batch;
+    batch.add(1, [](glm::mat4* destination) { *destination = glm::mat4(); });
+    auto pool = batch.evaluate();
+    ClusterMatrixPool* firstPool = pool.get();
+
+    // a pool still referenced by a view must not be handed out again
+    ClusterMatrices view(pool, 0, 1);
+    pool.reset();
+    batch.add(1, [](glm::mat4* destination) { *destination = glm::mat4(); });
+    pool = batch.evaluate();
+    QVERIFY(pool.get() != firstPool);
+
+    // once released it is recycled
+    view = ClusterMatrices();
+    pool.reset();
+    batch.add(1, [](glm::mat4* destination) { *destination = glm::mat4(); });
+    pool = batch.evaluate();
+    QCOMPARE(pool.get(), firstPool);
+}
+
+// The previous path: every model on the calling thread, every mesh's matrices copied into its own vector
+void ClusterMatrixBatchTests::benchmarkPerModelCopies() {
+    std::vector<std::vector<glm::mat4>> copies;
+    QBENCHMARK {
+        copies.clear();
+        for (auto& model : models) {
+            model.computeMeshClusterMatrices();
+            for (const auto& matrices : model.clusterMatrices) {
+                copies.push_back(matrices);
+            }
+        }
+    }
+}
+
+void ClusterMatrixBatchTests::benchmarkBatch() {
+    ClusterMatrixBatch batch;
+    QBENCHMARK {
+        for (auto& model : models) {
+            SyntheticModel* self = &model;
+            batch.add(self->getNumClusterMatrices(), [self](glm::mat4* destination) {
+                self->computeClusterMatrices(destination);
+            });
+        }
+        batch.evaluate();
+    }
+}
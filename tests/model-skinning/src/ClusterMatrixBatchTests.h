@@ -0,0 +1,27 @@
+//
+//  ClusterMatrixBatchTests.h
+//  tests/model-skinning/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ClusterMatrixBatchTests_h
+#define hifi_ClusterMatrixBatchTests_h
+
+#include <QtTest/QtTest>
+
+class ClusterMatrixBatchTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void testEvaluate();
+    void testPoolRecycling();
+    void benchmarkPerModelCopies();
+    void benchmarkBatch();
+};
+
+#endif // hifi_ClusterMatrixBatchTests_h
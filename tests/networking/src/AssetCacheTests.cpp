@@ -0,0 +1,134 @@
+//
+//  AssetCacheTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetCacheTests.h"
+
+#include <AssetCache.h>
+#include <AssetUtils.h>
+
+QTEST_GUILESS_MAIN(AssetCacheTests)
+
+static QByteArray makeTestData(int size) {
+    QByteArray data(size, 0);
+    for (int i = 0; i < size; ++i) {
+        data[i] = (char)(i * 31);
+    }
+    return data;
+}
+
+static std::shared_ptr<AssetCache> makeAssetCache(const QString& location) {
+    auto result = std::make_shared<AssetCache>(location.toStdString());
+    result->initialize();
+    return result;
+}
+
+void AssetCacheTests::readWriteTest() {
+    auto cache = makeAssetCache(_testDir.path() + "/readWrite");
+    const QByteArray data = makeTestData(64 * 1024);
+    const AssetHash hash = hashData(data).toHex();
+
+    QVERIFY(!cache->contains(hash));
+    QVERIFY(cache->read(hash).isNull());
+
+    QVERIFY(cache->write(hash, data));
+    QVERIFY(cache->contains(hash));
+    QCOMPARE(cache->read(hash), data);
+    QCOMPARE(cache->read(hash.toUpper()), data);
+
+    // a positive range, an open ended range, and a range back from the end of the asset
+    QCOMPARE(cache->read(hash, { 100, 300 }), data.mid(100, 200));
+    QCOMPARE(cache->read(hash, { 1000, 0 }), data.mid(1000));
+    QCOMPARE(cache->read(hash, { -500, 0 }), data.right(500));
+
+    // ranges past the end of the asset are not served from the cache
+    QVERIFY(cache->read(hash, { 0, data.size() + 1 }).isNull());
+
+    // assets persist across cache instances, and are verified before their first read
+    cache.reset();
+    cache = makeAssetCache(_testDir.path() + "/readWrite");
+    QVERIFY(cache->contains(hash));
+    QCOMPARE(cache->read(hash, { 0, 16 }), data.left(16));
+}
+
+void AssetCacheTests::corruptionTest() {
+    const QString location = _testDir.path() + "/corruption";
+    const QByteArray data = makeTestData(4096);
+    const AssetHash hash = hashData(data).toHex();
+
+    auto cache = makeAssetCache(location);
+    QVERIFY(cache->write(hash, data));
+    cache.reset();
+
+    // flip a byte on disk while the cache isn't looking
+    QFile file(QDir(location).filePath(hash + "." + AssetCache::ASSET_CACHE_EXT));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    file.seek(10);
+    file.write("x", 1);
+    file.close();
+
+    cache = makeAssetCache(location);
+    QVERIFY(cache->contains(hash));
+    QVERIFY(cache->read(hash).isNull());
+    QVERIFY(!cache->contains(hash));
+
+    // once dropped, the asset can be cached again
+    QVERIFY(cache->write(hash, data));
+    QCOMPARE(cache->read(hash), data);
+}
+
+// counts the descriptors and mappings this process has on files under location
+static int countOpenFiles(const QString& location) {
+    int count = 0;
+    QDir fdDir("/proc/self/fd");
+    for (const auto& fd : fdDir.entryInfoList(QDir::Files | QDir::System)) {
+        if (fd.symLinkTarget().startsWith(location)) {
+            ++count;
+        }
+    }
+
+    QFile maps("/proc/self/maps");
+    if (maps.open(QIODevice::ReadOnly)) {
+        for (const auto& line : maps.readAll().split('\n')) {
+            if (line.contains(location.toUtf8())) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+void AssetCacheTests::openFilesTest() {
+    if (!QDir("/proc/self/fd").exists()) {
+        QSKIP("needs /proc to see the process' open files");
+    }
+
+    // /proc shows the resolved paths
+    const QString location = QDir(_testDir.path()).canonicalPath() + "/openFiles";
+    auto cache = makeAssetCache(location);
+
+    const int NUM_ASSETS = 64;
+    QList<QByteArray> assets;
+    QList<AssetHash> hashes;
+    for (int i = 0; i < NUM_ASSETS; ++i) {
+        assets << makeTestData(4096 + i);
+        hashes << hashData(assets.last()).toHex();
+        QVERIFY(cache->write(hashes.last(), assets.last()));
+    }
+
+    // the files are kept, and reread with and without their first read's verification
+    cache.reset();
+    cache = makeAssetCache(location);
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < NUM_ASSETS; ++i) {
+            QCOMPARE(cache->read(hashes[i], { 10, 20 }), assets[i].mid(10, 10));
+        }
+        QCOMPARE(countOpenFiles(location), 0);
+    }
+}
@@ -0,0 +1,33 @@
+//
+//  AssetCacheTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetCacheTests_h
+#define hifi_AssetCacheTests_h
+
+#include <QtTest/QtTest>
+#include <QtCore/QTemporaryDir>
+
+class AssetCacheTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test writing an asset and reading it back whole and by range
+    void readWriteTest();
+
+    // Test that a cached asset whose contents no longer match its hash is dropped on first use
+    void corruptionTest();
+
+    // Test that reading cached assets leaves none of their files open or mapped
+    void openFilesTest();
+
+private:
+    QTemporaryDir _testDir;
+};
+
+#endif // hifi_AssetCacheTests_h
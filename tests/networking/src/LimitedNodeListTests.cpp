@@ -0,0 +1,136 @@
+//
+//  LimitedNodeListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LimitedNodeListTests.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+
+#include <DependencyManager.h>
+#include <LimitedNodeList.h>
+
+QTEST_MAIN(LimitedNodeListTests)
+
+static const int NUM_THREADS = 8;
+static const int NUM_NODES = 200;
+
+// the node list is only ever created by its subclasses, this one binds to any free port
+class TestNodeList : public LimitedNodeList {
+public:
+    TestNodeList() : LimitedNodeList(0) {}
+};
+
+static SharedNodePointer addNode(LimitedNodeList& nodeList, const QUuid& uuid) {
+    return nodeList.addOrUpdateNode(uuid, NodeType::Agent, HifiSockAddr(), HifiSockAddr());
+}
+
+void LimitedNodeListTests::concurrentAddTest() {
+    TestNodeList nodeList;
+
+    std::vector<QUuid> uuids;
+    for (int i = 0; i < NUM_NODES; ++i) {
+        uuids.push_back(QUuid::createUuid());
+    }
+
+    // every thread adds every node, in its own order, and keeps what it got back
+    std::vector<std::vector<SharedNodePointer>> addedNodes(NUM_THREADS, std::vector<SharedNodePointer>(NUM_NODES));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<int> order(NUM_NODES);
+            std::iota(order.begin(), order.end(), 0);
+            std::shuffle(order.begin(), order.end(), std::mt19937(t));
+
+            for (int i : order) {
+                addedNodes[t][i] = addNode(nodeList, uuids[i]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto nodeTable = nodeList.getNodeTable();
+    QCOMPARE(nodeTable->size(), (size_t)NUM_NODES);
+
+    // all threads got the node that is in the list
+    std::set<NodeIndex> indices;
+    for (int i = 0; i < NUM_NODES; ++i) {
+        const auto& node = nodeTable->nodeWithUUID(uuids[i]);
+        QVERIFY(node);
+        for (int t = 0; t < NUM_THREADS; ++t) {
+            QCOMPARE(addedNodes[t][i], node);
+        }
+        indices.insert(node->getNodeIndex());
+    }
+
+    // and the indices of the nodes that lost the race went back to be reused, so the indices are still dense
+    QCOMPARE(indices.size(), (size_t)NUM_NODES);
+    QCOMPARE(nodeTable->getIndexCount(), (NodeIndex)NUM_NODES);
+
+    // which the nodes that replace these get
+    for (const auto& uuid : uuids) {
+        QVERIFY(nodeList.killNodeWithUUID(uuid));
+    }
+    for (int i = 0; i < NUM_NODES; ++i) {
+        addNode(nodeList, QUuid::createUuid());
+    }
+    QCOMPARE(nodeList.getNodeTable()->size(), (size_t)NUM_NODES);
+    QCOMPARE(nodeList.getNodeTable()->getIndexCount(), (NodeIndex)NUM_NODES);
+}
+
+void LimitedNodeListTests::ignoredNodeReaddedTest() {
+    // nodes resolve their ignored IDs through the node list dependency
+    auto nodeList = DependencyManager::set<LimitedNodeList, TestNodeList>();
+
+    auto listener = addNode(*nodeList, QUuid::createUuid());
+    auto ignoredID = QUuid::createUuid();
+    auto ignored = addNode(*nodeList, ignoredID);
+    auto other = addNode(*nodeList, QUuid::createUuid());
+
+    listener->addIgnoredNode(ignoredID);
+    QVERIFY(listener->isIgnoringNode(*ignored));
+    QVERIFY(!listener->isIgnoringNode(*other));
+
+    // the ignored node leaves, another node takes its index, and it comes back with a new one
+    auto oldIndex = ignored->getNodeIndex();
+    QVERIFY(nodeList->killNodeWithUUID(ignoredID));
+    auto newcomer = addNode(*nodeList, QUuid::createUuid());
+    QCOMPARE(newcomer->getNodeIndex(), oldIndex);
+    auto readded = addNode(*nodeList, ignoredID);
+    QVERIFY(readded != ignored);
+    QVERIFY(readded->getNodeIndex() != oldIndex);
+
+    // asked twice, first from the UUID set while the indices are resolved again, then from the new indices
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(listener->isIgnoringNode(*readded));
+        QVERIFY(!listener->isIgnoringNode(*newcomer));
+        QVERIFY(!listener->isIgnoringNode(*other));
+    }
+
+    // an ID ignored before its node joins is ignored once it does
+    auto laterID = QUuid::createUuid();
+    listener->addIgnoredNode(laterID);
+    auto later = addNode(*nodeList, laterID);
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(listener->isIgnoringNode(*later));
+        QVERIFY(listener->isIgnoringNode(*readded));
+        QVERIFY(!listener->isIgnoringNode(*newcomer));
+    }
+
+    listener->removeIgnoredNode(ignoredID);
+    QVERIFY(!listener->isIgnoringNode(*readded));
+    QVERIFY(listener->isIgnoringNode(*later));
+
+    DependencyManager::destroy<LimitedNodeList>();
+}
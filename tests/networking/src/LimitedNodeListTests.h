@@ -0,0 +1,27 @@
+//
+//  LimitedNodeListTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LimitedNodeListTests_h
+#define hifi_LimitedNodeListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LimitedNodeListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test threads racing to add the same nodes, which must end up with one node each and no lost indices
+    void concurrentAddTest();
+    // Test that an ignored node is still ignored once it's killed and comes back with another index
+    void ignoredNodeReaddedTest();
+};
+
+#endif // hifi_LimitedNodeListTests_h
@@ -0,0 +1,171 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+
+#include <algorithm>
+#include <random>
+
+#include <udt/LossList.h>
+
+QTEST_MAIN(LossListTests)
+
+using namespace udt;
+
+static SequenceNumber seq(int value) {
+    return SequenceNumber(value);
+}
+
+void LossListTests::appendTest() {
+    LossList list;
+    QVERIFY(list.isEmpty());
+
+    list.append(seq(10));
+    list.append(seq(11));
+    list.append(seq(13), seq(20));
+    QCOMPARE(list.getLength(), 10);
+    QCOMPARE(list.getFirstSequenceNumber(), seq(10));
+
+    QCOMPARE(list.popFirstSequenceNumber(), seq(10));
+    QCOMPARE(list.popFirstSequenceNumber(), seq(11));
+    QCOMPARE(list.popFirstSequenceNumber(), seq(13));
+    QCOMPARE(list.getLength(), 7);
+
+    list.clear();
+    QVERIFY(list.isEmpty());
+}
+
+void LossListTests::insertTest() {
+    LossList list;
+    list.append(seq(10), seq(12));
+    list.append(seq(20), seq(22));
+    list.append(seq(30), seq(32));
+
+    // in a gap
+    list.insert(seq(15), seq(16));
+    QCOMPARE(list.getLength(), 11);
+
+    // bridging and overlapping several ranges
+    list.insert(seq(11), seq(25));
+    QCOMPARE(list.getLength(), 19);
+
+    // before everything
+    list.insert(seq(1), seq(2));
+    QCOMPARE(list.getLength(), 21);
+    QCOMPARE(list.getFirstSequenceNumber(), seq(1));
+
+    // already lost
+    list.insert(seq(30), seq(31));
+    QCOMPARE(list.getLength(), 21);
+}
+
+void LossListTests::removeTest() {
+    LossList list;
+    list.append(seq(10), seq(14));
+
+    QVERIFY(!list.remove(seq(9)));
+    QVERIFY(!list.remove(seq(15)));
+
+    // splits the range
+    QVERIFY(list.remove(seq(12)));
+    QVERIFY(!list.remove(seq(12)));
+    QCOMPARE(list.getLength(), 4);
+
+    QVERIFY(list.remove(seq(10)));
+    QVERIFY(list.remove(seq(14)));
+    QVERIFY(list.remove(seq(11)));
+    QVERIFY(list.remove(seq(13)));
+    QVERIFY(list.isEmpty());
+}
+
+void LossListTests::removeRangeTest() {
+    LossList list;
+    list.append(seq(10), seq(19));
+    list.append(seq(30), seq(39));
+    list.append(seq(50), seq(59));
+
+    // inside one range
+    list.remove(seq(12), seq(13));
+    QCOMPARE(list.getLength(), 28);
+    QVERIFY(!list.remove(seq(12)));
+    QVERIFY(list.remove(seq(14)));
+
+    // tail of the first range, all of the second and head of the third
+    list.remove(seq(18), seq(52));
+    QCOMPARE(list.getLength(), 12);
+    QVERIFY(list.remove(seq(17)));
+    QVERIFY(!list.remove(seq(35)));
+    QVERIFY(list.remove(seq(53)));
+
+    // nothing lost there
+    list.remove(seq(20), seq(29));
+    QCOMPARE(list.getLength(), 10);
+}
+
+void LossListTests::burstyLossBenchmark() {
+    static const int NUM_PACKETS = 2000000;
+    static const double LOSS_RATE = 0.05;
+    static const int MEAN_BURST = 8;
+
+    std::mt19937 generator(742272);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    // decide which packets are lost up front so only the list operations are timed
+    std::vector<int> lost;
+    bool inBurst = false;
+    for (int i = 1; i < NUM_PACKETS; ++i) {
+        double roll = distribution(generator);
+        inBurst = inBurst ? (roll < 1.0 - 1.0 / MEAN_BURST) : (roll < LOSS_RATE / (MEAN_BURST * (1.0 - LOSS_RATE)));
+        if (inBurst) {
+            lost.push_back(i);
+        }
+    }
+    // retransmissions arrive out of order, each for a loss that is in the list and hasn't been retransmitted yet
+    std::vector<uint32_t> retransmissionPicks(lost.size());
+    for (auto& pick : retransmissionPicks) {
+        pick = generator();
+    }
+    std::vector<int> pending;
+    pending.reserve(lost.size());
+
+    LossList list;
+    QElapsedTimer timer;
+    timer.start();
+
+    size_t nextLost = 0;
+    size_t numRetransmitted = 0;
+    bool wasRemoved = true;
+    for (int i = 1; i < NUM_PACKETS; ++i) {
+        if (nextLost < lost.size() && lost[nextLost] == i) {
+            list.append(seq(i));
+            pending.push_back(i);
+            ++nextLost;
+        } else if (!pending.empty() && (i % 4) == 0) {
+            // a retransmission arrives with every fourth new packet
+            size_t index = retransmissionPicks[numRetransmitted++] % pending.size();
+            wasRemoved = list.remove(seq(pending[index])) && wasRemoved;
+            pending[index] = pending.back();
+            pending.pop_back();
+        }
+    }
+    auto elapsedMsecs = timer.elapsed();
+
+    qDebug() << lost.size() << "losses out of" << NUM_PACKETS << "packets processed in" << elapsedMsecs << "ms";
+    QVERIFY(numRetransmitted > 0);
+    QVERIFY(wasRemoved);
+
+    // what was never retransmitted is still lost, in order
+    std::sort(pending.begin(), pending.end());
+    QCOMPARE(list.getLength(), (int)pending.size());
+    for (int lostSequenceNumber : pending) {
+        QCOMPARE(list.popFirstSequenceNumber(), seq(lostSequenceNumber));
+    }
+    QVERIFY(list.isEmpty());
+}
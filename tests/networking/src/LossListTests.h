@@ -0,0 +1,30 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    void appendTest();
+    void insertTest();
+    void removeTest();
+    void removeRangeTest();
+
+    // Bursty loss on a long transfer: append, then retransmissions arriving out of order
+    void burstyLossBenchmark();
+};
+
+#endif // hifi_LossListTests_h
@@ -0,0 +1,100 @@
+//
+//  PacketCaptureTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketCaptureTests.h"
+
+#include <QtCore/QTemporaryDir>
+
+#include <udt/PacketCapture.h>
+
+QTEST_MAIN(PacketCaptureTests)
+
+using namespace udt;
+
+void PacketCaptureTests::roundTripTest() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("roundTrip.hfpc");
+
+    const HifiSockAddr firstSender(QHostAddress("10.0.0.1"), 40102);
+    const HifiSockAddr secondSender(QHostAddress("192.168.1.20"), 55000);
+    const QByteArray firstData("first datagram");
+    const QByteArray secondData(1400, 'x');
+
+    PacketCaptureWriter writer;
+    QVERIFY(writer.open(path));
+    writer.write(0, firstSender, firstData.constData(), firstData.size());
+    writer.write(10000, secondSender, secondData.constData(), secondData.size());
+    writer.write(10000, firstSender, firstData.constData(), 0);
+    QCOMPARE(writer.getNumDatagrams(), 3);
+    writer.close();
+
+    PacketCaptureReader reader;
+    QVERIFY(reader.open(path));
+
+    CapturedDatagram datagram;
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.timeUsecs, (quint64)0);
+    QCOMPARE(datagram.senderSockAddr, firstSender);
+    QCOMPARE(datagram.data, firstData);
+
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.timeUsecs, (quint64)10000);
+    QCOMPARE(datagram.senderSockAddr, secondSender);
+    QCOMPARE(datagram.data, secondData);
+
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.senderSockAddr, firstSender);
+    QCOMPARE(datagram.data.size(), 0);
+
+    QVERIFY(!reader.readNext(datagram));
+}
+
+void PacketCaptureTests::invalidFileTest() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("invalid.hfpc");
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a packet capture");
+    file.close();
+
+    PacketCaptureReader reader;
+    QVERIFY(!reader.open(path));
+    QVERIFY(!reader.open(dir.filePath("missing.hfpc")));
+
+    CapturedDatagram datagram;
+    QVERIFY(!reader.readNext(datagram));
+}
+
+void PacketCaptureTests::truncatedTest() {
+    QTemporaryDir dir;
+    QString path = dir.filePath("truncated.hfpc");
+
+    const HifiSockAddr sender(QHostAddress("10.0.0.1"), 40102);
+    const QByteArray data(100, 'y');
+
+    PacketCaptureWriter writer;
+    QVERIFY(writer.open(path));
+    writer.write(0, sender, data.constData(), data.size());
+    writer.write(1000, sender, data.constData(), data.size());
+    writer.close();
+
+    // cut the second record short, as a capture from a process that was killed would be
+    QFile file(path);
+    QVERIFY(file.resize(file.size() - data.size() / 2));
+
+    PacketCaptureReader reader;
+    QVERIFY(reader.open(path));
+
+    CapturedDatagram datagram;
+    QVERIFY(reader.readNext(datagram));
+    QCOMPARE(datagram.data, data);
+    QVERIFY(!reader.readNext(datagram));
+}
@@ -0,0 +1,31 @@
+//
+//  PacketCaptureTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketCaptureTests_h
+#define hifi_PacketCaptureTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketCaptureTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test that datagrams read back as they were written, in order
+    void roundTripTest();
+
+    // Test that a file that is not a capture is refused
+    void invalidFileTest();
+
+    // Test that reading stops at a record cut short
+    void truncatedTest();
+};
+
+#endif // hifi_PacketCaptureTests_h
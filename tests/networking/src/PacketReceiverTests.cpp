@@ -0,0 +1,94 @@
+//
+//  PacketReceiverTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketReceiverTests.h"
+
+#include <atomic>
+#include <thread>
+
+#include <NLPacket.h>
+#include <PacketReceiver.h>
+
+QTEST_MAIN(PacketReceiverTests)
+
+static const int NUM_LISTENERS = 2000;
+static const quint32 LIVE_LISTENER_MAGIC = 0x4c495645;
+
+// a received copy of a non-sourced packet, so that dispatching it needs no node list
+static std::unique_ptr<udt::Packet> createReceivedPacket() {
+    auto packet = NLPacket::create(PacketType::ICEPing);
+    packet->writePrimitive((quint8)0);
+
+    auto dataSize = packet->getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[dataSize]);
+    memcpy(data.get(), packet->getData(), dataSize);
+    return udt::Packet::fromReceivedPacket(std::move(data), dataSize, HifiSockAddr());
+}
+
+class TestListener : public QObject {
+public:
+    TestListener(std::atomic<int>& numCalls, std::atomic<int>& numBadCalls) :
+        _numCalls(numCalls), _numBadCalls(numBadCalls) {}
+    ~TestListener() { _magic = 0; }
+
+    void handleMessage(QSharedPointer<ReceivedMessage>) {
+        // a call after destruction or off the listener's thread is what the receiver must never make
+        if (_magic != LIVE_LISTENER_MAGIC || QThread::currentThread() != thread()) {
+            ++_numBadCalls;
+        }
+        ++_numCalls;
+    }
+
+private:
+    volatile quint32 _magic { LIVE_LISTENER_MAGIC };
+    std::atomic<int>& _numCalls;
+    std::atomic<int>& _numBadCalls;
+};
+
+void PacketReceiverTests::concurrentRegistrationTest() {
+    PacketReceiver receiver;
+
+    QThread listenerThread;
+    listenerThread.start();
+
+    std::atomic<int> numCalls { 0 };
+    std::atomic<int> numBadCalls { 0 };
+    std::atomic<bool> isReceiving { true };
+
+    std::thread receivingThread([&] {
+        while (isReceiving) {
+            receiver.handleVerifiedPacket(createReceivedPacket());
+        }
+    });
+
+    for (int i = 0; i < NUM_LISTENERS; ++i) {
+        auto listener = new TestListener(numCalls, numBadCalls);
+        listener->moveToThread(&listenerThread);
+        receiver.registerListener(PacketType::ICEPing, listener, &TestListener::handleMessage);
+
+        // let some packets get queued for the listener before it goes away
+        QThread::usleep(i % 50);
+
+        // alternate between unregistering the listener first and leaving the receiver to notice it was destroyed
+        if (i % 2 == 0) {
+            receiver.unregisterListener(listener);
+        }
+        listener->deleteLater();
+    }
+
+    isReceiving = false;
+    receivingThread.join();
+
+    listenerThread.quit();
+    QVERIFY(listenerThread.wait());
+
+    QVERIFY(numCalls > 0);
+    QCOMPARE((int)numBadCalls, 0);
+}
@@ -0,0 +1,25 @@
+//
+//  PacketReceiverTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketReceiverTests_h
+#define hifi_PacketReceiverTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketReceiverTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test queued handlers being registered, unregistered and destroyed while packets are dispatched to them
+    void concurrentRegistrationTest();
+};
+
+#endif // hifi_PacketReceiverTests_h
@@ -0,0 +1,154 @@
+//
+//  PendingReceivedMessageTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PendingReceivedMessageTests.h"
+
+#include <udt/Connection.h>
+#include <udt/Constants.h>
+#include <udt/Packet.h>
+
+QTEST_MAIN(PendingReceivedMessageTests)
+
+using namespace udt;
+
+// a part of a reliable message, carrying a tag to tell copies of the same part apart
+static std::unique_ptr<Packet> createPart(Packet::MessagePartNumber partNumber, Packet::MessagePartNumber numParts,
+                                          int tag = 0) {
+    auto packet = Packet::create(sizeof(partNumber) + sizeof(tag), true, true);
+    packet->writePrimitive(partNumber);
+    packet->writePrimitive(tag);
+
+    Packet::PacketPosition position = Packet::PacketPosition::MIDDLE;
+    if (numParts == 1) {
+        position = Packet::PacketPosition::ONLY;
+    } else if (partNumber == 0) {
+        position = Packet::PacketPosition::FIRST;
+    } else if (partNumber == numParts - 1) {
+        position = Packet::PacketPosition::LAST;
+    }
+    packet->writeMessageNumber(1, position, partNumber);
+    return packet;
+}
+
+static int tagOf(const Packet& packet) {
+    int tag;
+    memcpy(&tag, packet.getPayload() + sizeof(Packet::MessagePartNumber), sizeof(tag));
+    return tag;
+}
+
+// removes the parts available, in order, checking that they are numbered from firstPartNumber
+static int removeAvailable(PendingReceivedMessage& message, Packet::MessagePartNumber firstPartNumber) {
+    int numRemoved = 0;
+    while (message.hasAvailablePackets()) {
+        auto packet = message.removeNextPacket();
+        if (!packet || packet->getMessagePartNumber() != firstPartNumber + numRemoved) {
+            return -1;
+        }
+        ++numRemoved;
+    }
+    return numRemoved;
+}
+
+void PendingReceivedMessageTests::inOrderTest() {
+    PendingReceivedMessage message;
+    QVERIFY(!message.hasAvailablePackets());
+    QVERIFY(!message.removeNextPacket());
+
+    const Packet::MessagePartNumber NUM_PARTS = 3;
+    for (Packet::MessagePartNumber i = 0; i < NUM_PARTS; i++) {
+        QVERIFY(!message.isComplete());
+        message.enqueuePacket(createPart(i, NUM_PARTS));
+        QCOMPARE(removeAvailable(message, i), 1);
+    }
+    QVERIFY(message.isComplete());
+
+    PendingReceivedMessage single;
+    single.enqueuePacket(createPart(0, 1));
+    QCOMPARE(removeAvailable(single, 0), 1);
+    QVERIFY(single.isComplete());
+}
+
+void PendingReceivedMessageTests::growWindowTest() {
+    const Packet::MessagePartNumber NUM_PARTS = 300;
+    PendingReceivedMessage message;
+
+    // held in the smallest window, then re-slotted each time a part further ahead grows it
+    message.enqueuePacket(createPart(10, NUM_PARTS));
+    message.enqueuePacket(createPart(50, NUM_PARTS));
+    message.enqueuePacket(createPart(150, NUM_PARTS));
+    message.enqueuePacket(createPart(NUM_PARTS - 1, NUM_PARTS));
+    QVERIFY(!message.hasAvailablePackets());
+    QVERIFY(!message.isComplete());
+
+    // the rest, backwards
+    for (Packet::MessagePartNumber i = NUM_PARTS - 1; i > 0; i--) {
+        message.enqueuePacket(createPart(i, NUM_PARTS));
+        QVERIFY(!message.hasAvailablePackets());
+    }
+    message.enqueuePacket(createPart(0, NUM_PARTS));
+    QCOMPARE(removeAvailable(message, 0), (int)NUM_PARTS);
+    QVERIFY(message.isComplete());
+}
+
+void PendingReceivedMessageTests::duplicateTest() {
+    const Packet::MessagePartNumber NUM_PARTS = 4;
+    PendingReceivedMessage message;
+
+    // a duplicate of a part being held doesn't replace it
+    message.enqueuePacket(createPart(2, NUM_PARTS, 1));
+    message.enqueuePacket(createPart(2, NUM_PARTS, 2));
+
+    message.enqueuePacket(createPart(0, NUM_PARTS));
+    message.enqueuePacket(createPart(1, NUM_PARTS));
+    QCOMPARE(message.removeNextPacket()->getMessagePartNumber(), (Packet::MessagePartNumber)0);
+    QCOMPARE(message.removeNextPacket()->getMessagePartNumber(), (Packet::MessagePartNumber)1);
+    auto held = message.removeNextPacket();
+    QVERIFY(held);
+    QCOMPARE(tagOf(*held), 1);
+
+    // nor is a part that was already removed taken again
+    message.enqueuePacket(createPart(1, NUM_PARTS));
+    message.enqueuePacket(createPart(2, NUM_PARTS));
+    QVERIFY(!message.hasAvailablePackets());
+
+    message.enqueuePacket(createPart(3, NUM_PARTS));
+    QCOMPARE(removeAvailable(message, 3), 1);
+    QVERIFY(message.isComplete());
+}
+
+void PendingReceivedMessageTests::maxPartOffsetTest() {
+    const Packet::MessagePartNumber MAX_PART_OFFSET = 4 * udt::MAX_PACKETS_IN_FLIGHT;
+    const Packet::MessagePartNumber NUM_PARTS = MAX_PART_OFFSET + 2;
+    PendingReceivedMessage message;
+
+    message.enqueuePacket(createPart(0, NUM_PARTS));
+    QCOMPARE(removeAvailable(message, 0), 1);
+
+    // the next part expected is 1, so this is as far ahead as a part can be
+    message.enqueuePacket(createPart(MAX_PART_OFFSET, NUM_PARTS));
+    // and this one too far, even though it would complete the message
+    message.enqueuePacket(createPart(MAX_PART_OFFSET + 1, NUM_PARTS));
+
+    // the parts in between stream through while the one ahead is held
+    bool isInOrder = true;
+    for (Packet::MessagePartNumber i = 1; i < MAX_PART_OFFSET; i++) {
+        message.enqueuePacket(createPart(i, NUM_PARTS));
+        auto packet = message.removeNextPacket();
+        isInOrder = isInOrder && packet && packet->getMessagePartNumber() == i;
+    }
+    QVERIFY(isInOrder);
+    QCOMPARE(removeAvailable(message, MAX_PART_OFFSET), 1);
+    QVERIFY(!message.isComplete());
+
+    // the dropped part is taken once it is sent again, within reach
+    message.enqueuePacket(createPart(MAX_PART_OFFSET + 1, NUM_PARTS));
+    QCOMPARE(removeAvailable(message, MAX_PART_OFFSET + 1), 1);
+    QVERIFY(message.isComplete());
+}
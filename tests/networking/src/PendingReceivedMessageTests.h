@@ -0,0 +1,34 @@
+//
+//  PendingReceivedMessageTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PendingReceivedMessageTests_h
+#define hifi_PendingReceivedMessageTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PendingReceivedMessageTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test parts arriving in order
+    void inOrderTest();
+
+    // Test parts arriving out of order, far enough ahead to grow the receive window while it holds parts
+    void growWindowTest();
+
+    // Test that duplicate parts, held or already removed, are dropped
+    void duplicateTest();
+
+    // Test that parts too far ahead of the message are dropped
+    void maxPartOffsetTest();
+};
+
+#endif // hifi_PendingReceivedMessageTests_h
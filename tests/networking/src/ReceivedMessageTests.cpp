@@ -0,0 +1,158 @@
+//
+//  ReceivedMessageTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ReceivedMessageTests.h"
+
+#include <NLPacket.h>
+#include <ReceivedMessage.h>
+
+QTEST_MAIN(ReceivedMessageTests)
+
+static const int NUM_PACKETS = 500;
+
+// a received copy of one packet of a reliable message, filled with bytes derived from their offset in the message
+static std::unique_ptr<NLPacket> createMessagePacket(int partNumber, qint64& messageOffset) {
+    auto packet = NLPacket::create(PacketType::AssetGetReply, -1, true, true);
+
+    auto size = packet->getPayloadCapacity();
+    QByteArray payload(size, 0);
+    for (qint64 i = 0; i < size; i++) {
+        payload[(int)i] = (char)((messageOffset + i) % 251);
+    }
+    messageOffset += size;
+    packet->write(payload);
+
+    udt::Packet::PacketPosition position = partNumber == 0 ? udt::Packet::PacketPosition::FIRST :
+        (partNumber == NUM_PACKETS - 1 ? udt::Packet::PacketPosition::LAST : udt::Packet::PacketPosition::MIDDLE);
+    packet->writeMessageNumber(1, position, partNumber);
+
+    auto dataSize = packet->getDataSize();
+    auto data = std::unique_ptr<char[]>(new char[dataSize]);
+    memcpy(data.get(), packet->getData(), dataSize);
+    return NLPacket::fromReceivedPacket(std::move(data), dataSize, HifiSockAddr());
+}
+
+static bool checkBytes(const char* data, qint64 size, qint64 messageOffset) {
+    for (qint64 i = 0; i < size; i++) {
+        if (data[i] != (char)((messageOffset + i) % 251)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReceivedMessageTests::assembleTest() {
+    qint64 messageSize = 0;
+    auto first = createMessagePacket(0, messageSize);
+    ReceivedMessage message(*first);
+    QVERIFY(!message.isComplete());
+
+    for (int i = 1; i < NUM_PACKETS; i++) {
+        auto packet = createMessagePacket(i, messageSize);
+        message.appendPacket(*packet);
+        QCOMPARE(message.getSize(), messageSize);
+    }
+    QVERIFY(message.isComplete());
+    QCOMPARE(message.getNumPackets(), (qint64)NUM_PACKETS);
+
+    const qint64 SKIPPED = 7;
+    message.seek(SKIPPED);
+    QCOMPARE(message.getBytesLeftToRead(), messageSize - SKIPPED);
+
+    auto data = message.readAll();
+    QCOMPARE((qint64)data.size(), messageSize - SKIPPED);
+    QVERIFY(checkBytes(data.constData(), data.size(), SKIPPED));
+    QVERIFY(checkBytes(message.getRawMessage(), message.getSize(), 0));
+}
+
+void ReceivedMessageTests::consumeTest() {
+    qint64 messageSize = 0;
+    auto first = createMessagePacket(0, messageSize);
+    ReceivedMessage message(*first);
+
+    // a reader that has parsed a header from the head of the message
+    const qint64 HEADER_SIZE = 45;
+    QByteArray header = message.readHead(HEADER_SIZE);
+    QVERIFY(checkBytes(header.constData(), header.size(), 0));
+
+    QByteArray consumed;
+    auto consumer = [&consumed](const QByteArray& chunk) {
+        consumed.append(chunk);
+    };
+
+    for (int i = 1; i < NUM_PACKETS; i++) {
+        auto packet = createMessagePacket(i, messageSize);
+        message.appendPacket(*packet);
+
+        if (i % 50 == 0) {
+            message.consumeReceivedData(consumer);
+            QCOMPARE((qint64)consumed.size(), message.getSize() - HEADER_SIZE);
+            QCOMPARE(message.getBytesLeftToRead(), (qint64)0);
+        }
+    }
+    message.consumeReceivedData(consumer);
+
+    QVERIFY(message.isComplete());
+    QCOMPARE((qint64)consumed.size(), messageSize - HEADER_SIZE);
+    QVERIFY(checkBytes(consumed.constData(), consumed.size(), HEADER_SIZE));
+    QCOMPARE(message.consumeReceivedData(consumer), (qint64)0);
+}
+
+void ReceivedMessageTests::readAfterConsumeTest() {
+    qint64 messageSize = 0;
+    auto first = createMessagePacket(0, messageSize);
+    ReceivedMessage message(*first);
+
+    const int NUM_CONSUMED_PACKETS = 10;
+    for (int i = 1; i < NUM_CONSUMED_PACKETS; i++) {
+        auto packet = createMessagePacket(i, messageSize);
+        message.appendPacket(*packet);
+    }
+
+    qint64 consumedSize = message.consumeReceivedData([](const QByteArray&) {});
+    QCOMPARE(consumedSize, messageSize);
+    QCOMPARE(message.getPosition(), messageSize);
+
+    // nothing is left to read until more arrives
+    char byte = 0;
+    QCOMPARE(message.peek(&byte, 1), (qint64)0);
+    QCOMPARE(message.read(1).size(), 0);
+    QCOMPARE(message.getPosition(), consumedSize);
+
+    auto packet = createMessagePacket(NUM_CONSUMED_PACKETS, messageSize);
+    message.appendPacket(*packet);
+    QCOMPARE(message.getBytesLeftToRead(), messageSize - consumedSize);
+
+    // what arrived afterwards reads back from where the consumed data ended
+    const qint64 READ_SIZE = 100;
+    QCOMPARE(message.peek(&byte, 1), (qint64)1);
+    QCOMPARE(byte, (char)(consumedSize % 251));
+    auto data = message.read(READ_SIZE);
+    QCOMPARE((qint64)data.size(), READ_SIZE);
+    QVERIFY(checkBytes(data.constData(), data.size(), consumedSize));
+
+    // reads are cut short at the end of what has been received
+    data = message.readAll();
+    QCOMPARE((qint64)data.size(), messageSize - consumedSize - READ_SIZE);
+    QVERIFY(checkBytes(data.constData(), data.size(), consumedSize + READ_SIZE));
+    QCOMPARE(message.getBytesLeftToRead(), (qint64)0);
+    QCOMPARE(message.read(1).size(), 0);
+
+    // consuming again only hands over what was neither consumed nor read
+    packet = createMessagePacket(NUM_CONSUMED_PACKETS + 1, messageSize);
+    message.appendPacket(*packet);
+    qint64 readSize = message.getPosition();
+    QByteArray consumed;
+    message.consumeReceivedData([&consumed](const QByteArray& chunk) {
+        consumed.append(chunk);
+    });
+    QCOMPARE((qint64)consumed.size(), messageSize - readSize);
+    QVERIFY(checkBytes(consumed.constData(), consumed.size(), readSize));
+}
@@ -0,0 +1,31 @@
+//
+//  ReceivedMessageTests.h
+//  tests/networking/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ReceivedMessageTests_h
+#define hifi_ReceivedMessageTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class ReceivedMessageTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test assembling a multi-packet message and reading it back contiguously
+    void assembleTest();
+
+    // Test consuming a multi-packet message chunk by chunk while it arrives
+    void consumeTest();
+
+    // Test reading what arrives after part of a message has been consumed
+    void readAfterConsumeTest();
+};
+
+#endif // hifi_ReceivedMessageTests_h
@@ -0,0 +1,150 @@
+//
+//  SignatureVerifierTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SignatureVerifierTests.h"
+
+#include <QtCore/QCryptographicHash>
+
+#include <DataServerAccountInfo.h>
+#include <RSAKeypairGenerator.h>
+#include <SignatureVerifier.h>
+
+QTEST_MAIN(SignatureVerifierTests)
+
+static const int NUM_VERIFICATIONS = 200;
+static const int VERIFY_TIMEOUT_MSECS = 20000;
+
+static QByteArray sign(const QByteArray& privateKey, const QByteArray& plaintext) {
+    DataServerAccountInfo accountInfo;
+    accountInfo.setPrivateKey(privateKey);
+    return accountInfo.signPlaintext(plaintext);
+}
+
+static QByteArray hash(const QByteArray& plaintext) {
+    return QCryptographicHash::hash(plaintext, QCryptographicHash::Sha256);
+}
+
+// collects the results of a verifier, checking that they arrive on its thread
+class VerificationResults : public QObject {
+public:
+    VerificationResults(SignatureVerifier& verifier) {
+        connect(&verifier, &SignatureVerifier::verified, this, [this, &verifier](QString name, bool isValid) {
+            if (QThread::currentThread() != verifier.thread()) {
+                ++numWrongThread;
+            }
+            results.insert(name, isValid);
+            ++numResults;
+            if (isValid) {
+                ++numValid;
+            }
+        });
+    }
+
+    QHash<QString, bool> results;
+    int numResults { 0 };
+    int numValid { 0 };
+    int numWrongThread { 0 };
+};
+
+void SignatureVerifierTests::initTestCase() {
+    RSAKeypairGenerator generator;
+    generator.generateKeypair();
+    _publicKey = generator.getPublicKey();
+    _privateKey = generator.getPrivateKey();
+
+    generator.generateKeypair();
+    _otherPublicKey = generator.getPublicKey();
+    _otherPrivateKey = generator.getPrivateKey();
+
+    QVERIFY(!_publicKey.isEmpty() && !_otherPublicKey.isEmpty());
+}
+
+void SignatureVerifierTests::concurrentVerificationTest() {
+    SignatureVerifier verifier;
+    VerificationResults results(verifier);
+
+    for (int i = 0; i < NUM_VERIFICATIONS; ++i) {
+        QString name = QString("user%1").arg(i);
+        QByteArray plaintext = name.toUtf8();
+        QByteArray signature = sign(_privateKey, plaintext);
+
+        // every third one is signed with the wrong key
+        if (i % 3 == 0) {
+            signature = sign(_otherPrivateKey, plaintext);
+        }
+        QVERIFY(verifier.verify(name, _publicKey, hash(plaintext), signature));
+    }
+    QVERIFY(verifier.getNumPending() > 0);
+
+    QTRY_COMPARE_WITH_TIMEOUT(results.numResults, NUM_VERIFICATIONS, VERIFY_TIMEOUT_MSECS);
+    QCOMPARE(results.numWrongThread, 0);
+    QCOMPARE(verifier.getNumPending(), 0);
+    QCOMPARE(verifier.getNumCachedKeys(), NUM_VERIFICATIONS);
+
+    for (int i = 0; i < NUM_VERIFICATIONS; ++i) {
+        QCOMPARE(results.results.value(QString("user%1").arg(i)), i % 3 != 0);
+    }
+}
+
+void SignatureVerifierTests::forgetKeyTest() {
+    SignatureVerifier verifier;
+    VerificationResults results(verifier);
+
+    const QString NAME = "user";
+    QByteArray plaintext = NAME.toUtf8();
+
+    // a verification queued with the first key keeps using it once it's forgotten, while the new key is used
+    QVERIFY(verifier.verify(NAME, _publicKey, hash(plaintext), sign(_privateKey, plaintext)));
+    verifier.forgetKey(NAME);
+    QCOMPARE(verifier.getNumCachedKeys(), 0);
+    QVERIFY(verifier.verify(NAME, _otherPublicKey, hash(plaintext), sign(_otherPrivateKey, plaintext)));
+    QTRY_COMPARE_WITH_TIMEOUT(results.numResults, 2, VERIFY_TIMEOUT_MSECS);
+    QCOMPARE(results.numValid, 2);
+
+    // once a key is parsed for a name, it's used until it's forgotten
+    QVERIFY(verifier.verify(NAME, _publicKey, hash(plaintext), sign(_privateKey, plaintext)));
+    QTRY_COMPARE_WITH_TIMEOUT(results.numResults, 3, VERIFY_TIMEOUT_MSECS);
+    QCOMPARE(results.numValid, 2);
+
+    verifier.forgetKey(NAME);
+    QVERIFY(verifier.verify(NAME, _publicKey, hash(plaintext), sign(_privateKey, plaintext)));
+    QTRY_COMPARE_WITH_TIMEOUT(results.numResults, 4, VERIFY_TIMEOUT_MSECS);
+    QCOMPARE(results.numValid, 3);
+    QCOMPARE(results.numWrongThread, 0);
+}
+
+void SignatureVerifierTests::invalidKeyTest() {
+    SignatureVerifier verifier;
+
+    QByteArray plaintext = "user";
+    QVERIFY(!verifier.verify("user", QByteArray("not a key"), hash(plaintext), sign(_privateKey, plaintext)));
+    QCOMPARE(verifier.getNumPending(), 0);
+    QCOMPARE(verifier.getNumCachedKeys(), 0);
+}
+
+void SignatureVerifierTests::destructionTest() {
+    int numResults = 0;
+    {
+        SignatureVerifier verifier;
+        connect(&verifier, &SignatureVerifier::verified, this, [&numResults] {
+            ++numResults;
+        });
+
+        QByteArray plaintext = "user";
+        QByteArray signature = sign(_privateKey, plaintext);
+        for (int i = 0; i < NUM_VERIFICATIONS; ++i) {
+            QVERIFY(verifier.verify(QString("user%1").arg(i), _publicKey, hash(plaintext), signature));
+        }
+    }
+
+    // the results posted before the verifier went are dropped with it
+    QTest::qWait(100);
+    QCOMPARE(numResults, 0);
+}
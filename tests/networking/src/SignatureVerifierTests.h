@@ -0,0 +1,42 @@
+//
+//  SignatureVerifierTests.h
+//  tests/networking/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SignatureVerifierTests_h
+#define hifi_SignatureVerifierTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class SignatureVerifierTests : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    // Test many verifications running at once, their results delivered on the verifier's thread
+    void concurrentVerificationTest();
+
+    // Test replacing a key while verifications with the old one are running
+    void forgetKeyTest();
+
+    // Test an unparseable key
+    void invalidKeyTest();
+
+    // Test destroying the verifier with verifications running
+    void destructionTest();
+
+private:
+    QByteArray _publicKey;
+    QByteArray _privateKey;
+    QByteArray _otherPublicKey;
+    QByteArray _otherPrivateKey;
+};
+
+#endif // hifi_SignatureVerifierTests_h
@@ -0,0 +1,155 @@
+//
+//  OctreeEditBatchTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEditBatchTests.h"
+
+#include <QtCore/QThread>
+
+#include <OctreeEditBatch.h>
+#include <SequenceNumberStats.h>
+
+QTEST_MAIN(OctreeEditBatchTests)
+
+static const int EDITS_PER_PACKET = 3;
+
+class TestEdit : public Octree::DecodedEdit {
+public:
+    TestEdit(quint32 value) : value(value) {}
+    quint32 value;
+};
+
+// Edits are numbers, decoded at uneven speeds so that the decoding threads finish out of order, and the tree logs
+// the edits it applies and the challenges it processes
+class TestOctree : public Octree {
+public:
+    OctreeElementPointer createNewElement(unsigned char* octalCode = NULL) override { return OctreeElementPointer(); }
+    bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues,
+                    bool skipThoseWithBadParents) override { return false; }
+    bool readFromMap(QVariantMap& entityDescription) override { return false; }
+
+    bool handlesEditPacketType(PacketType packetType) const override { return packetType == PacketType::EntityEdit; }
+    bool canDecodeEditPackets() const override { return true; }
+
+    DecodedEditPointer decodeEditPacketData(ReceivedMessage& message, const unsigned char* editData, int maxLength,
+                                            int& bytesRead) const override {
+        quint32 value;
+        if (maxLength < (int)sizeof(value)) {
+            bytesRead = 0;
+            return DecodedEditPointer();
+        }
+        memcpy(&value, editData, sizeof(value));
+        bytesRead = sizeof(value);
+
+        QThread::usleep((value * 7) % 100);
+        return DecodedEditPointer(new TestEdit(value));
+    }
+
+    void applyDecodedEdit(DecodedEdit& edit, const SharedNodePointer& sourceNode) override {
+        log << QString("edit %1").arg(static_cast<TestEdit&>(edit).value);
+    }
+
+    void processChallengeOwnershipPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override {
+        log << "challenge";
+    }
+    void processChallengeOwnershipRequestPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override {
+        log << "request";
+    }
+    void processChallengeOwnershipReplyPacket(ReceivedMessage& message, const SharedNodePointer& sourceNode) override {
+        log << "reply";
+    }
+
+    QStringList log;
+};
+
+static QSharedPointer<ReceivedMessage> createEditMessage(quint32 firstValue) {
+    QByteArray data;
+    for (quint32 value = firstValue; value < firstValue + EDITS_PER_PACKET; ++value) {
+        data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return QSharedPointer<ReceivedMessage>::create(data, PacketType::EntityEdit, 0, HifiSockAddr());
+}
+
+static QSharedPointer<ReceivedMessage> createChallengeMessage(PacketType packetType) {
+    return QSharedPointer<ReceivedMessage>::create(QByteArray(), packetType, 0, HifiSockAddr());
+}
+
+void OctreeEditBatchTests::challengeOrderingTest() {
+    auto tree = std::make_shared<TestOctree>();
+    OctreeEditBatch batch([](const OctreeEditBatch::EditPacket&, quint64) {});
+
+    QStringList expectedLog;
+    const QList<PacketType> challengeTypes {
+        PacketType::ChallengeOwnership, PacketType::ChallengeOwnershipRequest, PacketType::ChallengeOwnershipReply
+    };
+    const QStringList challengeNames { "challenge", "request", "reply" };
+
+    for (int i = 0; i < 100; ++i) {
+        quint32 firstValue = i * EDITS_PER_PACKET;
+        batch.addEditPacket(tree, createEditMessage(firstValue), SharedNodePointer(), (unsigned short int)i, 0);
+        for (quint32 value = firstValue; value < firstValue + EDITS_PER_PACKET; ++value) {
+            expectedLog << QString("edit %1").arg(value);
+        }
+
+        if (i % 10 == 9) {
+            // nothing is applied until the challenge needs it
+            QCOMPARE(tree->log.size(), expectedLog.size() - 10 * EDITS_PER_PACKET);
+
+            int type = (i / 10) % challengeTypes.size();
+            auto message = createChallengeMessage(challengeTypes[type]);
+            batch.processChallengeOwnershipPacket(tree, *message, SharedNodePointer());
+            expectedLog << challengeNames[type];
+
+            QVERIFY(batch.isEmpty());
+            QCOMPARE(tree->log, expectedLog);
+        }
+    }
+}
+
+void OctreeEditBatchTests::nackOrderingTest() {
+    auto tree = std::make_shared<TestOctree>();
+    SequenceNumberStats sequenceNumberStats;
+    OctreeEditBatch batch([&](const OctreeEditBatch::EditPacket& packet, quint64) {
+        sequenceNumberStats.sequenceNumberReceived(packet.sequence);
+    });
+
+    // packet 3 is lost
+    for (unsigned short int sequence : { 0, 1, 2, 4, 5 }) {
+        batch.addEditPacket(tree, createEditMessage(sequence * EDITS_PER_PACKET), SharedNodePointer(), sequence, 0);
+    }
+
+    // the batched packets aren't tracked yet, NACKs computed now would miss them, or ask for them once tracked late
+    QCOMPARE(sequenceNumberStats.getReceived(), (quint32)0);
+
+    batch.flush(tree);
+    QCOMPARE(sequenceNumberStats.getReceived(), (quint32)5);
+    QCOMPARE(sequenceNumberStats.getMissingSet(), QSet<quint16> { 3 });
+    QCOMPARE(tree->log.size(), 5 * EDITS_PER_PACKET);
+}
+
+void OctreeEditBatchTests::fullBatchTest() {
+    auto tree = std::make_shared<TestOctree>();
+    int numApplied = 0;
+    OctreeEditBatch batch([&](const OctreeEditBatch::EditPacket& packet, quint64) {
+        QCOMPARE((int)packet.edits.size(), EDITS_PER_PACKET);
+        ++numApplied;
+    });
+
+    for (size_t i = 0; i < OctreeEditBatch::MAX_PACKETS_PER_BATCH - 1; ++i) {
+        batch.addEditPacket(tree, createEditMessage((quint32)i * EDITS_PER_PACKET), SharedNodePointer(),
+                            (unsigned short int)i, 0);
+    }
+    QCOMPARE(numApplied, 0);
+
+    batch.addEditPacket(tree, createEditMessage(0), SharedNodePointer(), 0, 0);
+    QVERIFY(batch.isEmpty());
+    QCOMPARE(numApplied, (int)OctreeEditBatch::MAX_PACKETS_PER_BATCH);
+    QCOMPARE(batch.getTotalBatches(), (quint64)1);
+    QCOMPARE(batch.getAverageEditsPerBatch(), (float)EDITS_PER_PACKET);
+}
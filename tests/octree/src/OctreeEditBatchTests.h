@@ -0,0 +1,28 @@
+//
+//  OctreeEditBatchTests.h
+//  tests/octree/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEditBatchTests_h
+#define hifi_OctreeEditBatchTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeEditBatchTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    // Test that edits are applied in arrival order, and before the ownership challenges that follow them
+    void challengeOrderingTest();
+    // Test that flushing tracks the batched sequence numbers, so NACKs sent after it only ask for lost packets
+    void nackOrderingTest();
+    // Test that a full batch is applied without waiting for a flush
+    void fullBatchTest();
+};
+
+#endif // hifi_OctreeEditBatchTests_h
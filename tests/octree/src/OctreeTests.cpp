@@ -12,6 +12,10 @@
 //    * need to add expected results and accumulation of test success/failure
 //
 
+#include <atomic>
+#include <random>
+#include <thread>
+
 #include <QDebug>
 
 #include <ByteCountCoding.h>
@@ -20,6 +24,7 @@
 #include <EntityTreeElement.h>
 #include <Octree.h>
 #include <OctreeConstants.h>
+#include <OctreeElementArena.h>
 #include <PropertyFlags.h>
 #include <SharedUtil.h>
 
@@ -827,3 +832,301 @@ void OctreeTests::elementAddChildTests() {
         }
     }
 }
+
+void OctreeTests::elementPackedChildrenTests() {
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    auto e = tree->createNewElement();
+
+    // fill every slot out of order, so each insert lands in the middle of the packed array
+    const int ADD_ORDER[NUMBER_OF_CHILDREN] = { 5, 1, 7, 0, 3, 6, 2, 4 };
+    OctreeElementPointer children[NUMBER_OF_CHILDREN];
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        int childIndex = ADD_ORDER[i];
+        children[childIndex] = e->addChildAtIndex(childIndex);
+        QCOMPARE(e->getChildCount(), i + 1);
+        for (int j = 0; j <= i; j++) {
+            QCOMPARE(e->getChildAtIndex(ADD_ORDER[j]), children[ADD_ORDER[j]]);
+        }
+    }
+
+    // replacing a child keeps the others in place
+    auto replacement = tree->createNewElement();
+    e->setChildAtIndex(3, replacement);
+    QCOMPARE(e->getChildCount(), NUMBER_OF_CHILDREN);
+    QCOMPARE(e->getChildAtIndex(3), replacement);
+    children[3] = replacement;
+
+    const int REMOVE_ORDER[NUMBER_OF_CHILDREN] = { 2, 7, 0, 4, 6, 3, 1, 5 };
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        e->removeChildAtIndex(REMOVE_ORDER[i]);
+        QCOMPARE(e->getChildCount(), NUMBER_OF_CHILDREN - i - 1);
+        QCOMPARE((bool)e->getChildAtIndex(REMOVE_ORDER[i]), false);
+        for (int j = i + 1; j < NUMBER_OF_CHILDREN; j++) {
+            QCOMPARE(e->getChildAtIndex(REMOVE_ORDER[j]), children[REMOVE_ORDER[j]]);
+        }
+    }
+    QCOMPARE(e->isLeaf(), true);
+}
+
+static void addChildrenToDepth(const OctreeElementPointer& element, int depth) {
+    if (depth == 0) {
+        return;
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        addChildrenToDepth(element->addChildAtIndex(i), depth - 1);
+    }
+}
+
+// The element layout the packed children replaced, for the benchmark to compare against: a single child slot plus an
+// external array of all eight children, in an element allocated on its own from the general heap, with its control
+// block in a second allocation, as EntityTree::createNewElement used to do
+class LegacyElement {
+public:
+    using Pointer = std::shared_ptr<LegacyElement>;
+
+    static Pointer create() { return Pointer(new LegacyElement(), [](LegacyElement* element) { delete element; }); }
+
+    Pointer getChildAtIndex(int childIndex) const {
+        switch (numberOfOnes(_childBitmask)) {
+            case 0:
+                return Pointer();
+            case 1:
+                return getNthBit(_childBitmask, 1) == childIndex ? _childrenSingle : Pointer();
+            default:
+                return _externalChildren[childIndex];
+        }
+    }
+
+    Pointer addChildAtIndex(int childIndex) {
+        auto child = create();
+        int previousChildCount = numberOfOnes(_childBitmask);
+        if (previousChildCount == 0) {
+            _childrenSingle = child;
+        } else {
+            if (previousChildCount == 1) {
+                _externalChildren[getNthBit(_childBitmask, 1)] = _childrenSingle;
+                _childrenSingle.reset();
+            }
+            _externalChildren[childIndex] = child;
+        }
+        setAtBit(_childBitmask, childIndex);
+        return child;
+    }
+
+private:
+    Pointer _childrenSingle;
+    Pointer _externalChildren[NUMBER_OF_CHILDREN];
+    unsigned char _childBitmask { 0 };
+    // the rest of an entity tree element, roughly
+    char _otherData[sizeof(EntityTreeElement) - sizeof(OctreeElementPointer*)];
+};
+
+static void addLegacyChildrenToDepth(const LegacyElement::Pointer& element, int depth) {
+    if (depth == 0) {
+        return;
+    }
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        addLegacyChildrenToDepth(element->addChildAtIndex(i), depth - 1);
+    }
+}
+
+// a full visit of every element, the access pattern of recurseTreeWithOperation and DiffTraversal
+template <typename ElementPointer>
+static int visitChildren(const ElementPointer& element) {
+    int visited = 1;
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        auto child = element->getChildAtIndex(i);
+        if (child) {
+            visited += visitChildren(child);
+        }
+    }
+    return visited;
+}
+
+void OctreeTests::traversalThroughputBenchmark() {
+    const int DEPTH = 5;
+    const int NUM_PASSES = 20;
+
+    int expectedElements = 0;
+    for (int level = 0, count = 1; level <= DEPTH; level++, count *= NUMBER_OF_CHILDREN) {
+        expectedElements += count;
+    }
+
+    // before: the previous layout and allocation
+    auto start = usecTimestampNow();
+    auto legacyRoot = LegacyElement::create();
+    addLegacyChildrenToDepth(legacyRoot, DEPTH);
+    auto legacyBuildDuration = usecTimestampNow() - start;
+
+    int legacyVisited = 0;
+    start = usecTimestampNow();
+    for (int pass = 0; pass < NUM_PASSES; pass++) {
+        legacyVisited += visitChildren(legacyRoot);
+    }
+    auto legacyDuration = usecTimestampNow() - start;
+
+    // after: packed children in arena allocated elements
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    start = usecTimestampNow();
+    addChildrenToDepth(tree->getRoot(), DEPTH);
+    auto buildDuration = usecTimestampNow() - start;
+
+    int visited = 0;
+    start = usecTimestampNow();
+    for (int pass = 0; pass < NUM_PASSES; pass++) {
+        visited += visitChildren(tree->getRoot());
+    }
+    auto duration = usecTimestampNow() - start;
+
+    // and through the tree's own recursion, which adds its operation's overhead
+    int operationVisited = 0;
+    start = usecTimestampNow();
+    for (int pass = 0; pass < NUM_PASSES; pass++) {
+        tree->recurseTreeWithOperation([&](const OctreeElementPointer& element, void* extraData) {
+            operationVisited++;
+            return true;
+        });
+    }
+    auto operationDuration = usecTimestampNow() - start;
+
+    auto elementsPerSecond = [](int visits, quint64 usecs) {
+        return usecs > 0 ? (float)visits * USECS_PER_SECOND / usecs : 0.0f;
+    };
+    qDebug() << "Octree build:" << expectedElements << "elements in" << (float)buildDuration / USECS_PER_MSEC
+        << "ms, was" << (float)legacyBuildDuration / USECS_PER_MSEC << "ms with the previous layout";
+    qDebug() << "Octree traversal:" << elementsPerSecond(visited, duration) << "elements/sec, was"
+        << elementsPerSecond(legacyVisited, legacyDuration) << "elements/sec with the previous layout,"
+        << (duration > 0 ? (float)legacyDuration / duration : 0.0f) << "x";
+    qDebug() << "Octree traversal through recurseTreeWithOperation:"
+        << elementsPerSecond(operationVisited, operationDuration) << "elements/sec";
+
+    QCOMPARE(legacyVisited, expectedElements * NUM_PASSES);
+    QCOMPARE(visited, expectedElements * NUM_PASSES);
+    QCOMPARE(operationVisited, expectedElements * NUM_PASSES);
+}
+
+// counts the elements below element, and the ones whose cube isn't half their parent's or whose child count
+// doesn't match the children they hold
+static int walkChildren(const OctreeElementPointer& element, int& badElements) {
+    int visited = 1;
+    int childCount = 0;
+    for (int i = 0; i < NUMBER_OF_CHILDREN; i++) {
+        OctreeElementPointer child = element->getChildAtIndex(i);
+        if (child) {
+            childCount++;
+            if (child->getAACube().getScale() != element->getAACube().getScale() / 2.0f) {
+                badElements++;
+            }
+            visited += walkChildren(child, badElements);
+        }
+    }
+    if (childCount != element->getChildCount() || (childCount == 0) != element->isLeaf()) {
+        badElements++;
+    }
+    return visited;
+}
+
+void OctreeTests::concurrentEditWalkTest() {
+    const int DEPTH = 4;
+    const int NUM_WALKS = 200;
+    EntityTreePointer tree = std::make_shared<EntityTree>();
+    addChildrenToDepth(tree->getRoot(), DEPTH);
+
+    // an edit thread that keeps adding and removing subtrees, each edit reshaping some element's children
+    std::atomic<bool> isWalking { true };
+    std::atomic<int> numEdits { 0 };
+    std::thread editThread([&] {
+        std::mt19937 random(1);
+        while (isWalking) {
+            tree->withWriteLock([&] {
+                OctreeElementPointer element = tree->getRoot();
+                int depth = 1 + random() % (DEPTH - 1);
+                for (int level = 0; level < depth && element; level++) {
+                    element = element->getChildAtIndex(random() % NUMBER_OF_CHILDREN);
+                }
+                if (element) {
+                    int childIndex = random() % NUMBER_OF_CHILDREN;
+                    if (element->getChildAtIndex(childIndex)) {
+                        element->removeChildAtIndex(childIndex);
+                    } else {
+                        addChildrenToDepth(element->addChildAtIndex(childIndex), 1);
+                    }
+                }
+            });
+            numEdits++;
+        }
+    });
+
+    int numVisited = 0;
+    int badElements = 0;
+    for (int walk = 0; walk < NUM_WALKS; walk++) {
+        int operationVisits = 0;
+        tree->withReadLock([&] {
+            numVisited += walkChildren(tree->getRoot(), badElements);
+
+            tree->recurseTreeWithOperation([&](const OctreeElementPointer& element, void* extraData) {
+                operationVisits++;
+                return true;
+            });
+        });
+        QVERIFY(operationVisits > 0);
+    }
+
+    isWalking = false;
+    editThread.join();
+
+    QVERIFY(numEdits > 0);
+    QVERIFY(numVisited > NUM_WALKS);
+    QCOMPARE(badElements, 0);
+}
+
+void OctreeTests::elementArenaThreadsTest() {
+    struct Block {
+        int owner;
+        int index;
+        char padding[56];
+    };
+    using Arena = OctreeElementSlabArena<sizeof(Block), alignof(Block)>;
+    const int NUM_THREADS = 4;
+    const int NUM_ROUNDS = 50;
+    const int BLOCKS_PER_ROUND = 1000;
+
+    // each thread keeps a third of its blocks from one round to the next, so blocks move through the threads' caches
+    // and the shared pool, and are freed on a thread that exits with blocks still cached
+    std::atomic<int> badBlocks { 0 };
+    std::vector<std::thread> threads;
+    for (int owner = 0; owner < NUM_THREADS; owner++) {
+        threads.emplace_back([&, owner] {
+            std::vector<Block*> blocks;
+            for (int round = 0; round < NUM_ROUNDS; round++) {
+                for (int i = 0; i < BLOCKS_PER_ROUND; i++) {
+                    Block* block = static_cast<Block*>(Arena::getInstance().allocate());
+                    block->owner = owner;
+                    block->index = (int)blocks.size();
+                    blocks.push_back(block);
+                }
+                for (int i = 0; i < (int)blocks.size(); i++) {
+                    if (blocks[i]->owner != owner || blocks[i]->index != i) {
+                        badBlocks++;
+                    }
+                }
+                size_t kept = blocks.size() / 3;
+                for (size_t i = kept; i < blocks.size(); i++) {
+                    Arena::getInstance().deallocate(blocks[i]);
+                }
+                blocks.resize(kept);
+            }
+            for (Block* block : blocks) {
+                Arena::getInstance().deallocate(block);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(badBlocks.load(), 0);
+    // the exited threads' caches went back to the pool
+    QCOMPARE(Arena::getInstance().getBlocksInUse(), (size_t)0);
+    QVERIFY(Arena::getInstance().getReservedBytes() > 0);
+}
@@ -26,6 +26,12 @@ private slots:
     void modelItemTests();
 
     void elementAddChildTests();
+    void elementPackedChildrenTests();
+    void traversalThroughputBenchmark();
+    // walks the tree under its read lock, the way the send threads and the persist pass do, while elements are added
+    // and removed under the write lock
+    void concurrentEditWalkTest();
+    void elementArenaThreadsTest();
 
     // TODO: Break these into separate test functions
 };
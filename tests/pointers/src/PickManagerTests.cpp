@@ -0,0 +1,317 @@
+//
+//  PickManagerTests.cpp
+//  tests/pointers/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PickManagerTests.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <random>
+#include <thread>
+
+#include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
+
+#include <PickManager.h>
+
+QTEST_MAIN(PickManagerTests)
+
+static const int NUM_FRAMES = 2000;
+static const int NUM_PICKS = 8;
+static const int NUM_ITEMS = 20;
+static const float CURSOR_DISTANCE = 0.5f;
+static const float MIN_ITEM_DISTANCE = 1.0f;
+static const float MAX_ITEM_DISTANCE = 10.0f;
+
+class TestPickResult : public PickResult {
+public:
+    TestPickResult() {}
+    TestPickResult(const QVariantMap& pickVariant) : PickResult(pickVariant) {}
+    TestPickResult(const QUuid& objectID, float distance, bool isTorn) :
+        objectID(objectID), distance(distance), isTorn(isTorn) {}
+
+    bool doesIntersect() const override { return !objectID.isNull(); }
+
+    PickResultPointer compareAndProcessNewResult(const PickResultPointer& newRes) override {
+        auto newResult = std::static_pointer_cast<TestPickResult>(newRes);
+        if (newResult->distance < distance) {
+            return std::make_shared<TestPickResult>(*newResult);
+        }
+        return std::make_shared<TestPickResult>(*this);
+    }
+
+    bool checkOrFilterAgainstMaxDistance(float maxDistance) override { return distance < maxDistance; }
+
+    QUuid objectID;
+    float distance { FLT_MAX };
+    bool isTorn { false };
+};
+
+// An item's geometry is rebuilt by every edit, the way a model's triangles are when it reloads, so an intersection
+// that reads it unlocked, mid-edit, sees triangles at different distances or freed memory.
+struct TestItem {
+    std::vector<float> triangleDistances;
+};
+
+using TestItems = QHash<QUuid, TestItem>;
+
+static PickResultPointer intersectItems(const TestItems& items, const QVector<QUuid>& ignore) {
+    auto result = std::make_shared<TestPickResult>();
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        if (ignore.contains(it.key())) {
+            continue;
+        }
+        const auto& triangles = it->triangleDistances;
+        for (float triangleDistance : triangles) {
+            result->isTorn = result->isTorn || triangleDistance != triangles.front();
+            if (triangleDistance < result->distance) {
+                result->objectID = it.key();
+                result->distance = triangleDistance;
+            }
+        }
+    }
+    return result;
+}
+
+static TestItem createItem(float distance, size_t numTriangles) {
+    return { std::vector<float>(numTriangles, distance) };
+}
+
+// Stands in for the entity tree, whose queries and edits take its read and write locks, and for the overlays, whose
+// queries and edits take their mutex.  Each scene has a cursor in front of everything else, which the picks ignore.
+class TestScene {
+public:
+    TestScene() {
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            _entities.insert(QUuid::createUuid(), createItem(MIN_ITEM_DISTANCE + i, 1));
+            _overlays.insert(QUuid::createUuid(), createItem(MIN_ITEM_DISTANCE + i + 0.5f, 1));
+        }
+        _entities.insert(entityCursor, createItem(CURSOR_DISTANCE, 1));
+        _overlays.insert(overlayCursor, createItem(CURSOR_DISTANCE, 1));
+    }
+
+    PickResultPointer intersectEntities(const QVector<QUuid>& ignore) const {
+        QReadLocker locker(&_entitiesLock);
+        return intersectItems(_entities, ignore);
+    }
+
+    PickResultPointer intersectOverlays(const QVector<QUuid>& ignore) const {
+        QMutexLocker locker(&_overlaysMutex);
+        return intersectItems(_overlays, ignore);
+    }
+
+    // moves, reshapes, or deletes and re-adds one item that isn't the cursor
+    void editEntity(std::mt19937& random) {
+        QWriteLocker locker(&_entitiesLock);
+        editItem(_entities, entityCursor, random);
+    }
+
+    void editOverlay(std::mt19937& random) {
+        QMutexLocker locker(&_overlaysMutex);
+        editItem(_overlays, overlayCursor, random);
+    }
+
+    const QUuid entityCursor { QUuid::createUuid() };
+    const QUuid overlayCursor { QUuid::createUuid() };
+
+private:
+    static void editItem(TestItems& items, const QUuid& cursor, std::mt19937& random) {
+        std::uniform_real_distribution<float> distance(MIN_ITEM_DISTANCE, MAX_ITEM_DISTANCE);
+        std::uniform_int_distribution<size_t> numTriangles(1, 64);
+
+        auto it = items.begin() + std::uniform_int_distribution<int>(0, items.size() - 1)(random);
+        if (it.key() == cursor) {
+            return;
+        }
+        if (random() % 8 == 0) {
+            items.erase(it);
+            items.insert(QUuid::createUuid(), createItem(distance(random), numTriangles(random)));
+        } else {
+            it->triangleDistances.clear();
+            it->triangleDistances.shrink_to_fit();
+            it->triangleDistances.resize(numTriangles(random), distance(random));
+        }
+    }
+
+    mutable QReadWriteLock _entitiesLock;
+    TestItems _entities;
+    mutable QMutex _overlaysMutex;
+    TestItems _overlays;
+};
+
+class TestRayPick : public Pick<PickRay> {
+public:
+    TestRayPick(const TestScene& scene, const PickRay& ray) :
+        Pick(PickFilter(PickFilter::getBitMask(PickFilter::PICK_ENTITIES) | PickFilter::getBitMask(PickFilter::PICK_OVERLAYS)),
+             0.0f, true),
+        _scene(scene), _ray(ray) {}
+
+    PickRay getMathematicalPick() const override { return _ray; }
+    PickResultPointer getDefaultResult(const QVariantMap& pickVariant) const override {
+        return std::make_shared<TestPickResult>(pickVariant);
+    }
+
+    PickResultPointer getEntityIntersection(const PickRay&) override {
+        return _scene.intersectEntities(getIgnoreItems());
+    }
+    PickResultPointer getOverlayIntersection(const PickRay&) override {
+        return _scene.intersectOverlays(getIgnoreItems());
+    }
+    PickResultPointer getAvatarIntersection(const PickRay&) override { return PickResultPointer(); }
+    PickResultPointer getHUDIntersection(const PickRay&) override { return PickResultPointer(); }
+
+    bool canIntersectConcurrently(IntersectionType type) const override { return type == ENTITY || type == OVERLAY; }
+
+private:
+    const TestScene& _scene;
+    const PickRay _ray;
+};
+
+// a result must hit an item behind the cursors, read whole
+static bool isValidResult(const PickResultPointer& result, const TestScene& scene) {
+    auto testResult = std::static_pointer_cast<TestPickResult>(result);
+    return testResult && testResult->doesIntersect() && !testResult->isTorn &&
+        testResult->objectID != scene.entityCursor && testResult->objectID != scene.overlayCursor &&
+        testResult->distance >= MIN_ITEM_DISTANCE && testResult->distance < MAX_ITEM_DISTANCE + NUM_ITEMS;
+}
+
+void PickManagerTests::concurrentEditTest() {
+    TestScene scene;
+    PickManager pickManager;
+
+    QVector<QUuid> ignore { scene.entityCursor, scene.overlayCursor };
+    std::vector<unsigned int> pickIDs;
+    for (int i = 0; i < NUM_PICKS; ++i) {
+        // half of the picks share a ray, and so their intersections
+        PickRay ray(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, (i % 2 == 0) ? -1.0f : -1.0f - i));
+        auto pick = std::make_shared<TestRayPick>(scene, ray);
+        pick->setIgnoreItems(ignore);
+        pickIDs.push_back(pickManager.addPick(PickQuery::Ray, pick));
+    }
+
+    std::atomic<bool> isUpdating { true };
+    std::atomic<int> numInvalidResults { 0 };
+
+    std::thread entityEditor([&] {
+        std::mt19937 random(1);
+        while (isUpdating) {
+            scene.editEntity(random);
+        }
+    });
+
+    std::thread overlayEditor([&] {
+        std::mt19937 random(2);
+        while (isUpdating) {
+            scene.editOverlay(random);
+        }
+    });
+
+    // a script thread, adding and removing picks of its own, editing the others and reading their results
+    std::thread scriptThread([&] {
+        std::mt19937 random(3);
+        while (isUpdating) {
+            auto pick = std::make_shared<TestRayPick>(scene, PickRay(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f)));
+            pick->setIgnoreItems(ignore);
+            unsigned int scriptPickID = pickManager.addPick(PickQuery::Ray, pick);
+
+            unsigned int pickID = pickIDs[random() % pickIDs.size()];
+            pickManager.setIgnoreItems(pickID, (random() % 2 == 0) ? ignore : QVector<QUuid> { ignore[1], ignore[0] });
+            pickManager.setPrecisionPicking(pickID, random() % 2 == 0);
+
+            auto result = pickManager.getPrevPickResult(pickID);
+            if (result && result->doesIntersect() && !isValidResult(result, scene)) {
+                ++numInvalidResults;
+            }
+
+            pickManager.removePick(scriptPickID);
+        }
+    });
+
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        pickManager.update();
+
+        for (auto pickID : pickIDs) {
+            if (!isValidResult(pickManager.getPrevPickResult(pickID), scene)) {
+                ++numInvalidResults;
+            }
+        }
+    }
+
+    isUpdating = false;
+    entityEditor.join();
+    overlayEditor.join();
+    scriptThread.join();
+
+    QCOMPARE((int)numInvalidResults, 0);
+    for (auto pickID : pickIDs) {
+        QVERIFY(pickManager.getUpdateStats(pickID)["updates"].toInt() > 0);
+    }
+}
+
+// Hits every ray at the length of its direction, and records the size of the entity batches it computes
+class TestBatchPick : public Pick<PickRay> {
+public:
+    TestBatchPick(const PickRay& ray, std::vector<size_t>& batchSizes) :
+        Pick(PickFilter(PickFilter::getBitMask(PickFilter::PICK_ENTITIES)), 0.0f, true),
+        _ray(ray), _batchSizes(batchSizes) {}
+
+    PickRay getMathematicalPick() const override { return _ray; }
+    PickResultPointer getDefaultResult(const QVariantMap& pickVariant) const override {
+        return std::make_shared<TestPickResult>(pickVariant);
+    }
+
+    PickResultPointer getEntityIntersection(const PickRay& pick) override {
+        return std::make_shared<TestPickResult>(HIT_ID, glm::length(pick.direction), false);
+    }
+    std::vector<PickResultPointer> getEntityIntersections(const std::vector<PickRay>& picks) override {
+        _batchSizes.push_back(picks.size());
+        return Pick::getEntityIntersections(picks);
+    }
+    PickResultPointer getOverlayIntersection(const PickRay&) override { return PickResultPointer(); }
+    PickResultPointer getAvatarIntersection(const PickRay&) override { return PickResultPointer(); }
+    PickResultPointer getHUDIntersection(const PickRay&) override { return PickResultPointer(); }
+
+    static const QUuid HIT_ID;
+
+private:
+    const PickRay _ray;
+    std::vector<size_t>& _batchSizes;
+};
+
+const QUuid TestBatchPick::HIT_ID { QUuid::createUuid() };
+
+void PickManagerTests::entityBatchTest() {
+    const int NUM_BATCH_PICKS = 6;
+    PickManager pickManager;
+    std::vector<size_t> batchSizes;
+
+    // picks 0 to 3 ignore one item and picks 4 and 5 another, and picks 0 and 1 share their ray
+    QVector<QUuid> ignore { QUuid::createUuid() };
+    QVector<QUuid> otherIgnore { QUuid::createUuid() };
+    std::vector<unsigned int> pickIDs;
+    for (int i = 0; i < NUM_BATCH_PICKS; ++i) {
+        PickRay ray(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f - std::max(i, 1)));
+        auto pick = std::make_shared<TestBatchPick>(ray, batchSizes);
+        pick->setIgnoreItems(i < 4 ? ignore : otherIgnore);
+        pickIDs.push_back(pickManager.addPick(PickQuery::Ray, pick));
+    }
+
+    pickManager.update();
+
+    std::sort(batchSizes.begin(), batchSizes.end());
+    QCOMPARE(batchSizes, std::vector<size_t>({ 2, 3 }));
+
+    for (int i = 0; i < NUM_BATCH_PICKS; ++i) {
+        auto result = std::static_pointer_cast<TestPickResult>(pickManager.getPrevPickResult(pickIDs[i]));
+        QVERIFY(result && result->doesIntersect());
+        QCOMPARE(result->objectID, TestBatchPick::HIT_ID);
+        QCOMPARE(result->distance, 1.0f + std::max(i, 1));
+    }
+}
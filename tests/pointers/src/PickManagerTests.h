@@ -0,0 +1,27 @@
+//
+//  PickManagerTests.h
+//  tests/pointers/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PickManagerTests_h
+#define hifi_PickManagerTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PickManagerTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test picks evaluated on the worker threads while the scene they query and the picks themselves are edited
+    void concurrentEditTest();
+    // Test that the entity intersections with the same filter and lists are computed as one batch
+    void entityBatchTest();
+};
+
+#endif // hifi_PickManagerTests_h
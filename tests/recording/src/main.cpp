@@ -97,6 +97,54 @@ void testClipOrdering() {
     Q_UNUSED(lastFrameTimeOffset); // FIXME - Unix build not yet upgraded to Qt 5.5.1 we can remove this once it is
 }
 
+void testChunkedPlayback() {
+    QTemporaryFile file;
+    QString fileName;
+    if (file.open()) {
+        fileName = file.fileName();
+        file.close();
+    }
+
+    // enough data for many chunks
+    const int FRAME_COUNT = 5000;
+    auto writeClip = Clip::newClip();
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        QByteArray data(100 + (i % 50), (char)i);
+        writeClip->addFrame(std::make_shared<Frame>(TEST_FRAME_TYPE, (float)(i * 10), data));
+    }
+    Clip::toFile(fileName, writeClip);
+
+    // two cursors over the same recording play independently
+    auto readClip = Clip::fromFile(fileName);
+    auto otherClip = Clip::fromFile(fileName);
+    QVERIFY(readClip != Clip::Pointer());
+    QVERIFY(readClip->frameCount() == FRAME_COUNT);
+    QVERIFY(readClip->positionFrameTime() == 0);
+
+    readClip->seekFrameTime(30000);
+    QVERIFY(readClip->positionFrameTime() == 30000);
+    auto frame = readClip->nextFrame();
+    QVERIFY(frame && frame->data == QByteArray(100 + (3000 % 50), (char)3000));
+    QVERIFY(readClip->positionFrameTime() == 30010);
+
+    // seeking between frames lands on the next frame
+    otherClip->seekFrameTime(12345);
+    QVERIFY(otherClip->positionFrameTime() == 12350);
+    QVERIFY(readClip->positionFrameTime() == 30010);
+
+    // seeking past the end
+    readClip->seekFrameTime(FRAME_COUNT * 10);
+    QVERIFY(!readClip->peekFrame());
+    QVERIFY(readClip->positionFrameTime() == Frame::INVALID_TIME);
+
+    size_t count = 0;
+    readClip->seek(0);
+    for (auto readFrame = readClip->nextFrame(); readFrame; readFrame = readClip->nextFrame(), ++count) {
+        QVERIFY(readFrame->timeOffset == count * 10);
+    }
+    QVERIFY(count == FRAME_COUNT);
+}
+
 #ifdef Q_OS_WIN32
 void myMessageHandler(QtMsgType type, const QMessageLogContext & context, const QString & msg) {
     OutputDebugStringA(msg.toLocal8Bit().toStdString().c_str());
@@ -111,4 +159,5 @@ int main(int, const char**) {
     testFrameTypeRegistration();
     testFilePersist();
     testClipOrdering();
+    testChunkedPlayback();
 }
\ No newline at end of file
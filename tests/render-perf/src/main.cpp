@@ -497,6 +497,7 @@ public:
         DependencyManager::set<ModelCache>();
         DependencyManager::set<AnimationCache>();
         DependencyManager::set<ModelBlender>();
+        DependencyManager::set<ModelSkinningBatch>();
         DependencyManager::set<PathUtils>();
         DependencyManager::set<SceneScriptingInterface>();
         DependencyManager::set<TestActionFactory>();
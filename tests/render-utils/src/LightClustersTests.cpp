@@ -0,0 +1,321 @@
+//
+//  LightClustersTests.cpp
+//  tests/render-utils/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LightClustersTests.h"
+
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include <LightClusters.h>
+
+QTEST_MAIN(LightClustersTests)
+
+static const float NEAR_CLIP = 0.1f;
+static const float FAR_CLIP = 1000.0f;
+
+static ViewFrustum makeFrustum() {
+    ViewFrustum frustum;
+    frustum.setProjection(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, NEAR_CLIP, FAR_CLIP));
+    frustum.setPosition(glm::vec3(0.0f));
+    frustum.setOrientation(glm::quat());
+    frustum.calculate();
+    return frustum;
+}
+
+// Scatter lights in front of the camera (looking down -z), most of them inside the clustered range
+static LightClusters::LightSpheres makeLights(int numLights, float spotRatio) {
+    std::mt19937 generator(numLights);
+    std::uniform_real_distribution<float> depth(1.0f, 250.0f);
+    std::uniform_real_distribution<float> spread(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 10.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    LightClusters::LightSpheres lights(numLights);
+    for (int i = 0; i < numLights; i++) {
+        auto& light = lights[i];
+        float z = depth(generator);
+        light.position = glm::vec3(spread(generator) * z, spread(generator) * z * 0.6f, -z);
+        light.radius = radius(generator);
+        light.id = (LightClusters::LightID)i;
+        light.isSpot = unit(generator) < spotRatio;
+    }
+    return lights;
+}
+
+using LightIndexLists = std::vector<std::vector<LightClusters::LightIndex>>;
+
+static float serialDistanceToPlane(const glm::vec3& point, const glm::vec4& plane) {
+    return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+}
+
+static bool serialReduceSphereToPlane(const glm::vec4& sphere, const glm::vec4& plane, glm::vec4& reducedSphere) {
+    float distance = serialDistanceToPlane(glm::vec3(sphere), plane);
+
+    if (std::abs(distance) <= sphere.w) {
+        reducedSphere = glm::vec4(sphere.x - distance * plane.x, sphere.y - distance * plane.y, sphere.z - distance * plane.z, sqrt(sphere.w * sphere.w - distance * distance));
+        return true;
+    }
+
+    return false;
+}
+
+// The clustering as it was done before it went parallel: one light at a time, appending to a list per cluster.
+// Kept here as the reference the per-slice passes must reproduce.
+static void serialClusterLights(const LightClusters& clusters, const LightClusters::LightSpheres& lights,
+                                LightIndexLists& clusterGridPoint, LightIndexLists& clusterGridSpot) {
+    auto grid(clusters._frustumGridBuffer.get());
+    const auto& xPlanes = clusters._gridPlanes[0];
+    const auto& yPlanes = clusters._gridPlanes[1];
+    const auto& zPlanes = clusters._gridPlanes[2];
+
+    clusterGridPoint.assign(clusters._clusterGrid.size(), std::vector<LightClusters::LightIndex>());
+    clusterGridSpot.assign(clusters._clusterGrid.size(), std::vector<LightClusters::LightIndex>());
+
+    for (const auto& light : lights) {
+        auto radius = light.radius;
+        auto eyeOri = grid.frustumGrid_worldToEye(glm::vec4(light.position, 1.0f));
+
+        float eyeZMax = eyeOri.z - radius;
+        if (eyeZMax > -grid.rangeNear) {
+            continue;
+        }
+        float eyeZMin = eyeOri.z + radius;
+        bool beyondFar = (eyeZMin < -grid.rangeFar);
+
+        int zMin = grid.frustumGrid_eyeDepthToClusterLayer(eyeZMin);
+        int zMax = grid.frustumGrid_eyeDepthToClusterLayer(eyeZMax);
+        if ((zMin == -2 && zMax == -2) || (zMin == -1 && zMax == -1)) {
+            continue;
+        }
+        zMin = std::max(0, zMin);
+
+        auto xLeftDistance = radius - serialDistanceToPlane(eyeOri, xPlanes[0]);
+        auto xRightDistance = radius + serialDistanceToPlane(eyeOri, xPlanes.back());
+        auto yBottomDistance = radius - serialDistanceToPlane(eyeOri, yPlanes[0]);
+        auto yTopDistance = radius + serialDistanceToPlane(eyeOri, yPlanes.back());
+        if ((xLeftDistance < 0.f) || (xRightDistance < 0.f) || (yBottomDistance < 0.f) || (yTopDistance < 0.f)) {
+            continue;
+        }
+
+        int xMin { 0 };
+        int xMax { grid.dims.x - 1 };
+        int yMin { 0 };
+        int yMax { grid.dims.y - 1 };
+
+        float radius2 = radius * radius;
+        auto eyeOriH = glm::vec3(eyeOri);
+        auto eyeOriV = glm::vec3(eyeOri);
+        eyeOriH.y = 0.0f;
+        eyeOriV.x = 0.0f;
+        float eyeOriLen2H = glm::length2(eyeOriH);
+        float eyeOriLen2V = glm::length2(eyeOriV);
+
+        if ((eyeOriLen2H > radius2)) {
+            float eyeOriLenH = sqrt(eyeOriLen2H);
+            auto eyeOriDirH = glm::vec3(eyeOriH) / eyeOriLenH;
+            float eyeToTangentCircleCosH = sqrt(eyeOriLen2H - radius2) / eyeOriLenH;
+            float eyeToTangentCircleSinH = radius / eyeOriLenH;
+
+            glm::vec3 leftDir(eyeOriDirH.x * eyeToTangentCircleCosH + eyeOriDirH.z * eyeToTangentCircleSinH, 0.0f, eyeOriDirH.x * -eyeToTangentCircleSinH + eyeOriDirH.z * eyeToTangentCircleCosH);
+            glm::vec3 rightDir(eyeOriDirH.x * eyeToTangentCircleCosH - eyeOriDirH.z * eyeToTangentCircleSinH, 0.0f, eyeOriDirH.x * eyeToTangentCircleSinH + eyeOriDirH.z * eyeToTangentCircleCosH);
+
+            auto lc = grid.frustumGrid_eyeToClusterDirH(leftDir);
+            if (lc > xMax) {
+                lc = xMin;
+            }
+            auto rc = grid.frustumGrid_eyeToClusterDirH(rightDir);
+            if (rc < 0) {
+                rc = xMax;
+            }
+            xMin = std::max(xMin, lc);
+            xMax = std::min(rc, xMax);
+        }
+
+        if ((eyeOriLen2V > radius2)) {
+            float eyeOriLenV = sqrt(eyeOriLen2V);
+            auto eyeOriDirV = glm::vec3(eyeOriV) / eyeOriLenV;
+            float eyeToTangentCircleCosV = sqrt(eyeOriLen2V - radius2) / eyeOriLenV;
+            float eyeToTangentCircleSinV = radius / eyeOriLenV;
+
+            glm::vec3 bottomDir(0.0f, eyeOriDirV.y * eyeToTangentCircleCosV + eyeOriDirV.z * eyeToTangentCircleSinV, eyeOriDirV.y * -eyeToTangentCircleSinV + eyeOriDirV.z * eyeToTangentCircleCosV);
+            glm::vec3 topDir(0.0f, eyeOriDirV.y * eyeToTangentCircleCosV - eyeOriDirV.z * eyeToTangentCircleSinV, eyeOriDirV.y * eyeToTangentCircleSinV + eyeOriDirV.z * eyeToTangentCircleCosV);
+
+            auto bc = grid.frustumGrid_eyeToClusterDirV(bottomDir);
+            auto tc = grid.frustumGrid_eyeToClusterDirV(topDir);
+            if (bc > yMax) {
+                bc = yMin;
+            }
+            if (tc < 0) {
+                tc = yMax;
+            }
+            yMin = std::max(yMin, bc);
+            yMax = std::min(tc, yMax);
+        }
+
+        auto& clusterGrid = (light.isSpot ? clusterGridSpot : clusterGridPoint);
+        auto lightId = (LightClusters::LightIndex)light.id;
+
+        if (beyondFar) {
+            for (auto y = yMin; (y <= yMax); y++) {
+                for (auto x = xMin; (x <= xMax); x++) {
+                    clusterGrid[grid.frustumGrid_clusterToIndex(glm::ivec3(x, y, zMin))].emplace_back(lightId);
+                }
+            }
+            continue;
+        }
+
+        auto center = grid.frustumGrid_eyeToClusterPos(glm::vec3(eyeOri));
+        for (auto z = zMin; (z <= zMax); z++) {
+            auto zSphere = glm::vec4(glm::vec3(eyeOri), radius);
+            if (z != center.z) {
+                auto plane = (z < center.z) ? zPlanes[z + 1] : -zPlanes[z];
+                if (!serialReduceSphereToPlane(zSphere, plane, zSphere)) {
+                    continue;
+                }
+            }
+            for (auto y = yMin; (y <= yMax); y++) {
+                auto ySphere = zSphere;
+                if (y != center.y) {
+                    auto plane = (y < center.y) ? yPlanes[y + 1] : -yPlanes[y];
+                    if (!serialReduceSphereToPlane(ySphere, plane, ySphere)) {
+                        continue;
+                    }
+                }
+
+                glm::vec3 spherePoint(ySphere);
+                auto x = xMin;
+                for (; (x < xMax); ++x) {
+                    if (serialDistanceToPlane(spherePoint, xPlanes[x + 1]) + ySphere.w >= 0.0f) {
+                        break;
+                    }
+                }
+                auto xs = xMax;
+                for (; (xs >= x); --xs) {
+                    if (serialDistanceToPlane(spherePoint, -xPlanes[xs]) + ySphere.w >= 0.0f) {
+                        break;
+                    }
+                }
+
+                for (; (x <= xs); x++) {
+                    auto index = grid.frustumGrid_clusterToIndex(glm::ivec3(x, y, z));
+                    if (index < (int)clusterGrid.size()) {
+                        clusterGrid[index].emplace_back(lightId);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void LightClustersTests::testClusterContent() {
+    LightClusters clusters;
+    clusters.setRangeNearFar(0.1f, 200.0f);
+    clusters.setDimensions(glm::uvec3(14, 14, 14));
+    clusters.updateFrustum(makeFrustum());
+
+    auto lights = makeLights(200, 0.5f);
+    auto stats = clusters.clusterLights(lights);
+    QCOMPARE(stats.x, 200);
+    QVERIFY(stats.y > 0);
+    QVERIFY(stats.z >= stats.y);
+
+    // Every cluster must reference a valid range of the content, points first then spots
+    uint32_t totalReferences = 0;
+    for (auto cluster : clusters._clusterGrid) {
+        if (cluster == clusters.EMPTY_CLUSTER) {
+            continue;
+        }
+        uint32_t offset = (cluster & 0x0000FFFF);
+        uint32_t numPoints = (cluster & 0x00FF0000) >> 16;
+        uint32_t numSpots = (cluster & 0xFF000000) >> 24;
+        QVERIFY(offset + numPoints + numSpots <= clusters._clusterContentSize);
+        for (uint32_t i = 0; i < numPoints; i++) {
+            auto lightId = clusters._clusterContent[offset + i];
+            QVERIFY(lightId < lights.size());
+            QVERIFY(!lights[lightId].isSpot);
+        }
+        for (uint32_t i = numPoints; i < numPoints + numSpots; i++) {
+            auto lightId = clusters._clusterContent[offset + i];
+            QVERIFY(lightId < lights.size());
+            QVERIFY(lights[lightId].isSpot);
+        }
+        totalReferences += numPoints + numSpots;
+    }
+    QCOMPARE(totalReferences, clusters._clusterContentSize);
+
+    // Clustering the same set twice must give the same layout
+    auto grid = clusters._clusterGrid;
+    auto content = clusters._clusterContent;
+    clusters.clusterLights(lights);
+    QCOMPARE(clusters._clusterGrid, grid);
+    QCOMPARE(clusters._clusterContent, content);
+}
+
+void LightClustersTests::testMatchesSerialClustering() {
+    LightClusters clusters;
+    clusters.setRangeNearFar(0.1f, 200.0f);
+    clusters.setDimensions(glm::uvec3(14, 14, 14));
+    clusters.updateFrustum(makeFrustum());
+
+    // Some of these lights straddle the far range, so the box path is compared as well as the sphere one
+    auto lights = makeLights(300, 0.4f);
+    clusters.clusterLights(lights);
+
+    LightIndexLists serialPoints;
+    LightIndexLists serialSpots;
+    serialClusterLights(clusters, lights, serialPoints, serialSpots);
+
+    size_t serialReferences = 0;
+    for (size_t i = 0; i < serialPoints.size(); i++) {
+        serialReferences += serialPoints[i].size() + serialSpots[i].size();
+    }
+    QVERIFY(serialReferences > 0);
+    // the content budget must hold every reference, or the comparison would be against a truncated grid
+    QVERIFY(serialReferences <= clusters._clusterContent.size());
+    QCOMPARE((size_t)clusters._clusterContentSize, serialReferences);
+
+    // Both must give every cluster the same lights, in the same order
+    QCOMPARE(clusters._clusterGrid.size(), serialPoints.size());
+    for (size_t i = 0; i < clusters._clusterGrid.size(); i++) {
+        auto cluster = clusters._clusterGrid[i];
+        uint32_t offset = (cluster & 0x0000FFFF);
+        uint32_t numPoints = (cluster & 0x00FF0000) >> 16;
+        uint32_t numSpots = (cluster & 0xFF000000) >> 24;
+
+        auto pointsBegin = clusters._clusterContent.begin() + offset;
+        std::vector<LightClusters::LightIndex> points(pointsBegin, pointsBegin + numPoints);
+        std::vector<LightClusters::LightIndex> spots(pointsBegin + numPoints, pointsBegin + numPoints + numSpots);
+        QCOMPARE(points, serialPoints[i]);
+        QCOMPARE(spots, serialSpots[i]);
+    }
+}
+
+void LightClustersTests::benchmarkClusterLights_data() {
+    QTest::addColumn<int>("numLights");
+    QTest::newRow("16 lights") << 16;
+    QTest::newRow("128 lights") << 128;
+    QTest::newRow("512 lights") << 512;
+    QTest::newRow("2048 lights") << 2048;
+}
+
+void LightClustersTests::benchmarkClusterLights() {
+    QFETCH(int, numLights);
+
+    LightClusters clusters;
+    clusters.setDimensions(glm::uvec3(LightClusters::MAX_GRID_DIMENSIONS));
+    clusters.updateFrustum(makeFrustum());
+
+    auto lights = makeLights(numLights, 0.3f);
+    QBENCHMARK {
+        clusters.clusterLights(lights);
+    }
+}
@@ -0,0 +1,26 @@
+//
+//  LightClustersTests.h
+//  tests/render-utils/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LightClustersTests_h
+#define hifi_LightClustersTests_h
+
+#include <QtTest/QtTest>
+
+class LightClustersTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testClusterContent();
+    void testMatchesSerialClustering();
+    void benchmarkClusterLights_data();
+    void benchmarkClusterLights();
+};
+
+#endif // hifi_LightClustersTests_h
@@ -0,0 +1,166 @@
+//
+//  SpatiallyNestableTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SpatiallyNestableTests.h"
+
+#include <QtCore/QHash>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <StreamUtils.h>
+#include <SpatiallyNestable.h>
+#include <SpatialParentFinder.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(SpatiallyNestableTests)
+
+const float EPSILON = 0.0001f;
+
+class TestNestable : public SpatiallyNestable {
+public:
+    TestNestable() : SpatiallyNestable(NestableType::Entity, QUuid::createUuid()) {}
+
+    // a single movable joint, every other index is the identity
+    virtual const Transform getAbsoluteJointTransformInObjectFrame(int jointIndex) const override {
+        return jointIndex == 0 ? _jointTransform : Transform();
+    }
+    void setJointTransform(const Transform& transform) { _jointTransform = transform; }
+
+private:
+    Transform _jointTransform;
+};
+using TestNestablePointer = std::shared_ptr<TestNestable>;
+
+class TestParentFinder : public SpatialParentFinder {
+public:
+    virtual SpatiallyNestableWeakPointer find(QUuid parentID, bool& success, SpatialParentTree* entityTree = nullptr) const override {
+        success = true;
+        return _nestables.value(parentID);
+    }
+
+    TestNestablePointer create(const QUuid& parentID = QUuid()) {
+        auto nestable = std::make_shared<TestNestable>();
+        _nestables[nestable->getID()] = nestable;
+        nestable->setParentID(parentID);
+        return nestable;
+    }
+
+private:
+    QHash<QUuid, SpatiallyNestableWeakPointer> _nestables;
+};
+
+static std::vector<TestNestablePointer> createChain(int length) {
+    auto finder = DependencyManager::get<SpatialParentFinder>().staticCast<TestParentFinder>();
+    std::vector<TestNestablePointer> chain;
+    for (int i = 0; i < length; i++) {
+        chain.push_back(finder->create(i > 0 ? chain.back()->getID() : QUuid()));
+        chain.back()->setLocalPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    }
+    return chain;
+}
+
+void SpatiallyNestableTests::initTestCase() {
+    DependencyManager::set<SpatialParentFinder, TestParentFinder>();
+}
+
+void SpatiallyNestableTests::parentMoves() {
+    auto chain = createChain(3);
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(3.0f, 0.0f, 0.0f), EPSILON);
+
+    // the leaf's cached transform is invalidated from the root down
+    chain[0]->setWorldPosition(glm::vec3(0.0f, 10.0f, 0.0f));
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(2.0f, 10.0f, 0.0f), EPSILON);
+
+    chain[0]->setWorldOrientation(glm::angleAxis(PI_OVER_TWO, Vectors::UNIT_Z));
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(0.0f, 12.0f, 0.0f), EPSILON);
+
+    chain[1]->setLocalSNScale(glm::vec3(2.0f));
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(0.0f, 13.0f, 0.0f), EPSILON);
+}
+
+void SpatiallyNestableTests::reparenting() {
+    auto chain = createChain(2);
+    auto finder = DependencyManager::get<SpatialParentFinder>().staticCast<TestParentFinder>();
+    auto otherParent = finder->create();
+    otherParent->setWorldPosition(glm::vec3(0.0f, 0.0f, 5.0f));
+
+    QCOMPARE_WITH_ABS_ERROR(chain[1]->getWorldPosition(), glm::vec3(2.0f, 0.0f, 0.0f), EPSILON);
+    chain[1]->setParentID(otherParent->getID());
+    QCOMPARE_WITH_ABS_ERROR(chain[1]->getWorldPosition(), glm::vec3(1.0f, 0.0f, 5.0f), EPSILON);
+
+    // the child of a deleted parent falls back to its local transform
+    otherParent.reset();
+    QCOMPARE_WITH_ABS_ERROR(chain[1]->getWorldPosition(), glm::vec3(1.0f, 0.0f, 0.0f), EPSILON);
+}
+
+void SpatiallyNestableTests::jointParenting() {
+    auto chain = createChain(3);
+    chain[1]->setParentJointIndex(0);
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(3.0f, 0.0f, 0.0f), EPSILON);
+
+    // joints move without notifying anyone, so nothing below a joint may be served from the cache
+    Transform jointTransform;
+    jointTransform.setTranslation(glm::vec3(0.0f, 1.0f, 0.0f));
+    chain[0]->setJointTransform(jointTransform);
+    QCOMPARE_WITH_ABS_ERROR(chain[1]->getWorldPosition(), glm::vec3(2.0f, 1.0f, 0.0f), EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(3.0f, 1.0f, 0.0f), EPSILON);
+
+    chain[1]->setParentJointIndex(INVALID_JOINT_INDEX);
+    QCOMPARE_WITH_ABS_ERROR(chain[2]->getWorldPosition(), glm::vec3(3.0f, 0.0f, 0.0f), EPSILON);
+}
+
+void SpatiallyNestableTests::deepHierarchyBenchmark() {
+    const int DEPTH = 25;
+    const int NUM_FRAMES = 1000;
+    auto chain = createChain(DEPTH);
+
+    // every frame the root moves and every link of the chain is read, as when rendering a jointless attachment chain
+    auto start = usecTimestampNow();
+    glm::vec3 sum;
+    for (int frame = 0; frame < NUM_FRAMES; frame++) {
+        chain[0]->setWorldPosition(glm::vec3((float)frame, 0.0f, 0.0f));
+        for (auto& link : chain) {
+            sum += link->getWorldPosition();
+        }
+    }
+    auto duration = usecTimestampNow() - start;
+    qDebug() << "Deep hierarchy:" << DEPTH * NUM_FRAMES << "reads in" << (float)duration / USECS_PER_MSEC << "ms";
+
+    QCOMPARE_WITH_ABS_ERROR(chain.back()->getWorldPosition(), glm::vec3((float)(NUM_FRAMES - 1 + DEPTH - 1), 0.0f, 0.0f), EPSILON);
+}
+
+void SpatiallyNestableTests::wideHierarchyBenchmark() {
+    const int NUM_CHILDREN = 10000;
+    const int NUM_READS = 10;
+    auto finder = DependencyManager::get<SpatialParentFinder>().staticCast<TestParentFinder>();
+    auto root = finder->create();
+    std::vector<TestNestablePointer> children;
+    for (int i = 0; i < NUM_CHILDREN; i++) {
+        children.push_back(finder->create(root->getID()));
+        children.back()->setLocalPosition(glm::vec3(0.0f, (float)i, 0.0f));
+    }
+
+    // one move of the root, followed by repeated reads of all its children
+    auto start = usecTimestampNow();
+    root->setWorldPosition(glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::vec3 sum;
+    for (int read = 0; read < NUM_READS; read++) {
+        for (auto& child : children) {
+            sum += child->getWorldPosition();
+        }
+    }
+    auto duration = usecTimestampNow() - start;
+    qDebug() << "Wide hierarchy:" << NUM_CHILDREN * NUM_READS << "reads in" << (float)duration / USECS_PER_MSEC << "ms";
+
+    QCOMPARE_WITH_ABS_ERROR(children.back()->getWorldPosition(), glm::vec3(1.0f, (float)(NUM_CHILDREN - 1), 0.0f), EPSILON);
+}
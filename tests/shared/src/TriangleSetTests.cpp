@@ -0,0 +1,193 @@
+//
+//  TriangleSetTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2017 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "TriangleSetTests.h"
+
+#include <random>
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <StreamUtils.h>
+#include <TriangleSet.h>
+
+#include <../GLMTestUtils.h>
+#include <../QTestExtensions.h>
+
+QTEST_MAIN(TriangleSetTests)
+
+const float EPSILON = 0.0001f;
+
+// a soup of small random triangles, like the sub meshes of a detailed model
+static std::vector<Triangle> randomTriangles(int numTriangles, std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    auto randomVector = [&] { return glm::vec3(distribution(generator), distribution(generator), distribution(generator)); };
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < numTriangles; i++) {
+        glm::vec3 center = 10.0f * randomVector();
+        triangles.push_back({ center + 0.5f * randomVector(), center + 0.5f * randomVector(), center + 0.5f * randomVector() });
+    }
+    return triangles;
+}
+
+// rays from around the set towards its center
+static void randomRays(int numRays, std::mt19937& generator, std::vector<glm::vec3>& origins, std::vector<glm::vec3>& directions) {
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (int i = 0; i < numRays; i++) {
+        glm::vec3 origin(15.0f * distribution(generator), 15.0f * distribution(generator), 20.0f);
+        glm::vec3 target(5.0f * distribution(generator), 5.0f * distribution(generator), 5.0f * distribution(generator));
+        origins.push_back(origin);
+        directions.push_back(glm::normalize(target - origin));
+    }
+}
+
+static bool bruteForceIntersection(const std::vector<Triangle>& triangles, const glm::vec3& origin, const glm::vec3& direction,
+                                   bool allowBackface, float& distance) {
+    bool intersects = false;
+    distance = std::numeric_limits<float>::max();
+    for (const auto& triangle : triangles) {
+        float triangleDistance;
+        if (findRayTriangleIntersection(origin, direction, triangle.v0, triangle.v1, triangle.v2, triangleDistance) ||
+                (allowBackface && findRayTriangleIntersection(origin, direction, triangle.v0, triangle.v2, triangle.v1, triangleDistance))) {
+            if (triangleDistance < distance) {
+                distance = triangleDistance;
+                intersects = true;
+            }
+        }
+    }
+    return intersects;
+}
+
+void TriangleSetTests::emptySet() {
+    TriangleSet triangleSet;
+    float distance;
+    BoxFace face;
+    glm::vec3 normal;
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f), Vectors::UNIT_X, distance, face, normal, true), false);
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f), Vectors::UNIT_X, distance, face, normal, false), false);
+}
+
+void TriangleSetTests::singleTriangle() {
+    TriangleSet triangleSet;
+    // facing +z
+    triangleSet.insert({ glm::vec3(-1.0f, -1.0f, 0.0f), glm::vec3(1.0f, -1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) });
+
+    float distance;
+    BoxFace face;
+    glm::vec3 normal;
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f, 0.0f, 2.0f), -Vectors::UNIT_Z, distance, face, normal, true), true);
+    QCOMPARE_WITH_ABS_ERROR(distance, 2.0f, EPSILON);
+    QCOMPARE_WITH_ABS_ERROR(normal, Vectors::UNIT_Z, EPSILON);
+
+    // the back face is only hit when asked for
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f, 0.0f, -3.0f), Vectors::UNIT_Z, distance, face, normal, true), false);
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f, 0.0f, -3.0f), Vectors::UNIT_Z, distance, face, normal, true, true), true);
+    QCOMPARE_WITH_ABS_ERROR(distance, 3.0f, EPSILON);
+
+    // nothing behind the origin
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(0.0f, 0.0f, -3.0f), -Vectors::UNIT_Z, distance, face, normal, true, true), false);
+    QCOMPARE(triangleSet.findRayIntersection(glm::vec3(2.0f, 0.0f, 2.0f), -Vectors::UNIT_Z, distance, face, normal, true), false);
+}
+
+void TriangleSetTests::matchesBruteForce() {
+    std::mt19937 generator(1);
+    const int NUM_TRIANGLES = 5000;
+    const int NUM_RAYS = 500;
+    std::vector<Triangle> triangles = randomTriangles(NUM_TRIANGLES, generator);
+    TriangleSet triangleSet;
+    for (const auto& triangle : triangles) {
+        triangleSet.insert(triangle);
+    }
+    std::vector<glm::vec3> origins;
+    std::vector<glm::vec3> directions;
+    randomRays(NUM_RAYS, generator, origins, directions);
+
+    for (bool allowBackface : { false, true }) {
+        int numHits = 0;
+        for (int i = 0; i < NUM_RAYS; i++) {
+            float expectedDistance;
+            bool expected = bruteForceIntersection(triangles, origins[i], directions[i], allowBackface, expectedDistance);
+
+            float distance;
+            BoxFace face;
+            glm::vec3 normal;
+            QCOMPARE(triangleSet.findRayIntersection(origins[i], directions[i], distance, face, normal, true, allowBackface), expected);
+            if (expected) {
+                QCOMPARE_WITH_ABS_ERROR(distance, expectedDistance, EPSILON * expectedDistance);
+                numHits++;
+            }
+        }
+        // make sure the rays aren't all misses
+        QVERIFY(numHits > NUM_RAYS / 10);
+    }
+}
+
+void TriangleSetTests::batchMatchesSingle() {
+    std::mt19937 generator(2);
+    const int NUM_RAYS = 203;
+    TriangleSet triangleSet;
+    for (const auto& triangle : randomTriangles(2000, generator)) {
+        triangleSet.insert(triangle);
+    }
+    std::vector<glm::vec3> origins;
+    std::vector<glm::vec3> directions;
+    randomRays(NUM_RAYS, generator, origins, directions);
+
+    for (bool precision : { false, true }) {
+        std::vector<TriangleSet::RayIntersection> results;
+        triangleSet.findRayIntersections(origins, directions, results, precision);
+        QCOMPARE(results.size(), (size_t)NUM_RAYS);
+
+        for (int i = 0; i < NUM_RAYS; i++) {
+            float distance;
+            BoxFace face;
+            glm::vec3 normal;
+            bool intersects = triangleSet.findRayIntersection(origins[i], directions[i], distance, face, normal, precision);
+            QCOMPARE(results[i].intersects, intersects);
+            if (intersects) {
+                QCOMPARE(results[i].distance, distance);
+                QCOMPARE(results[i].face, face);
+                QCOMPARE_WITH_ABS_ERROR(results[i].surfaceNormal, normal, EPSILON);
+            }
+        }
+    }
+}
+
+void TriangleSetTests::rayBenchmark() {
+    std::mt19937 generator(3);
+    const int NUM_TRIANGLES = 200000;
+    const int NUM_RAYS = 10000;
+    TriangleSet triangleSet;
+    triangleSet.reserve(NUM_TRIANGLES);
+    for (const auto& triangle : randomTriangles(NUM_TRIANGLES, generator)) {
+        triangleSet.insert(triangle);
+    }
+    std::vector<glm::vec3> origins;
+    std::vector<glm::vec3> directions;
+    randomRays(NUM_RAYS, generator, origins, directions);
+
+    auto start = usecTimestampNow();
+    triangleSet.balanceTree();
+    auto buildDuration = usecTimestampNow() - start;
+
+    start = usecTimestampNow();
+    int numHits = 0;
+    for (int i = 0; i < NUM_RAYS; i++) {
+        float distance;
+        BoxFace face;
+        glm::vec3 normal;
+        numHits += triangleSet.findRayIntersection(origins[i], directions[i], distance, face, normal, true) ? 1 : 0;
+    }
+    auto rayDuration = usecTimestampNow() - start;
+
+    qDebug() << "Built BVH over" << NUM_TRIANGLES << "triangles in" << (float)buildDuration / USECS_PER_MSEC << "ms";
+    qDebug() << NUM_RAYS << "rays," << numHits << "hits in" << (float)rayDuration / USECS_PER_MSEC << "ms";
+}
@@ -0,0 +1,484 @@
+//
+//  AvatarBot.cpp
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarBot.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QtCore/QDataStream>
+
+#include <GLMHelpers.h>
+#include <LimitedNodeList.h>
+#include <NodePermissions.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+#include <udt/PacketHeaders.h>
+
+// bots are spread over a disc around the origin, walking in small circles of their own
+const float SPAWN_RADIUS = 20.0f;
+const float WALK_RADIUS = 2.0f;
+const float WALK_SPEED = 1.0f; // meters per second
+
+// a quiet tone, so that every bot is an audible (non-silent) stream for the mixer
+const float TONE_AMPLITUDE = 0.05f * AudioConstants::MAX_SAMPLE_VALUE;
+const float TONE_BASE_FREQUENCY = 220.0f;
+
+// mixed audio sequence numbers further apart than this are taken as a reset rather than loss
+const int MAX_SEQUENCE_GAP = 1000;
+
+std::shared_ptr<const AvatarBotClip> AvatarBotClip::fromClip(const recording::ClipPointer& clip) {
+    auto botClip = std::make_shared<AvatarBotClip>();
+    botClip->duration = clip->duration();
+    botClip->frames.reserve(clip->frameCount());
+
+    clip->seekFrameTime(0);
+    while (auto frame = clip->nextFrame()) {
+        botClip->frames.push_back(frame);
+    }
+    return botClip;
+}
+
+AvatarBot::AvatarBot(int index, const HifiSockAddr& domainServerAddr, AvatarBotClipPointer clip,
+                     AvatarBotStats& stats, QObject* parent) :
+    QObject(parent),
+    _index(index),
+    _domainServerAddr(domainServerAddr),
+    _stats(stats),
+    _startUsecs(usecTimestampNow()),
+    _clip(clip),
+    _toneFrequency(TONE_BASE_FREQUENCY * (1.0f + (index % 12) / 12.0f))
+{
+    unsigned int localPort = 0;
+    _socket.bind(QHostAddress::AnyIPv4, localPort);
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet)); });
+    _localSockAddr = HifiSockAddr(QHostAddress::LocalHost, _socket.localPort());
+
+    _avatar.setDisplayName(QString("bot-%1").arg(index));
+
+    if (_clip) {
+        // stagger the bots through the clip, so they do not all move and talk in lockstep
+        float startSeconds = randFloat() * _clip->duration;
+        _clipStartUsecs = _startUsecs - (quint64)(startSeconds * USECS_PER_SECOND);
+        auto startTime = recording::Frame::secondsToFrameTime(startSeconds);
+        auto startFrame = std::lower_bound(_clip->frames.begin(), _clip->frames.end(), startTime,
+            [](const recording::FrameConstPointer& frame, recording::Frame::Time time) {
+                return frame->timeOffset < time;
+            });
+        _nextClipFrame = startFrame - _clip->frames.begin();
+    }
+}
+
+AvatarBot::~AvatarBot() {
+    // let the avatar-mixer know right away, rather than waiting for the domain-server to time us out
+    if (auto avatarMixer = mixerOfType(NodeType::AvatarMixer)) {
+        auto packet = NLPacket::create(PacketType::KillAvatar, NUM_BYTES_RFC4122_UUID + sizeof(KillAvatarReason));
+        packet->write(_sessionUUID.toRfc4122());
+        packet->writePrimitive(KillAvatarReason::NoReason);
+        sendToMixer(std::move(packet), *avatarMixer);
+    }
+
+    if (_isConnected) {
+        _stats.numConnected--;
+    }
+}
+
+void AvatarBot::checkIn() {
+    PacketType packetType = _isConnected ? PacketType::DomainListRequest : PacketType::DomainConnectRequest;
+    auto domainPacket = NLPacket::create(packetType);
+    QDataStream packetStream(domainPacket.get());
+
+    if (packetType == PacketType::DomainConnectRequest) {
+        packetStream << _connectUUID;
+
+        QByteArray protocolVersionSig = protocolVersionsSignature();
+        packetStream.writeBytes(protocolVersionSig.constData(), protocolVersionSig.size());
+
+        // no hardware address, and a fingerprint of our own so the domain-server sees distinct machines
+        packetStream << QString() << _connectUUID;
+    }
+
+    // a null public address asks the domain-server to fill in the one it sees us on
+    HifiSockAddr publicSockAddr(QHostAddress(), _socket.localPort());
+    QList<NodeType_t> nodeTypesOfInterest { NodeType::AudioMixer, NodeType::AvatarMixer };
+    packetStream << NodeType::Agent << publicSockAddr << _localSockAddr << nodeTypesOfInterest << QString();
+
+    if (!_isConnected) {
+        // anonymous
+        packetStream << QString();
+    }
+
+    sendPacket(*domainPacket, _domainServerAddr, QUuid());
+}
+
+void AvatarBot::pingMixers() {
+    for (auto& mixer : _mixers) {
+        auto sendPing = [&](PingType_t pingType, const HifiSockAddr& sockAddr) {
+            int packetSize = sizeof(PingType_t) + sizeof(quint64);
+            auto pingPacket = NLPacket::create(PacketType::Ping, packetSize);
+            pingPacket->writePrimitive(pingType);
+            pingPacket->writePrimitive(usecTimestampNow());
+            sendPacket(*pingPacket, sockAddr, mixer.connectionSecret);
+        };
+
+        if (mixer.activeSocket.isNull()) {
+            // same as NodeList, try both sockets and keep whichever answers first
+            sendPing(PingType::Local, mixer.localSocket);
+            sendPing(PingType::Public, mixer.publicSocket);
+        } else {
+            sendPing(PingType::Agnostic, mixer.activeSocket);
+        }
+    }
+}
+
+void AvatarBot::sendAudio() {
+    auto audioMixer = mixerOfType(NodeType::AudioMixer);
+    if (!audioMixer || audioMixer->activeSocket.isNull()) {
+        return;
+    }
+
+    if (!_clip) {
+        fillProceduralAudio();
+    } else if (_clipAudio.size() >= (int)sizeof(_audioFrame)) {
+        memcpy(_audioFrame, _clipAudio.constData(), sizeof(_audioFrame));
+        _clipAudio.remove(0, sizeof(_audioFrame));
+    } else {
+        memset(_audioFrame, 0, sizeof(_audioFrame));
+    }
+
+    auto audioPacket = NLPacket::create(PacketType::MicrophoneAudioNoEcho);
+    audioPacket->writePrimitive(_outgoingAudioSequenceNumber++);
+    audioPacket->writeString(QString()); // no codec, plain PCM
+
+    quint8 isStereo = 0;
+    audioPacket->writePrimitive(isStereo);
+
+    audioPacket->writePrimitive(_avatar.getWorldPosition());
+    audioPacket->writePrimitive(_avatar.getWorldOrientation());
+
+    // a unit box around the avatar, as the audio-mixer expects for zone checks
+    glm::vec3 boundingBoxScale(1.0f);
+    glm::vec3 boundingBoxCorner = _avatar.getWorldPosition() - 0.5f * boundingBoxScale;
+    audioPacket->writePrimitive(boundingBoxCorner);
+    audioPacket->writePrimitive(boundingBoxScale);
+
+    audioPacket->write(reinterpret_cast<const char*>(_audioFrame), sizeof(_audioFrame));
+
+    sendToMixer(std::move(audioPacket), *audioMixer);
+    _stats.audioPacketsSent++;
+}
+
+void AvatarBot::setJointPoses(const AnimPoseBatch& absolutePoses, const AnimPoseBatch& relativePoses, int crowdIndex) {
+    for (int i = 0; i < absolutePoses.getNumJoints(); ++i) {
+        _avatar.setJointData(i, absolutePoses.getPose(i, crowdIndex).rot(), relativePoses.getPose(i, crowdIndex).trans());
+    }
+}
+
+void AvatarBot::sendAvatarData() {
+    auto avatarMixer = mixerOfType(NodeType::AvatarMixer);
+    if (!avatarMixer || avatarMixer->activeSocket.isNull()) {
+        return;
+    }
+
+    quint64 now = usecTimestampNow();
+    if (_clip) {
+        advanceClip(now);
+    } else {
+        advanceProceduralMotion(now);
+    }
+
+    if (!_hasSentIdentity) {
+        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity);
+        identityPacket->write(_avatar.identityByteArray());
+        sendToMixer(std::move(identityPacket), *avatarMixer);
+        _hasSentIdentity = true;
+    }
+
+    // same detail choice as Agent::processAgentAvatar
+    bool sendAll = randFloat() < AVATAR_SEND_FULL_UPDATE_RATIO;
+    QByteArray avatarByteArray = _avatar.toByteArrayStateful(sendAll ? AvatarData::SendAllData : AvatarData::CullSmallData);
+    int maximumByteArraySize = NLPacket::maxPayloadSize(PacketType::AvatarData) - sizeof(AvatarDataSequenceNumber);
+    if (avatarByteArray.size() > maximumByteArraySize) {
+        avatarByteArray = _avatar.toByteArrayStateful(AvatarData::MinimumData, true);
+    }
+    _avatar.doneEncoding(true);
+
+    auto avatarPacket = NLPacket::create(PacketType::AvatarData, avatarByteArray.size() + sizeof(_avatarSequenceNumber));
+    avatarPacket->writePrimitive(_avatarSequenceNumber++);
+    avatarPacket->write(avatarByteArray);
+
+    sendToMixer(std::move(avatarPacket), *avatarMixer);
+    _stats.avatarPacketsSent++;
+}
+
+glm::vec3 AvatarBot::spawnCenter() const {
+    // spread the bots evenly over a disc, by their index
+    float spawnAngle = _index * (float)(PI * (3.0 - std::sqrt(5.0))); // golden angle
+    float spawnDistance = SPAWN_RADIUS * std::sqrt((float)(_index % 1000) / 1000.0f);
+    return glm::vec3(spawnDistance * std::cos(spawnAngle), 0.0f, spawnDistance * std::sin(spawnAngle));
+}
+
+void AvatarBot::advanceProceduralMotion(quint64 nowUsecs) {
+    // each bot walks its own circle, starting at a different point on it
+    float seconds = (float)(nowUsecs - _startUsecs) / USECS_PER_SECOND;
+    float walkAngle = seconds * WALK_SPEED / WALK_RADIUS + _index;
+    glm::vec3 position = spawnCenter() + WALK_RADIUS * glm::vec3(std::cos(walkAngle), 0.0f, std::sin(walkAngle));
+
+    _avatar.setWorldPosition(position);
+    _avatar.setWorldOrientation(glm::angleAxis(-walkAngle, Vectors::UNIT_Y));
+}
+
+void AvatarBot::advanceClip(quint64 nowUsecs) {
+    static const recording::FrameType AVATAR_FRAME_TYPE = recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+    static const recording::FrameType AUDIO_FRAME_TYPE =
+        recording::Frame::registerFrameType(AudioConstants::getAudioFrameName());
+
+    // loop the clip
+    auto clipTime = recording::Frame::secondsToFrameTime((float)(nowUsecs - _clipStartUsecs) / USECS_PER_SECOND);
+    if (clipTime > _clip->duration * MSECS_PER_SECOND) {
+        _clipStartUsecs = nowUsecs;
+        _nextClipFrame = 0;
+        clipTime = 0;
+    }
+
+    const int MAX_BUFFERED_AUDIO = (int)sizeof(_audioFrame) * 10;
+    bool hasNewPose = false;
+    const auto& frames = _clip->frames;
+    while (_nextClipFrame < frames.size() && frames[_nextClipFrame]->timeOffset <= clipTime) {
+        const auto& frame = frames[_nextClipFrame++];
+        if (frame->type == AVATAR_FRAME_TYPE) {
+            // keep our own skeleton, there is no need to have every bot fetch a new model
+            AvatarData::fromFrame(frame->data, _avatar, false);
+            hasNewPose = true;
+        } else if (frame->type == AUDIO_FRAME_TYPE) {
+            _clipAudio.append(frame->data);
+            if (_clipAudio.size() > MAX_BUFFERED_AUDIO) {
+                _clipAudio.remove(0, _clipAudio.size() - MAX_BUFFERED_AUDIO);
+            }
+        }
+    }
+
+    if (hasNewPose) {
+        // move the recording to this bot's spot, so that bots playing the same clip do not all pile up in one place
+        _avatar.setWorldPosition(_avatar.getWorldPosition() + spawnCenter());
+    }
+}
+
+void AvatarBot::fillProceduralAudio() {
+    double phaseStep = 2.0 * PI * _toneFrequency / AudioConstants::SAMPLE_RATE;
+    for (int i = 0; i < AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL; ++i) {
+        _audioFrame[i] = (int16_t)(TONE_AMPLITUDE * std::sin(_tonePhase));
+        _tonePhase += phaseStep;
+    }
+    _tonePhase = std::fmod(_tonePhase, 2.0 * PI);
+}
+
+void AvatarBot::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+
+    switch (nlPacket->getType()) {
+        case PacketType::DomainList:
+            processDomainList(*nlPacket);
+            break;
+        case PacketType::DomainServerAddedNode: {
+            QDataStream packetStream(nlPacket.get());
+            parseNode(packetStream);
+            break;
+        }
+        case PacketType::DomainServerRemovedNode: {
+            QUuid nodeUUID = QUuid::fromRfc4122(nlPacket->read(NUM_BYTES_RFC4122_UUID));
+            _mixers.erase(std::remove_if(_mixers.begin(), _mixers.end(), [&](const Mixer& mixer) {
+                return mixer.uuid == nodeUUID;
+            }), _mixers.end());
+            break;
+        }
+        case PacketType::DomainConnectionDenied:
+            qWarning() << "bot" << _index << "was denied by the domain-server";
+            break;
+        case PacketType::Ping: {
+            // answer the mixers' pings, this is how they activate a socket for us
+            auto mixer = mixerForSocket(nlPacket->getSenderSockAddr());
+            if (mixer) {
+                PingType_t pingType;
+                quint64 pingTime;
+                nlPacket->readPrimitive(&pingType);
+                nlPacket->readPrimitive(&pingTime);
+
+                auto replyPacket = NLPacket::create(PacketType::PingReply,
+                    sizeof(PingType_t) + sizeof(quint64) + sizeof(quint64));
+                replyPacket->writePrimitive(pingType);
+                replyPacket->writePrimitive(pingTime);
+                replyPacket->writePrimitive(usecTimestampNow());
+                sendPacket(*replyPacket, nlPacket->getSenderSockAddr(), mixer->connectionSecret);
+            }
+            break;
+        }
+        case PacketType::PingReply: {
+            auto mixer = mixerForSocket(nlPacket->getSenderSockAddr());
+            if (mixer) {
+                processPingReply(*nlPacket, *mixer);
+            }
+            break;
+        }
+        case PacketType::MixedAudio:
+        case PacketType::SilentAudioFrame:
+            processMixedAudio(*nlPacket);
+            break;
+        case PacketType::BulkAvatarData:
+            _stats.bulkAvatarBytesReceived += nlPacket->getDataSize();
+            break;
+        default:
+            break;
+    }
+}
+
+void AvatarBot::processDomainList(NLPacket& packet) {
+    QDataStream packetStream(&packet);
+
+    QUuid domainUUID;
+    QUuid sessionUUID;
+    NodePermissions permissions;
+    packetStream >> domainUUID >> sessionUUID >> permissions;
+
+    if (!_isConnected) {
+        _isConnected = true;
+        _domainUUID = domainUUID;
+        _stats.numConnected++;
+    }
+
+    if (_sessionUUID != sessionUUID) {
+        _sessionUUID = sessionUUID;
+        _avatar.setSessionUUID(sessionUUID);
+        _hasSentIdentity = false;
+    }
+
+    while (packetStream.device()->pos() < packet.getPayloadSize()) {
+        parseNode(packetStream);
+    }
+}
+
+void AvatarBot::parseNode(QDataStream& packetStream) {
+    qint8 nodeType;
+    QUuid nodeUUID, connectionSecret;
+    HifiSockAddr publicSocket, localSocket;
+    NodePermissions permissions;
+    bool isReplicated;
+
+    packetStream >> nodeType >> nodeUUID >> publicSocket >> localSocket >> permissions >> isReplicated;
+    packetStream >> connectionSecret;
+
+    if (nodeType != NodeType::AudioMixer && nodeType != NodeType::AvatarMixer) {
+        return;
+    }
+
+    // a null public address means the node is on the domain-server's address
+    if (publicSocket.getAddress().isNull()) {
+        publicSocket.setAddress(_domainServerAddr.getAddress());
+    }
+
+    auto it = std::find_if(_mixers.begin(), _mixers.end(), [&](const Mixer& mixer) {
+        return mixer.uuid == nodeUUID;
+    });
+    if (it == _mixers.end()) {
+        Mixer mixer;
+        mixer.type = nodeType;
+        mixer.uuid = nodeUUID;
+        _mixers.push_back(mixer);
+        it = _mixers.end() - 1;
+    }
+
+    if (it->publicSocket != publicSocket || it->localSocket != localSocket) {
+        it->activeSocket = HifiSockAddr();
+    }
+    it->connectionSecret = connectionSecret;
+    it->publicSocket = publicSocket;
+    it->localSocket = localSocket;
+}
+
+void AvatarBot::processPingReply(NLPacket& packet, Mixer& mixer) {
+    PingType_t pingType;
+    quint64 ourOriginalTime;
+    packet.readPrimitive(&pingType);
+    packet.readPrimitive(&ourOriginalTime);
+
+    if (mixer.activeSocket.isNull()) {
+        mixer.activeSocket = packet.getSenderSockAddr();
+    }
+
+    qint64 pingUsecs = (qint64)(usecTimestampNow() - ourOriginalTime);
+    if (mixer.type == NodeType::AudioMixer) {
+        _stats.audioMixerPingUsecs += pingUsecs;
+        _stats.audioMixerPings++;
+    } else {
+        _stats.avatarMixerPingUsecs += pingUsecs;
+        _stats.avatarMixerPings++;
+    }
+
+    qint64 maxPingUsecs = _stats.maxPingUsecs;
+    while (pingUsecs > maxPingUsecs && !_stats.maxPingUsecs.compare_exchange_weak(maxPingUsecs, pingUsecs)) {
+    }
+}
+
+void AvatarBot::processMixedAudio(NLPacket& packet) {
+    quint16 sequenceNumber;
+    packet.readPrimitive(&sequenceNumber);
+
+    if (_hasReceivedMixedAudio) {
+        int gap = (quint16)(sequenceNumber - _incomingAudioSequenceNumber) - 1;
+        if (gap > 0 && gap < MAX_SEQUENCE_GAP) {
+            _stats.mixedAudioLost += gap;
+        }
+    }
+    _hasReceivedMixedAudio = true;
+    _incomingAudioSequenceNumber = sequenceNumber;
+
+    _stats.mixedAudioReceived++;
+}
+
+AvatarBot::Mixer* AvatarBot::mixerOfType(NodeType_t type) {
+    for (auto& mixer : _mixers) {
+        if (mixer.type == type) {
+            return &mixer;
+        }
+    }
+    return nullptr;
+}
+
+AvatarBot::Mixer* AvatarBot::mixerForSocket(const HifiSockAddr& sockAddr) {
+    for (auto& mixer : _mixers) {
+        if (sockAddr == mixer.activeSocket || sockAddr == mixer.publicSocket || sockAddr == mixer.localSocket) {
+            return &mixer;
+        }
+    }
+    return nullptr;
+}
+
+void AvatarBot::sendToMixer(std::unique_ptr<NLPacket> packet, const Mixer& mixer) {
+    if (!mixer.activeSocket.isNull()) {
+        sendPacket(*packet, mixer.activeSocket, mixer.connectionSecret);
+    }
+}
+
+void AvatarBot::sendPacket(const NLPacket& packet, const HifiSockAddr& sockAddr, const QUuid& connectionSecret) {
+    // same header rules as LimitedNodeList::fillPacketHeader, with this bot's session
+    if (!PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())) {
+        packet.writeSourceID(_sessionUUID);
+    }
+
+    if (!connectionSecret.isNull()
+        && !PacketTypeEnum::getNonSourcedPackets().contains(packet.getType())
+        && !PacketTypeEnum::getNonVerifiedPackets().contains(packet.getType())) {
+        packet.writeVerificationHashGivenSecret(connectionSecret);
+    }
+
+    _socket.writePacket(packet, sockAddr);
+}
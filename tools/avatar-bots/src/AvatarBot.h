@@ -0,0 +1,146 @@
+//
+//  AvatarBot.h
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarBot_h
+#define hifi_AvatarBot_h
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QUuid>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <AnimPoseBatch.h>
+#include <AudioConstants.h>
+#include <AvatarData.h>
+#include <NLPacket.h>
+#include <NodeType.h>
+#include <recording/Forward.h>
+#include <udt/Socket.h>
+
+// Counters shared by every bot in the process, read and reset once per report.
+struct AvatarBotStats {
+    std::atomic<int> numConnected { 0 };
+
+    std::atomic<qint64> audioPacketsSent { 0 };
+    std::atomic<qint64> avatarPacketsSent { 0 };
+
+    std::atomic<qint64> mixedAudioReceived { 0 };
+    std::atomic<qint64> mixedAudioLost { 0 };
+    std::atomic<qint64> bulkAvatarBytesReceived { 0 };
+
+    // round trip times to the mixers, measured with pings
+    std::atomic<qint64> audioMixerPingUsecs { 0 };
+    std::atomic<qint64> audioMixerPings { 0 };
+    std::atomic<qint64> avatarMixerPingUsecs { 0 };
+    std::atomic<qint64> avatarMixerPings { 0 };
+    std::atomic<qint64> maxPingUsecs { 0 };
+};
+
+// A recording read once and shared, read-only, by every bot playing it. Each bot keeps its own place in the frames
+// and its own start time, so the clip's frames are in memory once however many bots there are.
+struct AvatarBotClip {
+    // reads the whole of clip, from its start
+    static std::shared_ptr<const AvatarBotClip> fromClip(const recording::ClipPointer& clip);
+
+    std::vector<recording::FrameConstPointer> frames; // in time order
+    float duration { 0.0f }; // seconds
+};
+
+using AvatarBotClipPointer = std::shared_ptr<const AvatarBotClip>;
+
+// One simulated agent. Each bot has its own socket and session with the domain-server, so to the domain-server and the
+// mixers it is indistinguishable from an interface client, but it speaks just enough of the protocol to stream an
+// avatar and a microphone: check-ins, the node list, pings, avatar data and mono PCM audio.
+//   AvatarBot is not thread-safe, it lives on the thread of the AvatarBotGroup that ticks it.
+class AvatarBot : public QObject {
+    Q_OBJECT
+public:
+    AvatarBot(int index, const HifiSockAddr& domainServerAddr, AvatarBotClipPointer clip,
+              AvatarBotStats& stats, QObject* parent = nullptr);
+    ~AvatarBot();
+
+    // poses the joints the way interface sends them, with absolute rotations and relative translations
+    void setJointPoses(const AnimPoseBatch& absolutePoses, const AnimPoseBatch& relativePoses, int crowdIndex);
+
+    // called every network frame
+    void sendAudio();
+    void sendAvatarData();
+
+    // called about once a second
+    void checkIn();
+    void pingMixers();
+
+private:
+    struct Mixer {
+        NodeType_t type { NodeType::Unassigned };
+        QUuid uuid;
+        QUuid connectionSecret;
+        HifiSockAddr publicSocket;
+        HifiSockAddr localSocket;
+        HifiSockAddr activeSocket;
+    };
+
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+    void processDomainList(NLPacket& packet);
+    void parseNode(QDataStream& packetStream);
+    void processPingReply(NLPacket& packet, Mixer& mixer);
+    void processMixedAudio(NLPacket& packet);
+
+    Mixer* mixerOfType(NodeType_t type);
+    Mixer* mixerForSocket(const HifiSockAddr& sockAddr);
+
+    void sendToMixer(std::unique_ptr<NLPacket> packet, const Mixer& mixer);
+    void sendPacket(const NLPacket& packet, const HifiSockAddr& sockAddr, const QUuid& connectionSecret);
+
+    // motion and audio sources
+    void advanceClip(quint64 nowUsecs);
+    void advanceProceduralMotion(quint64 nowUsecs);
+    glm::vec3 spawnCenter() const;
+    void fillProceduralAudio();
+
+    int _index;
+    HifiSockAddr _domainServerAddr;
+    AvatarBotStats& _stats;
+
+    udt::Socket _socket;
+    HifiSockAddr _localSockAddr;
+
+    QUuid _connectUUID { QUuid::createUuid() };
+    QUuid _sessionUUID;
+    QUuid _domainUUID;
+    bool _isConnected { false };
+
+    std::vector<Mixer> _mixers;
+
+    AvatarData _avatar;
+    AvatarDataSequenceNumber _avatarSequenceNumber { 0 };
+    bool _hasSentIdentity { false };
+    quint64 _startUsecs;
+
+    AvatarBotClipPointer _clip;
+    size_t _nextClipFrame { 0 };
+    quint64 _clipStartUsecs { 0 };
+
+    int16_t _audioFrame[AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL];
+    QByteArray _clipAudio; // recorded audio not yet sent
+    quint16 _outgoingAudioSequenceNumber { 0 };
+    double _tonePhase { 0.0 };
+    double _toneFrequency;
+
+    bool _hasReceivedMixedAudio { false };
+    quint16 _incomingAudioSequenceNumber { 0 };
+};
+
+#endif // hifi_AvatarBot_h
@@ -0,0 +1,100 @@
+//
+//  AvatarBotGroup.cpp
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarBotGroup.h"
+
+#include <QtCore/QThread>
+
+#include <AvatarData.h>
+#include <NumericalConstants.h>
+#include <SharedUtil.h>
+
+const int TICK_INTERVAL_MSECS = 10;
+const int TICKS_PER_SECOND = (int)MSECS_PER_SECOND / TICK_INTERVAL_MSECS;
+
+// the rate interface sends avatar data at
+const int AVATAR_DATA_FRAMES_PER_SECOND = 45;
+
+AvatarBotGroup::AvatarBotGroup(int firstIndex, int numBots, const HifiSockAddr& domainServerAddr,
+                               AvatarBotClipPointer clip, AnimCrowdClipPointer animation, AvatarBotStats& stats) :
+    _firstIndex(firstIndex),
+    _numBots(numBots),
+    _domainServerAddr(domainServerAddr),
+    _clip(clip),
+    _animation(animation),
+    _stats(stats)
+{
+}
+
+void AvatarBotGroup::start() {
+    _bots.reserve(_numBots);
+    for (int i = 0; i < _numBots; ++i) {
+        _bots.emplace_back(new AvatarBot(_firstIndex + i, _domainServerAddr, _clip, _stats));
+    }
+
+    if (_animation) {
+        // each bot starts somewhere else in the animation, so that the crowd is not in lockstep
+        _crowd.reset(new AnimCrowd(_animation, _numBots));
+        for (int i = 0; i < _numBots; ++i) {
+            _crowd->setFrame(i, randFloat() * _animation->frames.size());
+        }
+    }
+
+    _tickTimer = new QTimer(this);
+    _tickTimer->setTimerType(Qt::PreciseTimer);
+    connect(_tickTimer, &QTimer::timeout, this, &AvatarBotGroup::tick);
+    _tickTimer->start(TICK_INTERVAL_MSECS);
+
+    _elapsed.start();
+}
+
+void AvatarBotGroup::stop() {
+    if (_tickTimer) {
+        _tickTimer->stop();
+    }
+    _bots.clear();
+
+    thread()->quit();
+}
+
+void AvatarBotGroup::tick() {
+    // catch up on whatever frames are due, timers slip when the thread falls behind
+    qint64 elapsedUsecs = _elapsed.nsecsElapsed() / NSECS_PER_USEC;
+
+    qint64 audioFramesDue = (qint64)(elapsedUsecs / (AudioConstants::NETWORK_FRAME_SECS * USECS_PER_SECOND));
+    for (; _numAudioFrames < audioFramesDue; ++_numAudioFrames) {
+        for (auto& bot : _bots) {
+            bot->sendAudio();
+        }
+    }
+
+    qint64 avatarFramesDue = elapsedUsecs * AVATAR_DATA_FRAMES_PER_SECOND / USECS_PER_SECOND;
+    if (_numAvatarFrames < avatarFramesDue) {
+        // only the latest avatar state matters, a late frame is not worth sending twice
+        _numAvatarFrames = avatarFramesDue;
+        if (_crowd) {
+            _crowd->update((float)(elapsedUsecs - _lastAvatarFrameUsecs) / USECS_PER_SECOND);
+            _lastAvatarFrameUsecs = elapsedUsecs;
+        }
+        for (size_t i = 0; i < _bots.size(); ++i) {
+            if (_crowd) {
+                _bots[i]->setJointPoses(_crowd->getAbsolutePoses(), _crowd->getRelativePoses(), (int)i);
+            }
+            _bots[i]->sendAvatarData();
+        }
+    }
+
+    // check in and ping once a second, spread over the ticks so that the domain-server is not hit all at once
+    int slice = (int)(_numTicks++ % TICKS_PER_SECOND);
+    for (size_t i = slice; i < _bots.size(); i += TICKS_PER_SECOND) {
+        _bots[i]->checkIn();
+        _bots[i]->pingMixers();
+    }
+}
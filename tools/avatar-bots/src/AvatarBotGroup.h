@@ -0,0 +1,61 @@
+//
+//  AvatarBotGroup.h
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarBotGroup_h
+#define hifi_AvatarBotGroup_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+
+#include <AnimCrowd.h>
+
+#include "AvatarBot.h"
+
+// The bots ticked by one thread. A group is moved to its thread before start(), so that the bots, their sockets and
+// the tick timer are all created on, and only ever touched from, that thread.
+class AvatarBotGroup : public QObject {
+    Q_OBJECT
+public:
+    AvatarBotGroup(int firstIndex, int numBots, const HifiSockAddr& domainServerAddr, AvatarBotClipPointer clip,
+                   AnimCrowdClipPointer animation, AvatarBotStats& stats);
+
+public slots:
+    void start();
+    void stop();
+
+private slots:
+    void tick();
+
+private:
+    int _firstIndex;
+    int _numBots;
+    HifiSockAddr _domainServerAddr;
+    AvatarBotClipPointer _clip;
+    AnimCrowdClipPointer _animation;
+    AvatarBotStats& _stats;
+
+    std::vector<std::unique_ptr<AvatarBot>> _bots;
+
+    // the bots of the group as one crowd, posed together before they send their avatar data
+    std::unique_ptr<AnimCrowd> _crowd;
+    qint64 _lastAvatarFrameUsecs { 0 };
+
+    QTimer* _tickTimer { nullptr };
+    QElapsedTimer _elapsed;
+    qint64 _numTicks { 0 };
+    qint64 _numAudioFrames { 0 };
+    qint64 _numAvatarFrames { 0 };
+};
+
+#endif // hifi_AvatarBotGroup_h
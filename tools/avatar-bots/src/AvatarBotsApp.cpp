@@ -0,0 +1,220 @@
+//
+//  AvatarBotsApp.cpp
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarBotsApp.h"
+
+#include <algorithm>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QLoggingCategory>
+
+#include <AnimCrowd.h>
+#include <DomainHandler.h>
+#include <FBXReader.h>
+#include <NetworkLogging.h>
+#include <NumericalConstants.h>
+#include <recording/Clip.h>
+#include <recording/Frame.h>
+
+#include "AvatarBotGroup.h"
+
+const int REPORT_INTERVAL_MSECS = 1000;
+
+AvatarBotsApp::AvatarBotsApp(int argc, char* argv[]) :
+    QCoreApplication(argc, argv)
+{
+    // parse command-line
+    QCommandLineParser parser;
+    parser.setApplicationDescription("High Fidelity avatar bots");
+
+    const QCommandLineOption helpOption = parser.addHelpOption();
+
+    const QCommandLineOption verboseOutput("v", "verbose output");
+    parser.addOption(verboseOutput);
+
+    const QCommandLineOption numBotsOption("n", "number of bots", "100");
+    parser.addOption(numBotsOption);
+
+    const QCommandLineOption domainAddressOption("d", "domain-server address", "IP:PORT or HOSTNAME:PORT");
+    parser.addOption(domainAddressOption);
+
+    const QCommandLineOption clipOption("c", "recording to play back, instead of walking in circles and humming", "file");
+    parser.addOption(clipOption);
+
+    const QCommandLineOption animationOption("a", "FBX animation for the walking bots to play, on its own skeleton", "file");
+    parser.addOption(animationOption);
+
+    const QCommandLineOption threadsOption("j", "number of threads to run the bots on", "4");
+    parser.addOption(threadsOption);
+
+    const QCommandLineOption durationOption("t", "seconds to run for, 0 runs until killed", "0");
+    parser.addOption(durationOption);
+
+    if (!parser.parse(QCoreApplication::arguments())) {
+        qCritical() << parser.errorText() << endl;
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (parser.isSet(helpOption)) {
+        parser.showHelp();
+        Q_UNREACHABLE();
+    }
+
+    if (!parser.isSet(verboseOutput)) {
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtDebugMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtInfoMsg, false);
+        const_cast<QLoggingCategory*>(&networking())->setEnabled(QtWarningMsg, false);
+    }
+
+    const int DEFAULT_NUM_BOTS = 100;
+    int numBots = parser.isSet(numBotsOption) ? std::max(parser.value(numBotsOption).toInt(), 1) : DEFAULT_NUM_BOTS;
+
+    int numThreads = std::max(QThread::idealThreadCount(), 1);
+    if (parser.isSet(threadsOption)) {
+        numThreads = std::max(parser.value(threadsOption).toInt(), 1);
+    }
+    numThreads = std::min(numThreads, numBots);
+
+    _durationSeconds = parser.isSet(durationOption) ? parser.value(durationOption).toInt() : 0;
+
+    HifiSockAddr domainServerAddr("127.0.0.1", DEFAULT_DOMAIN_SERVER_PORT);
+    if (parser.isSet(domainAddressOption)) {
+        // parse the hostname and port combination for this target
+        QString hostnamePortString = parser.value(domainAddressOption);
+
+        QString hostname = hostnamePortString.left(hostnamePortString.indexOf(':'));
+        quint16 port = DEFAULT_DOMAIN_SERVER_PORT;
+        if (hostnamePortString.contains(':')) {
+            port = (quint16)hostnamePortString.mid(hostnamePortString.indexOf(':') + 1).toUInt();
+        }
+
+        domainServerAddr = HifiSockAddr(hostname, port, true);
+        if (domainServerAddr.getAddress().isNull()) {
+            qCritical() << "Could not look up the domain-server address" << hostnamePortString;
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+    }
+
+    AvatarBotClipPointer clip;
+    if (parser.isSet(clipOption)) {
+        // the frame types have to be known before the clip is loaded, or its frames are dropped
+        recording::Frame::registerFrameType(AvatarData::FRAME_NAME);
+        recording::Frame::registerFrameType(AudioConstants::getAudioFrameName());
+
+        auto recordedClip = recording::Clip::fromFile(parser.value(clipOption));
+        if (!recordedClip) {
+            qCritical() << "Could not load the recording" << parser.value(clipOption);
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+        clip = AvatarBotClip::fromClip(recordedClip);
+    }
+
+    AnimCrowdClipPointer animation;
+    if (parser.isSet(animationOption)) {
+        if (clip) {
+            qCritical() << "A recording has its own poses, it can't be played with an animation";
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+
+        QFile file(parser.value(animationOption));
+        std::unique_ptr<FBXGeometry> geometry;
+        if (file.open(QIODevice::ReadOnly)) {
+            geometry.reset(readFBX(file.readAll(), QVariantHash(), file.fileName()));
+        }
+        if (!geometry || geometry->animationFrames.isEmpty()) {
+            qCritical() << "Could not load the animation" << parser.value(animationOption);
+            QMetaObject::invokeMethod(this, "quit", Qt::QueuedConnection);
+            return;
+        }
+        animation = AnimCrowdClip::fromGeometry(*geometry);
+    }
+
+    qDebug() << "Connecting" << numBots << "bots on" << numThreads << "threads to" << domainServerAddr;
+
+    for (int i = 0; i < numThreads; ++i) {
+        int firstIndex = numBots * i / numThreads;
+        int groupSize = numBots * (i + 1) / numThreads - firstIndex;
+
+        auto group = new AvatarBotGroup(firstIndex, groupSize, domainServerAddr, clip, animation, _stats);
+        auto thread = new QThread();
+        thread->setObjectName("AvatarBotGroup");
+        group->moveToThread(thread);
+        connect(thread, &QThread::started, group, &AvatarBotGroup::start);
+        thread->start();
+
+        _groups.push_back(group);
+        _threads.push_back(thread);
+    }
+
+    connect(&_reportTimer, &QTimer::timeout, this, &AvatarBotsApp::report);
+    _reportTimer.start(REPORT_INTERVAL_MSECS);
+}
+
+AvatarBotsApp::~AvatarBotsApp() {
+    stopGroups();
+}
+
+void AvatarBotsApp::stopGroups() {
+    // the bots have to be torn down on the threads that own their sockets
+    for (auto group : _groups) {
+        QMetaObject::invokeMethod(group, "stop", Qt::QueuedConnection);
+    }
+
+    for (size_t i = 0; i < _threads.size(); ++i) {
+        _threads[i]->wait();
+        delete _groups[i];
+        delete _threads[i];
+    }
+
+    _groups.clear();
+    _threads.clear();
+}
+
+void AvatarBotsApp::report() {
+    qint64 audioPacketsSent = _stats.audioPacketsSent.exchange(0);
+    qint64 avatarPacketsSent = _stats.avatarPacketsSent.exchange(0);
+    qint64 mixedAudioReceived = _stats.mixedAudioReceived.exchange(0);
+    qint64 mixedAudioLost = _stats.mixedAudioLost.exchange(0);
+    qint64 bulkAvatarBytesReceived = _stats.bulkAvatarBytesReceived.exchange(0);
+
+    qint64 audioMixerPingUsecs = _stats.audioMixerPingUsecs.exchange(0);
+    qint64 audioMixerPings = _stats.audioMixerPings.exchange(0);
+    qint64 avatarMixerPingUsecs = _stats.avatarMixerPingUsecs.exchange(0);
+    qint64 avatarMixerPings = _stats.avatarMixerPings.exchange(0);
+    qint64 maxPingUsecs = _stats.maxPingUsecs.exchange(0);
+
+    qint64 mixedAudioExpected = mixedAudioReceived + mixedAudioLost;
+    float lossPercentage = mixedAudioExpected > 0 ? 100.0f * mixedAudioLost / mixedAudioExpected : 0.0f;
+
+    float audioMixerPingMsecs = audioMixerPings > 0 ? (float)audioMixerPingUsecs / audioMixerPings / USECS_PER_MSEC : 0.0f;
+    float avatarMixerPingMsecs = avatarMixerPings > 0 ?
+        (float)avatarMixerPingUsecs / avatarMixerPings / USECS_PER_MSEC : 0.0f;
+
+    qDebug().noquote() << QString("connected %1 | sent audio %2/s avatar %3/s | mixed audio %4/s loss %5% | "
+                                  "ping audio %6ms avatar %7ms max %8ms | bulk avatar %9 kB/s")
+        .arg(_stats.numConnected.load())
+        .arg(audioPacketsSent).arg(avatarPacketsSent)
+        .arg(mixedAudioReceived).arg(lossPercentage, 0, 'f', 1)
+        .arg(audioMixerPingMsecs, 0, 'f', 1).arg(avatarMixerPingMsecs, 0, 'f', 1)
+        .arg((float)maxPingUsecs / USECS_PER_MSEC, 0, 'f', 1)
+        .arg(bulkAvatarBytesReceived / BYTES_PER_KILOBYTE);
+
+    if (_durationSeconds > 0 && ++_numReports >= _durationSeconds) {
+        _reportTimer.stop();
+        stopGroups();
+        quit();
+    }
+}
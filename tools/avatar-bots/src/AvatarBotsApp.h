@@ -0,0 +1,47 @@
+//
+//  AvatarBotsApp.h
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarBotsApp_h
+#define hifi_AvatarBotsApp_h
+
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include "AvatarBot.h"
+
+class AvatarBotGroup;
+
+// Connects a crowd of bots to a domain and prints, once a second, how the domain's mixers are keeping up with them.
+class AvatarBotsApp : public QCoreApplication {
+    Q_OBJECT
+public:
+    AvatarBotsApp(int argc, char* argv[]);
+    ~AvatarBotsApp();
+
+private slots:
+    void report();
+
+private:
+    void stopGroups();
+
+    AvatarBotStats _stats;
+
+    std::vector<QThread*> _threads;
+    std::vector<AvatarBotGroup*> _groups;
+
+    QTimer _reportTimer;
+    int _durationSeconds { 0 };
+    int _numReports { 0 };
+};
+
+#endif // hifi_AvatarBotsApp_h
@@ -0,0 +1,16 @@
+//
+//  main.cpp
+//  tools/avatar-bots/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AvatarBotsApp.h"
+
+int main(int argc, char* argv[]) {
+    AvatarBotsApp app(argc, argv);
+    return app.exec();
+}
@@ -9,6 +9,8 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
+
 #include <QDataStream>
 #include <QLoggingCategory>
 #include <QCommandLineParser>
@@ -17,6 +19,7 @@
 #include <NetworkLogging.h>
 
 #include "ICEClientApp.h"
+#include "ICELoadGenerator.h"
 
 ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     QCoreApplication(argc, argv)
@@ -43,6 +46,19 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
     const QCommandLineOption cacheSTUNOption("s", "cache stun-server response");
     parser.addOption(cacheSTUNOption);
 
+    const QCommandLineOption loadDomainsOption("l", "load test: heartbeat from this many simulated domains", "1000");
+    parser.addOption(loadDomainsOption);
+
+    const QCommandLineOption loadRateOption("r", "load test: total heartbeats per second", "10000");
+    parser.addOption(loadRateOption);
+
+    const QCommandLineOption loadDurationOption("t", "load test: seconds to run for, 0 runs until killed", "10");
+    parser.addOption(loadDurationOption);
+
+    const QCommandLineOption loadPublicKeyOption("k", "load test: write the simulated domains' public key here, "
+                                                 "for the ice-server's -k option", "path");
+    parser.addOption(loadPublicKeyOption);
+
     if (!parser.parse(QCoreApplication::arguments())) {
         qCritical() << parser.errorText() << endl;
         parser.showHelp();
@@ -103,6 +119,21 @@ ICEClientApp::ICEClientApp(int argc, char* argv[]) :
         qDebug() << "ICE-server address is" << _iceServerAddr;
     }
 
+    if (parser.isSet(loadDomainsOption)) {
+        // measure how many heartbeats the ice-server keeps up with, instead of walking through a connection
+        const int DEFAULT_LOAD_RATE = 10000;
+        const int DEFAULT_LOAD_DURATION = 10;
+        int numDomains = std::max(parser.value(loadDomainsOption).toInt(), 1);
+        int heartbeatsPerSecond = parser.isSet(loadRateOption) ? parser.value(loadRateOption).toInt() : DEFAULT_LOAD_RATE;
+        int durationSeconds = parser.isSet(loadDurationOption) ?
+            parser.value(loadDurationOption).toInt() : DEFAULT_LOAD_DURATION;
+
+        auto loadGenerator = new ICELoadGenerator(_iceServerAddr, numDomains, heartbeatsPerSecond, durationSeconds,
+                                                  parser.value(loadPublicKeyOption), this);
+        connect(loadGenerator, &ICELoadGenerator::finished, this, &QCoreApplication::quit, Qt::QueuedConnection);
+        return;
+    }
+
     setState(lookUpStunServer);
 
     QTimer* doTimer = new QTimer(this);
@@ -0,0 +1,128 @@
+//
+//  ICELoadGenerator.cpp
+//  tools/ice-client/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ICELoadGenerator.h"
+
+#include <algorithm>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+
+#include <DataServerAccountInfo.h>
+#include <NumericalConstants.h>
+#include <RSAKeypairGenerator.h>
+#include <SharedUtil.h>
+
+const int SEND_INTERVAL_MSECS = 5;
+const int REPORT_INTERVAL_MSECS = 1000;
+
+ICELoadGenerator::ICELoadGenerator(const HifiSockAddr& iceServerAddr, int numDomains, int heartbeatsPerSecond,
+                                   int durationSeconds, const QString& publicKeyPath, QObject* parent) :
+    QObject(parent),
+    _iceServerAddr(iceServerAddr),
+    _heartbeatsPerSecond(heartbeatsPerSecond),
+    _durationSeconds(durationSeconds)
+{
+    unsigned int localPort = 0;
+    _socket.bind(QHostAddress::AnyIPv4, localPort);
+    _socket.setPacketHandler([this](std::unique_ptr<udt::Packet> packet) { processPacket(std::move(packet)); });
+
+    HifiSockAddr localSockAddr("127.0.0.1", _socket.localPort());
+
+    // one keypair signs for every simulated domain, so the ice-server can be given a single public key for all of them
+    RSAKeypairGenerator keypairGenerator;
+    keypairGenerator.generateKeypair();
+    if (keypairGenerator.getPrivateKey().isEmpty()) {
+        qWarning() << "Could not generate a keypair, heartbeats will go out unsigned";
+    } else if (!publicKeyPath.isEmpty()) {
+        QFile publicKeyFile(publicKeyPath);
+        if (publicKeyFile.open(QIODevice::WriteOnly) && publicKeyFile.write(keypairGenerator.getPublicKey()) > 0) {
+            qDebug() << "Wrote the simulated domains' public key to" << publicKeyPath;
+        } else {
+            qWarning() << "Could not write the simulated domains' public key to" << publicKeyPath;
+        }
+    }
+
+    DataServerAccountInfo accountInfo;
+    accountInfo.setPrivateKey(keypairGenerator.getPrivateKey());
+
+    // build and sign every domain's heartbeat up front, in the same layout a domain-server sends, so the send loop is
+    // just writes and the ice-server sees the same heartbeat from each domain every time, as it does from a real one
+    _heartbeatPackets.reserve(numDomains);
+    for (int i = 0; i < numDomains; ++i) {
+        auto heartbeatPacket = NLPacket::create(PacketType::ICEServerHeartbeat);
+        QDataStream heartbeatDataStream(heartbeatPacket.get());
+        heartbeatDataStream << QUuid::createUuid() << localSockAddr << localSockAddr;
+
+        auto plaintext = QByteArray::fromRawData(heartbeatPacket->getPayload(), heartbeatPacket->getPayloadSize());
+        heartbeatDataStream << accountInfo.signPlaintext(plaintext);
+        _heartbeatPackets.push_back(std::move(heartbeatPacket));
+    }
+
+    qDebug() << "Sending" << heartbeatsPerSecond << "heartbeats/s from" << numDomains << "domains to" << iceServerAddr;
+
+    connect(&_sendTimer, &QTimer::timeout, this, &ICELoadGenerator::sendHeartbeats);
+    _sendTimer.setTimerType(Qt::PreciseTimer);
+    _sendTimer.start(SEND_INTERVAL_MSECS);
+
+    connect(&_reportTimer, &QTimer::timeout, this, &ICELoadGenerator::report);
+    _reportTimer.start(REPORT_INTERVAL_MSECS);
+
+    _elapsed.start();
+}
+
+void ICELoadGenerator::sendHeartbeats() {
+    if (_heartbeatPackets.empty()) {
+        return;
+    }
+
+    // send however many heartbeats are due since the last tick, timers are not precise enough to send a fixed count
+    qint64 nowMsecs = _elapsed.elapsed();
+    _sendBudget += (double)(nowMsecs - _lastSendMsecs) * _heartbeatsPerSecond / MSECS_PER_SECOND;
+    _lastSendMsecs = nowMsecs;
+
+    while (_sendBudget >= 1.0) {
+        _socket.writePacket(*_heartbeatPackets[_nextHeartbeat], _iceServerAddr);
+        _nextHeartbeat = (_nextHeartbeat + 1) % _heartbeatPackets.size();
+        _sendBudget -= 1.0;
+        ++_numSent;
+    }
+}
+
+void ICELoadGenerator::processPacket(std::unique_ptr<udt::Packet> packet) {
+    auto nlPacket = NLPacket::fromBase(std::move(packet));
+    if (nlPacket->getType() == PacketType::ICEServerHeartbeatACK) {
+        ++_numAcked;
+    } else if (nlPacket->getType() == PacketType::ICEServerHeartbeatDenied) {
+        ++_numDenied;
+    }
+}
+
+void ICELoadGenerator::report() {
+    int numAnswered = _numAcked + _numDenied;
+    float lossPercentage = _numSent > 0 ? std::max(0.0f, 100.0f * (_numSent - numAnswered) / _numSent) : 0.0f;
+
+    qDebug().noquote() << QString("sent %1/s answered %2/s (%3 acked, %4 denied) loss %5%")
+        .arg(_numSent).arg(numAnswered).arg(_numAcked).arg(_numDenied).arg(lossPercentage, 0, 'f', 1);
+
+    _totalSent += _numSent;
+    _totalAnswered += numAnswered;
+    _numSent = _numAcked = _numDenied = 0;
+
+    if (_durationSeconds > 0 && ++_numReports >= _durationSeconds) {
+        _sendTimer.stop();
+        _reportTimer.stop();
+
+        qDebug().noquote() << QString("average over %1s: sent %2/s answered %3/s")
+            .arg(_numReports).arg(_totalSent / _numReports).arg(_totalAnswered / _numReports);
+        emit finished();
+    }
+}
@@ -0,0 +1,70 @@
+//
+//  ICELoadGenerator.h
+//  tools/ice-client/src
+//
+//  Copyright 2018 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ICELoadGenerator_h
+#define hifi_ICELoadGenerator_h
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QUuid>
+
+#include <NLPacket.h>
+#include <udt/Socket.h>
+
+// Floods an ice-server with heartbeats from simulated domains and reports how many it answers per second.
+// The simulated domains share a keypair generated for the run and sign their heartbeats the way a domain-server does.
+// Its public key is written to publicKeyPath, for the ice-server to be pointed at with its -k option; otherwise the
+// ice-server looks the domains up on the metaverse API, and denies them.
+class ICELoadGenerator : public QObject {
+    Q_OBJECT
+public:
+    ICELoadGenerator(const HifiSockAddr& iceServerAddr, int numDomains, int heartbeatsPerSecond,
+                     int durationSeconds, const QString& publicKeyPath = QString(), QObject* parent = nullptr);
+
+signals:
+    void finished();
+
+private slots:
+    void sendHeartbeats();
+    void report();
+
+private:
+    void processPacket(std::unique_ptr<udt::Packet> packet);
+
+    HifiSockAddr _iceServerAddr;
+    int _heartbeatsPerSecond;
+    int _durationSeconds;
+
+    udt::Socket _socket;
+    std::vector<std::unique_ptr<NLPacket>> _heartbeatPackets;
+    size_t _nextHeartbeat { 0 };
+
+    QTimer _sendTimer;
+    QTimer _reportTimer;
+    QElapsedTimer _elapsed;
+    qint64 _lastSendMsecs { 0 };
+    double _sendBudget { 0.0 };
+
+    // this interval
+    int _numSent { 0 };
+    int _numAcked { 0 };
+    int _numDenied { 0 };
+
+    // whole run
+    qint64 _totalSent { 0 };
+    qint64 _totalAnswered { 0 };
+    int _numReports { 0 };
+};
+
+#endif // hifi_ICELoadGenerator_h
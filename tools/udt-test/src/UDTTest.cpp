@@ -55,6 +55,12 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption LOSS_RATE {
+    "loss-rate", "percentage of received data packets to drop, simulating a lossy link (default is 0)", "percent"
+};
+const QCommandLineOption LOSS_BURST {
+    "loss-burst", "average number of consecutive data packets dropped per loss event (default is 1)", "packets"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (Mb/s)", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -65,7 +71,7 @@ const QStringList CLIENT_STATS_TABLE_HEADERS {
 const QStringList SERVER_STATS_TABLE_HEADERS {
     "  Mb/s  ", "Recv Mb/s", "Est. Max (Mb/s)", "RTT (ms)", "CW (P)",
     "Sent ACK", "Sent LACK", "Sent NAK", "Sent TNAK",
-    "Recv ACK2", "Duplicates (P)"
+    "Recv ACK2", "Duplicates (P)", "Sim. Loss (P)"
 };
 
 UDTTest::UDTTest(int& argc, char** argv) :
@@ -207,6 +213,8 @@ UDTTest::UDTTest(int& argc, char** argv) :
         }
     );
     
+    setupSimulatedLoss();
+    
     // the sender reports stats every 100 milliseconds, unless passed a custom value
     
     if (_argumentParser.isSet(STATS_INTERVAL)) {
@@ -228,7 +236,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, LOSS_RATE, LOSS_BURST
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -243,6 +251,42 @@ void UDTTest::parseArguments() {
     }
 }
 
+void UDTTest::setupSimulatedLoss() {
+    if (_argumentParser.isSet(LOSS_RATE)) {
+        static const double PERCENT = 100.0;
+        static const double MAX_LOSS_RATE = 0.99;
+        _lossRate = std::min(std::max(_argumentParser.value(LOSS_RATE).toDouble() / PERCENT, 0.0), MAX_LOSS_RATE);
+    }
+    
+    if (_argumentParser.isSet(LOSS_BURST)) {
+        _lossBurst = std::max(_argumentParser.value(LOSS_BURST).toDouble(), 1.0);
+    }
+    
+    if (_lossRate <= 0.0) {
+        return;
+    }
+    
+    qDebug() << "Simulating" << QString("%1%").arg(_lossRate * 100.0) << "loss of received data packets,"
+        << "in bursts of" << _lossBurst << "packets on average";
+    
+    // two state (Gilbert) loss model - once in a burst each packet is dropped and the burst continues with
+    // probability 1 - 1 / burst, which gives the average burst length, and bursts start at the rate that makes
+    // the overall fraction of dropped packets the requested loss rate
+    const double continueBurstProbability = 1.0 - 1.0 / _lossBurst;
+    const double startBurstProbability = _lossRate / (_lossBurst * (1.0 - _lossRate));
+    
+    _socket.setPacketFilterOperator([this, continueBurstProbability, startBurstProbability](const udt::Packet& packet) {
+        double roll = _lossDistribution(_lossGenerator);
+        _inLossBurst = _inLossBurst ? (roll < continueBurstProbability) : (roll < startBurstProbability);
+        
+        if (_inLossBurst) {
+            ++_simulatedLossCount;
+            return false;
+        }
+        return true;
+    });
+}
+
 void UDTTest::sendInitialPackets() {
     static const int NUM_INITIAL_PACKETS = 500;
     
@@ -426,9 +470,12 @@ void UDTTest::sampleStats() {
                 QString::number(stats.events[udt::ConnectionStats::Stats::SentNAK]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
                 QString::number(stats.events[udt::ConnectionStats::Stats::SentTimeoutNAK]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
                 QString::number(stats.events[udt::ConnectionStats::Stats::ReceivedACK2]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
-                QString::number(stats.events[udt::ConnectionStats::Stats::Duplicate]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size())
+                QString::number(stats.events[udt::ConnectionStats::Stats::Duplicate]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
+                QString::number(_simulatedLossCount).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size())
             };
             
+            _simulatedLossCount = 0;
+            
             // output this line of values
             qDebug() << qPrintable(values.join(" | "));
         }
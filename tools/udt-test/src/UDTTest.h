@@ -43,6 +43,8 @@ private:
     void parseArguments();
     void handleMessage(std::unique_ptr<Message> message);
     
+    void setupSimulatedLoss(); // installs a packet filter dropping received data packets at the requested rate
+    
     void sendInitialPackets(); // fills the queue with packets to start
     void sendPacket(); // constructs and sends a packet according to the test parameters
     
@@ -71,6 +73,13 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+    
+    double _lossRate { 0.0 }; // fraction of received data packets dropped to simulate a lossy link
+    double _lossBurst { 1.0 }; // average number of consecutive packets dropped per loss event
+    bool _inLossBurst { false };
+    int _simulatedLossCount { 0 }; // data packets dropped since the last stats sample
+    std::mt19937 _lossGenerator { 1 }; // separate from _generator so ordered message verification is unaffected
+    std::uniform_real_distribution<double> _lossDistribution { 0.0, 1.0 };
 };
 
 #endif // hifi_UDTTest_h